@@ -4,105 +4,464 @@
 
 #include "cc/base/region.h"
 
+#include <algorithm>
+#include <limits>
+
 #include "base/debug/trace_event_argument.h"
+#include "base/logging.h"
 #include "base/values.h"
 #include "cc/base/simple_enclosed_region.h"
 
 namespace cc {
 
+namespace {
+
+// Returns the index one past the last rect of the band that starts at |begin|.
+size_t BandEnd(const gfx::Rect* rects, size_t begin, size_t size) {
+  size_t end = begin + 1;
+  while (end < size && rects[end].y() == rects[begin].y())
+    ++end;
+  return end;
+}
+
+}  // namespace
+
+Region::RectVector::RectVector() : size_(0) {
+}
+
+Region::RectVector::RectVector(const RectVector& other) : size_(0) {
+  *this = other;
+}
+
+Region::RectVector::~RectVector() {
+}
+
+Region::RectVector& Region::RectVector::operator=(const RectVector& other) {
+  if (this == &other)
+    return *this;
+  if (other.size_ > capacity())
+    heap_.resize(other.size_);
+  std::copy(other.data(), other.data() + other.size_, data());
+  size_ = other.size_;
+  return *this;
+}
+
+bool Region::RectVector::operator==(const RectVector& other) const {
+  return size_ == other.size_ &&
+         std::equal(data(), data() + size_, other.data());
+}
+
+void Region::RectVector::Swap(RectVector* other) {
+  std::swap_ranges(inline_rects_,
+                   inline_rects_ + kInlineCapacity,
+                   other->inline_rects_);
+  heap_.swap(other->heap_);
+  std::swap(size_, other->size_);
+}
+
+void Region::RectVector::Grow() {
+  if (heap_.empty()) {
+    heap_.assign(inline_rects_, inline_rects_ + size_);
+    heap_.resize(2 * kInlineCapacity);
+  } else {
+    heap_.resize(2 * heap_.size());
+  }
+}
+
 Region::Region() {
 }
 
 Region::Region(const Region& region)
-    : skregion_(region.skregion_) {
+    : rects_(region.rects_), bounds_(region.bounds_) {
 }
 
-Region::Region(const gfx::Rect& rect)
-    : skregion_(gfx::RectToSkIRect(rect)) {
+Region::Region(const gfx::Rect& rect) {
+  *this = rect;
 }
 
 Region::~Region() {
 }
 
 const Region& Region::operator=(const gfx::Rect& rect) {
-  skregion_ = SkRegion(gfx::RectToSkIRect(rect));
+  rects_.clear();
+  if (!rect.IsEmpty())
+    rects_.push_back(rect);
+  UpdateBounds();
   return *this;
 }
 
 const Region& Region::operator=(const Region& region) {
-  skregion_ = region.skregion_;
+  rects_ = region.rects_;
+  bounds_ = region.bounds_;
   return *this;
 }
 
 void Region::Swap(Region* region) {
-  region->skregion_.swap(skregion_);
+  region->rects_.Swap(&rects_);
+  std::swap(region->bounds_, bounds_);
 }
 
 void Region::Clear() {
-  skregion_.setEmpty();
+  rects_.clear();
+  bounds_ = gfx::Rect();
 }
 
 bool Region::IsEmpty() const {
-  return skregion_.isEmpty();
+  return rects_.empty();
 }
 
 int Region::GetRegionComplexity() const {
-  return skregion_.computeRegionComplexity();
+  return static_cast<int>(rects_.size());
 }
 
 bool Region::Contains(const gfx::Point& point) const {
-  return skregion_.contains(point.x(), point.y());
+  if (!bounds_.Contains(point))
+    return false;
+  for (size_t i = 0; i < rects_.size(); ++i) {
+    if (rects_[i].y() > point.y())
+      return false;
+    if (rects_[i].Contains(point))
+      return true;
+  }
+  return false;
 }
 
 bool Region::Contains(const gfx::Rect& rect) const {
   if (rect.IsEmpty())
     return true;
-  return skregion_.contains(gfx::RectToSkIRect(rect));
+  if (!bounds_.Contains(rect))
+    return false;
+  if (rects_.size() == 1)
+    return true;
+
+  // Every row of |rect| has to be covered by a single rect of some band, and
+  // the bands covering |rect| have to be adjacent.
+  int covered_bottom = rect.y();
+  for (size_t i = 0; i < rects_.size(); ++i) {
+    const gfx::Rect& band_rect = rects_[i];
+    if (band_rect.bottom() <= covered_bottom)
+      continue;
+    if (band_rect.y() > covered_bottom)
+      return false;
+    if (band_rect.x() <= rect.x() && band_rect.right() >= rect.right()) {
+      covered_bottom = band_rect.bottom();
+      if (covered_bottom >= rect.bottom())
+        return true;
+    }
+  }
+  return false;
 }
 
 bool Region::Contains(const Region& region) const {
   if (region.IsEmpty())
     return true;
-  return skregion_.contains(region.skregion_);
+  if (!bounds_.Contains(region.bounds_))
+    return false;
+  if (rects_.size() == 1)
+    return true;
+  return SubtractRegions(region, *this).IsEmpty();
 }
 
 bool Region::Intersects(const gfx::Rect& rect) const {
-  return skregion_.intersects(gfx::RectToSkIRect(rect));
+  if (!bounds_.Intersects(rect))
+    return false;
+  for (size_t i = 0; i < rects_.size(); ++i) {
+    if (rects_[i].Intersects(rect))
+      return true;
+  }
+  return false;
 }
 
 bool Region::Intersects(const Region& region) const {
-  return skregion_.intersects(region.skregion_);
+  if (!bounds_.Intersects(region.bounds_))
+    return false;
+  if (region.rects_.size() == 1)
+    return Intersects(region.bounds_);
+  if (rects_.size() == 1)
+    return region.Intersects(bounds_);
+  RectVector intersection;
+  CombineRects(rects_, region.rects_, INTERSECT_OPERATION, &intersection);
+  return !intersection.empty();
 }
 
 void Region::Subtract(const gfx::Rect& rect) {
-  skregion_.op(gfx::RectToSkIRect(rect), SkRegion::kDifference_Op);
+  if (!bounds_.Intersects(rect))
+    return;
+  if (rect.Contains(bounds_)) {
+    Clear();
+    return;
+  }
+  RectVector other;
+  other.push_back(rect);
+  Combine(other, DIFFERENCE_OPERATION);
 }
 
 void Region::Subtract(const Region& region) {
-  skregion_.op(region.skregion_, SkRegion::kDifference_Op);
+  if (!bounds_.Intersects(region.bounds_))
+    return;
+  if (region.rects_.size() == 1) {
+    Subtract(region.bounds_);
+    return;
+  }
+  Combine(region.rects_, DIFFERENCE_OPERATION);
 }
 
 void Region::Subtract(const SimpleEnclosedRegion& region) {
-  for (size_t i = 0; i < region.GetRegionComplexity(); ++i) {
-    skregion_.op(gfx::RectToSkIRect(region.GetRect(i)),
-                 SkRegion::kDifference_Op);
-  }
+  for (size_t i = 0; i < region.GetRegionComplexity(); ++i)
+    Subtract(region.GetRect(i));
 }
 
 void Region::Union(const gfx::Rect& rect) {
-  skregion_.op(gfx::RectToSkIRect(rect), SkRegion::kUnion_Op);
+  if (rect.IsEmpty())
+    return;
+  if (IsEmpty() || rect.Contains(bounds_)) {
+    *this = rect;
+    return;
+  }
+  if (rects_.size() == 1 && bounds_.Contains(rect))
+    return;
+  RectVector other;
+  other.push_back(rect);
+  Combine(other, UNION_OPERATION);
 }
 
 void Region::Union(const Region& region) {
-  skregion_.op(region.skregion_, SkRegion::kUnion_Op);
+  if (region.IsEmpty())
+    return;
+  if (region.rects_.size() == 1) {
+    Union(region.bounds_);
+    return;
+  }
+  if (IsEmpty() || (rects_.size() == 1 && region.Contains(bounds_))) {
+    *this = region;
+    return;
+  }
+  if (rects_.size() == 1 && bounds_.Contains(region.bounds_))
+    return;
+  Combine(region.rects_, UNION_OPERATION);
 }
 
 void Region::Intersect(const gfx::Rect& rect) {
-  skregion_.op(gfx::RectToSkIRect(rect), SkRegion::kIntersect_Op);
+  if (rect.Contains(bounds_))
+    return;
+  if (!rect.Intersects(bounds_)) {
+    Clear();
+    return;
+  }
+  if (rects_.size() == 1) {
+    rects_[0].Intersect(rect);
+    bounds_ = rects_[0];
+    return;
+  }
+  RectVector other;
+  other.push_back(rect);
+  Combine(other, INTERSECT_OPERATION);
 }
 
 void Region::Intersect(const Region& region) {
-  skregion_.op(region.skregion_, SkRegion::kIntersect_Op);
+  if (!bounds_.Intersects(region.bounds_)) {
+    Clear();
+    return;
+  }
+  if (region.rects_.size() == 1) {
+    Intersect(region.bounds_);
+    return;
+  }
+  if (rects_.size() == 1) {
+    gfx::Rect rect = bounds_;
+    *this = region;
+    Intersect(rect);
+    return;
+  }
+  Combine(region.rects_, INTERSECT_OPERATION);
+}
+
+void Region::Combine(const RectVector& other, SetOperation op) {
+  RectVector result;
+  CombineRects(rects_, other, op, &result);
+  rects_.Swap(&result);
+  UpdateBounds();
+}
+
+// static
+void Region::CombineRects(const RectVector& a,
+                          const RectVector& b,
+                          SetOperation op,
+                          RectVector* result) {
+  DCHECK(result->empty());
+  const gfx::Rect* a_rects = a.data();
+  const gfx::Rect* b_rects = b.data();
+  size_t a_size = a.size();
+  size_t b_size = b.size();
+  size_t a_band = 0;
+  size_t b_band = 0;
+  size_t a_band_end = a_size ? BandEnd(a_rects, 0, a_size) : 0;
+  size_t b_band_end = b_size ? BandEnd(b_rects, 0, b_size) : 0;
+  size_t previous_band_start = 0;
+
+  // Sweep down through the horizontal slabs between consecutive band edges of
+  // either input. Within each slab, both inputs are a (possibly empty) list of
+  // x-spans.
+  int y = std::numeric_limits<int>::max();
+  if (a_size)
+    y = a_rects[0].y();
+  if (b_size)
+    y = std::min(y, b_rects[0].y());
+  while (a_band < a_size || b_band < b_size) {
+    if (op == INTERSECT_OPERATION && (a_band == a_size || b_band == b_size))
+      break;
+    if (op == DIFFERENCE_OPERATION && a_band == a_size)
+      break;
+
+    bool a_active = a_band < a_size && a_rects[a_band].y() <= y;
+    bool b_active = b_band < b_size && b_rects[b_band].y() <= y;
+    int slab_bottom = std::numeric_limits<int>::max();
+    if (a_band < a_size) {
+      slab_bottom = std::min(slab_bottom,
+                             a_active ? a_rects[a_band].bottom()
+                                      : a_rects[a_band].y());
+    }
+    if (b_band < b_size) {
+      slab_bottom = std::min(slab_bottom,
+                             b_active ? b_rects[b_band].bottom()
+                                      : b_rects[b_band].y());
+    }
+
+    if (a_active || b_active) {
+      AppendBand(y,
+                 slab_bottom,
+                 a_rects + a_band,
+                 a_active ? a_band_end - a_band : 0,
+                 b_rects + b_band,
+                 b_active ? b_band_end - b_band : 0,
+                 op,
+                 &previous_band_start,
+                 result);
+    }
+
+    y = slab_bottom;
+    if (a_active && a_rects[a_band].bottom() == y) {
+      a_band = a_band_end;
+      if (a_band < a_size)
+        a_band_end = BandEnd(a_rects, a_band, a_size);
+    }
+    if (b_active && b_rects[b_band].bottom() == y) {
+      b_band = b_band_end;
+      if (b_band < b_size)
+        b_band_end = BandEnd(b_rects, b_band, b_size);
+    }
+  }
+}
+
+// static
+void Region::AppendBand(int top,
+                        int bottom,
+                        const gfx::Rect* a,
+                        size_t a_size,
+                        const gfx::Rect* b,
+                        size_t b_size,
+                        SetOperation op,
+                        size_t* previous_band_start,
+                        RectVector* result) {
+  size_t band_start = result->size();
+  int height = bottom - top;
+  size_t i = 0;
+  size_t j = 0;
+  switch (op) {
+    case UNION_OPERATION:
+      while (i < a_size || j < b_size) {
+        // Take the span that starts first, and merge everything that
+        // overlaps or touches it.
+        bool take_a = j == b_size || (i < a_size && a[i].x() <= b[j].x());
+        int left = take_a ? a[i].x() : b[j].x();
+        int right = take_a ? a[i++].right() : b[j++].right();
+        for (;;) {
+          if (i < a_size && a[i].x() <= right) {
+            right = std::max(right, a[i++].right());
+          } else if (j < b_size && b[j].x() <= right) {
+            right = std::max(right, b[j++].right());
+          } else {
+            break;
+          }
+        }
+        result->push_back(gfx::Rect(left, top, right - left, height));
+      }
+      break;
+    case INTERSECT_OPERATION:
+      while (i < a_size && j < b_size) {
+        int left = std::max(a[i].x(), b[j].x());
+        int right = std::min(a[i].right(), b[j].right());
+        if (left < right)
+          result->push_back(gfx::Rect(left, top, right - left, height));
+        if (a[i].right() < b[j].right())
+          ++i;
+        else
+          ++j;
+      }
+      break;
+    case DIFFERENCE_OPERATION:
+      for (; i < a_size; ++i) {
+        int left = a[i].x();
+        int right = a[i].right();
+        // Spans of |b| that end before this span can't affect later ones
+        // either.
+        while (j < b_size && b[j].right() <= left)
+          ++j;
+        for (size_t k = j; k < b_size && b[k].x() < right; ++k) {
+          if (b[k].x() > left)
+            result->push_back(gfx::Rect(left, top, b[k].x() - left, height));
+          left = std::max(left, b[k].right());
+          if (left >= right)
+            break;
+        }
+        if (left < right)
+          result->push_back(gfx::Rect(left, top, right - left, height));
+      }
+      break;
+  }
+
+  size_t band_size = result->size() - band_start;
+  if (!band_size)
+    return;
+
+  // Merge the new band into the previous one if they are adjacent and have
+  // the same spans.
+  size_t previous_band_size = band_start - *previous_band_start;
+  if (previous_band_size == band_size &&
+      (*result)[*previous_band_start].bottom() == top) {
+    bool same_spans = true;
+    for (size_t k = 0; k < band_size && same_spans; ++k) {
+      const gfx::Rect& previous = (*result)[*previous_band_start + k];
+      const gfx::Rect& current = (*result)[band_start + k];
+      same_spans =
+          previous.x() == current.x() && previous.right() == current.right();
+    }
+    if (same_spans) {
+      for (size_t k = 0; k < band_size; ++k) {
+        gfx::Rect& previous = (*result)[*previous_band_start + k];
+        previous.set_height(bottom - previous.y());
+      }
+      result->Truncate(band_start);
+      return;
+    }
+  }
+  *previous_band_start = band_start;
+}
+
+void Region::UpdateBounds() {
+  if (rects_.empty()) {
+    bounds_ = gfx::Rect();
+    return;
+  }
+  int left = rects_[0].x();
+  int right = rects_[0].right();
+  for (size_t i = 1; i < rects_.size(); ++i) {
+    left = std::min(left, rects_[i].x());
+    right = std::max(right, rects_[i].right());
+  }
+  int top = rects_[0].y();
+  int bottom = rects_[rects_.size() - 1].bottom();
+  bounds_ = gfx::Rect(left, top, right - left, bottom - top);
 }
 
 std::string Region::ToString() const {
@@ -140,11 +499,11 @@ void Region::AsValueInto(base::debug::TracedValue* result) const {
   }
 }
 
-Region::Iterator::Iterator() {
+Region::Iterator::Iterator() : region_(NULL), index_(0) {
 }
 
 Region::Iterator::Iterator(const Region& region)
-    : it_(region.skregion_) {
+    : region_(&region), index_(0) {
 }
 
 Region::Iterator::~Iterator() {
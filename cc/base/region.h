@@ -6,12 +6,11 @@
 #define CC_BASE_REGION_H_
 
 #include <string>
+#include <vector>
 
 #include "base/memory/scoped_ptr.h"
 #include "cc/base/cc_export.h"
-#include "third_party/skia/include/core/SkRegion.h"
 #include "ui/gfx/rect.h"
-#include "ui/gfx/skia_util.h"
 
 namespace base {
 class Value;
@@ -23,6 +22,12 @@ class TracedValue;
 namespace cc {
 class SimpleEnclosedRegion;
 
+// A set of pixels, stored as a list of non-overlapping rects in y-x banded
+// form: the rects are sorted by y and then by x, rects in the same horizontal
+// band have the same top and bottom, rects within a band don't touch, and
+// vertically adjacent bands with the same x-spans are merged. This is the
+// same canonical form SkRegion uses, so iteration yields the same rects; but
+// regions of up to four rects (the common case) don't allocate.
 class CC_EXPORT Region {
  public:
   Region();
@@ -54,11 +59,11 @@ class CC_EXPORT Region {
   void Intersect(const Region& region);
 
   bool Equals(const Region& other) const {
-    return skregion_ == other.skregion_;
+    return rects_ == other.rects_;
   }
 
   gfx::Rect bounds() const {
-    return gfx::SkIRectToRect(skregion_.getBounds());
+    return bounds_;
   }
 
   std::string ToString() const;
@@ -72,23 +77,93 @@ class CC_EXPORT Region {
     ~Iterator();
 
     gfx::Rect rect() const {
-      return gfx::SkIRectToRect(it_.rect());
+      return region_->rects_[index_];
     }
 
     void next() {
-      it_.next();
+      ++index_;
     }
 
     bool has_rect() const {
-      return !it_.done();
+      return region_ && index_ < region_->rects_.size();
     }
 
    private:
-    SkRegion::Iterator it_;
+    const Region* region_;
+    size_t index_;
   };
 
  private:
-  SkRegion skregion_;
+  // A vector of rects that stores the first few of them inline.
+  class RectVector {
+   public:
+    RectVector();
+    RectVector(const RectVector& other);
+    ~RectVector();
+
+    RectVector& operator=(const RectVector& other);
+    bool operator==(const RectVector& other) const;
+
+    void Swap(RectVector* other);
+
+    size_t size() const { return size_; }
+    bool empty() const { return !size_; }
+    const gfx::Rect* data() const {
+      return heap_.empty() ? inline_rects_ : &heap_[0];
+    }
+    gfx::Rect* data() { return heap_.empty() ? inline_rects_ : &heap_[0]; }
+    const gfx::Rect& operator[](size_t i) const { return data()[i]; }
+    gfx::Rect& operator[](size_t i) { return data()[i]; }
+
+    void push_back(const gfx::Rect& rect) {
+      if (size_ == capacity())
+        Grow();
+      data()[size_++] = rect;
+    }
+    void Truncate(size_t size) { size_ = size; }
+    void clear() { size_ = 0; }
+
+   private:
+    static const size_t kInlineCapacity = 4;
+
+    size_t capacity() const {
+      return heap_.empty() ? kInlineCapacity : heap_.size();
+    }
+    void Grow();
+
+    gfx::Rect inline_rects_[kInlineCapacity];
+    // Once more than kInlineCapacity rects are stored, all of them live here.
+    // Its size is the capacity of the vector.
+    std::vector<gfx::Rect> heap_;
+    size_t size_;
+  };
+
+  enum SetOperation {
+    UNION_OPERATION,
+    INTERSECT_OPERATION,
+    DIFFERENCE_OPERATION
+  };
+
+  // Replaces this region with |this op other|.
+  void Combine(const RectVector& other, SetOperation op);
+
+  static void CombineRects(const RectVector& a,
+                           const RectVector& b,
+                           SetOperation op,
+                           RectVector* result);
+  static void AppendBand(int top,
+                         int bottom,
+                         const gfx::Rect* a,
+                         size_t a_size,
+                         const gfx::Rect* b,
+                         size_t b_size,
+                         SetOperation op,
+                         size_t* previous_band_start,
+                         RectVector* result);
+  void UpdateBounds();
+
+  RectVector rects_;
+  gfx::Rect bounds_;
 };
 
 inline bool operator==(const Region& a, const Region& b) {
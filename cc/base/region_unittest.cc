@@ -5,6 +5,7 @@
 #include "cc/base/region.h"
 
 #include "testing/gtest/include/gtest/gtest.h"
+#include "third_party/skia/include/core/SkRect.h"
 
 namespace cc {
 namespace {
@@ -396,6 +397,28 @@ TEST(RegionTest, Union) {
   EXPECT_EQ(Region(gfx::Rect(0, 0, 500, 500)), r);
 }
 
+TEST(RegionTest, ManyRects) {
+  // More rects than are stored inline.
+  Region r;
+  for (int i = 0; i < 6; ++i)
+    r.Union(gfx::Rect(i * 20, 0, 10, 10));
+  EXPECT_EQ(6, r.GetRegionComplexity());
+  EXPECT_EQ(gfx::Rect(0, 0, 110, 10), r.bounds());
+
+  // Filling the gaps merges the band into a single rect.
+  for (int i = 0; i < 5; ++i)
+    r.Union(gfx::Rect(i * 20 + 10, 0, 10, 10));
+  EXPECT_EQ(1, r.GetRegionComplexity());
+  EXPECT_EQ(Region(gfx::Rect(0, 0, 110, 10)), r);
+
+  // Bands with the same spans are merged vertically.
+  r.Union(gfx::Rect(0, 10, 110, 10));
+  EXPECT_EQ(1, r.GetRegionComplexity());
+  r.Subtract(gfx::Rect(50, 5, 10, 10));
+  EXPECT_EQ(4, r.GetRegionComplexity());
+  EXPECT_EQ("0,0 110x5 | 0,5 50x10 | 60,5 50x10 | 0,15 110x5", r.ToString());
+}
+
 TEST(RegionTest, IsEmpty) {
   EXPECT_TRUE(Region().IsEmpty());
   EXPECT_TRUE(Region(gfx::Rect()).IsEmpty());
@@ -26,7 +26,7 @@ namespace {
 const int kDefaultRecordRepeatCount = 100;
 
 const char* kModeSuffixes[Picture::RECORDING_MODE_COUNT] = {
-    "", "_sk_null_canvas", "_painting_disabled", "_skrecord"};
+    "", "_sk_null_canvas", "_painting_disabled", "_skrecord", "_display_list"};
 
 }  // namespace
 
@@ -135,6 +135,14 @@ class FixedInvalidationPictureLayerTilingClient
     return base_client_->GetSkewportExtrapolationLimitInContentPixels();
   }
 
+  virtual bool UsePredictiveSkewport() const OVERRIDE {
+    return base_client_->UsePredictiveSkewport();
+  }
+
+  virtual float GetRasterThroughputInContentPixelsPerSecond() const OVERRIDE {
+    return base_client_->GetRasterThroughputInContentPixelsPerSecond();
+  }
+
   virtual WhichTree GetTree() const OVERRIDE { return base_client_->GetTree(); }
 
  private:
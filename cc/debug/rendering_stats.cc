@@ -60,7 +60,8 @@ RenderingStats::ImplThreadRenderingStats::ImplThreadRenderingStats()
     : frame_count(0),
       rasterized_pixel_count(0),
       visible_content_area(0),
-      approximated_visible_content_area(0) {
+      approximated_visible_content_area(0),
+      checkerboarded_visible_content_area(0) {
 }
 
 RenderingStats::ImplThreadRenderingStats::~ImplThreadRenderingStats() {
@@ -76,6 +77,8 @@ RenderingStats::ImplThreadRenderingStats::AsTraceableData() const {
   record_data->SetInteger("visible_content_area", visible_content_area);
   record_data->SetInteger("approximated_visible_content_area",
                           approximated_visible_content_area);
+  record_data->SetInteger("checkerboarded_visible_content_area",
+                          checkerboarded_visible_content_area);
   record_data->BeginArray("draw_duration_ms");
   draw_duration.AddToTracedValue(record_data.get());
   record_data->EndArray();
@@ -111,6 +114,8 @@ void RenderingStats::ImplThreadRenderingStats::Add(
   rasterized_pixel_count += other.rasterized_pixel_count;
   visible_content_area += other.visible_content_area;
   approximated_visible_content_area += other.approximated_visible_content_area;
+  checkerboarded_visible_content_area +=
+      other.checkerboarded_visible_content_area;
 
   draw_duration.Add(other.draw_duration);
   draw_duration_estimate.Add(other.draw_duration_estimate);
@@ -59,6 +59,7 @@ struct CC_EXPORT RenderingStats {
     int64 rasterized_pixel_count;
     int64 visible_content_area;
     int64 approximated_visible_content_area;
+    int64 checkerboarded_visible_content_area;
 
     TimeDeltaList draw_duration;
     TimeDeltaList draw_duration_estimate;
@@ -16,6 +16,7 @@ struct AppendQuadsData {
         num_missing_tiles(0),
         visible_content_area(0),
         approximated_visible_content_area(0),
+        checkerboarded_visible_content_area(0),
         render_pass_id(0, 0) {}
 
   explicit AppendQuadsData(RenderPassId render_pass_id)
@@ -23,6 +24,7 @@ struct AppendQuadsData {
         num_missing_tiles(0),
         visible_content_area(0),
         approximated_visible_content_area(0),
+        checkerboarded_visible_content_area(0),
         render_pass_id(render_pass_id) {}
 
   // Set by the layer appending quads.
@@ -33,6 +35,8 @@ struct AppendQuadsData {
   int64 visible_content_area;
   // Set by the layer appending quads.
   int64 approximated_visible_content_area;
+  // Set by the layer appending quads.
+  int64 checkerboarded_visible_content_area;
   // Given to the layer appending quads.
   const RenderPassId render_pass_id;
 };
@@ -0,0 +1,31 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "cc/layers/content_layer_client.h"
+
+#include "cc/resources/display_item_list.h"
+#include "skia/ext/refptr.h"
+#include "third_party/skia/include/core/SkCanvas.h"
+#include "third_party/skia/include/core/SkPictureRecorder.h"
+#include "ui/gfx/rect.h"
+#include "ui/gfx/skia_util.h"
+
+namespace cc {
+
+scoped_refptr<DisplayItemList> ContentLayerClient::PaintContentsToDisplayList(
+    const gfx::Rect& clip,
+    GraphicsContextStatus gc_status) {
+  SkPictureRecorder recorder;
+  SkCanvas* canvas = recorder.beginRecording(clip.width(), clip.height(), NULL);
+  canvas->translate(-clip.x(), -clip.y());
+  canvas->clipRect(gfx::RectToSkRect(clip));
+  PaintContents(canvas, clip, gc_status);
+
+  scoped_refptr<DisplayItemList> display_list = DisplayItemList::Create();
+  display_list->AppendItem(skia::AdoptRef(recorder.endRecording()),
+                           clip.origin());
+  return display_list;
+}
+
+}  // namespace cc
@@ -5,6 +5,7 @@
 #ifndef CC_LAYERS_CONTENT_LAYER_CLIENT_H_
 #define CC_LAYERS_CONTENT_LAYER_CLIENT_H_
 
+#include "base/memory/ref_counted.h"
 #include "cc/base/cc_export.h"
 
 class SkCanvas;
@@ -16,6 +17,8 @@ class RectF;
 
 namespace cc {
 
+class DisplayItemList;
+
 class CC_EXPORT ContentLayerClient {
  public:
   enum GraphicsContextStatus {
@@ -27,6 +30,14 @@ class CC_EXPORT ContentLayerClient {
                              const gfx::Rect& clip,
                              GraphicsContextStatus gc_status) = 0;
 
+  // Paints the contents in |clip| as a list of separately recorded items with
+  // their bounds, so that rastering a tile can skip the items that don't
+  // intersect it. Only used when recording with a display list. The default
+  // implementation records all of PaintContents() as a single item.
+  virtual scoped_refptr<DisplayItemList> PaintContentsToDisplayList(
+      const gfx::Rect& clip,
+      GraphicsContextStatus gc_status);
+
   // Called by the content layer during the update phase.
   // If the client paints LCD text, it may want to invalidate the layer.
   virtual void DidChangeLayerCanUseLCDText() = 0;
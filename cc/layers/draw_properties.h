@@ -29,6 +29,7 @@ struct CC_EXPORT DrawProperties {
         num_unclipped_descendants(0),
         layer_or_descendant_has_copy_request(false),
         layer_or_descendant_has_input_handler(false),
+        layer_or_descendant_has_untracked_dependencies(false),
         has_child_with_a_scroll_parent(false),
         sorted_for_recursion(false),
         index_of_first_descendants_addition(0),
@@ -106,6 +107,12 @@ struct CC_EXPORT DrawProperties {
   // If true, the layer or one of its descendants has a wheel or touch handler.
   bool layer_or_descendant_has_input_handler;
 
+  // If true, the draw properties of the layer or one of its descendants depend
+  // on state that is not covered by the layer's draw properties dirty bits
+  // (clip parents or delegated render passes), so cached draw properties for
+  // this subtree can't be reused.
+  bool layer_or_descendant_has_untracked_dependencies;
+
   // This is true if the layer has any direct child that has a scroll parent.
   // This layer will not be the scroll parent in this case. This information
   // lets us avoid work in CalculateDrawPropertiesInternal -- if none of our
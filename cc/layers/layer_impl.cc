@@ -63,6 +63,12 @@ LayerImpl::LayerImpl(LayerTreeImpl* tree_impl, int id)
       force_render_surface_(false),
       transform_is_invertible_(true),
       is_container_for_fixed_position_layers_(false),
+      draw_properties_dirty_(true),
+      descendant_draw_properties_dirty_(true),
+      transform_was_animating_(false),
+      opacity_was_animating_(false),
+      had_only_translation_transforms_(true),
+      maximum_animation_target_scale_(0.f),
       background_color_(0),
       opacity_(1.0),
       blend_mode_(SkXfermode::kSrcOver_Mode),
@@ -163,6 +169,7 @@ void LayerImpl::SetScrollParent(LayerImpl* parent) {
     DCHECK_EQ(layer_tree_impl()->LayerById(parent->id()), parent);
 
   scroll_parent_ = parent;
+  NoteDrawPropertiesChangedForSubtree();
   SetNeedsPushProperties();
 }
 
@@ -183,6 +190,7 @@ void LayerImpl::SetNumDescendantsThatDrawContent(int num_descendants) {
   if (num_descendants_that_draw_content_ == num_descendants)
     return;
   num_descendants_that_draw_content_ = num_descendants;
+  NoteDrawPropertiesChangedForSubtree();
   SetNeedsPushProperties();
 }
 
@@ -191,6 +199,7 @@ void LayerImpl::SetClipParent(LayerImpl* ancestor) {
     return;
 
   clip_parent_ = ancestor;
+  NoteDrawPropertiesChangedForSubtree();
   SetNeedsPushProperties();
 }
 
@@ -380,7 +389,13 @@ gfx::Vector2dF LayerImpl::ScrollBy(const gfx::Vector2dF& scroll) {
 }
 
 void LayerImpl::SetScrollClipLayer(int scroll_clip_layer_id) {
-  scroll_clip_layer_ = layer_tree_impl()->LayerById(scroll_clip_layer_id);
+  LayerImpl* scroll_clip_layer =
+      layer_tree_impl()->LayerById(scroll_clip_layer_id);
+  if (scroll_clip_layer_ == scroll_clip_layer)
+    return;
+
+  scroll_clip_layer_ = scroll_clip_layer;
+  NoteDrawPropertiesChangedForSubtree();
 }
 
 void LayerImpl::ApplySentScrollDeltasFromAbortedCommit() {
@@ -398,9 +413,16 @@ void LayerImpl::ApplySentScrollDeltasFromAbortedCommit() {
   // Because of the way scroll delta is calculated with a delegate, this will
   // leave the total scroll offset unchanged on this layer regardless of
   // whether a delegate is being used.
+  if (sent_scroll_delta_.IsZero())
+    return;
+
   scroll_offset_ += sent_scroll_delta_;
   scroll_delta_ -= sent_scroll_delta_;
   sent_scroll_delta_ = gfx::Vector2d();
+
+  // The scroll delta on its own feeds into the scroll compensation of fixed
+  // position descendants.
+  NoteDrawPropertiesChangedForSubtree();
 }
 
 void LayerImpl::ApplyScrollDeltasSinceBeginMainFrame() {
@@ -688,13 +710,16 @@ void LayerImpl::SetStackingOrderChanged(bool stacking_order_changed) {
 
 void LayerImpl::NoteLayerPropertyChanged() {
   layer_property_changed_ = true;
-  layer_tree_impl()->set_needs_update_draw_properties();
+  MarkDrawPropertiesDirtyForSubtree();
+  layer_tree_impl()->set_needs_update_draw_properties_for_dirty_layers();
   SetNeedsPushProperties();
 }
 
 void LayerImpl::NoteLayerPropertyChangedForSubtree() {
   layer_property_changed_ = true;
-  layer_tree_impl()->set_needs_update_draw_properties();
+  draw_properties_dirty_ = true;
+  NoteDescendantDrawPropertiesDirtyForAncestors();
+  layer_tree_impl()->set_needs_update_draw_properties_for_dirty_layers();
   for (size_t i = 0; i < children_.size(); ++i)
     children_[i]->NoteLayerPropertyChangedForDescendantsInternal();
   SetNeedsPushProperties();
@@ -702,17 +727,75 @@ void LayerImpl::NoteLayerPropertyChangedForSubtree() {
 
 void LayerImpl::NoteLayerPropertyChangedForDescendantsInternal() {
   layer_property_changed_ = true;
+  draw_properties_dirty_ = true;
+  descendant_draw_properties_dirty_ = true;
   for (size_t i = 0; i < children_.size(); ++i)
     children_[i]->NoteLayerPropertyChangedForDescendantsInternal();
 }
 
 void LayerImpl::NoteLayerPropertyChangedForDescendants() {
-  layer_tree_impl()->set_needs_update_draw_properties();
+  layer_tree_impl()->set_needs_update_draw_properties_for_dirty_layers();
   for (size_t i = 0; i < children_.size(); ++i)
     children_[i]->NoteLayerPropertyChangedForDescendantsInternal();
+  NoteDescendantDrawPropertiesDirtyForAncestors();
   SetNeedsPushProperties();
 }
 
+void LayerImpl::MarkDrawPropertiesDirtyForSubtree() {
+  // The draw properties of a layer feed into those of all of its descendants,
+  // so the whole subtree has to be recomputed.
+  draw_properties_dirty_ = true;
+  NoteDescendantDrawPropertiesDirtyForAncestors();
+  for (size_t i = 0; i < children_.size(); ++i)
+    children_[i]->MarkDrawPropertiesDirtyForDescendantsInternal();
+}
+
+void LayerImpl::MarkDrawPropertiesDirty() {
+  draw_properties_dirty_ = true;
+  NoteDescendantDrawPropertiesDirtyForAncestors();
+}
+
+void LayerImpl::UpdateAnimationStateForDrawProperties() {
+  bool transform_is_animating = TransformIsAnimating();
+  bool opacity_is_animating = OpacityIsAnimating();
+  bool has_only_translation_transforms =
+      layer_animation_controller_->HasOnlyTranslationTransforms();
+  float maximum_animation_target_scale = 0.f;
+  if (!has_only_translation_transforms &&
+      !layer_animation_controller_->MaximumTargetScale(
+          &maximum_animation_target_scale))
+    maximum_animation_target_scale = 0.f;
+
+  if (transform_was_animating_ == transform_is_animating &&
+      opacity_was_animating_ == opacity_is_animating &&
+      had_only_translation_transforms_ == has_only_translation_transforms &&
+      maximum_animation_target_scale_ == maximum_animation_target_scale)
+    return;
+
+  transform_was_animating_ = transform_is_animating;
+  opacity_was_animating_ = opacity_is_animating;
+  had_only_translation_transforms_ = has_only_translation_transforms;
+  maximum_animation_target_scale_ = maximum_animation_target_scale;
+  MarkDrawPropertiesDirty();
+}
+
+void LayerImpl::MarkDrawPropertiesDirtyForDescendantsInternal() {
+  draw_properties_dirty_ = true;
+  descendant_draw_properties_dirty_ = true;
+  for (size_t i = 0; i < children_.size(); ++i)
+    children_[i]->MarkDrawPropertiesDirtyForDescendantsInternal();
+}
+
+void LayerImpl::NoteDescendantDrawPropertiesDirtyForAncestors() {
+  for (LayerImpl* layer = parent_; layer; layer = layer->parent_)
+    layer->descendant_draw_properties_dirty_ = true;
+}
+
+void LayerImpl::NoteDrawPropertiesChangedForSubtree() {
+  MarkDrawPropertiesDirtyForSubtree();
+  layer_tree_impl()->set_needs_update_draw_properties_for_dirty_layers();
+}
+
 const char* LayerImpl::LayerTypeAsString() const {
   return "cc::LayerImpl";
 }
@@ -871,6 +954,14 @@ void LayerImpl::SetHideLayerAndSubtree(bool hide) {
   NoteLayerPropertyChangedForSubtree();
 }
 
+void LayerImpl::SetForceRenderSurface(bool force) {
+  if (force_render_surface_ == force)
+    return;
+
+  force_render_surface_ = force;
+  NoteDrawPropertiesChangedForSubtree();
+}
+
 void LayerImpl::SetTransformOrigin(const gfx::Point3F& transform_origin) {
   if (transform_origin_ == transform_origin)
     return;
@@ -979,6 +1070,7 @@ void LayerImpl::SetIsRootForIsolatedGroup(bool root) {
     return;
 
   is_root_for_isolated_group_ = root;
+  NoteDrawPropertiesChangedForSubtree();
   SetNeedsPushProperties();
 }
 
@@ -990,6 +1082,23 @@ void LayerImpl::SetPosition(const gfx::PointF& position) {
   NoteLayerPropertyChangedForSubtree();
 }
 
+void LayerImpl::SetIsContainerForFixedPositionLayers(bool container) {
+  if (is_container_for_fixed_position_layers_ == container)
+    return;
+
+  is_container_for_fixed_position_layers_ = container;
+  NoteDrawPropertiesChangedForSubtree();
+}
+
+void LayerImpl::SetPositionConstraint(
+    const LayerPositionConstraint& constraint) {
+  if (position_constraint_ == constraint)
+    return;
+
+  position_constraint_ = constraint;
+  NoteDrawPropertiesChangedForSubtree();
+}
+
 void LayerImpl::SetShouldFlattenTransform(bool flatten) {
   if (should_flatten_transform_ == flatten)
     return;
@@ -998,6 +1107,14 @@ void LayerImpl::SetShouldFlattenTransform(bool flatten) {
   NoteLayerPropertyChangedForSubtree();
 }
 
+void LayerImpl::SetUseParentBackfaceVisibility(bool use) {
+  if (use_parent_backface_visibility_ == use)
+    return;
+
+  use_parent_backface_visibility_ = use;
+  NoteDrawPropertiesChangedForSubtree();
+}
+
 void LayerImpl::Set3dSortingContextId(int id) {
   if (id == sorting_context_id_)
     return;
@@ -1301,7 +1418,7 @@ void LayerImpl::SetScrollbarPosition(ScrollbarLayerImplBase* scrollbar_layer,
         scrollbar_layer->SetVisibleToTotalLengthRatio(visible_ratio);
   }
   if (scrollbar_needs_animation) {
-    layer_tree_impl()->set_needs_update_draw_properties();
+    layer_tree_impl()->set_needs_update_draw_properties_for_dirty_layers();
     // TODO(wjmaclean) The scrollbar animator for the pinch-zoom scrollbars
     // should activate for every scroll on the main frame, not just the
     // scrolls that move the pinch virtual viewport (i.e. trigger from
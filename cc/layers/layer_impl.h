@@ -220,7 +220,7 @@ class CC_EXPORT LayerImpl : public LayerAnimationValueObserver,
   bool hide_layer_and_subtree() const { return hide_layer_and_subtree_; }
 
   bool force_render_surface() const { return force_render_surface_; }
-  void SetForceRenderSurface(bool force) { force_render_surface_ = force; }
+  void SetForceRenderSurface(bool force);
 
   void SetTransformOrigin(const gfx::Point3F& transform_origin);
   gfx::Point3F transform_origin() const { return transform_origin_; }
@@ -266,9 +266,7 @@ class CC_EXPORT LayerImpl : public LayerAnimationValueObserver,
   void SetPosition(const gfx::PointF& position);
   gfx::PointF position() const { return position_; }
 
-  void SetIsContainerForFixedPositionLayers(bool container) {
-    is_container_for_fixed_position_layers_ = container;
-  }
+  void SetIsContainerForFixedPositionLayers(bool container);
   // This is a non-trivial function in Layer.
   bool IsContainerForFixedPositionLayers() const {
     return is_container_for_fixed_position_layers_;
@@ -276,9 +274,7 @@ class CC_EXPORT LayerImpl : public LayerAnimationValueObserver,
 
   gfx::Vector2dF FixedContainerSizeDelta() const;
 
-  void SetPositionConstraint(const LayerPositionConstraint& constraint) {
-    position_constraint_ = constraint;
-  }
+  void SetPositionConstraint(const LayerPositionConstraint& constraint);
   const LayerPositionConstraint& position_constraint() const {
     return position_constraint_;
   }
@@ -288,9 +284,7 @@ class CC_EXPORT LayerImpl : public LayerAnimationValueObserver,
 
   bool Is3dSorted() const { return sorting_context_id_ != 0; }
 
-  void SetUseParentBackfaceVisibility(bool use) {
-    use_parent_backface_visibility_ = use;
-  }
+  void SetUseParentBackfaceVisibility(bool use);
   bool use_parent_backface_visibility() const {
     return use_parent_backface_visibility_;
   }
@@ -311,6 +305,28 @@ class CC_EXPORT LayerImpl : public LayerAnimationValueObserver,
     return draw_properties_;
   }
 
+  // Set when a property that feeds into the draw properties of this layer
+  // (respectively, of one of its descendants) changes. LayerTreeHostCommon
+  // clears them once it has recomputed the draw properties, and skips
+  // unchanged subtrees when incremental draw property updates are enabled.
+  bool draw_properties_dirty() const { return draw_properties_dirty_; }
+  void set_draw_properties_dirty(bool dirty) { draw_properties_dirty_ = dirty; }
+  bool descendant_draw_properties_dirty() const {
+    return descendant_draw_properties_dirty_;
+  }
+  void set_descendant_draw_properties_dirty(bool dirty) {
+    descendant_draw_properties_dirty_ = dirty;
+  }
+  void MarkDrawPropertiesDirtyForSubtree();
+  // Marks only this layer dirty, for changes that reach its descendants
+  // through the inputs LayerTreeHostCommon compares before reusing them.
+  void MarkDrawPropertiesDirty();
+  // Marks the layer dirty if the state of its animations that its draw
+  // properties depend on (which properties are animating, and to what scale)
+  // changed since the last call. Animated values are tracked by the setters
+  // they go through.
+  void UpdateAnimationStateForDrawProperties();
+
   // The following are shortcut accessors to get various information from
   // draw_properties_
   const gfx::Transform& draw_transform() const {
@@ -576,6 +592,11 @@ class CC_EXPORT LayerImpl : public LayerAnimationValueObserver,
 
  private:
   void NoteLayerPropertyChangedForDescendantsInternal();
+  void MarkDrawPropertiesDirtyForDescendantsInternal();
+  void NoteDescendantDrawPropertiesDirtyForAncestors();
+  // Like NoteLayerPropertyChangedForSubtree(), for properties that don't
+  // damage the layer.
+  void NoteDrawPropertiesChangedForSubtree();
 
   virtual const char* LayerTypeAsString() const;
 
@@ -638,6 +659,17 @@ class CC_EXPORT LayerImpl : public LayerAnimationValueObserver,
 
   // Set for the layer that other layers are fixed to.
   bool is_container_for_fixed_position_layers_ : 1;
+
+  bool draw_properties_dirty_ : 1;
+  bool descendant_draw_properties_dirty_ : 1;
+
+  // The animation state the draw properties were last computed with; see
+  // UpdateAnimationStateForDrawProperties().
+  bool transform_was_animating_ : 1;
+  bool opacity_was_animating_ : 1;
+  bool had_only_translation_transforms_ : 1;
+  float maximum_animation_target_scale_;
+
   Region non_fast_scrollable_region_;
   Region touch_event_handler_region_;
   SkColor background_color_;
@@ -155,6 +155,8 @@ Picture::RecordingMode PictureLayer::RecordingMode() const {
       return Picture::RECORD_NORMALLY;
     case LayerTreeSettings::RecordWithSkRecord:
       return Picture::RECORD_WITH_SKRECORD;
+    case LayerTreeSettings::RecordWithDisplayList:
+      return Picture::RECORD_WITH_DISPLAY_LIST;
   }
   NOTREACHED();
   return Picture::RECORD_NORMALLY;
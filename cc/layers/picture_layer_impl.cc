@@ -421,8 +421,12 @@ void PictureLayerImpl::AppendQuads(
         append_quads_data->num_missing_tiles++;
         ++missing_tile_count;
       }
-      append_quads_data->approximated_visible_content_area +=
+      int64 checkerboarded_area =
           visible_geometry_rect.width() * visible_geometry_rect.height();
+      append_quads_data->approximated_visible_content_area +=
+          checkerboarded_area;
+      append_quads_data->checkerboarded_visible_content_area +=
+          checkerboarded_area;
       continue;
     }
 
@@ -677,6 +681,17 @@ int PictureLayerImpl::GetSkewportExtrapolationLimitInContentPixels() const {
       .skewport_extrapolation_limit_in_content_pixels;
 }
 
+bool PictureLayerImpl::UsePredictiveSkewport() const {
+  return layer_tree_impl()->settings().use_predictive_skewport;
+}
+
+float PictureLayerImpl::GetRasterThroughputInContentPixelsPerSecond() const {
+  TileManager* tile_manager = layer_tree_impl()->tile_manager();
+  if (!tile_manager)
+    return 0.f;
+  return tile_manager->raster_throughput_in_content_pixels_per_second();
+}
+
 gfx::Size PictureLayerImpl::CalculateTileSize(
     const gfx::Size& content_bounds) const {
   int max_texture_size =
@@ -132,6 +132,8 @@ class CC_EXPORT PictureLayerImpl
   virtual size_t GetMaxTilesForInterestArea() const OVERRIDE;
   virtual float GetSkewportTargetTimeInSeconds() const OVERRIDE;
   virtual int GetSkewportExtrapolationLimitInContentPixels() const OVERRIDE;
+  virtual bool UsePredictiveSkewport() const OVERRIDE;
+  virtual float GetRasterThroughputInContentPixelsPerSecond() const OVERRIDE;
   virtual WhichTree GetTree() const OVERRIDE;
 
   // PushPropertiesTo active tree => pending tree.
@@ -157,7 +157,8 @@ void CreateTestTextureDrawQuad(const gfx::Rect& rect,
 typedef ::testing::Types<GLRenderer,
                          SoftwareRenderer,
                          GLRendererWithExpandedViewport,
-                         SoftwareRendererWithExpandedViewport> RendererTypes;
+                         SoftwareRendererWithExpandedViewport,
+                         SoftwareRendererWithParallelDraw> RendererTypes;
 TYPED_TEST_CASE(RendererPixelTest, RendererTypes);
 
 template <typename RendererType>
@@ -189,6 +190,14 @@ bool FuzzyForSoftwareOnlyPixelComparator<
   return fuzzy_.Compare(actual_bmp, expected_bmp);
 }
 
+template <>
+bool FuzzyForSoftwareOnlyPixelComparator<
+    SoftwareRendererWithParallelDraw>::Compare(
+    const SkBitmap& actual_bmp,
+    const SkBitmap& expected_bmp) const {
+  return fuzzy_.Compare(actual_bmp, expected_bmp);
+}
+
 template<typename RendererType>
 bool FuzzyForSoftwareOnlyPixelComparator<RendererType>::Compare(
     const SkBitmap& actual_bmp,
@@ -1882,6 +1891,11 @@ bool IsSoftwareRenderer<SoftwareRendererWithExpandedViewport>() {
   return true;
 }
 
+template <>
+bool IsSoftwareRenderer<SoftwareRendererWithParallelDraw>() {
+  return true;
+}
+
 // If we disable image filtering, then a 2x2 bitmap should appear as four
 // huge sharp squares.
 TYPED_TEST(RendererPixelTest, PictureDrawQuadDisableImageFiltering) {
@@ -4,6 +4,7 @@
 
 #include "cc/output/software_renderer.h"
 
+#include "base/bind.h"
 #include "base/debug/trace_event.h"
 #include "cc/base/math_util.h"
 #include "cc/output/compositor_frame.h"
@@ -20,6 +21,8 @@
 #include "cc/quads/solid_color_draw_quad.h"
 #include "cc/quads/texture_draw_quad.h"
 #include "cc/quads/tile_draw_quad.h"
+#include "cc/resources/raster_worker_pool.h"
+#include "cc/resources/task_graph_runner.h"
 #include "skia/ext/opacity_draw_filter.h"
 #include "third_party/skia/include/core/SkCanvas.h"
 #include "third_party/skia/include/core/SkColor.h"
@@ -59,6 +62,29 @@ static SkShader::TileMode WrapModeToTileMode(GLint wrap_mode) {
   return SkShader::kClamp_TileMode;
 }
 
+// Bands are at least this many rows high...
+static const int kMinDrawBandHeight = 32;
+// ...and a quad list is split into at most this many bands.
+static const int kMaxDrawBands = 8;
+// Maximum number of worker tasks that help the compositor thread draw bands.
+static const size_t kMaxDrawBandTasks = 3;
+
+class DrawBandsTask : public Task {
+ public:
+  explicit DrawBandsTask(const base::Closure& callback)
+      : callback_(callback) {}
+
+  // Overridden from Task:
+  virtual void RunOnWorkerThread() OVERRIDE { callback_.Run(); }
+
+ private:
+  virtual ~DrawBandsTask() {}
+
+  base::Closure callback_;
+
+  DISALLOW_COPY_AND_ASSIGN(DrawBandsTask);
+};
+
 }  // anonymous namespace
 
 scoped_ptr<SoftwareRenderer> SoftwareRenderer::Create(
@@ -78,7 +104,11 @@ SoftwareRenderer::SoftwareRenderer(RendererClient* client,
       is_scissor_enabled_(false),
       is_backbuffer_discarded_(false),
       output_device_(output_surface->software_device()),
-      current_canvas_(NULL) {
+      current_canvas_(NULL),
+      task_graph_runner_(settings->use_parallel_software_draw
+                             ? RasterWorkerPool::GetTaskGraphRunner()
+                             : NULL),
+      deferred_quads_frame_(NULL) {
   if (resource_provider_) {
     capabilities_.max_texture_size = resource_provider_->max_texture_size();
     capabilities_.best_texture_format =
@@ -150,6 +180,7 @@ void SoftwareRenderer::Finish() {}
 
 void SoftwareRenderer::BindFramebufferToOutputSurface(DrawingFrame* frame) {
   DCHECK(!output_surface_->HasExternalStencilTest());
+  DCHECK(deferred_quads_.empty());
   current_framebuffer_lock_.reset();
   current_canvas_ = root_canvas_;
 }
@@ -158,6 +189,7 @@ bool SoftwareRenderer::BindFramebufferToTexture(
     DrawingFrame* frame,
     const ScopedResource* texture,
     const gfx::Rect& target_rect) {
+  DCHECK(deferred_quads_.empty());
   current_framebuffer_lock_.reset();
   current_framebuffer_lock_ = make_scoped_ptr(
       new ResourceProvider::ScopedWriteLockSoftware(
@@ -229,6 +261,234 @@ bool SoftwareRenderer::IsSoftwareResource(
 
 void SoftwareRenderer::DoDrawQuad(DrawingFrame* frame, const DrawQuad* quad) {
   TRACE_EVENT0("cc", "SoftwareRenderer::DoDrawQuad");
+  if (task_graph_runner_) {
+    if (CanDeferQuad(quad)) {
+      DeferQuad(frame, quad);
+      return;
+    }
+    // Keep the drawing order.
+    DrawDeferredQuads();
+  }
+  QuadResources resources;
+  LockQuadResources(quad, &resources);
+  DrawQuadToCanvas(frame, quad, resources, current_canvas_);
+  read_locks_.clear();
+}
+
+void SoftwareRenderer::FinishDrawingQuadList() {
+  DrawDeferredQuads();
+}
+
+bool SoftwareRenderer::CanDeferQuad(const DrawQuad* quad) const {
+  // Filters are applied to the whole render pass texture, which shouldn't be
+  // done once per band. Pictures can contain filters too, and those would
+  // miss the content outside of a band.
+  if (quad->material == DrawQuad::RENDER_PASS &&
+      !RenderPassDrawQuad::MaterialCast(quad)->filters.IsEmpty())
+    return false;
+  if (quad->material == DrawQuad::PICTURE_CONTENT)
+    return false;
+
+  // Bands draw straight into the pixels of the current canvas.
+  SkImageInfo info;
+  size_t row_bytes;
+  return !!current_canvas_->peekPixels(&info, &row_bytes);
+}
+
+void SoftwareRenderer::DeferQuad(const DrawingFrame* frame,
+                                 const DrawQuad* quad) {
+  DCHECK(deferred_quads_.empty() || deferred_quads_frame_ == frame);
+  deferred_quads_frame_ = frame;
+
+  SkISize size = current_canvas_->getDeviceSize();
+  gfx::Rect clip_rect(size.width(), size.height());
+  if (is_scissor_enabled_)
+    clip_rect.Intersect(scissor_rect_);
+
+  // Debug borders are stroked outside of the quad, so only clip to the quad
+  // bounds for the other materials. The bounds are outset by a pixel to keep
+  // anti-aliased edges.
+  if (quad->material != DrawQuad::DEBUG_BORDER) {
+    gfx::Transform quad_rect_matrix;
+    QuadRectTransform(&quad_rect_matrix, quad->quadTransform(), quad->rect);
+    gfx::Transform contents_device_transform =
+        frame->window_matrix * frame->projection_matrix * quad_rect_matrix;
+    contents_device_transform.FlattenTo2d();
+    gfx::Rect quad_bounds = gfx::ToEnclosingRect(
+        MathUtil::MapClippedRect(contents_device_transform, QuadVertexRect()));
+    quad_bounds.Inset(-1, -1);
+    clip_rect.Intersect(quad_bounds);
+  }
+  if (clip_rect.IsEmpty())
+    return;
+
+  deferred_quads_.push_back(DeferredQuad(quad, clip_rect));
+  LockQuadResources(quad, &deferred_quads_.back().resources);
+  deferred_quads_bounds_.Union(clip_rect);
+}
+
+void SoftwareRenderer::LockQuadResources(const DrawQuad* quad,
+                                         QuadResources* resources) {
+  switch (quad->material) {
+    case DrawQuad::RENDER_PASS: {
+      const RenderPassDrawQuad* render_pass_quad =
+          RenderPassDrawQuad::MaterialCast(quad);
+      ScopedResource* content_texture =
+          render_pass_textures_.get(render_pass_quad->render_pass_id);
+      if (content_texture && content_texture->id()) {
+        DCHECK(IsSoftwareResource(content_texture->id()));
+        LockResource(content_texture->id(),
+                     &resources->bitmap,
+                     &resources->wrap_mode);
+      }
+      if (render_pass_quad->mask_resource_id) {
+        LockResource(render_pass_quad->mask_resource_id,
+                     &resources->mask,
+                     &resources->mask_wrap_mode);
+      }
+      break;
+    }
+    case DrawQuad::TEXTURE_CONTENT: {
+      ResourceProvider::ResourceId resource_id =
+          TextureDrawQuad::MaterialCast(quad)->resource_id;
+      resources->is_software = IsSoftwareResource(resource_id);
+      if (resources->is_software)
+        LockResource(resource_id, &resources->bitmap, &resources->wrap_mode);
+      break;
+    }
+    case DrawQuad::TILED_CONTENT: {
+      // |resource_provider_| can be NULL in resourceless software draws,
+      // which should never produce tile quads in the first place.
+      DCHECK(resource_provider_);
+      ResourceProvider::ResourceId resource_id =
+          TileDrawQuad::MaterialCast(quad)->resource_id;
+      DCHECK(IsSoftwareResource(resource_id));
+      LockResource(resource_id, &resources->bitmap, &resources->wrap_mode);
+      break;
+    }
+    default:
+      break;
+  }
+}
+
+void SoftwareRenderer::LockResource(ResourceProvider::ResourceId resource_id,
+                                    const SkBitmap** bitmap,
+                                    GLint* wrap_mode) {
+  ResourceProvider::ScopedReadLockSoftware* lock =
+      read_locks_.get(resource_id);
+  if (!lock) {
+    lock = new ResourceProvider::ScopedReadLockSoftware(resource_provider_,
+                                                        resource_id);
+    read_locks_.set(resource_id, make_scoped_ptr(lock));
+  }
+  if (!lock->valid())
+    return;
+  *bitmap = lock->sk_bitmap();
+  *wrap_mode = lock->wrap_mode();
+}
+
+void SoftwareRenderer::DrawDeferredQuads() {
+  if (deferred_quads_.empty())
+    return;
+
+  TRACE_EVENT1("cc",
+               "SoftwareRenderer::DrawDeferredQuads",
+               "num_quads",
+               deferred_quads_.size());
+
+  SkImageInfo info;
+  size_t row_bytes;
+  const void* pixels = current_canvas_->peekPixels(&info, &row_bytes);
+  DCHECK(pixels);
+  SkBitmap target;
+  target.installPixels(info, const_cast<void*>(pixels), row_bytes);
+
+  // Every band draws all quads that intersect it, so there is no point in
+  // making bands much smaller than needed to keep the threads busy.
+  int band_height = std::max(
+      kMinDrawBandHeight,
+      (deferred_quads_bounds_.height() + kMaxDrawBands - 1) / kMaxDrawBands);
+  std::vector<gfx::Rect> bands;
+  for (int y = deferred_quads_bounds_.y(); y < deferred_quads_bounds_.bottom();
+       y += band_height) {
+    bands.push_back(gfx::Rect(deferred_quads_bounds_.x(),
+                              y,
+                              deferred_quads_bounds_.width(),
+                              std::min(band_height,
+                                       deferred_quads_bounds_.bottom() - y)));
+  }
+
+  base::subtle::Atomic32 next_band = 0;
+  if (bands.size() < 2) {
+    DrawDeferredQuadsInBands(&bands, &next_band, &target);
+  } else {
+    NamespaceToken token = task_graph_runner_->GetNamespaceToken();
+    Task::Vector tasks;
+    TaskGraph graph;
+    for (size_t i = 0; i < std::min(bands.size() - 1, kMaxDrawBandTasks);
+         ++i) {
+      scoped_refptr<Task> task(new DrawBandsTask(
+          base::Bind(&SoftwareRenderer::DrawDeferredQuadsInBands,
+                     base::Unretained(this),
+                     &bands,
+                     &next_band,
+                     &target)));
+      graph.nodes.push_back(TaskGraph::Node(task.get(), 0u, 0u));
+      tasks.push_back(task);
+    }
+    task_graph_runner_->ScheduleTasks(token, &graph);
+
+    // This thread draws bands too. Once there are none left, cancel the tasks
+    // that haven't started and wait for the ones that have.
+    DrawDeferredQuadsInBands(&bands, &next_band, &target);
+    TaskGraph empty;
+    task_graph_runner_->ScheduleTasks(token, &empty);
+    task_graph_runner_->WaitForTasksToFinishRunning(token);
+    Task::Vector completed_tasks;
+    task_graph_runner_->CollectCompletedTasks(token, &completed_tasks);
+    DCHECK_EQ(tasks.size(), completed_tasks.size());
+  }
+
+  deferred_quads_.clear();
+  deferred_quads_frame_ = NULL;
+  deferred_quads_bounds_ = gfx::Rect();
+  read_locks_.clear();
+}
+
+void SoftwareRenderer::DrawDeferredQuadsInBands(
+    const std::vector<gfx::Rect>* bands,
+    base::subtle::Atomic32* next_band,
+    const SkBitmap* target) {
+  while (true) {
+    size_t index = static_cast<size_t>(
+        base::subtle::NoBarrier_AtomicIncrement(next_band, 1) - 1);
+    if (index >= bands->size())
+      return;
+    DrawDeferredQuadsInBand(*target, (*bands)[index]);
+  }
+}
+
+void SoftwareRenderer::DrawDeferredQuadsInBand(const SkBitmap& target,
+                                               const gfx::Rect& band_rect) {
+  // Each band has its own canvas on the shared pixels. Clipping every quad to
+  // the band keeps the bands from touching each other's pixels, and a pixel
+  // gets the same value as when all quads are drawn on one canvas.
+  SkCanvas canvas(target);
+  for (std::vector<DeferredQuad>::const_iterator it = deferred_quads_.begin();
+       it != deferred_quads_.end();
+       ++it) {
+    gfx::Rect clip_rect = gfx::IntersectRects(it->clip_rect, band_rect);
+    if (clip_rect.IsEmpty())
+      continue;
+    canvas.clipRect(gfx::RectToSkRect(clip_rect), SkRegion::kReplace_Op);
+    DrawQuadToCanvas(deferred_quads_frame_, it->quad, it->resources, &canvas);
+  }
+}
+
+void SoftwareRenderer::DrawQuadToCanvas(const DrawingFrame* frame,
+                                        const DrawQuad* quad,
+                                        const QuadResources& resources,
+                                        SkCanvas* canvas) {
   gfx::Transform quad_rect_matrix;
   QuadRectTransform(&quad_rect_matrix, quad->quadTransform(), quad->rect);
   gfx::Transform contents_device_transform =
@@ -237,9 +497,9 @@ void SoftwareRenderer::DoDrawQuad(DrawingFrame* frame, const DrawQuad* quad) {
   SkMatrix sk_device_matrix;
   gfx::TransformToFlattenedSkMatrix(contents_device_transform,
                                     &sk_device_matrix);
-  current_canvas_->setMatrix(sk_device_matrix);
+  canvas->setMatrix(sk_device_matrix);
 
-  current_paint_.reset();
+  SkPaint paint;
   if (!IsScaleAndIntegerTranslate(sk_device_matrix)) {
     // TODO(danakj): Until we can enable AA only on exterior edges of the
     // layer, disable AA if any interior edges are present. crbug.com/248175
@@ -248,39 +508,55 @@ void SoftwareRenderer::DoDrawQuad(DrawingFrame* frame, const DrawQuad* quad) {
                                        quad->IsBottomEdge() &&
                                        quad->IsRightEdge();
     if (settings_->allow_antialiasing && all_four_edges_are_exterior)
-      current_paint_.setAntiAlias(true);
-    current_paint_.setFilterLevel(SkPaint::kLow_FilterLevel);
+      paint.setAntiAlias(true);
+    paint.setFilterLevel(SkPaint::kLow_FilterLevel);
   }
 
   if (quad->ShouldDrawWithBlending() ||
       quad->shared_quad_state->blend_mode != SkXfermode::kSrcOver_Mode) {
-    current_paint_.setAlpha(quad->opacity() * 255);
-    current_paint_.setXfermodeMode(quad->shared_quad_state->blend_mode);
+    paint.setAlpha(quad->opacity() * 255);
+    paint.setXfermodeMode(quad->shared_quad_state->blend_mode);
   } else {
-    current_paint_.setXfermodeMode(SkXfermode::kSrc_Mode);
+    paint.setXfermodeMode(SkXfermode::kSrc_Mode);
   }
 
   switch (quad->material) {
     case DrawQuad::CHECKERBOARD:
-      DrawCheckerboardQuad(frame, CheckerboardDrawQuad::MaterialCast(quad));
+      DrawCheckerboardQuad(
+          frame, CheckerboardDrawQuad::MaterialCast(quad), canvas, &paint);
       break;
     case DrawQuad::DEBUG_BORDER:
-      DrawDebugBorderQuad(frame, DebugBorderDrawQuad::MaterialCast(quad));
+      DrawDebugBorderQuad(
+          frame, DebugBorderDrawQuad::MaterialCast(quad), canvas, &paint);
       break;
     case DrawQuad::PICTURE_CONTENT:
-      DrawPictureQuad(frame, PictureDrawQuad::MaterialCast(quad));
+      DrawPictureQuad(
+          frame, PictureDrawQuad::MaterialCast(quad), canvas, &paint);
       break;
     case DrawQuad::RENDER_PASS:
-      DrawRenderPassQuad(frame, RenderPassDrawQuad::MaterialCast(quad));
+      DrawRenderPassQuad(frame,
+                         RenderPassDrawQuad::MaterialCast(quad),
+                         resources,
+                         canvas,
+                         &paint);
       break;
     case DrawQuad::SOLID_COLOR:
-      DrawSolidColorQuad(frame, SolidColorDrawQuad::MaterialCast(quad));
+      DrawSolidColorQuad(
+          frame, SolidColorDrawQuad::MaterialCast(quad), canvas, &paint);
       break;
     case DrawQuad::TEXTURE_CONTENT:
-      DrawTextureQuad(frame, TextureDrawQuad::MaterialCast(quad));
+      DrawTextureQuad(frame,
+                      TextureDrawQuad::MaterialCast(quad),
+                      resources,
+                      canvas,
+                      &paint);
       break;
     case DrawQuad::TILED_CONTENT:
-      DrawTileQuad(frame, TileDrawQuad::MaterialCast(quad));
+      DrawTileQuad(frame,
+                   TileDrawQuad::MaterialCast(quad),
+                   resources,
+                   canvas,
+                   &paint);
       break;
     case DrawQuad::SURFACE_CONTENT:
       // Surface content should be fully resolved to other quad types before
@@ -291,51 +567,56 @@ void SoftwareRenderer::DoDrawQuad(DrawingFrame* frame, const DrawQuad* quad) {
     case DrawQuad::IO_SURFACE_CONTENT:
     case DrawQuad::YUV_VIDEO_CONTENT:
     case DrawQuad::STREAM_VIDEO_CONTENT:
-      DrawUnsupportedQuad(frame, quad);
+      DrawUnsupportedQuad(frame, quad, canvas, &paint);
       NOTREACHED();
       break;
   }
 
-  current_canvas_->resetMatrix();
+  canvas->resetMatrix();
 }
 
 void SoftwareRenderer::DrawCheckerboardQuad(const DrawingFrame* frame,
-                                            const CheckerboardDrawQuad* quad) {
+                                            const CheckerboardDrawQuad* quad,
+                                            SkCanvas* canvas,
+                                            SkPaint* paint) {
   gfx::RectF visible_quad_vertex_rect = MathUtil::ScaleRectProportional(
       QuadVertexRect(), quad->rect, quad->visible_rect);
-  current_paint_.setColor(quad->color);
-  current_paint_.setAlpha(quad->opacity() * SkColorGetA(quad->color));
-  current_canvas_->drawRect(gfx::RectFToSkRect(visible_quad_vertex_rect),
-                            current_paint_);
+  paint->setColor(quad->color);
+  paint->setAlpha(quad->opacity() * SkColorGetA(quad->color));
+  canvas->drawRect(gfx::RectFToSkRect(visible_quad_vertex_rect), *paint);
 }
 
 void SoftwareRenderer::DrawDebugBorderQuad(const DrawingFrame* frame,
-                                           const DebugBorderDrawQuad* quad) {
+                                           const DebugBorderDrawQuad* quad,
+                                           SkCanvas* canvas,
+                                           SkPaint* paint) {
   // We need to apply the matrix manually to have pixel-sized stroke width.
   SkPoint vertices[4];
   gfx::RectFToSkRect(QuadVertexRect()).toQuad(vertices);
   SkPoint transformed_vertices[4];
-  current_canvas_->getTotalMatrix().mapPoints(transformed_vertices,
-                                              vertices,
-                                              4);
-  current_canvas_->resetMatrix();
+  canvas->getTotalMatrix().mapPoints(transformed_vertices, vertices, 4);
+  canvas->resetMatrix();
 
-  current_paint_.setColor(quad->color);
-  current_paint_.setAlpha(quad->opacity() * SkColorGetA(quad->color));
-  current_paint_.setStyle(SkPaint::kStroke_Style);
-  current_paint_.setStrokeWidth(quad->width);
-  current_canvas_->drawPoints(SkCanvas::kPolygon_PointMode,
-                              4, transformed_vertices, current_paint_);
+  paint->setColor(quad->color);
+  paint->setAlpha(quad->opacity() * SkColorGetA(quad->color));
+  paint->setStyle(SkPaint::kStroke_Style);
+  paint->setStrokeWidth(quad->width);
+  canvas->drawPoints(SkCanvas::kPolygon_PointMode,
+                     4,
+                     transformed_vertices,
+                     *paint);
 }
 
 void SoftwareRenderer::DrawPictureQuad(const DrawingFrame* frame,
-                                       const PictureDrawQuad* quad) {
+                                       const PictureDrawQuad* quad,
+                                       SkCanvas* canvas,
+                                       SkPaint* paint) {
   SkMatrix content_matrix;
   content_matrix.setRectToRect(
       gfx::RectFToSkRect(quad->tex_coord_rect),
       gfx::RectFToSkRect(QuadVertexRect()),
       SkMatrix::kFill_ScaleToFit);
-  current_canvas_->concat(content_matrix);
+  canvas->concat(content_matrix);
 
   // TODO(aelias): This isn't correct in all cases. We should detect these
   // cases and fall back to a persistent bitmap backing
@@ -343,41 +624,43 @@ void SoftwareRenderer::DrawPictureQuad(const DrawingFrame* frame,
   skia::RefPtr<SkDrawFilter> opacity_filter =
       skia::AdoptRef(new skia::OpacityDrawFilter(
           quad->opacity(), frame->disable_picture_quad_image_filtering));
-  DCHECK(!current_canvas_->getDrawFilter());
-  current_canvas_->setDrawFilter(opacity_filter.get());
+  DCHECK(!canvas->getDrawFilter());
+  canvas->setDrawFilter(opacity_filter.get());
 
   TRACE_EVENT0("cc",
                "SoftwareRenderer::DrawPictureQuad");
 
   quad->picture_pile->RasterDirect(
-      current_canvas_, quad->content_rect, quad->contents_scale, NULL);
+      canvas, quad->content_rect, quad->contents_scale, NULL);
 
-  current_canvas_->setDrawFilter(NULL);
+  canvas->setDrawFilter(NULL);
 }
 
 void SoftwareRenderer::DrawSolidColorQuad(const DrawingFrame* frame,
-                                          const SolidColorDrawQuad* quad) {
+                                          const SolidColorDrawQuad* quad,
+                                          SkCanvas* canvas,
+                                          SkPaint* paint) {
   gfx::RectF visible_quad_vertex_rect = MathUtil::ScaleRectProportional(
       QuadVertexRect(), quad->rect, quad->visible_rect);
-  current_paint_.setColor(quad->color);
-  current_paint_.setAlpha(quad->opacity() * SkColorGetA(quad->color));
-  current_canvas_->drawRect(gfx::RectFToSkRect(visible_quad_vertex_rect),
-                            current_paint_);
+  paint->setColor(quad->color);
+  paint->setAlpha(quad->opacity() * SkColorGetA(quad->color));
+  canvas->drawRect(gfx::RectFToSkRect(visible_quad_vertex_rect), *paint);
 }
 
 void SoftwareRenderer::DrawTextureQuad(const DrawingFrame* frame,
-                                       const TextureDrawQuad* quad) {
-  if (!IsSoftwareResource(quad->resource_id)) {
-    DrawUnsupportedQuad(frame, quad);
+                                       const TextureDrawQuad* quad,
+                                       const QuadResources& resources,
+                                       SkCanvas* canvas,
+                                       SkPaint* paint) {
+  if (!resources.is_software) {
+    DrawUnsupportedQuad(frame, quad, canvas, paint);
     return;
   }
 
   // TODO(skaslev): Add support for non-premultiplied alpha.
-  ResourceProvider::ScopedReadLockSoftware lock(resource_provider_,
-                                                quad->resource_id);
-  if (!lock.valid())
+  if (!resources.bitmap)
     return;
-  const SkBitmap* bitmap = lock.sk_bitmap();
+  const SkBitmap* bitmap = resources.bitmap;
   gfx::RectF uv_rect = gfx::ScaleRect(gfx::BoundingRect(quad->uv_top_left,
                                                         quad->uv_bottom_right),
                                       bitmap->width(),
@@ -390,21 +673,21 @@ void SoftwareRenderer::DrawTextureQuad(const DrawingFrame* frame,
   SkRect quad_rect = gfx::RectFToSkRect(visible_quad_vertex_rect);
 
   if (quad->flipped)
-    current_canvas_->scale(1, -1);
+    canvas->scale(1, -1);
 
   bool blend_background = quad->background_color != SK_ColorTRANSPARENT &&
                           !bitmap->isOpaque();
-  bool needs_layer = blend_background && (current_paint_.getAlpha() != 0xFF);
+  bool needs_layer = blend_background && (paint->getAlpha() != 0xFF);
   if (needs_layer) {
-    current_canvas_->saveLayerAlpha(&quad_rect, current_paint_.getAlpha());
-    current_paint_.setAlpha(0xFF);
+    canvas->saveLayerAlpha(&quad_rect, paint->getAlpha());
+    paint->setAlpha(0xFF);
   }
   if (blend_background) {
     SkPaint background_paint;
     background_paint.setColor(quad->background_color);
-    current_canvas_->drawRect(quad_rect, background_paint);
+    canvas->drawRect(quad_rect, background_paint);
   }
-  SkShader::TileMode tile_mode = WrapModeToTileMode(lock.wrap_mode());
+  SkShader::TileMode tile_mode = WrapModeToTileMode(resources.wrap_mode);
   if (tile_mode != SkShader::kClamp_TileMode) {
     SkMatrix matrix;
     matrix.setRectToRect(sk_uv_rect, quad_rect, SkMatrix::kFill_ScaleToFit);
@@ -413,30 +696,23 @@ void SoftwareRenderer::DrawTextureQuad(const DrawingFrame* frame,
     SkPaint paint;
     paint.setStyle(SkPaint::kFill_Style);
     paint.setShader(shader.get());
-    current_canvas_->drawRect(quad_rect, paint);
+    canvas->drawRect(quad_rect, paint);
   } else {
-    current_canvas_->drawBitmapRectToRect(*bitmap,
-                                          &sk_uv_rect,
-                                          quad_rect,
-                                          &current_paint_);
+    canvas->drawBitmapRectToRect(*bitmap, &sk_uv_rect, quad_rect, paint);
   }
 
   if (needs_layer)
-    current_canvas_->restore();
+    canvas->restore();
 }
 
 void SoftwareRenderer::DrawTileQuad(const DrawingFrame* frame,
-                                    const TileDrawQuad* quad) {
-  // |resource_provider_| can be NULL in resourceless software draws, which
-  // should never produce tile quads in the first place.
-  DCHECK(resource_provider_);
-  DCHECK(IsSoftwareResource(quad->resource_id));
-
-  ResourceProvider::ScopedReadLockSoftware lock(resource_provider_,
-                                                quad->resource_id);
-  if (!lock.valid())
+                                    const TileDrawQuad* quad,
+                                    const QuadResources& resources,
+                                    SkCanvas* canvas,
+                                    SkPaint* paint) {
+  if (!resources.bitmap)
     return;
-  DCHECK_EQ(GL_CLAMP_TO_EDGE, lock.wrap_mode());
+  DCHECK_EQ(GL_CLAMP_TO_EDGE, resources.wrap_mode);
 
   gfx::RectF visible_tex_coord_rect = MathUtil::ScaleRectProportional(
       quad->tex_coord_rect, quad->rect, quad->visible_rect);
@@ -444,27 +720,23 @@ void SoftwareRenderer::DrawTileQuad(const DrawingFrame* frame,
       QuadVertexRect(), quad->rect, quad->visible_rect);
 
   SkRect uv_rect = gfx::RectFToSkRect(visible_tex_coord_rect);
-  current_paint_.setFilterLevel(SkPaint::kLow_FilterLevel);
-  current_canvas_->drawBitmapRectToRect(
-      *lock.sk_bitmap(),
+  paint->setFilterLevel(SkPaint::kLow_FilterLevel);
+  canvas->drawBitmapRectToRect(
+      *resources.bitmap,
       &uv_rect,
       gfx::RectFToSkRect(visible_quad_vertex_rect),
-      &current_paint_);
+      paint);
 }
 
 void SoftwareRenderer::DrawRenderPassQuad(const DrawingFrame* frame,
-                                          const RenderPassDrawQuad* quad) {
-  ScopedResource* content_texture =
-      render_pass_textures_.get(quad->render_pass_id);
-  if (!content_texture || !content_texture->id())
-    return;
-
-  DCHECK(IsSoftwareResource(content_texture->id()));
-  ResourceProvider::ScopedReadLockSoftware lock(resource_provider_,
-                                                content_texture->id());
-  if (!lock.valid())
+                                          const RenderPassDrawQuad* quad,
+                                          const QuadResources& resources,
+                                          SkCanvas* canvas,
+                                          SkPaint* paint) {
+  if (!resources.bitmap)
     return;
-  SkShader::TileMode content_tile_mode = WrapModeToTileMode(lock.wrap_mode());
+  SkShader::TileMode content_tile_mode =
+      WrapModeToTileMode(resources.wrap_mode);
 
   SkRect dest_rect = gfx::RectFToSkRect(QuadVertexRect());
   SkRect dest_visible_rect = gfx::RectFToSkRect(MathUtil::ScaleRectProportional(
@@ -475,26 +747,28 @@ void SoftwareRenderer::DrawRenderPassQuad(const DrawingFrame* frame,
   content_mat.setRectToRect(content_rect, dest_rect,
                             SkMatrix::kFill_ScaleToFit);
 
-  const SkBitmap* content = lock.sk_bitmap();
+  const SkBitmap* content = resources.bitmap;
 
   SkBitmap filter_bitmap;
   if (!quad->filters.IsEmpty()) {
+    // The bitmap of a software resource has the size of the resource.
+    gfx::Size content_size(content->width(), content->height());
     skia::RefPtr<SkImageFilter> filter = RenderSurfaceFilters::BuildImageFilter(
-        quad->filters, content_texture->size());
+        quad->filters, content_size);
     // TODO(ajuma): Apply the filter in the same pass as the content where
     // possible (e.g. when there's no origin offset). See crbug.com/308201.
     if (filter) {
-      SkImageInfo info = SkImageInfo::MakeN32Premul(
-          content_texture->size().width(), content_texture->size().height());
+      SkImageInfo info = SkImageInfo::MakeN32Premul(content_size.width(),
+                                                    content_size.height());
       if (filter_bitmap.tryAllocPixels(info)) {
-        SkCanvas canvas(filter_bitmap);
-        SkPaint paint;
-        paint.setImageFilter(filter.get());
-        canvas.clear(SK_ColorTRANSPARENT);
-        canvas.translate(SkIntToScalar(-quad->rect.origin().x()),
-                         SkIntToScalar(-quad->rect.origin().y()));
-        canvas.scale(quad->filters_scale.x(), quad->filters_scale.y());
-        canvas.drawSprite(*content, 0, 0, &paint);
+        SkCanvas filter_canvas(filter_bitmap);
+        SkPaint filter_paint;
+        filter_paint.setImageFilter(filter.get());
+        filter_canvas.clear(SK_ColorTRANSPARENT);
+        filter_canvas.translate(SkIntToScalar(-quad->rect.origin().x()),
+                                SkIntToScalar(-quad->rect.origin().y()));
+        filter_canvas.scale(quad->filters_scale.x(), quad->filters_scale.y());
+        filter_canvas.drawSprite(*content, 0, 0, &filter_paint);
       }
     }
   }
@@ -507,17 +781,15 @@ void SoftwareRenderer::DrawRenderPassQuad(const DrawingFrame* frame,
     shader = skia::AdoptRef(SkShader::CreateBitmapShader(
         filter_bitmap, content_tile_mode, content_tile_mode, &content_mat));
   }
-  current_paint_.setShader(shader.get());
+  paint->setShader(shader.get());
 
   if (quad->mask_resource_id) {
-    ResourceProvider::ScopedReadLockSoftware mask_lock(resource_provider_,
-                                                       quad->mask_resource_id);
-    if (!lock.valid())
+    if (!resources.mask)
       return;
-    SkShader::TileMode mask_tile_mode = WrapModeToTileMode(
-        mask_lock.wrap_mode());
+    SkShader::TileMode mask_tile_mode =
+        WrapModeToTileMode(resources.mask_wrap_mode);
 
-    const SkBitmap* mask = mask_lock.sk_bitmap();
+    const SkBitmap* mask = resources.mask;
 
     SkRect mask_rect = SkRect::MakeXYWH(
         quad->mask_uv_rect.x() * mask->width(),
@@ -541,24 +813,25 @@ void SoftwareRenderer::DrawRenderPassQuad(const DrawingFrame* frame,
     skia::RefPtr<SkLayerRasterizer> mask_rasterizer =
         skia::AdoptRef(builder.detachRasterizer());
 
-    current_paint_.setRasterizer(mask_rasterizer.get());
-    current_canvas_->drawRect(dest_visible_rect, current_paint_);
+    paint->setRasterizer(mask_rasterizer.get());
+    canvas->drawRect(dest_visible_rect, *paint);
   } else {
     // TODO(skaslev): Apply background filters
-    current_canvas_->drawRect(dest_visible_rect, current_paint_);
+    canvas->drawRect(dest_visible_rect, *paint);
   }
 }
 
 void SoftwareRenderer::DrawUnsupportedQuad(const DrawingFrame* frame,
-                                           const DrawQuad* quad) {
+                                           const DrawQuad* quad,
+                                           SkCanvas* canvas,
+                                           SkPaint* paint) {
 #ifdef NDEBUG
-  current_paint_.setColor(SK_ColorWHITE);
+  paint->setColor(SK_ColorWHITE);
 #else
-  current_paint_.setColor(SK_ColorMAGENTA);
+  paint->setColor(SK_ColorMAGENTA);
 #endif
-  current_paint_.setAlpha(quad->opacity() * 255);
-  current_canvas_->drawRect(gfx::RectFToSkRect(QuadVertexRect()),
-                            current_paint_);
+  paint->setAlpha(quad->opacity() * 255);
+  canvas->drawRect(gfx::RectFToSkRect(QuadVertexRect()), *paint);
 }
 
 void SoftwareRenderer::CopyCurrentRenderPassToBitmap(
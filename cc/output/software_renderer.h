@@ -5,7 +5,11 @@
 #ifndef CC_OUTPUT_SOFTWARE_RENDERER_H_
 #define CC_OUTPUT_SOFTWARE_RENDERER_H_
 
+#include <vector>
+
+#include "base/atomicops.h"
 #include "base/basictypes.h"
+#include "base/containers/scoped_ptr_hash_map.h"
 #include "cc/base/cc_export.h"
 #include "cc/output/compositor_frame.h"
 #include "cc/output/direct_renderer.h"
@@ -16,6 +20,7 @@ class OutputSurface;
 class RendererClient;
 class ResourceProvider;
 class SoftwareOutputDevice;
+class TaskGraphRunner;
 
 class CheckerboardDrawQuad;
 class DebugBorderDrawQuad;
@@ -55,6 +60,7 @@ class CC_EXPORT SoftwareRenderer : public DirectRenderer {
   virtual void ClearFramebuffer(DrawingFrame* frame,
                                 bool has_external_stencil_test) OVERRIDE;
   virtual void DoDrawQuad(DrawingFrame* frame, const DrawQuad* quad) OVERRIDE;
+  virtual void FinishDrawingQuadList() OVERRIDE;
   virtual void BeginDrawingFrame(DrawingFrame* frame) OVERRIDE;
   virtual void FinishDrawingFrame(DrawingFrame* frame) OVERRIDE;
   virtual bool FlippedFramebuffer() const OVERRIDE;
@@ -72,26 +78,104 @@ class CC_EXPORT SoftwareRenderer : public DirectRenderer {
   virtual void DidChangeVisibility() OVERRIDE;
 
  private:
+  // The bitmaps a quad draws from. They are looked up on the compositor
+  // thread, so that drawing a quad never calls into the ResourceProvider.
+  struct QuadResources {
+    QuadResources()
+        : is_software(true),
+          bitmap(NULL),
+          wrap_mode(GL_CLAMP_TO_EDGE),
+          mask(NULL),
+          mask_wrap_mode(GL_CLAMP_TO_EDGE) {}
+
+    // False for texture quads of GL resources, which can't be drawn.
+    bool is_software;
+    // NULL when the quad has no such resource or it failed to lock.
+    const SkBitmap* bitmap;
+    GLint wrap_mode;
+    const SkBitmap* mask;
+    GLint mask_wrap_mode;
+  };
+
+  // A quad whose drawing was deferred so that it can be drawn in bands on
+  // worker threads.
+  struct DeferredQuad {
+    DeferredQuad(const DrawQuad* quad, const gfx::Rect& clip_rect)
+        : quad(quad), clip_rect(clip_rect) {}
+
+    const DrawQuad* quad;
+    // The scissor rect of the quad intersected with its bounds, in window
+    // space.
+    gfx::Rect clip_rect;
+    QuadResources resources;
+  };
+
+  typedef base::ScopedPtrHashMap<ResourceProvider::ResourceId,
+                                 ResourceProvider::ScopedReadLockSoftware>
+      ReadLockMap;
+
   void ClearCanvas(SkColor color);
   void SetClipRect(const gfx::Rect& rect);
   bool IsSoftwareResource(ResourceProvider::ResourceId resource_id) const;
 
+  // Returns false if |quad| has to be drawn on the compositor thread.
+  bool CanDeferQuad(const DrawQuad* quad) const;
+  void DeferQuad(const DrawingFrame* frame, const DrawQuad* quad);
+  // Draws the deferred quads into the current canvas, splitting it into
+  // horizontal bands that are drawn in parallel.
+  void DrawDeferredQuads();
+  void DrawDeferredQuadsInBands(const std::vector<gfx::Rect>* bands,
+                                base::subtle::Atomic32* next_band,
+                                const SkBitmap* target);
+  void DrawDeferredQuadsInBand(const SkBitmap& target,
+                               const gfx::Rect& band_rect);
+
+  // Locks the resources |quad| draws from into |read_locks_| and fills in
+  // |resources| with their bitmaps.
+  void LockQuadResources(const DrawQuad* quad, QuadResources* resources);
+  void LockResource(ResourceProvider::ResourceId resource_id,
+                    const SkBitmap** bitmap,
+                    GLint* wrap_mode);
+
+  void DrawQuadToCanvas(const DrawingFrame* frame,
+                        const DrawQuad* quad,
+                        const QuadResources& resources,
+                        SkCanvas* canvas);
   void DrawCheckerboardQuad(const DrawingFrame* frame,
-                            const CheckerboardDrawQuad* quad);
+                            const CheckerboardDrawQuad* quad,
+                            SkCanvas* canvas,
+                            SkPaint* paint);
   void DrawDebugBorderQuad(const DrawingFrame* frame,
-                           const DebugBorderDrawQuad* quad);
+                           const DebugBorderDrawQuad* quad,
+                           SkCanvas* canvas,
+                           SkPaint* paint);
   void DrawPictureQuad(const DrawingFrame* frame,
-                       const PictureDrawQuad* quad);
+                       const PictureDrawQuad* quad,
+                       SkCanvas* canvas,
+                       SkPaint* paint);
   void DrawRenderPassQuad(const DrawingFrame* frame,
-                          const RenderPassDrawQuad* quad);
+                          const RenderPassDrawQuad* quad,
+                          const QuadResources& resources,
+                          SkCanvas* canvas,
+                          SkPaint* paint);
   void DrawSolidColorQuad(const DrawingFrame* frame,
-                          const SolidColorDrawQuad* quad);
+                          const SolidColorDrawQuad* quad,
+                          SkCanvas* canvas,
+                          SkPaint* paint);
   void DrawTextureQuad(const DrawingFrame* frame,
-                       const TextureDrawQuad* quad);
+                       const TextureDrawQuad* quad,
+                       const QuadResources& resources,
+                       SkCanvas* canvas,
+                       SkPaint* paint);
   void DrawTileQuad(const DrawingFrame* frame,
-                    const TileDrawQuad* quad);
+                    const TileDrawQuad* quad,
+                    const QuadResources& resources,
+                    SkCanvas* canvas,
+                    SkPaint* paint);
   void DrawUnsupportedQuad(const DrawingFrame* frame,
-                           const DrawQuad* quad);
+                           const DrawQuad* quad,
+                           SkCanvas* canvas,
+                           SkPaint* paint);
 
   RendererCapabilitiesImpl capabilities_;
   bool is_scissor_enabled_;
@@ -101,11 +185,18 @@ class CC_EXPORT SoftwareRenderer : public DirectRenderer {
   SoftwareOutputDevice* output_device_;
   SkCanvas* root_canvas_;
   SkCanvas* current_canvas_;
-  SkPaint current_paint_;
   scoped_ptr<ResourceProvider::ScopedWriteLockSoftware>
       current_framebuffer_lock_;
   scoped_ptr<SoftwareFrameData> current_frame_data_;
 
+  // Set when quads are drawn on worker threads.
+  TaskGraphRunner* task_graph_runner_;
+  std::vector<DeferredQuad> deferred_quads_;
+  const DrawingFrame* deferred_quads_frame_;
+  gfx::Rect deferred_quads_bounds_;
+  // Locks of the resources of the quads being drawn.
+  ReadLockMap read_locks_;
+
   DISALLOW_COPY_AND_ASSIGN(SoftwareRenderer);
 };
 
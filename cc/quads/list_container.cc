@@ -94,8 +94,12 @@ class ListContainer<BaseElementType>::ListContainerCharAllocator {
   ~ListContainerCharAllocator() {}
 
   void* Allocate() {
-    if (last_list_->IsFull())
-      AllocateNewList(last_list_->capacity * 2);
+    if (last_list_->IsFull()) {
+      // A list that was created empty can't be grown by doubling.
+      AllocateNewList(last_list_->capacity
+                          ? last_list_->capacity * 2
+                          : kDefaultNumElementTypesToReserve);
+    }
 
     ++size_;
     return last_list_->AddElement();
@@ -47,7 +47,12 @@ class QuadList : public ListContainer<DrawQuad> {
   inline ConstBackToFrontIterator BackToFrontEnd() const { return rend(); }
 };
 
-typedef ScopedPtrVector<SharedQuadState> SharedQuadStateList;
+// SharedQuadStates are stored inline in a few large blocks rather than being
+// allocated one by one, the same way QuadList stores its DrawQuads.
+class SharedQuadStateList : public ListContainer<SharedQuadState> {
+ public:
+  explicit SharedQuadStateList(size_t default_size_to_reserve);
+};
 
 class CC_EXPORT RenderPass {
  public:
@@ -55,6 +60,11 @@ class CC_EXPORT RenderPass {
 
   static scoped_ptr<RenderPass> Create();
   static scoped_ptr<RenderPass> Create(size_t num_layers);
+  // Reserves exactly enough room for the given number of shared quad states
+  // and quads, so that a pass whose contents are known up front (e.g. one
+  // being deserialized) fills each list without further allocations.
+  static scoped_ptr<RenderPass> Create(size_t shared_quad_state_list_size,
+                                       size_t quad_list_size);
 
   // A shallow copy of the render pass, which does not include its quads or copy
   // requests.
@@ -117,6 +127,7 @@ class CC_EXPORT RenderPass {
  protected:
   explicit RenderPass(size_t num_layers);
   RenderPass();
+  RenderPass(size_t shared_quad_state_list_size, size_t quad_list_size);
 
  private:
   template <typename DrawQuadType>
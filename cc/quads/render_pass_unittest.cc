@@ -319,5 +319,56 @@ TEST(RenderPassTest, CopyAllWithCulledQuads) {
   CompareRenderPassLists(pass_list, copy_list);
 }
 
+TEST(RenderPassTest, CreateWithListSizesAllocatesOnce) {
+  scoped_ptr<RenderPass> pass = RenderPass::Create(2, 3);
+  pass->SetAll(RenderPassId(3, 2),
+               gfx::Rect(0, 0, 10, 10),
+               gfx::Rect(),
+               gfx::Transform(),
+               false);
+  SharedQuadStateList& sqs_list = pass->shared_quad_state_list;
+  EXPECT_EQ(2u, sqs_list.AvailableSizeWithoutAnotherAllocationForTesting());
+  EXPECT_EQ(3u,
+            pass->quad_list.AvailableSizeWithoutAnotherAllocationForTesting());
+
+  for (size_t i = 0; i < 2; ++i) {
+    SharedQuadState* shared_state = pass->CreateAndAppendSharedQuadState();
+    shared_state->SetAll(gfx::Transform(),
+                         gfx::Size(1, 1),
+                         gfx::Rect(),
+                         gfx::Rect(),
+                         false,
+                         1,
+                         SkXfermode::kSrcOver_Mode,
+                         0);
+  }
+  for (size_t i = 0; i < 3; ++i) {
+    CheckerboardDrawQuad* quad =
+        pass->CreateAndAppendDrawQuad<CheckerboardDrawQuad>();
+    quad->SetNew(sqs_list.ElementAt(i / 2),
+                 gfx::Rect(1, 1, 1, 1),
+                 gfx::Rect(1, 1, 1, 1),
+                 SkColor());
+  }
+
+  // Everything fit in the initial reservation, which is now used up.
+  EXPECT_EQ(0u, sqs_list.AvailableSizeWithoutAnotherAllocationForTesting());
+  EXPECT_EQ(0u,
+            pass->quad_list.AvailableSizeWithoutAnotherAllocationForTesting());
+
+  // Copies are sized to fit their source exactly too.
+  RenderPassList pass_list;
+  pass_list.push_back(pass.Pass());
+  RenderPassList copy_list;
+  RenderPass::CopyAll(pass_list, &copy_list);
+  CompareRenderPassLists(pass_list, copy_list);
+  RenderPass* copy = copy_list[0];
+  EXPECT_EQ(0u,
+            copy->shared_quad_state_list
+                .AvailableSizeWithoutAnotherAllocationForTesting());
+  EXPECT_EQ(0u,
+            copy->quad_list.AvailableSizeWithoutAnotherAllocationForTesting());
+}
+
 }  // namespace
 }  // namespace cc
@@ -0,0 +1,176 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "cc/resources/compressed_bitmap.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "base/logging.h"
+
+namespace cc {
+
+namespace {
+
+// Each token keeps its operation in the top two bits and a pixel count in the
+// rest.
+enum Operation {
+  // |count| pixels follow the token.
+  OPERATION_LITERAL = 0,
+  // A single pixel follows the token, and is repeated |count| times.
+  OPERATION_RUN = 1,
+  // Nothing follows the token; |count| pixels are copied from one row up.
+  OPERATION_COPY_ABOVE = 2
+};
+
+const int kOperationShift = 30;
+const uint32_t kMaxCount = (1u << kOperationShift) - 1;
+
+// Shorter matches are cheaper to keep as literals. A run takes two words and
+// a copy takes one.
+const size_t kMinRunLength = 3;
+const size_t kMinCopyAboveLength = 2;
+
+uint32_t MakeToken(Operation operation, size_t count) {
+  DCHECK_LE(count, kMaxCount);
+  return (static_cast<uint32_t>(operation) << kOperationShift) |
+         static_cast<uint32_t>(count);
+}
+
+size_t RunLength(const uint32_t* pixels, size_t index, size_t end) {
+  size_t length = 1;
+  while (index + length < end && length < kMaxCount &&
+         pixels[index + length] == pixels[index])
+    ++length;
+  return length;
+}
+
+size_t CopyAboveLength(const uint32_t* pixels,
+                       size_t index,
+                       size_t stride,
+                       size_t end) {
+  if (index < stride)
+    return 0;
+  size_t length = 0;
+  while (index + length < end && length < kMaxCount &&
+         pixels[index + length] == pixels[index + length - stride])
+    ++length;
+  return length;
+}
+
+void AppendLiteral(const uint32_t* pixels,
+                   size_t start,
+                   size_t end,
+                   std::vector<uint32_t>* data) {
+  while (start < end) {
+    size_t count = std::min(end - start, static_cast<size_t>(kMaxCount));
+    data->push_back(MakeToken(OPERATION_LITERAL, count));
+    data->insert(data->end(), pixels + start, pixels + start + count);
+    start += count;
+  }
+}
+
+}  // namespace
+
+// static
+scoped_ptr<CompressedBitmap> CompressedBitmap::Create(const uint8_t* pixels,
+                                                      const gfx::Size& size) {
+  DCHECK(pixels);
+  const uint32_t* source = reinterpret_cast<const uint32_t*>(pixels);
+  size_t stride = size.width();
+  size_t num_pixels = size.GetArea();
+
+  std::vector<uint32_t> data;
+  size_t literal_start = 0;
+  size_t index = 0;
+  while (index < num_pixels) {
+    // Give up as soon as the encoding can't be smaller than the pixels.
+    if (data.size() + (index - literal_start) >= num_pixels)
+      return scoped_ptr<CompressedBitmap>();
+
+    size_t copy_above_length =
+        CopyAboveLength(source, index, stride, num_pixels);
+    if (copy_above_length >= kMinCopyAboveLength) {
+      size_t run_length = RunLength(source, index, num_pixels);
+      if (copy_above_length >= run_length) {
+        AppendLiteral(source, literal_start, index, &data);
+        data.push_back(MakeToken(OPERATION_COPY_ABOVE, copy_above_length));
+        index += copy_above_length;
+        literal_start = index;
+        continue;
+      }
+    }
+
+    size_t run_length = RunLength(source, index, num_pixels);
+    if (run_length >= kMinRunLength) {
+      AppendLiteral(source, literal_start, index, &data);
+      data.push_back(MakeToken(OPERATION_RUN, run_length));
+      data.push_back(source[index]);
+      index += run_length;
+      literal_start = index;
+      continue;
+    }
+
+    ++index;
+  }
+  AppendLiteral(source, literal_start, num_pixels, &data);
+  if (data.size() >= num_pixels)
+    return scoped_ptr<CompressedBitmap>();
+
+  return make_scoped_ptr(new CompressedBitmap(size, &data));
+}
+
+CompressedBitmap::CompressedBitmap(const gfx::Size& size,
+                                   std::vector<uint32_t>* data)
+    : size_(size) {
+  data_.swap(*data);
+}
+
+CompressedBitmap::~CompressedBitmap() {
+}
+
+void CompressedBitmap::Decompress(uint8_t* pixels) const {
+  DCHECK(pixels);
+  uint32_t* dest = reinterpret_cast<uint32_t*>(pixels);
+  size_t stride = size_.width();
+  size_t num_pixels = size_.GetArea();
+
+  size_t index = 0;
+  std::vector<uint32_t>::const_iterator it = data_.begin();
+  while (it != data_.end()) {
+    Operation operation = static_cast<Operation>(*it >> kOperationShift);
+    size_t count = *it & kMaxCount;
+    ++it;
+    DCHECK_LE(index + count, num_pixels);
+
+    switch (operation) {
+      case OPERATION_LITERAL:
+        memcpy(dest + index, &*it, count * sizeof(uint32_t));
+        it += count;
+        break;
+      case OPERATION_RUN:
+        std::fill(dest + index, dest + index + count, *it);
+        ++it;
+        break;
+      case OPERATION_COPY_ABOVE: {
+        DCHECK_GE(index, stride);
+        // Copy at most a row at a time so that the source and destination
+        // never overlap.
+        size_t copied = 0;
+        while (copied < count) {
+          size_t length = std::min(count - copied, stride);
+          memcpy(dest + index + copied,
+                 dest + index + copied - stride,
+                 length * sizeof(uint32_t));
+          copied += length;
+        }
+        break;
+      }
+    }
+    index += count;
+  }
+  DCHECK_EQ(num_pixels, index);
+}
+
+}  // namespace cc
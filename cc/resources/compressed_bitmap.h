@@ -0,0 +1,51 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CC_RESOURCES_COMPRESSED_BITMAP_H_
+#define CC_RESOURCES_COMPRESSED_BITMAP_H_
+
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/memory/scoped_ptr.h"
+#include "cc/base/cc_export.h"
+#include "ui/gfx/size.h"
+
+namespace cc {
+
+// A lossless, LZ-style encoding of a 32-bit per pixel bitmap, used to keep
+// bitmaps that are not being drawn in less memory. Pixels are encoded as runs
+// of a single color, copies of the pixels one row up, or literal pixels, which
+// makes both encoding and decoding a single pass over the pixels. Web content
+// is mostly made of flat backgrounds and repeated rows, which this compresses
+// well; photos and gradients don't compress and are rejected.
+class CC_EXPORT CompressedBitmap {
+ public:
+  // Returns NULL if the encoded pixels would not be smaller than the
+  // |size| * 4 bytes at |pixels|.
+  static scoped_ptr<CompressedBitmap> Create(const uint8_t* pixels,
+                                             const gfx::Size& size);
+
+  ~CompressedBitmap();
+
+  // Writes the pixels back into |pixels|, which must hold size() * 4 bytes.
+  void Decompress(uint8_t* pixels) const;
+
+  const gfx::Size& size() const { return size_; }
+  size_t bytes() const { return data_.size() * sizeof(uint32_t); }
+
+ private:
+  CompressedBitmap(const gfx::Size& size, std::vector<uint32_t>* data);
+
+  gfx::Size size_;
+  // A sequence of tokens, each holding an operation and a pixel count,
+  // followed by the pixels the operation needs.
+  std::vector<uint32_t> data_;
+
+  DISALLOW_COPY_AND_ASSIGN(CompressedBitmap);
+};
+
+}  // namespace cc
+
+#endif  // CC_RESOURCES_COMPRESSED_BITMAP_H_
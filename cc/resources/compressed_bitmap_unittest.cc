@@ -0,0 +1,90 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "cc/resources/compressed_bitmap.h"
+
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace cc {
+namespace {
+
+void ExpectRoundTrip(const std::vector<uint32_t>& pixels,
+                     const gfx::Size& size,
+                     size_t max_bytes) {
+  ASSERT_EQ(static_cast<size_t>(size.GetArea()), pixels.size());
+  scoped_ptr<CompressedBitmap> compressed = CompressedBitmap::Create(
+      reinterpret_cast<const uint8_t*>(&pixels[0]), size);
+  ASSERT_TRUE(compressed);
+  EXPECT_EQ(size, compressed->size());
+  EXPECT_LE(compressed->bytes(), max_bytes);
+
+  std::vector<uint32_t> decompressed(pixels.size(), 0u);
+  compressed->Decompress(reinterpret_cast<uint8_t*>(&decompressed[0]));
+  EXPECT_EQ(pixels, decompressed);
+}
+
+TEST(CompressedBitmapTest, SolidColor) {
+  gfx::Size size(256, 256);
+  std::vector<uint32_t> pixels(size.GetArea(), 0xff336699u);
+
+  // A single run, followed by copies of the first row.
+  ExpectRoundTrip(pixels, size, 3 * sizeof(uint32_t));
+}
+
+TEST(CompressedBitmapTest, RepeatedRows) {
+  gfx::Size size(64, 32);
+  std::vector<uint32_t> pixels;
+  for (int y = 0; y < size.height(); ++y) {
+    for (int x = 0; x < size.width(); ++x)
+      pixels.push_back(0xff000000u | x * 0x010203u);
+  }
+
+  // The first row is literal, and the rest is copied from it.
+  ExpectRoundTrip(pixels, size, (size.width() + 2) * sizeof(uint32_t));
+}
+
+TEST(CompressedBitmapTest, TextOnBackground) {
+  gfx::Size size(128, 128);
+  std::vector<uint32_t> pixels(size.GetArea(), 0xffffffffu);
+  // A few rows with distinct glyph-like pixels.
+  for (int y = 40; y < 48; ++y) {
+    for (int x = 10; x < 100; x += 3)
+      pixels[y * size.width() + x] = 0xff000000u | (x * y);
+  }
+
+  ExpectRoundTrip(pixels, size, pixels.size() * sizeof(uint32_t) / 4);
+}
+
+TEST(CompressedBitmapTest, RunsLongerThanARow) {
+  gfx::Size size(16, 16);
+  std::vector<uint32_t> pixels(size.GetArea(), 0xff00ff00u);
+  // Noise in the first row, so that later rows are copied from it across
+  // several rows at once.
+  for (int x = 0; x < size.width(); ++x)
+    pixels[x] = 0xff000000u | (x * 0x1234567u);
+  for (int y = 1; y < size.height(); ++y) {
+    for (int x = 0; x < size.width(); ++x)
+      pixels[y * size.width() + x] = pixels[x];
+  }
+
+  ExpectRoundTrip(pixels, size, (size.width() + 2) * sizeof(uint32_t));
+}
+
+TEST(CompressedBitmapTest, RejectsNoise) {
+  gfx::Size size(32, 32);
+  std::vector<uint32_t> pixels;
+  uint32_t value = 12345u;
+  for (int i = 0; i < size.GetArea(); ++i) {
+    value = value * 1103515245u + 12345u;
+    pixels.push_back(value);
+  }
+
+  EXPECT_FALSE(CompressedBitmap::Create(
+      reinterpret_cast<const uint8_t*>(&pixels[0]), size));
+}
+
+}  // namespace
+}  // namespace cc
@@ -0,0 +1,133 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "cc/resources/display_item_list.h"
+
+#include "base/debug/trace_event.h"
+#include "base/logging.h"
+#include "third_party/skia/include/core/SkCanvas.h"
+#include "ui/gfx/skia_util.h"
+
+namespace cc {
+
+DisplayItemList::Item::Item() {
+}
+
+DisplayItemList::Item::~Item() {
+}
+
+scoped_refptr<DisplayItemList> DisplayItemList::Create() {
+  return make_scoped_refptr(new DisplayItemList());
+}
+
+DisplayItemList::DisplayItemList() {
+}
+
+DisplayItemList::~DisplayItemList() {
+}
+
+void DisplayItemList::AppendItem(skia::RefPtr<SkPicture> picture,
+                                 const gfx::PointF& location) {
+  DCHECK(picture);
+  gfx::RectF bounds(location, gfx::SizeF(picture->width(), picture->height()));
+  // Items that can't draw anything don't need to be kept around.
+  if (bounds.IsEmpty())
+    return;
+
+  items_.push_back(Item());
+  items_.back().picture = picture;
+  items_.back().bounds = bounds;
+  bounds_.Union(bounds);
+}
+
+size_t DisplayItemList::Raster(SkCanvas* canvas,
+                               SkDrawPictureCallback* callback) const {
+  TRACE_EVENT1("cc", "DisplayItemList::Raster", "num_items", items_.size());
+  SkRect clip_bounds;
+  if (!canvas->getClipBounds(&clip_bounds))
+    return 0;
+
+  size_t num_items_drawn = 0;
+  for (std::vector<Item>::const_iterator it = items_.begin();
+       it != items_.end();
+       ++it) {
+    if (!clip_bounds.intersects(gfx::RectFToSkRect(it->bounds)))
+      continue;
+    if (callback && callback->abortDrawing())
+      break;
+
+    canvas->save();
+    canvas->translate(it->bounds.x(), it->bounds.y());
+    if (callback) {
+      // |drawPicture()| doesn't take a callback. This is used by
+      // |AnalysisCanvas| to early out.
+      it->picture->draw(canvas, callback);
+    } else {
+      canvas->drawPicture(it->picture.get());
+    }
+    canvas->restore();
+    ++num_items_drawn;
+  }
+  return num_items_drawn;
+}
+
+bool DisplayItemList::IsSuitableForGpuRasterization() const {
+  for (std::vector<Item>::const_iterator it = items_.begin();
+       it != items_.end();
+       ++it) {
+    if (!it->picture->suitableForGpuRasterization(NULL))
+      return false;
+  }
+  return true;
+}
+
+int DisplayItemList::ApproximateOpCount() const {
+  int total_op_count = 0;
+  for (std::vector<Item>::const_iterator it = items_.begin();
+       it != items_.end();
+       ++it) {
+    total_op_count += it->picture->approximateOpCount();
+  }
+  return total_op_count;
+}
+
+bool DisplayItemList::HasText() const {
+  for (std::vector<Item>::const_iterator it = items_.begin();
+       it != items_.end();
+       ++it) {
+    if (it->picture->hasText())
+      return true;
+  }
+  return false;
+}
+
+bool DisplayItemList::WillPlayBackBitmaps() const {
+  for (std::vector<Item>::const_iterator it = items_.begin();
+       it != items_.end();
+       ++it) {
+    if (it->picture->willPlayBackBitmaps())
+      return true;
+  }
+  return false;
+}
+
+void DisplayItemList::GatherDiscardablePixelRefs(
+    skia::DiscardablePixelRefList* pixel_refs) const {
+  for (std::vector<Item>::const_iterator it = items_.begin();
+       it != items_.end();
+       ++it) {
+    if (!it->picture->willPlayBackBitmaps())
+      continue;
+
+    size_t first_new_pixel_ref = pixel_refs->size();
+    skia::PixelRefUtils::GatherDiscardablePixelRefs(it->picture.get(),
+                                                    pixel_refs);
+    for (size_t i = first_new_pixel_ref; i < pixel_refs->size(); ++i) {
+      (*pixel_refs)[i].pixel_ref_rect.offset(it->bounds.x(),
+                                             it->bounds.y());
+    }
+  }
+}
+
+}  // namespace cc
@@ -0,0 +1,82 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CC_RESOURCES_DISPLAY_ITEM_LIST_H_
+#define CC_RESOURCES_DISPLAY_ITEM_LIST_H_
+
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/memory/ref_counted.h"
+#include "cc/base/cc_export.h"
+#include "skia/ext/pixel_ref_utils.h"
+#include "skia/ext/refptr.h"
+#include "third_party/skia/include/core/SkPicture.h"
+#include "ui/gfx/point_f.h"
+#include "ui/gfx/rect_f.h"
+
+class SkCanvas;
+class SkDrawPictureCallback;
+
+namespace cc {
+
+// A flat list of recorded draw operations, each kept together with its bounds
+// in layer space. Unlike a single SkPicture for a whole recording, this lets
+// raster skip every item that doesn't intersect the rect being rastered.
+//
+// Items are usually single draw operations (or small groups of them) that the
+// ContentLayerClient recorded separately. The list is immutable once it has
+// been handed to a Picture, so it can be rastered from multiple threads.
+class CC_EXPORT DisplayItemList
+    : public base::RefCountedThreadSafe<DisplayItemList> {
+ public:
+  static scoped_refptr<DisplayItemList> Create();
+
+  // Appends |picture|, whose origin is placed at |location| in layer space.
+  // Items are drawn in the order they were appended.
+  void AppendItem(skia::RefPtr<SkPicture> picture, const gfx::PointF& location);
+
+  size_t size() const { return items_.size(); }
+  gfx::RectF ItemBounds(size_t index) const { return items_[index].bounds; }
+
+  // The union of the bounds of all items.
+  gfx::RectF bounds() const { return bounds_; }
+
+  // Draws the items that intersect the canvas clip, in layer space. Returns
+  // the number of items drawn. If |callback| asks to abort, the remaining
+  // items are skipped.
+  size_t Raster(SkCanvas* canvas, SkDrawPictureCallback* callback) const;
+
+  bool IsSuitableForGpuRasterization() const;
+  int ApproximateOpCount() const;
+  bool HasText() const;
+  bool WillPlayBackBitmaps() const;
+
+  // Appends the discardable pixel refs of all items, in layer space.
+  void GatherDiscardablePixelRefs(skia::DiscardablePixelRefList* pixel_refs)
+      const;
+
+ private:
+  friend class base::RefCountedThreadSafe<DisplayItemList>;
+
+  struct Item {
+    Item();
+    ~Item();
+
+    skia::RefPtr<SkPicture> picture;
+    gfx::RectF bounds;
+  };
+
+  DisplayItemList();
+  ~DisplayItemList();
+
+  std::vector<Item> items_;
+  gfx::RectF bounds_;
+
+  DISALLOW_COPY_AND_ASSIGN(DisplayItemList);
+};
+
+}  // namespace cc
+
+#endif  // CC_RESOURCES_DISPLAY_ITEM_LIST_H_
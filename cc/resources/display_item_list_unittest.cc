@@ -0,0 +1,72 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "cc/resources/display_item_list.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "third_party/skia/include/core/SkCanvas.h"
+#include "third_party/skia/include/core/SkPictureRecorder.h"
+#include "ui/gfx/rect.h"
+#include "ui/gfx/skia_util.h"
+
+namespace cc {
+namespace {
+
+skia::RefPtr<SkPicture> CreateRectPicture(const gfx::Size& size,
+                                          SkColor color) {
+  SkPictureRecorder recorder;
+  SkCanvas* canvas = recorder.beginRecording(size.width(), size.height(), NULL);
+  SkPaint paint;
+  paint.setColor(color);
+  canvas->drawRect(gfx::RectToSkRect(gfx::Rect(size)), paint);
+  return skia::AdoptRef(recorder.endRecording());
+}
+
+TEST(DisplayItemListTest, Bounds) {
+  scoped_refptr<DisplayItemList> list = DisplayItemList::Create();
+  EXPECT_EQ(0u, list->size());
+  EXPECT_TRUE(list->bounds().IsEmpty());
+
+  list->AppendItem(CreateRectPicture(gfx::Size(10, 20), SK_ColorRED),
+                   gfx::PointF(5.f, 5.f));
+  list->AppendItem(CreateRectPicture(gfx::Size(30, 10), SK_ColorGREEN),
+                   gfx::PointF(100.f, 200.f));
+  // Empty items are dropped.
+  list->AppendItem(CreateRectPicture(gfx::Size(), SK_ColorBLUE),
+                   gfx::PointF(300.f, 300.f));
+
+  EXPECT_EQ(2u, list->size());
+  EXPECT_EQ(gfx::RectF(5.f, 5.f, 10.f, 20.f).ToString(),
+            list->ItemBounds(0).ToString());
+  EXPECT_EQ(gfx::RectF(100.f, 200.f, 30.f, 10.f).ToString(),
+            list->ItemBounds(1).ToString());
+  EXPECT_EQ(gfx::RectF(5.f, 5.f, 125.f, 205.f).ToString(),
+            list->bounds().ToString());
+}
+
+TEST(DisplayItemListTest, RasterSkipsItemsOutsideClip) {
+  scoped_refptr<DisplayItemList> list = DisplayItemList::Create();
+  for (int i = 0; i < 10; ++i) {
+    list->AppendItem(CreateRectPicture(gfx::Size(10, 10), SK_ColorRED),
+                     gfx::PointF(0.f, i * 100.f));
+  }
+
+  SkBitmap bitmap;
+  bitmap.allocN32Pixels(10, 10);
+  bitmap.eraseColor(SK_ColorTRANSPARENT);
+  SkCanvas canvas(bitmap);
+
+  // The canvas covers the item at (0, 300) only.
+  canvas.translate(0.f, -300.f);
+  EXPECT_EQ(1u, list->Raster(&canvas, NULL));
+  EXPECT_EQ(SK_ColorRED, bitmap.getColor(5, 5));
+
+  // Nothing intersects a canvas between two items.
+  canvas.translate(0.f, -50.f);
+  EXPECT_EQ(0u, list->Raster(&canvas, NULL));
+}
+
+}  // namespace
+}  // namespace cc
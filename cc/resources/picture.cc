@@ -17,6 +17,7 @@
 #include "cc/debug/traced_picture.h"
 #include "cc/debug/traced_value.h"
 #include "cc/layers/content_layer_client.h"
+#include "cc/resources/display_item_list.h"
 #include "skia/ext/pixel_ref_utils.h"
 #include "third_party/skia/include/core/SkCanvas.h"
 #include "third_party/skia/include/core/SkData.h"
@@ -176,6 +177,8 @@ Picture::~Picture() {
 }
 
 bool Picture::IsSuitableForGpuRasterization() const {
+  if (display_list_)
+    return display_list_->IsSuitableForGpuRasterization();
   DCHECK(picture_);
 
   // TODO(alokp): SkPicture::suitableForGpuRasterization needs a GrContext.
@@ -189,15 +192,26 @@ bool Picture::IsSuitableForGpuRasterization() const {
 }
 
 int Picture::ApproximateOpCount() const {
+  if (display_list_)
+    return display_list_->ApproximateOpCount();
   DCHECK(picture_);
   return picture_->approximateOpCount();
 }
 
 bool Picture::HasText() const {
+  if (display_list_)
+    return display_list_->HasText();
   DCHECK(picture_);
   return picture_->hasText();
 }
 
+bool Picture::WillPlayBackBitmaps() const {
+  if (display_list_)
+    return display_list_->WillPlayBackBitmaps();
+  DCHECK(picture_);
+  return picture_->willPlayBackBitmaps();
+}
+
 void Picture::Record(ContentLayerClient* painter,
                      const SkTileGridFactory::TileGridInfo& tile_grid_info,
                      RecordingMode recording_mode) {
@@ -209,8 +223,19 @@ void Picture::Record(ContentLayerClient* painter,
                recording_mode);
 
   DCHECK(!picture_);
+  DCHECK(!display_list_);
   DCHECK(!tile_grid_info.fTileInterval.isEmpty());
 
+  if (recording_mode == RECORD_WITH_DISPLAY_LIST) {
+    // The display list keeps each item with its own bounds, so it doesn't
+    // need a tile grid to cull operations at raster time.
+    display_list_ = painter->PaintContentsToDisplayList(
+        layer_rect_, ContentLayerClient::GRAPHICS_CONTEXT_ENABLED);
+    DCHECK(display_list_);
+    EmitTraceSnapshot();
+    return;
+  }
+
   SkTileGridFactory factory(tile_grid_info);
   SkPictureRecorder recorder;
 
@@ -279,7 +304,7 @@ void Picture::GatherPixelRefs(
                "width", layer_rect_.width(),
                "height", layer_rect_.height());
 
-  DCHECK(picture_);
+  DCHECK(HasRecording());
   DCHECK(pixel_refs_.empty());
   if (!WillPlayBackBitmaps())
     return;
@@ -297,7 +322,18 @@ void Picture::GatherPixelRefs(
   int max_y = 0;
 
   skia::DiscardablePixelRefList pixel_refs;
-  skia::PixelRefUtils::GatherDiscardablePixelRefs(picture_.get(), &pixel_refs);
+  if (display_list_) {
+    display_list_->GatherDiscardablePixelRefs(&pixel_refs);
+    // Pixel ref cells are in picture space.
+    for (skia::DiscardablePixelRefList::iterator it = pixel_refs.begin();
+         it != pixel_refs.end();
+         ++it) {
+      it->pixel_ref_rect.offset(-layer_rect_.x(), -layer_rect_.y());
+    }
+  } else {
+    skia::PixelRefUtils::GatherDiscardablePixelRefs(picture_.get(),
+                                                    &pixel_refs);
+  }
   for (skia::DiscardablePixelRefList::const_iterator it = pixel_refs.begin();
        it != pixel_refs.end();
        ++it) {
@@ -339,7 +375,7 @@ int Picture::Raster(SkCanvas* canvas,
       "data",
       AsTraceableRasterData(contents_scale));
 
-  DCHECK(picture_);
+  DCHECK(HasRecording());
 
   canvas->save();
 
@@ -350,6 +386,10 @@ int Picture::Raster(SkCanvas* canvas,
   canvas->translate(layer_rect_.x(), layer_rect_.y());
   if (playback_) {
     playback_->draw(canvas);
+  } else if (display_list_) {
+    // Only the items intersecting the clip (e.g. the tile being rastered) are
+    // played back.
+    DrawDisplayList(canvas, callback);
   } else if (callback) {
     // If we have a callback, we need to call |draw()|, |drawPicture()| doesn't
     // take a callback.  This is used by |AnalysisCanvas| to early out.
@@ -370,10 +410,12 @@ int Picture::Raster(SkCanvas* canvas,
 
 void Picture::Replay(SkCanvas* canvas) {
   TRACE_EVENT_BEGIN0("cc", "Picture::Replay");
-  DCHECK(picture_);
+  DCHECK(HasRecording());
 
   if (playback_) {
     playback_->draw(canvas);
+  } else if (display_list_) {
+    DrawDisplayList(canvas, NULL);
   } else {
     picture_->draw(canvas);
   }
@@ -383,17 +425,33 @@ void Picture::Replay(SkCanvas* canvas) {
                    "num_pixels_replayed", bounds.width() * bounds.height());
 }
 
+void Picture::DrawDisplayList(SkCanvas* canvas,
+                              SkDrawPictureCallback* callback) const {
+  DCHECK(display_list_);
+  canvas->save();
+  // Display list items are in layer space, and are clipped to |layer_rect_|
+  // like a recorded picture would be.
+  canvas->translate(-layer_rect_.x(), -layer_rect_.y());
+  canvas->clipRect(gfx::RectToSkRect(layer_rect_));
+  display_list_->Raster(canvas, callback);
+  canvas->restore();
+}
+
 scoped_ptr<base::Value> Picture::AsValue() const {
   SkDynamicMemoryWStream stream;
 
-  if (playback_) {
-    // SkPlayback can't serialize itself, so re-record into an SkPicture.
+  if (playback_ || display_list_) {
+    // SkPlayback and display lists can't serialize themselves, so re-record
+    // into an SkPicture.
     SkPictureRecorder recorder;
     skia::RefPtr<SkCanvas> canvas(skia::SharePtr(recorder.beginRecording(
         layer_rect_.width(),
         layer_rect_.height(),
         NULL)));  // Default (no) bounding-box hierarchy is fastest.
-    playback_->draw(canvas.get());
+    if (playback_)
+      playback_->draw(canvas.get());
+    else
+      DrawDisplayList(canvas.get(), NULL);
     skia::RefPtr<SkPicture> picture(skia::AdoptRef(recorder.endRecording()));
     picture->serialize(&stream, &EncodeBitmap);
   } else {
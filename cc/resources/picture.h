@@ -37,6 +37,7 @@ class AnalysisCanvas;
 namespace cc {
 
 class ContentLayerClient;
+class DisplayItemList;
 
 class CC_EXPORT Picture
     : public base::RefCountedThreadSafe<Picture> {
@@ -50,6 +51,7 @@ class CC_EXPORT Picture
     RECORD_WITH_SK_NULL_CANVAS,
     RECORD_WITH_PAINTING_DISABLED,
     RECORD_WITH_SKRECORD,
+    RECORD_WITH_DISPLAY_LIST,
     RECORDING_MODE_COUNT,  // Must be the last entry.
   };
 
@@ -65,7 +67,9 @@ class CC_EXPORT Picture
   gfx::Rect LayerRect() const { return layer_rect_; }
 
   // Has Record() been called yet?
-  bool HasRecording() const { return picture_.get() != NULL; }
+  bool HasRecording() const {
+    return picture_.get() != NULL || display_list_.get() != NULL;
+  }
 
   bool IsSuitableForGpuRasterization() const;
   int ApproximateOpCount() const;
@@ -126,7 +130,7 @@ class CC_EXPORT Picture
   void EmitTraceSnapshot() const;
   void EmitTraceSnapshotAlias(Picture* original) const;
 
-  bool WillPlayBackBitmaps() const { return picture_->willPlayBackBitmaps(); }
+  bool WillPlayBackBitmaps() const;
 
  private:
   explicit Picture(const gfx::Rect& layer_rect);
@@ -148,9 +152,16 @@ class CC_EXPORT Picture
   // Gather pixel refs from recording.
   void GatherPixelRefs(const SkTileGridFactory::TileGridInfo& tile_grid_info);
 
+  // Draws |display_list_| into |canvas|, which is in picture space (i.e. with
+  // the origin at the top left of |layer_rect_|).
+  void DrawDisplayList(SkCanvas* canvas, SkDrawPictureCallback* callback) const;
+
   gfx::Rect layer_rect_;
   skia::RefPtr<SkPicture> picture_;
   scoped_ptr<const EXPERIMENTAL::SkPlayback> playback_;
+  // Set instead of |picture_| when recorded with RECORD_WITH_DISPLAY_LIST.
+  // Items are in layer space.
+  scoped_refptr<DisplayItemList> display_list_;
 
   PixelRefMap pixel_refs_;
   gfx::Point min_pixel_cell_;
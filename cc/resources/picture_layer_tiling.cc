@@ -25,6 +25,20 @@ namespace {
 
 const float kSoonBorderDistanceInScreenPixels = 312.f;
 
+// Returns how far an edge moving at |velocity| and speeding up by
+// |acceleration| travels in |time|. An edge that is slowing down is assumed to
+// come to rest rather than turn around.
+float PredictEdgeDisplacement(float velocity, float acceleration, float time) {
+  if (velocity == 0.f)
+    return 0.f;
+  if (velocity * acceleration < 0.f) {
+    float time_to_rest = -velocity / acceleration;
+    if (time_to_rest < time)
+      return 0.5f * velocity * time_to_rest;
+  }
+  return velocity * time + 0.5f * acceleration * time * time;
+}
+
 class TileEvictionOrder {
  public:
   explicit TileEvictionOrder(TreePriority tree_priority)
@@ -81,6 +95,7 @@ PictureLayerTiling::PictureLayerTiling(float contents_scale,
       client_(client),
       tiling_data_(gfx::Size(), gfx::Size(), true),
       last_impl_frame_time_in_seconds_(0.0),
+      has_last_visible_rect_velocity_(false),
       has_visible_rect_tiles_(false),
       has_skewport_rect_tiles_(false),
       has_soon_border_rect_tiles_(false),
@@ -268,6 +283,10 @@ void PictureLayerTiling::Invalidate(const Region& layer_region) {
 void PictureLayerTiling::DoInvalidate(const Region& layer_region,
                                       bool recreate_invalidated_tiles) {
   std::vector<TileMapKey> new_tile_keys;
+  // The removed tiles, in the same order as |new_tile_keys|, and the part of
+  // each of them that was invalidated.
+  std::vector<scoped_refptr<Tile> > previous_tiles;
+  base::hash_map<TileMapKey, gfx::Rect> invalidated_content_rects;
   gfx::Rect expanded_live_tiles_rect =
       tiling_data_.ExpandRectIgnoringBordersToTileBounds(live_tiles_rect_);
   for (Region::Iterator iter(layer_region); iter.has_rect(); iter.next()) {
@@ -295,8 +314,13 @@ void PictureLayerTiling::DoInvalidate(const Region& layer_region,
       PictureLayerTiling* recycled_twin = NULL;
       DCHECK_EQ(recycled_twin, client_->GetRecycledTwinTiling(this));
       DCHECK_EQ(PENDING_TREE, client_->GetTree());
-      if (RemoveTileAt(iter.index_x(), iter.index_y(), recycled_twin))
+      invalidated_content_rects[iter.index()].Union(content_rect);
+      scoped_refptr<Tile> previous_tile =
+          TileAt(iter.index_x(), iter.index_y());
+      if (RemoveTileAt(iter.index_x(), iter.index_y(), recycled_twin)) {
         new_tile_keys.push_back(iter.index());
+        previous_tiles.push_back(previous_tile);
+      }
     }
   }
 
@@ -305,7 +329,14 @@ void PictureLayerTiling::DoInvalidate(const Region& layer_region,
       // Don't try to share a tile with the twin layer, it's been invalidated so
       // we have to make our own tile here.
       const PictureLayerTiling* twin_tiling = NULL;
-      CreateTile(new_tile_keys[i].first, new_tile_keys[i].second, twin_tiling);
+      Tile* tile = CreateTile(
+          new_tile_keys[i].first, new_tile_keys[i].second, twin_tiling);
+      // Let the new tile reuse what the old one rastered outside of the
+      // invalidation.
+      if (tile && tile->content_rect() == previous_tiles[i]->content_rect()) {
+        tile->SetPreviousTile(previous_tiles[i].get(),
+                              invalidated_content_rects[new_tile_keys[i]]);
+      }
     }
   }
 }
@@ -520,6 +551,12 @@ gfx::Rect PictureLayerTiling::ComputeSkewport(
   max_skewport.Inset(
       -skewport_limit, -skewport_limit, -skewport_limit, -skewport_limit);
 
+  if (client_->UsePredictiveSkewport()) {
+    return ComputePredictiveSkewport(current_frame_time_in_seconds,
+                                     visible_rect_in_content_space,
+                                     max_skewport);
+  }
+
   // Inset the skewport by the needed adjustment.
   skewport.Inset(extrapolation_multiplier * (new_x - old_x),
                  extrapolation_multiplier * (new_y - old_y),
@@ -534,6 +571,104 @@ gfx::Rect PictureLayerTiling::ComputeSkewport(
   return skewport;
 }
 
+gfx::Rect PictureLayerTiling::ComputePredictiveSkewport(
+    double current_frame_time_in_seconds,
+    const gfx::Rect& visible_rect_in_content_space,
+    const gfx::Rect& max_skewport) const {
+  gfx::Vector2dF origin_velocity;
+  gfx::Vector2dF bottom_right_velocity;
+  if (!ComputeVisibleRectVelocity(current_frame_time_in_seconds,
+                                  visible_rect_in_content_space,
+                                  &origin_velocity,
+                                  &bottom_right_velocity))
+    return visible_rect_in_content_space;
+
+  // Acceleration needs the velocity from the update before this one.
+  gfx::Vector2dF origin_acceleration;
+  gfx::Vector2dF bottom_right_acceleration;
+  if (has_last_visible_rect_velocity_) {
+    double time_delta =
+        current_frame_time_in_seconds - last_impl_frame_time_in_seconds_;
+    float inverse_time_delta = 1.f / time_delta;
+    origin_acceleration = gfx::ScaleVector2d(
+        origin_velocity - last_origin_velocity_, inverse_time_delta);
+    bottom_right_acceleration = gfx::ScaleVector2d(
+        bottom_right_velocity - last_bottom_right_velocity_,
+        inverse_time_delta);
+  }
+
+  float target_time = client_->GetSkewportTargetTimeInSeconds();
+  gfx::Vector2dF origin_displacement(
+      PredictEdgeDisplacement(
+          origin_velocity.x(), origin_acceleration.x(), target_time),
+      PredictEdgeDisplacement(
+          origin_velocity.y(), origin_acceleration.y(), target_time));
+  gfx::Vector2dF bottom_right_displacement(
+      PredictEdgeDisplacement(bottom_right_velocity.x(),
+                              bottom_right_acceleration.x(),
+                              target_time),
+      PredictEdgeDisplacement(bottom_right_velocity.y(),
+                              bottom_right_acceleration.y(),
+                              target_time));
+
+  gfx::Rect skewport = visible_rect_in_content_space;
+  skewport.Inset(origin_displacement.x(),
+                 origin_displacement.y(),
+                 -bottom_right_displacement.x(),
+                 -bottom_right_displacement.y());
+  skewport.Intersect(max_skewport);
+  skewport.Union(visible_rect_in_content_space);
+
+  // Content that raster can't get to before it becomes visible is not worth
+  // prioritizing, so scale the prediction down to what raster can produce in
+  // the target time.
+  float raster_throughput =
+      client_->GetRasterThroughputInContentPixelsPerSecond();
+  if (raster_throughput > 0.f) {
+    float predicted_area = static_cast<float>(skewport.size().GetArea()) -
+                           visible_rect_in_content_space.size().GetArea();
+    float raster_budget = raster_throughput * target_time;
+    if (predicted_area > raster_budget) {
+      float scale = raster_budget / predicted_area;
+      origin_displacement.Scale(scale);
+      bottom_right_displacement.Scale(scale);
+
+      skewport = visible_rect_in_content_space;
+      skewport.Inset(origin_displacement.x(),
+                     origin_displacement.y(),
+                     -bottom_right_displacement.x(),
+                     -bottom_right_displacement.y());
+      skewport.Intersect(max_skewport);
+      skewport.Union(visible_rect_in_content_space);
+    }
+  }
+  return skewport;
+}
+
+bool PictureLayerTiling::ComputeVisibleRectVelocity(
+    double current_frame_time_in_seconds,
+    const gfx::Rect& visible_rect_in_content_space,
+    gfx::Vector2dF* origin_velocity,
+    gfx::Vector2dF* bottom_right_velocity) const {
+  if (last_impl_frame_time_in_seconds_ == 0.0)
+    return false;
+  double time_delta =
+      current_frame_time_in_seconds - last_impl_frame_time_in_seconds_;
+  if (time_delta == 0.0)
+    return false;
+
+  float inverse_time_delta = 1.f / time_delta;
+  *origin_velocity = gfx::ScaleVector2d(
+      visible_rect_in_content_space.origin() -
+          last_visible_rect_in_content_space_.origin(),
+      inverse_time_delta);
+  *bottom_right_velocity = gfx::ScaleVector2d(
+      visible_rect_in_content_space.bottom_right() -
+          last_visible_rect_in_content_space_.bottom_right(),
+      inverse_time_delta);
+  return true;
+}
+
 void PictureLayerTiling::UpdateTilePriorities(
     WhichTree tree,
     const gfx::Rect& viewport_in_layer_space,
@@ -580,6 +715,11 @@ void PictureLayerTiling::UpdateTilePriorities(
 
   SetLiveTilesRect(eventually_rect);
 
+  has_last_visible_rect_velocity_ =
+      ComputeVisibleRectVelocity(current_frame_time_in_seconds,
+                                 visible_rect_in_content_space,
+                                 &last_origin_velocity_,
+                                 &last_bottom_right_velocity_);
   last_impl_frame_time_in_seconds_ = current_frame_time_in_seconds;
   last_viewport_in_layer_space_ = viewport_in_layer_space;
   last_visible_rect_in_content_space_ = visible_rect_in_content_space;
@@ -19,6 +19,7 @@
 #include "cc/resources/tile_priority.h"
 #include "cc/trees/occlusion.h"
 #include "ui/gfx/rect.h"
+#include "ui/gfx/vector2d_f.h"
 
 namespace base {
 namespace debug {
@@ -49,6 +50,12 @@ class CC_EXPORT PictureLayerTilingClient {
   virtual size_t GetMaxTilesForInterestArea() const = 0;
   virtual float GetSkewportTargetTimeInSeconds() const = 0;
   virtual int GetSkewportExtrapolationLimitInContentPixels() const = 0;
+  // When true, the skewport follows the acceleration of the visible rect as
+  // well as its velocity, and is limited to what can be rastered in time.
+  virtual bool UsePredictiveSkewport() const = 0;
+  // The number of content pixels that raster is currently producing per
+  // second, or zero if that isn't known.
+  virtual float GetRasterThroughputInContentPixelsPerSecond() const = 0;
   virtual WhichTree GetTree() const = 0;
 
  protected:
@@ -310,6 +317,25 @@ class CC_EXPORT PictureLayerTiling {
                             const gfx::Rect& visible_rect_in_content_space)
       const;
 
+  // Like the above, but extrapolates the movement of each edge of the visible
+  // rect from both its velocity and its acceleration, so that a decelerating
+  // scroll stops predicting past where it will come to rest. The skewport is
+  // also shrunk so that the content it adds can be rastered in time, given
+  // the client's raster throughput.
+  gfx::Rect ComputePredictiveSkewport(
+      double current_frame_time_in_seconds,
+      const gfx::Rect& visible_rect_in_content_space,
+      const gfx::Rect& max_skewport) const;
+
+  // Computes how fast the top left and bottom right corners of the visible
+  // rect have moved since the last update, in content pixels per second.
+  // Returns false if that isn't known.
+  bool ComputeVisibleRectVelocity(
+      double current_frame_time_in_seconds,
+      const gfx::Rect& visible_rect_in_content_space,
+      gfx::Vector2dF* origin_velocity,
+      gfx::Vector2dF* bottom_right_velocity) const;
+
   void UpdateEvictionCacheIfNeeded(TreePriority tree_priority);
   const std::vector<Tile*>* GetEvictionTiles(TreePriority tree_priority,
                                              EvictionCategory category);
@@ -334,6 +360,9 @@ class CC_EXPORT PictureLayerTiling {
   double last_impl_frame_time_in_seconds_;
   gfx::Rect last_viewport_in_layer_space_;
   gfx::Rect last_visible_rect_in_content_space_;
+  bool has_last_visible_rect_velocity_;
+  gfx::Vector2dF last_origin_velocity_;
+  gfx::Vector2dF last_bottom_right_velocity_;
 
   // Iteration rects in content space
   gfx::Rect current_visible_rect_;
@@ -210,6 +210,60 @@ TEST_F(PictureLayerTilingIteratorTest, ResizeDeletesTiles) {
   EXPECT_FALSE(tiling_->TileAt(0, 0));
 }
 
+TEST_F(PictureLayerTilingIteratorTest, InvalidatedTilesRememberPreviousTiles) {
+  Initialize(gfx::Size(100, 100), 1, gfx::Size(250, 250));
+  SetLiveRectAndVerifyTiles(gfx::Rect(250, 250));
+
+  Tile* untouched_tile = tiling_->TileAt(0, 0);
+  Tile::Id first_id = tiling_->TileAt(1, 1)->id();
+
+  gfx::Rect first_invalidation(120, 120, 10, 10);
+  tiling_->UpdateTilesToCurrentPile(Region(first_invalidation),
+                                    gfx::Size(250, 250));
+  EXPECT_EQ(untouched_tile, tiling_->TileAt(0, 0));
+  EXPECT_TRUE(untouched_tile->partial_raster_sources().empty());
+
+  Tile* tile = tiling_->TileAt(1, 1);
+  ASSERT_TRUE(tile);
+  Tile::Id second_id = tile->id();
+  EXPECT_NE(first_id, second_id);
+  ASSERT_EQ(1u, tile->partial_raster_sources().size());
+  EXPECT_EQ(first_id, tile->partial_raster_sources()[0].content_id);
+  gfx::Rect first_invalidated_rect =
+      tile->partial_raster_sources()[0].invalidated_content_rect;
+  EXPECT_TRUE(first_invalidated_rect.Contains(first_invalidation));
+  EXPECT_TRUE(tile->content_rect().Contains(first_invalidated_rect));
+
+  // The next tile can also be rastered from the first tile's content, as long
+  // as both invalidations are repainted.
+  gfx::Rect second_invalidation(170, 160, 5, 5);
+  tiling_->UpdateTilesToCurrentPile(Region(second_invalidation),
+                                    gfx::Size(250, 250));
+  tile = tiling_->TileAt(1, 1);
+  ASSERT_TRUE(tile);
+  Tile::Id third_id = tile->id();
+  ASSERT_EQ(2u, tile->partial_raster_sources().size());
+  EXPECT_EQ(second_id, tile->partial_raster_sources()[0].content_id);
+  EXPECT_TRUE(tile->partial_raster_sources()[0]
+                  .invalidated_content_rect.Contains(second_invalidation));
+  EXPECT_FALSE(tile->partial_raster_sources()[0]
+                   .invalidated_content_rect.Intersects(first_invalidation));
+  EXPECT_EQ(first_id, tile->partial_raster_sources()[1].content_id);
+  EXPECT_TRUE(tile->partial_raster_sources()[1]
+                  .invalidated_content_rect.Contains(first_invalidation));
+  EXPECT_TRUE(tile->partial_raster_sources()[1]
+                  .invalidated_content_rect.Contains(second_invalidation));
+
+  // Only the most recent tiles are remembered.
+  tiling_->UpdateTilesToCurrentPile(Region(second_invalidation),
+                                    gfx::Size(250, 250));
+  tile = tiling_->TileAt(1, 1);
+  ASSERT_TRUE(tile);
+  ASSERT_EQ(2u, tile->partial_raster_sources().size());
+  EXPECT_EQ(third_id, tile->partial_raster_sources()[0].content_id);
+  EXPECT_EQ(second_id, tile->partial_raster_sources()[1].content_id);
+}
+
 TEST_F(PictureLayerTilingIteratorTest, CreateMissingTilesStaysInsideLiveRect) {
   // The tiling has three rows and columns.
   Initialize(gfx::Size(100, 100), 1, gfx::Size(250, 250));
@@ -593,6 +647,77 @@ TEST(PictureLayerTilingTest, SkewportLimits) {
   EXPECT_TRUE(big_expand_skewport.Contains(gfx::Rect(-500, -500, 1500, 1500)));
 }
 
+TEST(PictureLayerTilingTest, PredictiveSkewportFollowsAcceleration) {
+  FakePictureLayerTilingClient client;
+  client.set_use_predictive_skewport(true);
+  client.set_tree(ACTIVE_TREE);
+  scoped_ptr<TestablePictureLayerTiling> tiling;
+
+  gfx::Size layer_bounds(100, 10000);
+  client.SetTileSize(gfx::Size(100, 100));
+  tiling = TestablePictureLayerTiling::Create(1.0f, layer_bounds, &client);
+
+  tiling->UpdateTilePriorities(
+      ACTIVE_TREE, gfx::Rect(0, 0, 100, 100), 1.f, 1.0, Occlusion());
+
+  // With only one previous viewport, the velocity is all that is known, so
+  // this is the same as the linear skewport. Moving down 100 pixels in 0.5
+  // seconds predicts 200 pixels of movement in a second.
+  gfx::Rect linear_skewport =
+      tiling->ComputeSkewport(1.5, gfx::Rect(0, 100, 100, 100));
+  EXPECT_EQ(gfx::Rect(0, 100, 100, 300).ToString(),
+            linear_skewport.ToString());
+
+  tiling->UpdateTilePriorities(
+      ACTIVE_TREE, gfx::Rect(0, 100, 100, 100), 1.f, 1.5, Occlusion());
+
+  // Slowing down from 200 to 100 pixels per second. The scroll comes to rest
+  // after another 0.5 seconds and 25 pixels, which is all that is predicted.
+  gfx::Rect decelerating_skewport =
+      tiling->ComputeSkewport(2.0, gfx::Rect(0, 150, 100, 100));
+  EXPECT_EQ(gfx::Rect(0, 150, 100, 125).ToString(),
+            decelerating_skewport.ToString());
+
+  // Speeding up from 200 to 300 pixels per second predicts 300 pixels from
+  // the velocity and another 100 from the acceleration.
+  gfx::Rect accelerating_skewport =
+      tiling->ComputeSkewport(2.0, gfx::Rect(0, 250, 100, 100));
+  EXPECT_EQ(gfx::Rect(0, 250, 100, 500).ToString(),
+            accelerating_skewport.ToString());
+
+  // Without the predictive skewport, both are extrapolated linearly.
+  client.set_use_predictive_skewport(false);
+  EXPECT_EQ(gfx::Rect(0, 150, 100, 200).ToString(),
+            tiling->ComputeSkewport(2.0, gfx::Rect(0, 150, 100, 100))
+                .ToString());
+}
+
+TEST(PictureLayerTilingTest, PredictiveSkewportLimitedByRasterThroughput) {
+  FakePictureLayerTilingClient client;
+  client.set_use_predictive_skewport(true);
+  client.set_tree(ACTIVE_TREE);
+  scoped_ptr<TestablePictureLayerTiling> tiling;
+
+  gfx::Size layer_bounds(100, 10000);
+  client.SetTileSize(gfx::Size(100, 100));
+  tiling = TestablePictureLayerTiling::Create(1.0f, layer_bounds, &client);
+
+  tiling->UpdateTilePriorities(
+      ACTIVE_TREE, gfx::Rect(0, 0, 100, 100), 1.f, 1.0, Occlusion());
+
+  // Moving 100 pixels per second would add 100x100 pixels to the skewport,
+  // but only half of that can be rastered in the one second target time.
+  client.set_raster_throughput_in_content_pixels_per_second(5000.f);
+  gfx::Rect skewport =
+      tiling->ComputeSkewport(1.5, gfx::Rect(0, 50, 100, 100));
+  EXPECT_EQ(gfx::Rect(0, 50, 100, 150).ToString(), skewport.ToString());
+
+  // Enough throughput doesn't limit the skewport.
+  client.set_raster_throughput_in_content_pixels_per_second(50000.f);
+  skewport = tiling->ComputeSkewport(1.5, gfx::Rect(0, 50, 100, 100));
+  EXPECT_EQ(gfx::Rect(0, 50, 100, 200).ToString(), skewport.ToString());
+}
+
 TEST(PictureLayerTilingTest, ComputeSkewport) {
   FakePictureLayerTilingClient client;
   scoped_ptr<TestablePictureLayerTiling> tiling;
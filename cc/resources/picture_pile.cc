@@ -226,7 +226,7 @@ bool PicturePile::UpdateAndExpandInvalidation(
     }
 
     for (size_t i = 0; i < to_erase.size(); ++i)
-      picture_map_.erase(to_erase[i]);
+      ErasePictureInfo(to_erase[i]);
 
     // If a recording is dropped and not re-recorded below, invalidate that
     // full recording to cause any raster tiles that would use it to be
@@ -421,16 +421,14 @@ bool PicturePile::UpdateAndExpandInvalidation(
           invalid_rect_outside_interest_rect_tiles);
 
       // Split this inflated invalidation across tile boundaries and apply it
-      // to all tiles that it touches.
-      bool include_borders = true;
-      for (TilingData::Iterator iter(&tiling_, invalid_rect, include_borders);
-           iter;
-           ++iter) {
-        const PictureMapKey& key = iter.index();
+      // to all recorded tiles that it touches (including borders).
+      std::vector<PictureMapKey> invalid_keys;
+      AppendPictureMapKeysInRect(invalid_rect, &invalid_keys);
+      for (size_t k = 0; k < invalid_keys.size(); ++k) {
+        const PictureMapKey& key = invalid_keys[k];
 
         PictureMap::iterator picture_it = picture_map_.find(key);
-        if (picture_it == picture_map_.end())
-          continue;
+        DCHECK(picture_it != picture_map_.end());
 
         // Inform the grid cell that it has been invalidated in this frame.
         updated = picture_it->second.Invalidate(frame_number) || updated;
@@ -454,7 +452,7 @@ bool PicturePile::UpdateAndExpandInvalidation(
   for (TilingData::Iterator it(&tiling_, interest_rect, include_borders); it;
        ++it) {
     const PictureMapKey& key = it.index();
-    PictureInfo& info = picture_map_[key];
+    PictureInfo& info = GetOrCreatePictureInfo(key);
 
     gfx::Rect rect = PaddedRect(key);
     int distance_to_visible =
@@ -535,7 +533,7 @@ bool PicturePile::UpdateAndExpandInvalidation(
       const PictureMapKey& key = it.index();
       gfx::Rect tile = PaddedRect(key);
       if (record_rect.Contains(tile)) {
-        PictureInfo& info = picture_map_[key];
+        PictureInfo& info = GetOrCreatePictureInfo(key);
         info.SetPicture(picture);
         found_tile_for_recorded_picture = true;
       }
@@ -551,7 +549,7 @@ bool PicturePile::UpdateAndExpandInvalidation(
 
 void PicturePile::SetEmptyBounds() {
   tiling_.SetTilingSize(gfx::Size());
-  picture_map_.clear();
+  ClearPictureMap();
   has_any_recordings_ = false;
   recorded_viewport_ = gfx::Rect();
 }
@@ -35,10 +35,36 @@ const bool kDefaultClearCanvasSetting = true;
 const float kInvalidationFrequencyThreshold = 0.75f;
 const int kFrequentInvalidationDistanceThreshold = 512;
 
+// Node sizes of the picture index. Indexed tiles never overlap, so small nodes
+// keep insertions cheap without hurting queries.
+const size_t kPictureIndexMinChildren = 2;
+const size_t kPictureIndexMaxChildren = 8;
+
+bool KeyIsAboveOrLeftOf(const std::pair<int, int>& a,
+                        const std::pair<int, int>& b) {
+  return a.second < b.second || (a.second == b.second && a.first < b.first);
+}
+
 }  // namespace
 
 namespace cc {
 
+// The index is only changed while a single pile holds it. It is shared with
+// the piles copied for the impl side, which read it on other threads.
+class PicturePileBase::PictureIndex
+    : public base::RefCountedThreadSafe<PictureIndex> {
+ public:
+  PictureIndex() : tree(kPictureIndexMinChildren, kPictureIndexMaxChildren) {}
+
+  gfx::RTree<PictureMapKey> tree;
+
+ private:
+  friend class base::RefCountedThreadSafe<PictureIndex>;
+  ~PictureIndex() {}
+
+  DISALLOW_COPY_AND_ASSIGN(PictureIndex);
+};
+
 PicturePileBase::PicturePileBase()
     : min_contents_scale_(0),
       background_color_(SkColorSetARGBInline(0, 0, 0, 0)),
@@ -51,7 +77,8 @@ PicturePileBase::PicturePileBase()
       has_text_(false),
       is_mask_(false),
       is_solid_color_(false),
-      solid_color_(SK_ColorTRANSPARENT) {
+      solid_color_(SK_ColorTRANSPARENT),
+      picture_index_(new PictureIndex) {
   tiling_.SetMaxTextureSize(gfx::Size(kBasePictureSize, kBasePictureSize));
   tile_grid_info_.fTileInterval.setEmpty();
   tile_grid_info_.fMargin.setEmpty();
@@ -75,7 +102,8 @@ PicturePileBase::PicturePileBase(const PicturePileBase* other)
       has_text_(other->has_text_),
       is_mask_(other->is_mask_),
       is_solid_color_(other->is_solid_color_),
-      solid_color_(other->solid_color_) {
+      solid_color_(other->solid_color_),
+      picture_index_(other->picture_index_) {
 }
 
 PicturePileBase::~PicturePileBase() {
@@ -131,10 +159,99 @@ void PicturePileBase::SetBufferPixels(int new_buffer_pixels) {
 }
 
 void PicturePileBase::Clear() {
-  picture_map_.clear();
+  ClearPictureMap();
   recorded_viewport_ = gfx::Rect();
 }
 
+PicturePileBase::PictureInfo& PicturePileBase::GetOrCreatePictureInfo(
+    const PictureMapKey& key) {
+  PictureMap::iterator it = picture_map_.find(key);
+  if (it != picture_map_.end())
+    return it->second;
+  MutablePictureIndex()->Insert(gfx::Rect(key.first, key.second, 1, 1), key);
+  return picture_map_[key];
+}
+
+void PicturePileBase::ErasePictureInfo(const PictureMapKey& key) {
+  PictureMap::iterator it = picture_map_.find(key);
+  if (it == picture_map_.end())
+    return;
+  MutablePictureIndex()->Remove(key);
+  picture_map_.erase(it);
+}
+
+void PicturePileBase::ClearPictureMap() {
+  picture_map_.clear();
+  if (picture_index_->HasOneRef())
+    picture_index_->tree.Clear();
+  else
+    picture_index_ = new PictureIndex;
+}
+
+gfx::RTree<PicturePileBase::PictureMapKey>*
+PicturePileBase::MutablePictureIndex() {
+  if (picture_index_->HasOneRef())
+    return &picture_index_->tree;
+
+  // The other piles keep the index as it was, which still matches the map.
+  scoped_refptr<PictureIndex> index = new PictureIndex;
+  for (PictureMap::const_iterator it = picture_map_.begin();
+       it != picture_map_.end();
+       ++it) {
+    const PictureMapKey& key = it->first;
+    index->tree.Insert(gfx::Rect(key.first, key.second, 1, 1), key);
+  }
+  picture_index_ = index;
+  return &picture_index_->tree;
+}
+
+void PicturePileBase::AppendPictureMapKeysInRect(
+    const gfx::Rect& layer_rect,
+    std::vector<PictureMapKey>* keys) const {
+  DCHECK(keys);
+  if (picture_map_.empty())
+    return;
+  if (tiling_.num_tiles_x() <= 0 || tiling_.num_tiles_y() <= 0)
+    return;
+
+  gfx::Rect rect = layer_rect;
+  rect.Intersect(gfx::Rect(tiling_.tiling_size()));
+  if (rect.IsEmpty())
+    return;
+
+  // These are the same tiles that a TilingData::Iterator including borders
+  // would visit.
+  int left = tiling_.FirstBorderTileXIndexFromSrcCoord(rect.x());
+  int top = tiling_.FirstBorderTileYIndexFromSrcCoord(rect.y());
+  int right = tiling_.LastBorderTileXIndexFromSrcCoord(rect.right() - 1);
+  int bottom = tiling_.LastBorderTileYIndexFromSrcCoord(rect.bottom() - 1);
+
+  // When the rect covers no more tiles than there are entries (e.g. a single
+  // raster tile), probing the map directly is cheaper than a tree query. For
+  // large rects over sparsely recorded piles (e.g. invalidations on very tall
+  // pages, where only the area around the viewport is recorded), the index
+  // only visits the entries that actually exist.
+  size_t num_tiles = static_cast<size_t>(right - left + 1) *
+                     static_cast<size_t>(bottom - top + 1);
+  if (num_tiles <= picture_map_.size()) {
+    for (int y = top; y <= bottom; ++y) {
+      for (int x = left; x <= right; ++x) {
+        PictureMapKey key(x, y);
+        if (picture_map_.find(key) != picture_map_.end())
+          keys->push_back(key);
+      }
+    }
+    return;
+  }
+
+  gfx::RTree<PictureMapKey>::Matches matches;
+  picture_index_->tree.AppendIntersectingRecords(
+      gfx::Rect(left, top, right - left + 1, bottom - top + 1), &matches);
+  size_t first_new_key = keys->size();
+  keys->insert(keys->end(), matches.begin(), matches.end());
+  std::sort(keys->begin() + first_new_key, keys->end(), KeyIsAboveOrLeftOf);
+}
+
 bool PicturePileBase::HasRecordingAt(int x, int y) {
   PictureMap::const_iterator found = picture_map_.find(PictureMapKey(x, y));
   if (found == picture_map_.end())
@@ -8,6 +8,7 @@
 #include <bitset>
 #include <list>
 #include <utility>
+#include <vector>
 
 #include "base/containers/hash_tables.h"
 #include "base/memory/ref_counted.h"
@@ -15,6 +16,7 @@
 #include "cc/base/region.h"
 #include "cc/base/tiling_data.h"
 #include "cc/resources/picture.h"
+#include "ui/gfx/geometry/r_tree.h"
 #include "ui/gfx/size.h"
 
 namespace base {
@@ -108,8 +110,22 @@ class CC_EXPORT PicturePileBase : public base::RefCounted<PicturePileBase> {
   // using the recorded_viewport hint.
   bool CanRasterSlowTileCheck(const gfx::Rect& layer_rect) const;
 
+  // Returns the picture info for |key|, adding an empty one to the picture map
+  // if there is none yet.
+  PictureInfo& GetOrCreatePictureInfo(const PictureMapKey& key);
+  void ErasePictureInfo(const PictureMapKey& key);
+  void ClearPictureMap();
+
+  // Appends the keys of all picture map entries whose tile bounds (including
+  // borders) intersect |layer_rect| to |keys|. Keys are appended top to bottom,
+  // then left to right, which matches the order of a TilingData::Iterator
+  // that includes borders.
+  void AppendPictureMapKeysInRect(const gfx::Rect& layer_rect,
+                                  std::vector<PictureMapKey>* keys) const;
+
   // A picture pile is a tiled set of pictures. The picture map is a map of tile
-  // indices to picture infos.
+  // indices to picture infos. Entries must only be added or removed through
+  // the functions above so that |picture_index_| stays in sync.
   PictureMap picture_map_;
   TilingData tiling_;
   gfx::Rect recorded_viewport_;
@@ -130,7 +146,19 @@ class CC_EXPORT PicturePileBase : public base::RefCounted<PicturePileBase> {
   SkColor solid_color_;
 
  private:
+  class PictureIndex;
+
   void SetBufferPixels(int buffer_pixels);
+  // Returns the tree of |picture_index_|, after giving this pile its own copy
+  // if the index is shared with another pile.
+  gfx::RTree<PictureMapKey>* MutablePictureIndex();
+
+  // Spatial index over the keys of |picture_map_|, so that finding the
+  // entries in a rect doesn't need to probe every tile it covers. Each entry
+  // is indexed by its tile indices (as a 1x1 rect) rather than its layer rect,
+  // so the index remains valid when the tiling geometry changes. A pile copied
+  // from another shares its index until one of them changes its picture map.
+  scoped_refptr<PictureIndex> picture_index_;
 
   friend class base::RefCounted<PicturePileBase>;
   DISALLOW_COPY_AND_ASSIGN(PicturePileBase);
@@ -4,6 +4,7 @@
 
 #include <algorithm>
 #include <limits>
+#include <vector>
 
 #include "base/debug/trace_event.h"
 #include "cc/base/region.h"
@@ -66,9 +67,53 @@ void PicturePileImpl::RasterToBitmap(
     float contents_scale,
     RenderingStatsInstrumentation* rendering_stats_instrumentation) const {
   canvas->discard();
+  RasterRectToBitmap(canvas,
+                     canvas_rect,
+                     canvas_rect,
+                     contents_scale,
+                     rendering_stats_instrumentation);
+}
+
+void PicturePileImpl::RasterInvalidationToBitmap(
+    SkCanvas* canvas,
+    const gfx::Rect& canvas_rect,
+    const gfx::Rect& invalidated_rect,
+    float contents_scale,
+    RenderingStatsInstrumentation* rendering_stats_instrumentation) const {
+  gfx::Rect raster_rect = gfx::IntersectRects(canvas_rect, invalidated_rect);
+  if (raster_rect.IsEmpty())
+    return;
+
+  canvas->save();
+  canvas->clipRect(
+      gfx::RectToSkRect(raster_rect - canvas_rect.OffsetFromOrigin()),
+      SkRegion::kIntersect_Op);
+  RasterRectToBitmap(canvas,
+                     canvas_rect,
+                     raster_rect,
+                     contents_scale,
+                     rendering_stats_instrumentation);
+  canvas->restore();
+}
+
+void PicturePileImpl::RasterRectToBitmap(
+    SkCanvas* canvas,
+    const gfx::Rect& canvas_rect,
+    const gfx::Rect& raster_rect,
+    float contents_scale,
+    RenderingStatsInstrumentation* rendering_stats_instrumentation) const {
+  // SkCanvas::clear() ignores the clip, so when only part of the canvas is
+  // rastered it has to be cleared by drawing instead.
+  bool raster_whole_canvas = raster_rect == canvas_rect;
+
   if (clear_canvas_with_debug_color_) {
     // Any non-painted areas in the content bounds will be left in this color.
-    canvas->clear(DebugColors::NonPaintedFillColor());
+    if (raster_whole_canvas) {
+      canvas->clear(DebugColors::NonPaintedFillColor());
+    } else {
+      canvas->drawColor(DebugColors::NonPaintedFillColor(),
+                        SkXfermode::kSrc_Mode);
+    }
   }
 
   // If this picture has opaque contents, it is guaranteeing that it will
@@ -87,7 +132,7 @@ void PicturePileImpl::RasterToBitmap(
     // covered by content.
     gfx::Rect deflated_content_tiling_rect = content_tiling_rect;
     deflated_content_tiling_rect.Inset(0, 0, 1, 1);
-    if (!deflated_content_tiling_rect.Contains(canvas_rect)) {
+    if (!deflated_content_tiling_rect.Contains(raster_rect)) {
       if (clear_canvas_with_debug_color_) {
         // Any non-painted areas outside of the content bounds are left in
         // this color.  If this is seen then it means that cc neglected to
@@ -103,23 +148,26 @@ void PicturePileImpl::RasterToBitmap(
       }
 
       // Drawing at most 2 x 2 x (canvas width + canvas height) texels is 2-3X
-      // faster than clearing, so special case this.
+      // faster than clearing, so special case this. The clip is intersected
+      // rather than replaced so that a partial raster stays inside its rect.
       canvas->save();
       canvas->translate(-canvas_rect.x(), -canvas_rect.y());
       gfx::Rect inflated_content_tiling_rect = content_tiling_rect;
       inflated_content_tiling_rect.Inset(0, 0, -1, -1);
       canvas->clipRect(gfx::RectToSkRect(inflated_content_tiling_rect),
-                       SkRegion::kReplace_Op);
+                       SkRegion::kIntersect_Op);
       canvas->clipRect(gfx::RectToSkRect(deflated_content_tiling_rect),
                        SkRegion::kDifference_Op);
       canvas->drawColor(background_color_, SkXfermode::kSrc_Mode);
       canvas->restore();
     }
-  } else {
+  } else if (raster_whole_canvas) {
     TRACE_EVENT_INSTANT0("cc", "SkCanvas::clear", TRACE_EVENT_SCOPE_THREAD);
     // Clearing is about ~4x faster than drawing a rect even if the content
     // isn't covering a majority of the canvas.
     canvas->clear(SK_ColorTRANSPARENT);
+  } else {
+    canvas->drawColor(SK_ColorTRANSPARENT, SkXfermode::kSrc_Mode);
   }
 
   RasterCommon(canvas,
@@ -160,13 +208,12 @@ void PicturePileImpl::CoalesceRasters(const gfx::Rect& canvas_rect,
   // that and subtract chunk rects to get the region that we need to subtract
   // from the canvas. Then, we can use clipRect with difference op to subtract
   // each rect in the region.
-  bool include_borders = true;
-  for (TilingData::Iterator tile_iter(&tiling_, layer_rect, include_borders);
-       tile_iter;
-       ++tile_iter) {
-    PictureMap::const_iterator map_iter = picture_map_.find(tile_iter.index());
-    if (map_iter == picture_map_.end())
-      continue;
+  std::vector<PictureMapKey> keys;
+  AppendPictureMapKeysInRect(layer_rect, &keys);
+  for (size_t k = 0; k < keys.size(); ++k) {
+    const PictureMapKey& key = keys[k];
+    PictureMap::const_iterator map_iter = picture_map_.find(key);
+    DCHECK(map_iter != picture_map_.end());
     const PictureInfo& info = map_iter->second;
     const Picture* picture = info.GetPicture();
     if (!picture)
@@ -177,7 +224,7 @@ void PicturePileImpl::CoalesceRasters(const gfx::Rect& canvas_rect,
     // of the picture chunk's layer rect.  The min_contents_scale enforces that
     // enough buffer pixels have been added such that the enclosed rect
     // encompasses all invalidated pixels at any larger scale level.
-    gfx::Rect chunk_rect = PaddedRect(tile_iter.index());
+    gfx::Rect chunk_rect = PaddedRect(key);
     gfx::Rect content_clip =
         gfx::ScaleToEnclosedRect(chunk_rect, contents_scale);
     DCHECK(!content_clip.IsEmpty()) << "Layer rect: "
@@ -185,21 +232,21 @@ void PicturePileImpl::CoalesceRasters(const gfx::Rect& canvas_rect,
                                     << "Contents scale: " << contents_scale;
     content_clip.Intersect(canvas_rect);
 
-    // Make sure iterator goes top->bottom.
-    DCHECK_GE(tile_iter.index_y(), last_row_index);
-    if (tile_iter.index_y() > last_row_index) {
+    // Make sure keys go top->bottom.
+    DCHECK_GE(key.second, last_row_index);
+    if (key.second > last_row_index) {
       // First tile in a new row.
       min_content_left = content_clip.x();
       min_content_top = last_content_rect.bottom();
     } else {
-      // Make sure iterator goes left->right.
-      DCHECK_GT(tile_iter.index_x(), last_col_index);
+      // Make sure keys go left->right.
+      DCHECK_GT(key.first, last_col_index);
       min_content_left = last_content_rect.right();
       min_content_top = last_content_rect.y();
     }
 
-    last_col_index = tile_iter.index_x();
-    last_row_index = tile_iter.index_y();
+    last_col_index = key.first;
+    last_row_index = key.second;
 
     // Only inset if the content_clip is less than then previous min.
     int inset_left = std::max(0, min_content_left - content_clip.x());
@@ -48,6 +48,16 @@ class CC_EXPORT PicturePileImpl : public PicturePileBase {
       float contents_scale,
       RenderingStatsInstrumentation* stats_instrumentation) const;
 
+  // Like RasterToBitmap, but only repaints |invalidated_rect| (in the same
+  // space as |canvas_rect|). The rest of the canvas is left untouched, so it
+  // must already hold valid content for |canvas_rect|.
+  void RasterInvalidationToBitmap(
+      SkCanvas* canvas,
+      const gfx::Rect& canvas_rect,
+      const gfx::Rect& invalidated_rect,
+      float contents_scale,
+      RenderingStatsInstrumentation* stats_instrumentation) const;
+
   // Called when analyzing a tile. We can use AnalysisCanvas as
   // SkDrawPictureCallback, which allows us to early out from analysis.
   void RasterForAnalysis(
@@ -116,6 +126,14 @@ class CC_EXPORT PicturePileImpl : public PicturePileBase {
                        float contents_scale,
                        PictureRegionMap* result) const;
 
+  // Clears |raster_rect|, a subrect of |canvas_rect|, and rasters into it.
+  void RasterRectToBitmap(
+      SkCanvas* canvas,
+      const gfx::Rect& canvas_rect,
+      const gfx::Rect& raster_rect,
+      float contents_scale,
+      RenderingStatsInstrumentation* stats_instrumentation) const;
+
   void RasterCommon(
       SkCanvas* canvas,
       SkDrawPictureCallback* callback,
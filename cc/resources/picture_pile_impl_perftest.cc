@@ -20,6 +20,19 @@ const int kTimeCheckInterval = 10;
 const int kTileSize = 100;
 const int kLayerSize = 1000;
 
+// A very tall page where, like in a PicturePile, only the area around the
+// viewport is recorded.
+const int kTallLayerHeight = 1000000;
+const int kTallLayerRecordedTop = kTallLayerHeight / 2 - 8000;
+const int kTallLayerRecordedHeight = 16000;
+
+// Content rect of one tile, centered on the recorded part of the tall page.
+gfx::Rect TallPageContentRect(float contents_scale) {
+  int center_y = static_cast<int>(
+      (kTallLayerRecordedTop + kTallLayerRecordedHeight / 2) * contents_scale);
+  return gfx::Rect(0, center_y - kTileSize / 2, kTileSize, kTileSize);
+}
+
 class PicturePileImplPerfTest : public testing::Test {
  public:
   PicturePileImplPerfTest()
@@ -68,6 +81,61 @@ class PicturePileImplPerfTest : public testing::Test {
         "raster", "", test_name, timer_.LapsPerSecond(), "runs/s", true);
   }
 
+  scoped_refptr<FakePicturePileImpl> CreateTallPile() {
+    scoped_refptr<FakePicturePileImpl> pile =
+        FakePicturePileImpl::CreateEmptyPile(
+            gfx::Size(kTileSize, kTileSize),
+            gfx::Size(kLayerSize, kTallLayerHeight));
+    const TilingData& tiling = pile->tiling();
+    int first_row = tiling.TileYIndexFromSrcCoord(kTallLayerRecordedTop);
+    int last_row = tiling.TileYIndexFromSrcCoord(kTallLayerRecordedTop +
+                                                 kTallLayerRecordedHeight - 1);
+    for (int y = first_row; y <= last_row; ++y) {
+      for (int x = 0; x < tiling.num_tiles_x(); ++x)
+        pile->AddRecordingAt(x, y);
+    }
+    return pile;
+  }
+
+  void RunAnalyzeTallPageTest(const std::string& test_name,
+                              float contents_scale) {
+    scoped_refptr<FakePicturePileImpl> pile = CreateTallPile();
+    gfx::Rect content_rect = TallPageContentRect(contents_scale);
+
+    PicturePileImpl::Analysis analysis;
+    timer_.Reset();
+    do {
+      pile->AnalyzeInRect(content_rect, contents_scale, &analysis);
+      timer_.NextLap();
+    } while (!timer_.HasTimeLimitExpired());
+
+    perf_test::PrintResult(
+        "analyze_tall", "", test_name, timer_.LapsPerSecond(), "runs/s", true);
+  }
+
+  void RunRasterTallPageTest(const std::string& test_name,
+                             float contents_scale) {
+    scoped_refptr<FakePicturePileImpl> pile = CreateTallPile();
+    gfx::Rect content_rect = TallPageContentRect(contents_scale);
+
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(1, 1);
+    SkCanvas canvas(bitmap);
+
+    FakeRenderingStatsInstrumentation rendering_stats_instrumentation;
+    timer_.Reset();
+    do {
+      pile->RasterToBitmap(&canvas,
+                           content_rect,
+                           contents_scale,
+                           &rendering_stats_instrumentation);
+      timer_.NextLap();
+    } while (!timer_.HasTimeLimitExpired());
+
+    perf_test::PrintResult(
+        "raster_tall", "", test_name, timer_.LapsPerSecond(), "runs/s", true);
+  }
+
  private:
   LapTimer timer_;
 };
@@ -84,5 +152,19 @@ TEST_F(PicturePileImplPerfTest, Raster) {
   RunRasterTest("100", 0.1f);
 }
 
+TEST_F(PicturePileImplPerfTest, AnalyzeTallPage) {
+  RunAnalyzeTallPageTest("1", 1.0f);
+  RunAnalyzeTallPageTest("100", 0.1f);
+  RunAnalyzeTallPageTest("10000", 0.01f);
+  RunAnalyzeTallPageTest("1000000", 0.001f);
+}
+
+TEST_F(PicturePileImplPerfTest, RasterTallPage) {
+  RunRasterTallPageTest("1", 1.0f);
+  RunRasterTallPageTest("100", 0.1f);
+  RunRasterTallPageTest("10000", 0.01f);
+  RunRasterTallPageTest("1000000", 0.001f);
+}
+
 }  // namespace
 }  // namespace cc
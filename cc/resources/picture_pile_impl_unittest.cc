@@ -748,6 +748,47 @@ TEST(PicturePileImpl, RasterContentsTransparent) {
   }
 }
 
+TEST(PicturePileImpl, RasterInvalidationLeavesRestOfCanvas) {
+  gfx::Size tile_size(100, 100);
+  gfx::Size layer_bounds(50, 50);
+  SkColor old_color = SK_ColorRED;
+  SkColor new_color = SkColorSetARGB(255, 45, 56, 67);
+
+  scoped_refptr<FakePicturePileImpl> pile =
+      FakePicturePileImpl::CreateFilledPile(tile_size, layer_bounds);
+  pile->set_background_color(SK_ColorTRANSPARENT);
+  pile->set_contents_opaque(false);
+  pile->set_clear_canvas_with_debug_color(false);
+  SkPaint paint;
+  paint.setColor(new_color);
+  pile->add_draw_rect_with_paint(gfx::RectF(layer_bounds), paint);
+  pile->RerecordPile();
+
+  // The canvas holds content for the whole rect already.
+  gfx::Rect canvas_rect(layer_bounds);
+  SkBitmap bitmap;
+  bitmap.allocN32Pixels(canvas_rect.width(), canvas_rect.height());
+  bitmap.eraseColor(old_color);
+  SkCanvas canvas(bitmap);
+
+  gfx::Rect invalidated_rect(10, 20, 15, 5);
+  FakeRenderingStatsInstrumentation rendering_stats_instrumentation;
+  pile->RasterInvalidationToBitmap(&canvas,
+                                   canvas_rect,
+                                   invalidated_rect,
+                                   1.f,
+                                   &rendering_stats_instrumentation);
+
+  for (int y = 0; y < bitmap.height(); y++) {
+    for (int x = 0; x < bitmap.width(); x++) {
+      SkColor expected_color =
+          invalidated_rect.Contains(x, y) ? new_color : old_color;
+      EXPECT_EQ(expected_color, bitmap.getColor(x, y)) << "x: " << x
+                                                       << ", y: " << y;
+    }
+  }
+}
+
 class OverlapTest : public ::testing::TestWithParam<float> {
  public:
   static float MinContentsScale() { return 1.f / 4.f; }
@@ -4,8 +4,10 @@
 
 #include <map>
 #include <utility>
+#include <vector>
 
 #include "cc/resources/picture_pile.h"
+#include "cc/resources/picture_pile_impl.h"
 #include "cc/test/fake_content_layer_client.h"
 #include "cc/test/fake_rendering_stats_instrumentation.h"
 #include "testing/gtest/include/gtest/gtest.h"
@@ -17,6 +19,7 @@ namespace {
 
 class TestPicturePile : public PicturePile {
  public:
+  using PicturePile::AppendPictureMapKeysInRect;
   using PicturePile::buffer_pixels;
   using PicturePile::CanRasterSlowTileCheck;
   using PicturePile::Clear;
@@ -36,6 +39,17 @@ class TestPicturePile : public PicturePile {
     virtual ~TestPicturePile() {}
 };
 
+class TestPicturePileImpl : public PicturePileImpl {
+ public:
+  explicit TestPicturePileImpl(const PicturePileBase* other)
+      : PicturePileImpl(other) {}
+
+  using PicturePileImpl::AppendPictureMapKeysInRect;
+
+ protected:
+  virtual ~TestPicturePileImpl() {}
+};
+
 class PicturePileTestBase {
  public:
   PicturePileTestBase()
@@ -436,6 +450,95 @@ TEST_F(PicturePileTest, FrequentInvalidationCanRaster) {
   EXPECT_FALSE(pile_->CanRasterSlowTileCheck(tile02_noborders));
 }
 
+TEST_F(PicturePileTest, PictureMapKeysInRectOnTallPile) {
+  gfx::Size tile_size(100, 100);
+  pile_->tiling().SetMaxTextureSize(tile_size);
+  pile_->SetPixelRecordDistanceForTesting(1000);
+
+  // Only the tiles around the viewport get an entry in the picture map.
+  gfx::Size tall_tiling_size(400, 100000);
+  gfx::Rect viewport(0, 50000, 400, 400);
+  Region invalidation;
+  UpdateAndExpandInvalidation(&invalidation, tall_tiling_size, viewport);
+  EXPECT_LT(pile_->picture_map().size(),
+            static_cast<size_t>(pile_->tiling().num_tiles_x() *
+                                pile_->tiling().num_tiles_y()));
+
+  gfx::Rect query_rects[] = {
+      gfx::Rect(tall_tiling_size),
+      gfx::Rect(0, 40000, 400, 20000),
+      gfx::Rect(150, 49050, 100, 900),
+      gfx::Rect(0, 0, 400, 1000),
+  };
+  for (size_t i = 0; i < arraysize(query_rects); ++i) {
+    std::vector<TestPicturePile::PictureMapKey> expected_keys;
+    bool include_borders = true;
+    for (TilingData::Iterator iter(
+             &pile_->tiling(), query_rects[i], include_borders);
+         iter;
+         ++iter) {
+      if (pile_->picture_map().count(iter.index()))
+        expected_keys.push_back(iter.index());
+    }
+
+    std::vector<TestPicturePile::PictureMapKey> keys;
+    pile_->AppendPictureMapKeysInRect(query_rects[i], &keys);
+    EXPECT_TRUE(expected_keys == keys) << query_rects[i].ToString();
+  }
+
+  // Invalidating most of the page only drops the recordings that exist, and
+  // re-records the viewport.
+  invalidation = gfx::Rect(0, 1000, 400, 98000);
+  UpdateAndExpandInvalidation(&invalidation, tall_tiling_size, viewport);
+  for (TestPicturePile::PictureMap::iterator it = pile_->picture_map().begin();
+       it != pile_->picture_map().end();
+       ++it) {
+    EXPECT_TRUE(it->second.GetPicture());
+  }
+  EXPECT_TRUE(pile_->CanRasterSlowTileCheck(viewport));
+}
+
+TEST_F(PicturePileTest, CopiedPileKeepsPictureMapKeys) {
+  gfx::Size tile_size(100, 100);
+  pile_->tiling().SetMaxTextureSize(tile_size);
+  pile_->SetPixelRecordDistanceForTesting(1000);
+
+  gfx::Size tall_tiling_size(400, 100000);
+  gfx::Rect viewport(0, 50000, 400, 400);
+  Region invalidation;
+  UpdateAndExpandInvalidation(&invalidation, tall_tiling_size, viewport);
+
+  scoped_refptr<TestPicturePileImpl> copy =
+      make_scoped_refptr(new TestPicturePileImpl(pile_.get()));
+  std::vector<TestPicturePile::PictureMapKey> copied_keys;
+  copy->AppendPictureMapKeysInRect(gfx::Rect(tall_tiling_size), &copied_keys);
+  EXPECT_FALSE(copied_keys.empty());
+
+  // Recording somewhere else adds entries to the pile's picture map, but not
+  // to the copy's.
+  viewport = gfx::Rect(0, 10000, 400, 400);
+  invalidation = Region();
+  UpdateAndExpandInvalidation(&invalidation, tall_tiling_size, viewport);
+
+  std::vector<TestPicturePile::PictureMapKey> keys;
+  copy->AppendPictureMapKeysInRect(gfx::Rect(tall_tiling_size), &keys);
+  EXPECT_TRUE(copied_keys == keys);
+
+  std::vector<TestPicturePile::PictureMapKey> expected_keys;
+  bool include_borders = true;
+  for (TilingData::Iterator iter(
+           &pile_->tiling(), gfx::Rect(tall_tiling_size), include_borders);
+       iter;
+       ++iter) {
+    if (pile_->picture_map().count(iter.index()))
+      expected_keys.push_back(iter.index());
+  }
+  keys.clear();
+  pile_->AppendPictureMapKeysInRect(gfx::Rect(tall_tiling_size), &keys);
+  EXPECT_TRUE(expected_keys == keys);
+  EXPECT_FALSE(copied_keys == keys);
+}
+
 TEST_F(PicturePileTest, NoInvalidationValidViewport) {
   // This test validates that the recorded_viewport cache of full tiles
   // is still valid for some use cases.  If it's not, it's a performance
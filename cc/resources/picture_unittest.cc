@@ -20,6 +20,20 @@
 namespace cc {
 namespace {
 
+// Rasters |layer_rect| of |picture| into |buffer|, which is the size of
+// |layer_rect|.
+void RasterLayerRect(unsigned char* buffer,
+                     const gfx::Rect& layer_rect,
+                     scoped_refptr<Picture> picture) {
+  SkImageInfo info =
+      SkImageInfo::MakeN32Premul(layer_rect.width(), layer_rect.height());
+  SkBitmap bitmap;
+  bitmap.installPixels(info, buffer, info.minRowBytes());
+  SkCanvas canvas(bitmap);
+  canvas.translate(-layer_rect.x(), -layer_rect.y());
+  picture->Raster(&canvas, NULL, Region(), 1.0f);
+}
+
 TEST(PictureTest, AsBase64String) {
   SkGraphics::Init();
 
@@ -45,8 +59,9 @@ TEST(PictureTest, AsBase64String) {
       Picture::CreateFromValue(tmp.get());
   EXPECT_FALSE(invalid_picture.get());
 
-  Picture::RecordingMode kRecordingModes[] = {Picture::RECORD_NORMALLY,
-                                              Picture::RECORD_WITH_SKRECORD};
+  Picture::RecordingMode kRecordingModes[] = {
+      Picture::RECORD_NORMALLY, Picture::RECORD_WITH_SKRECORD,
+      Picture::RECORD_WITH_DISPLAY_LIST};
 
   // Single full-size rect picture.
   content_layer_client.add_draw_rect(layer_rect, red_paint);
@@ -384,6 +399,70 @@ TEST(PictureTest, PixelRefIteratorOnePixelQuery) {
   }
 }
 
+TEST(PictureTest, DisplayListMatchesRecordedPicture) {
+  gfx::Rect layer_rect(100, 200, 100, 100);
+
+  SkTileGridFactory::TileGridInfo tile_grid_info;
+  tile_grid_info.fTileInterval = SkISize::Make(100, 100);
+  tile_grid_info.fMargin.setEmpty();
+  tile_grid_info.fOffset.setZero();
+
+  FakeContentLayerClient content_layer_client;
+  SkPaint red_paint;
+  red_paint.setColor(SkColorSetARGB(255, 255, 0, 0));
+  SkPaint green_paint;
+  green_paint.setColor(SkColorSetARGB(255, 0, 255, 0));
+  content_layer_client.add_draw_rect(gfx::Rect(90, 190, 40, 40), red_paint);
+  content_layer_client.add_draw_rect(gfx::Rect(150, 250, 30, 60), green_paint);
+  // Entirely outside of the layer rect.
+  content_layer_client.add_draw_rect(gfx::Rect(0, 0, 50, 50), green_paint);
+
+  SkBitmap discardable_bitmap;
+  CreateBitmap(gfx::Size(20, 20), "discardable", &discardable_bitmap);
+  content_layer_client.add_draw_bitmap(
+      discardable_bitmap, gfx::Point(160, 210), SkPaint());
+
+  scoped_refptr<Picture> picture = Picture::Create(layer_rect,
+                                                   &content_layer_client,
+                                                   tile_grid_info,
+                                                   true,
+                                                   Picture::RECORD_NORMALLY);
+  scoped_refptr<Picture> display_list_picture =
+      Picture::Create(layer_rect,
+                      &content_layer_client,
+                      tile_grid_info,
+                      true,
+                      Picture::RECORD_WITH_DISPLAY_LIST);
+
+  EXPECT_EQ(picture->HasText(), display_list_picture->HasText());
+  EXPECT_TRUE(display_list_picture->WillPlayBackBitmaps());
+
+  unsigned char buffer[4 * 100 * 100] = {0};
+  RasterLayerRect(buffer, layer_rect, picture);
+  // Sanity check that something was drawn.
+  unsigned char empty_buffer[4 * 100 * 100] = {0};
+  EXPECT_NE(0, memcmp(buffer, empty_buffer, 4 * 100 * 100));
+  unsigned char display_list_buffer[4 * 100 * 100] = {0};
+  RasterLayerRect(display_list_buffer, layer_rect, display_list_picture);
+  EXPECT_EQ(0, memcmp(buffer, display_list_buffer, 4 * 100 * 100));
+
+  // Pixel refs are found in the same place as in the recorded picture.
+  Picture::PixelRefIterator iterator(gfx::Rect(150, 200, 50, 50),
+                                     display_list_picture.get());
+  EXPECT_TRUE(iterator);
+  EXPECT_TRUE(*iterator == discardable_bitmap.pixelRef());
+  EXPECT_FALSE(++iterator);
+
+  // Serializing flattens the display list into an equivalent picture.
+  scoped_ptr<base::Value> value = display_list_picture->AsValue();
+  scoped_refptr<Picture> display_list_picture_check =
+      Picture::CreateFromValue(value.get());
+  ASSERT_TRUE(display_list_picture_check.get());
+  unsigned char check_buffer[4 * 100 * 100] = {0};
+  RasterLayerRect(check_buffer, layer_rect, display_list_picture_check);
+  EXPECT_EQ(0, memcmp(buffer, check_buffer, 4 * 100 * 100));
+}
+
 TEST(PictureTest, CreateFromSkpValue) {
   SkGraphics::Init();
 
@@ -487,7 +566,17 @@ TEST(PictureTest, RecordingModes) {
   EXPECT_TRUE(content_layer_client.last_canvas() != NULL);
   EXPECT_TRUE(picture.get());
 
-  EXPECT_EQ(4, Picture::RECORDING_MODE_COUNT);
+  picture = Picture::Create(layer_rect,
+                            &content_layer_client,
+                            tile_grid_info,
+                            false,
+                            Picture::RECORD_WITH_DISPLAY_LIST);
+  EXPECT_EQ(ContentLayerClient::GRAPHICS_CONTEXT_ENABLED,
+            content_layer_client.last_context_status());
+  EXPECT_TRUE(picture.get());
+  EXPECT_TRUE(picture->HasRecording());
+
+  EXPECT_EQ(5, Picture::RECORDING_MODE_COUNT);
 }
 
 }  // namespace
@@ -47,12 +47,23 @@ bool TilePriorityTieBreaker(const Tile* tile_i, const Tile* tile_j) {
 
 typedef std::vector<Tile*> TileVector;
 
-void SortBinTiles(ManagedTileBin bin, TileVector* tiles) {
+template <typename Comparator>
+void SortTailAndMerge(size_t sorted_count,
+                      TileVector* tiles,
+                      Comparator comparator) {
+  TileVector::iterator middle = tiles->begin() + sorted_count;
+  std::sort(middle, tiles->end(), comparator);
+  std::inplace_merge(tiles->begin(), middle, tiles->end(), comparator);
+}
+
+// Sorts the tiles after |sorted_count| and merges them into the sorted tiles
+// before it.
+void SortBinTiles(ManagedTileBin bin, size_t sorted_count, TileVector* tiles) {
   switch (bin) {
     case NEVER_BIN:
       break;
     case NOW_AND_READY_TO_DRAW_BIN:
-      std::sort(tiles->begin(), tiles->end(), TilePriorityTieBreaker);
+      SortTailAndMerge(sorted_count, tiles, TilePriorityTieBreaker);
       break;
     case NOW_BIN:
     case SOON_BIN:
@@ -60,7 +71,7 @@ void SortBinTiles(ManagedTileBin bin, TileVector* tiles) {
     case EVENTUALLY_BIN:
     case AT_LAST_AND_ACTIVE_BIN:
     case AT_LAST_BIN:
-      std::sort(tiles->begin(), tiles->end(), BinComparator());
+      SortTailAndMerge(sorted_count, tiles, BinComparator());
       break;
     default:
       NOTREACHED();
@@ -71,21 +82,65 @@ void SortBinTiles(ManagedTileBin bin, TileVector* tiles) {
 
 PrioritizedTileSet::PrioritizedTileSet() {
   for (int bin = 0; bin < NUM_BINS; ++bin)
-    bin_sorted_[bin] = true;
+    sorted_tile_count_[bin] = 0;
 }
 
 PrioritizedTileSet::~PrioritizedTileSet() {}
 
 void PrioritizedTileSet::InsertTile(Tile* tile, ManagedTileBin bin) {
+  DCHECK(tile_bins_.find(tile) == tile_bins_.end());
   tiles_[bin].push_back(tile);
-  bin_sorted_[bin] = false;
+  tile_bins_[tile] = bin;
+}
+
+void PrioritizedTileSet::RemoveTiles(const std::vector<Tile*>& tiles) {
+  bool bin_has_removals[NUM_BINS] = {false};
+  for (std::vector<Tile*>::const_iterator it = tiles.begin();
+       it != tiles.end();
+       ++it) {
+    TileBinMap::iterator bin_it = tile_bins_.find(*it);
+    if (bin_it == tile_bins_.end())
+      continue;
+    bin_has_removals[bin_it->second] = true;
+    tile_bins_.erase(bin_it);
+  }
+
+  for (int bin = 0; bin < NUM_BINS; ++bin) {
+    if (!bin_has_removals[bin])
+      continue;
+
+    // Compact the bin in place. Kept tiles don't change order, so the part
+    // that was sorted stays sorted.
+    TileVector& bin_tiles = tiles_[bin];
+    size_t sorted_count = sorted_tile_count_[bin];
+    size_t new_sorted_count = 0;
+    TileVector::iterator new_end = bin_tiles.begin();
+    for (size_t i = 0; i < bin_tiles.size(); ++i) {
+      if (tile_bins_.find(bin_tiles[i]) == tile_bins_.end())
+        continue;
+      *new_end++ = bin_tiles[i];
+      if (i < sorted_count)
+        ++new_sorted_count;
+    }
+    sorted_tile_count_[bin] = new_sorted_count;
+    bin_tiles.erase(new_end, bin_tiles.end());
+  }
+}
+
+bool PrioritizedTileSet::GetTileBin(Tile* tile, ManagedTileBin* bin) const {
+  TileBinMap::const_iterator it = tile_bins_.find(tile);
+  if (it == tile_bins_.end())
+    return false;
+  *bin = it->second;
+  return true;
 }
 
 void PrioritizedTileSet::Clear() {
   for (int bin = 0; bin < NUM_BINS; ++bin) {
     tiles_[bin].clear();
-    bin_sorted_[bin] = true;
+    sorted_tile_count_[bin] = 0;
   }
+  tile_bins_.clear();
 }
 
 bool PrioritizedTileSet::IsEmpty() {
@@ -97,9 +152,9 @@ bool PrioritizedTileSet::IsEmpty() {
 }
 
 void PrioritizedTileSet::SortBinIfNeeded(ManagedTileBin bin) {
-  if (!bin_sorted_[bin]) {
-    SortBinTiles(bin, &tiles_[bin]);
-    bin_sorted_[bin] = true;
+  if (sorted_tile_count_[bin] != tiles_[bin].size()) {
+    SortBinTiles(bin, sorted_tile_count_[bin], &tiles_[bin]);
+    sorted_tile_count_[bin] = tiles_[bin].size();
   }
 }
 
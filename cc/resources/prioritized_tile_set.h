@@ -7,6 +7,7 @@
 
 #include <vector>
 
+#include "base/containers/hash_tables.h"
 #include "cc/base/cc_export.h"
 #include "cc/resources/managed_tile_state.h"
 
@@ -18,7 +19,14 @@ class CC_EXPORT PrioritizedTileSet {
   PrioritizedTileSet();
   ~PrioritizedTileSet();
 
+  // |tile| must not already be in the set.
   void InsertTile(Tile* tile, ManagedTileBin bin);
+  // Removes |tiles| from the set, ignoring any that aren't in it. Bins that
+  // were sorted stay sorted, so a set can be kept up to date across frames by
+  // removing and re-inserting only the tiles whose bin or priority changed.
+  void RemoveTiles(const std::vector<Tile*>& tiles);
+  // Returns false if |tile| isn't in the set.
+  bool GetTileBin(Tile* tile, ManagedTileBin* bin) const;
   void Clear();
   bool IsEmpty();
 
@@ -52,7 +60,12 @@ class CC_EXPORT PrioritizedTileSet {
   void SortBinIfNeeded(ManagedTileBin bin);
 
   std::vector<Tile*> tiles_[NUM_BINS];
-  bool bin_sorted_[NUM_BINS];
+  // Tiles before this index in each bin are sorted. Tiles inserted since the
+  // bin was last sorted are merged in when the bin is iterated.
+  size_t sorted_tile_count_[NUM_BINS];
+
+  typedef base::hash_map<Tile*, ManagedTileBin> TileBinMap;
+  TileBinMap tile_bins_;
 };
 
 }  // namespace cc
@@ -769,6 +769,101 @@ TEST_F(PrioritizedTileSetTest, MultipleIterators) {
   EXPECT_FALSE(empty_it);
 }
 
+TEST_F(PrioritizedTileSetTest, RemoveTiles) {
+  // Ensure that removed tiles are no longer iterated and that the remaining
+  // tiles keep their order.
+
+  PrioritizedTileSet set;
+  std::vector<scoped_refptr<Tile> > tiles;
+  for (int i = 0; i < 20; ++i) {
+    scoped_refptr<Tile> tile = CreateTile();
+    tiles.push_back(tile);
+    set.InsertTile(tile.get(), NOW_AND_READY_TO_DRAW_BIN);
+  }
+
+  // Sort the bin before removing tiles from it.
+  PrioritizedTileSet::Iterator sort_it(&set, true);
+  EXPECT_TRUE(sort_it);
+
+  std::vector<Tile*> tiles_to_remove;
+  std::vector<Tile*> remaining_tiles;
+  for (size_t i = 0; i < tiles.size(); ++i) {
+    if (i % 3 == 0)
+      tiles_to_remove.push_back(tiles[i].get());
+    else
+      remaining_tiles.push_back(tiles[i].get());
+  }
+  set.RemoveTiles(tiles_to_remove);
+
+  ManagedTileBin bin;
+  EXPECT_FALSE(set.GetTileBin(tiles[0].get(), &bin));
+  EXPECT_TRUE(set.GetTileBin(tiles[1].get(), &bin));
+  EXPECT_EQ(NOW_AND_READY_TO_DRAW_BIN, bin);
+
+  size_t i = 0;
+  for (PrioritizedTileSet::Iterator it(&set, true); it; ++it) {
+    ASSERT_LT(i, remaining_tiles.size());
+    EXPECT_TRUE(*it == remaining_tiles[i]);
+    ++i;
+  }
+  EXPECT_EQ(remaining_tiles.size(), i);
+
+  ReleaseTiles(&tiles);
+}
+
+TEST_F(PrioritizedTileSetTest, ReinsertTiles) {
+  // Ensure that tiles re-inserted into a sorted bin are merged into the right
+  // place, and that tiles moved to another bin are iterated with that bin.
+
+  PrioritizedTileSet set;
+  std::vector<scoped_refptr<Tile> > tiles;
+  for (int i = 0; i < 20; ++i)
+    tiles.push_back(CreateTile());
+  // Insert in reverse order so that the bin has to be sorted.
+  for (int i = 19; i >= 0; --i)
+    set.InsertTile(tiles[i].get(), NOW_AND_READY_TO_DRAW_BIN);
+
+  PrioritizedTileSet::Iterator sort_it(&set, true);
+  EXPECT_TRUE(*sort_it == tiles[0].get());
+
+  std::vector<Tile*> tiles_to_update;
+  for (size_t i = 0; i < tiles.size(); i += 4)
+    tiles_to_update.push_back(tiles[i].get());
+  set.RemoveTiles(tiles_to_update);
+
+  // Put half of the removed tiles back in the same bin and the rest in
+  // AT_LAST_BIN.
+  std::vector<Tile*> at_last_tiles;
+  for (size_t i = 0; i < tiles_to_update.size(); ++i) {
+    Tile* tile = tiles_to_update[i];
+    if (i % 2 == 0) {
+      set.InsertTile(tile, NOW_AND_READY_TO_DRAW_BIN);
+    } else {
+      set.InsertTile(tile, AT_LAST_BIN);
+      at_last_tiles.push_back(tile);
+    }
+  }
+
+  std::vector<Tile*> expected_tiles;
+  for (size_t i = 0; i < tiles.size(); ++i) {
+    if (std::find(at_last_tiles.begin(), at_last_tiles.end(), tiles[i]) ==
+        at_last_tiles.end())
+      expected_tiles.push_back(tiles[i].get());
+  }
+  expected_tiles.insert(
+      expected_tiles.end(), at_last_tiles.begin(), at_last_tiles.end());
+
+  size_t i = 0;
+  for (PrioritizedTileSet::Iterator it(&set, true); it; ++it) {
+    ASSERT_LT(i, expected_tiles.size());
+    EXPECT_TRUE(*it == expected_tiles[i]);
+    ++i;
+  }
+  EXPECT_EQ(expected_tiles.size(), i);
+
+  ReleaseTiles(&tiles);
+}
+
 }  // namespace
 }  // namespace cc
 
@@ -4,11 +4,17 @@
 
 #include "cc/resources/resource_pool.h"
 
+#include <algorithm>
+
 #include "cc/resources/resource_provider.h"
 #include "cc/resources/scoped_resource.h"
 
 namespace cc {
 
+// Long enough to keep resources around through a pinch zoom or a fling, but
+// short enough that a pool that isn't over its limits still gets trimmed.
+const int ResourcePool::kResourceExpirationDelayMs = 5000;
+
 ResourcePool::ResourcePool(ResourceProvider* resource_provider,
                            GLenum target,
                            ResourceFormat format)
@@ -30,6 +36,7 @@ ResourcePool::~ResourcePool() {
 
   SetResourceUsageLimits(0, 0, 0);
   DCHECK_EQ(0u, unused_resources_.size());
+  DCHECK(unused_resource_buckets_.empty());
   DCHECK_EQ(0u, memory_usage_bytes_);
   DCHECK_EQ(0u, unused_memory_usage_bytes_);
   DCHECK_EQ(0u, resource_count_);
@@ -37,17 +44,13 @@ ResourcePool::~ResourcePool() {
 
 scoped_ptr<ScopedResource> ResourcePool::AcquireResource(
     const gfx::Size& size) {
-  for (ResourceList::iterator it = unused_resources_.begin();
-       it != unused_resources_.end();
-       ++it) {
-    ScopedResource* resource = *it;
+  UnusedResourceBucketMap::iterator bucket_it =
+      unused_resource_buckets_.find(KeyForSize(size));
+  if (bucket_it != unused_resource_buckets_.end()) {
+    ScopedResource* resource = TakeUnusedResource(bucket_it->second.front());
     DCHECK(resource_provider_->CanLockForWrite(resource->id()));
-
-    if (resource->size() != size)
-      continue;
-
-    unused_resources_.erase(it);
-    unused_memory_usage_bytes_ -= resource->bytes();
+    DCHECK(resource->size() == size);
+    content_ids_.erase(resource);
     return make_scoped_ptr(resource);
   }
 
@@ -64,6 +67,32 @@ void ResourcePool::ReleaseResource(scoped_ptr<ScopedResource> resource) {
   busy_resources_.push_back(resource.release());
 }
 
+void ResourcePool::ReleaseResourceWithContentId(
+    scoped_ptr<ScopedResource> resource,
+    uint64 content_id) {
+  content_ids_[resource.get()] = content_id;
+  ReleaseResource(resource.Pass());
+}
+
+scoped_ptr<ScopedResource> ResourcePool::TryAcquireResourceWithContentId(
+    uint64 content_id) {
+  // Search from the back, where the most recently released resources are.
+  for (UnusedResourceList::reverse_iterator it = unused_resources_.rbegin();
+       it != unused_resources_.rend();
+       ++it) {
+    ScopedResource* resource = it->resource;
+    ContentIdMap::iterator content_it = content_ids_.find(resource);
+    if (content_it == content_ids_.end() || content_it->second != content_id)
+      continue;
+
+    DCHECK(resource_provider_->CanLockForWrite(resource->id()));
+    TakeUnusedResource(--it.base());
+    content_ids_.erase(content_it);
+    return make_scoped_ptr(resource);
+  }
+  return scoped_ptr<ScopedResource>();
+}
+
 void ResourcePool::SetResourceUsageLimits(size_t max_memory_usage_bytes,
                                           size_t max_unused_memory_usage_bytes,
                                           size_t max_resource_count) {
@@ -75,6 +104,8 @@ void ResourcePool::SetResourceUsageLimits(size_t max_memory_usage_bytes,
 }
 
 void ResourcePool::ReduceResourceUsage() {
+  EvictExpiredResources(base::TimeTicks::Now());
+
   while (!unused_resources_.empty()) {
     if (!ResourceUsageTooHigh())
       break;
@@ -86,11 +117,23 @@ void ResourcePool::ReduceResourceUsage() {
     // can't be locked for write might also not be truly free-able.
     // We can free the resource here but it doesn't mean that the
     // memory is necessarily returned to the OS.
-    ScopedResource* resource = unused_resources_.front();
-    unused_resources_.pop_front();
+    ScopedResource* resource = TakeUnusedResource(unused_resources_.begin());
+    memory_usage_bytes_ -= resource->bytes();
+    --resource_count_;
+    content_ids_.erase(resource);
+    delete resource;
+  }
+}
+
+void ResourcePool::EvictExpiredResources(base::TimeTicks now) {
+  base::TimeTicks expiration_time =
+      now - base::TimeDelta::FromMilliseconds(kResourceExpirationDelayMs);
+  while (!unused_resources_.empty() &&
+         unused_resources_.front().unused_since < expiration_time) {
+    ScopedResource* resource = TakeUnusedResource(unused_resources_.begin());
     memory_usage_bytes_ -= resource->bytes();
-    unused_memory_usage_bytes_ -= resource->bytes();
     --resource_count_;
+    content_ids_.erase(resource);
     delete resource;
   }
 }
@@ -122,7 +165,36 @@ void ResourcePool::CheckBusyResources() {
 
 void ResourcePool::DidFinishUsingResource(ScopedResource* resource) {
   unused_memory_usage_bytes_ += resource->bytes();
-  unused_resources_.push_back(resource);
+  unused_resources_.push_back(
+      UnusedResource(resource, base::TimeTicks::Now()));
+  unused_resource_buckets_[KeyForSize(resource->size())].push_back(
+      --unused_resources_.end());
+}
+
+ScopedResource* ResourcePool::TakeUnusedResource(
+    UnusedResourceList::iterator it) {
+  ScopedResource* resource = it->resource;
+  UnusedResourceBucketMap::iterator bucket_map_it =
+      unused_resource_buckets_.find(KeyForSize(resource->size()));
+  DCHECK(bucket_map_it != unused_resource_buckets_.end());
+  UnusedResourceBucket& bucket = bucket_map_it->second;
+  // Resources are usually taken from the front of their bucket, either when
+  // acquired by size or when the oldest one is evicted.
+  if (bucket.front() == it) {
+    bucket.pop_front();
+  } else {
+    UnusedResourceBucket::iterator bucket_it =
+        std::find(bucket.begin(), bucket.end(), it);
+    DCHECK(bucket_it != bucket.end());
+    bucket.erase(bucket_it);
+  }
+  // Don't keep buckets around for sizes that are no longer in the pool.
+  if (bucket.empty())
+    unused_resource_buckets_.erase(bucket_map_it);
+
+  unused_memory_usage_bytes_ -= resource->bytes();
+  unused_resources_.erase(it);
+  return resource;
 }
 
 }  // namespace cc
@@ -5,9 +5,14 @@
 #ifndef CC_RESOURCES_RESOURCE_POOL_H_
 #define CC_RESOURCES_RESOURCE_POOL_H_
 
+#include <deque>
 #include <list>
+#include <map>
+#include <utility>
 
+#include "base/containers/hash_tables.h"
 #include "base/memory/scoped_ptr.h"
+#include "base/time/time.h"
 #include "cc/base/cc_export.h"
 #include "cc/output/renderer.h"
 #include "cc/resources/resource.h"
@@ -29,13 +34,33 @@ class CC_EXPORT ResourcePool {
   scoped_ptr<ScopedResource> AcquireResource(const gfx::Size& size);
   void ReleaseResource(scoped_ptr<ScopedResource>);
 
+  // Like ReleaseResource(), but remembers that |resource| holds the content
+  // identified by |content_id|. While the resource stays unused, it can be
+  // acquired again with that content intact.
+  void ReleaseResourceWithContentId(scoped_ptr<ScopedResource> resource,
+                                    uint64 content_id);
+
+  // Returns the unused resource that holds |content_id|, or NULL if it has
+  // been reused, evicted or is still in use by the compositor.
+  scoped_ptr<ScopedResource> TryAcquireResourceWithContentId(uint64 content_id);
+
   void SetResourceUsageLimits(size_t max_memory_usage_bytes,
                               size_t max_unused_memory_usage_bytes,
                               size_t max_resource_count);
 
+  // Evicts expired resources, then least recently used ones until usage is
+  // within the limits.
   void ReduceResourceUsage();
   void CheckBusyResources();
 
+  // Deletes the unused resources that became unused more than
+  // kResourceExpirationDelayMs before |now|. Resources of a size that stopped
+  // being requested, e.g. after a zoom, would otherwise only be evicted once
+  // the pool is over its limits.
+  void EvictExpiredResources(base::TimeTicks now);
+
+  static const int kResourceExpirationDelayMs;
+
   size_t total_memory_usage_bytes() const { return memory_usage_bytes_; }
   size_t acquired_memory_usage_bytes() const {
     return memory_usage_bytes_ - unused_memory_usage_bytes_;
@@ -46,6 +71,7 @@ class CC_EXPORT ResourcePool {
   }
 
   ResourceFormat resource_format() const { return format_; }
+  ResourceProvider* resource_provider() const { return resource_provider_; }
 
  protected:
   ResourcePool(ResourceProvider* resource_provider,
@@ -67,10 +93,42 @@ class CC_EXPORT ResourcePool {
   size_t unused_memory_usage_bytes_;
   size_t resource_count_;
 
+  struct UnusedResource {
+    UnusedResource(ScopedResource* resource, base::TimeTicks unused_since)
+        : resource(resource), unused_since(unused_since) {}
+
+    ScopedResource* resource;
+    base::TimeTicks unused_since;
+  };
+
+  typedef std::list<UnusedResource> UnusedResourceList;
+  typedef std::pair<int, int> SizeKey;
+  typedef std::deque<UnusedResourceList::iterator> UnusedResourceBucket;
+  typedef base::hash_map<SizeKey, UnusedResourceBucket> UnusedResourceBucketMap;
+
+  static SizeKey KeyForSize(const gfx::Size& size) {
+    return SizeKey(size.width(), size.height());
+  }
+
+  // Removes |it| from the unused resources and returns its resource.
+  ScopedResource* TakeUnusedResource(UnusedResourceList::iterator it);
+
+  // Unused resources, in the order they became unused. The oldest one is
+  // evicted first.
+  UnusedResourceList unused_resources_;
+  // The same resources bucketed by size, each bucket in the same order, so
+  // that a resource of a given size can be found without a search. Every
+  // resource in the pool has the same format, so the size is a full key.
+  UnusedResourceBucketMap unused_resource_buckets_;
+
   typedef std::list<ScopedResource*> ResourceList;
-  ResourceList unused_resources_;
   ResourceList busy_resources_;
 
+  // Content ids of released resources, kept until they are acquired again or
+  // deleted.
+  typedef std::map<const ScopedResource*, uint64> ContentIdMap;
+  ContentIdMap content_ids_;
+
   DISALLOW_COPY_AND_ASSIGN(ResourcePool);
 };
 
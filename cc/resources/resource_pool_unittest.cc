@@ -0,0 +1,194 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "cc/resources/resource_pool.h"
+
+#include <limits>
+
+#include "cc/resources/resource_provider.h"
+#include "cc/resources/scoped_resource.h"
+#include "cc/test/fake_output_surface.h"
+#include "cc/test/fake_output_surface_client.h"
+#include "cc/test/test_shared_bitmap_manager.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace cc {
+namespace {
+
+class ResourcePoolTest : public testing::Test {
+ public:
+  ResourcePoolTest() {
+    output_surface_ = FakeOutputSurface::Create3d().Pass();
+    CHECK(output_surface_->BindToClient(&output_surface_client_));
+
+    shared_bitmap_manager_.reset(new TestSharedBitmapManager());
+    resource_provider_ = ResourceProvider::Create(output_surface_.get(),
+                                                  shared_bitmap_manager_.get(),
+                                                  NULL,
+                                                  0,
+                                                  false,
+                                                  1,
+                                                  false).Pass();
+    resource_pool_ = ResourcePool::Create(
+        resource_provider_.get(), GL_TEXTURE_2D, RGBA_8888);
+    resource_pool_->SetResourceUsageLimits(
+        std::numeric_limits<size_t>::max(),
+        std::numeric_limits<size_t>::max(),
+        std::numeric_limits<size_t>::max());
+  }
+
+  // Releases |resource| and makes it available for reuse right away.
+  void ReleaseAndCheck(scoped_ptr<ScopedResource> resource) {
+    resource_pool_->ReleaseResource(resource.Pass());
+    resource_pool_->CheckBusyResources();
+  }
+
+ protected:
+  FakeOutputSurfaceClient output_surface_client_;
+  scoped_ptr<FakeOutputSurface> output_surface_;
+  scoped_ptr<SharedBitmapManager> shared_bitmap_manager_;
+  scoped_ptr<ResourceProvider> resource_provider_;
+  scoped_ptr<ResourcePool> resource_pool_;
+};
+
+TEST_F(ResourcePoolTest, ReusesResourcesOfTheSameSize) {
+  gfx::Size small_size(100, 100);
+  gfx::Size large_size(200, 200);
+
+  scoped_ptr<ScopedResource> small = resource_pool_->AcquireResource(
+      small_size);
+  scoped_ptr<ScopedResource> large = resource_pool_->AcquireResource(
+      large_size);
+  ResourceProvider::ResourceId small_id = small->id();
+  ResourceProvider::ResourceId large_id = large->id();
+  ReleaseAndCheck(small.Pass());
+  ReleaseAndCheck(large.Pass());
+  EXPECT_EQ(2u, resource_pool_->total_resource_count());
+  EXPECT_EQ(0u, resource_pool_->acquired_resource_count());
+
+  // Each size gets the resource that was released with that size, even
+  // though the other one is older or newer.
+  scoped_ptr<ScopedResource> resource = resource_pool_->AcquireResource(
+      large_size);
+  EXPECT_EQ(large_id, resource->id());
+  ReleaseAndCheck(resource.Pass());
+  resource = resource_pool_->AcquireResource(small_size);
+  EXPECT_EQ(small_id, resource->id());
+  ReleaseAndCheck(resource.Pass());
+
+  // A size that isn't in the pool gets a new resource.
+  resource = resource_pool_->AcquireResource(gfx::Size(150, 150));
+  EXPECT_NE(small_id, resource->id());
+  EXPECT_NE(large_id, resource->id());
+  EXPECT_EQ(3u, resource_pool_->total_resource_count());
+  ReleaseAndCheck(resource.Pass());
+}
+
+TEST_F(ResourcePoolTest, ReusesResourceWithContentId) {
+  gfx::Size size(100, 100);
+
+  scoped_ptr<ScopedResource> first = resource_pool_->AcquireResource(size);
+  scoped_ptr<ScopedResource> second = resource_pool_->AcquireResource(size);
+  ResourceProvider::ResourceId first_id = first->id();
+  ResourceProvider::ResourceId second_id = second->id();
+  resource_pool_->ReleaseResourceWithContentId(first.Pass(), 1u);
+  resource_pool_->ReleaseResourceWithContentId(second.Pass(), 2u);
+  resource_pool_->CheckBusyResources();
+
+  // Taking the newer resource out of the middle of its bucket leaves the
+  // older one to be acquired by size.
+  scoped_ptr<ScopedResource> resource =
+      resource_pool_->TryAcquireResourceWithContentId(2u);
+  ASSERT_TRUE(resource);
+  EXPECT_EQ(second_id, resource->id());
+  EXPECT_FALSE(resource_pool_->TryAcquireResourceWithContentId(2u));
+
+  scoped_ptr<ScopedResource> other = resource_pool_->AcquireResource(size);
+  EXPECT_EQ(first_id, other->id());
+  // Acquiring by size forgets the content.
+  ReleaseAndCheck(other.Pass());
+  EXPECT_FALSE(resource_pool_->TryAcquireResourceWithContentId(1u));
+  ReleaseAndCheck(resource.Pass());
+}
+
+TEST_F(ResourcePoolTest, TagsReleasedResourceWithContentId) {
+  gfx::Size size(100, 100);
+
+  scoped_ptr<ScopedResource> resource = resource_pool_->AcquireResource(size);
+  ResourceProvider::ResourceId id = resource->id();
+  resource_pool_->ReleaseResourceWithContentId(resource.Pass(), 1u);
+
+  // The resource can't be taken back while the compositor may still use it.
+  EXPECT_FALSE(resource_pool_->TryAcquireResourceWithContentId(1u));
+  resource_pool_->CheckBusyResources();
+
+  // Other content ids don't match.
+  EXPECT_FALSE(resource_pool_->TryAcquireResourceWithContentId(2u));
+  resource = resource_pool_->TryAcquireResourceWithContentId(1u);
+  ASSERT_TRUE(resource);
+  EXPECT_EQ(id, resource->id());
+  EXPECT_EQ(1u, resource_pool_->acquired_resource_count());
+
+  // Releasing it without a content id forgets the old one.
+  ReleaseAndCheck(resource.Pass());
+  EXPECT_FALSE(resource_pool_->TryAcquireResourceWithContentId(1u));
+  EXPECT_EQ(1u, resource_pool_->total_resource_count());
+}
+
+TEST_F(ResourcePoolTest, ForgetsContentIdOfEvictedResources) {
+  gfx::Size size(100, 100);
+
+  scoped_ptr<ScopedResource> resource = resource_pool_->AcquireResource(size);
+  size_t bytes = resource->bytes();
+  resource_pool_->ReleaseResourceWithContentId(resource.Pass(), 1u);
+  resource = resource_pool_->AcquireResource(size);
+  resource_pool_->ReleaseResourceWithContentId(resource.Pass(), 2u);
+  resource_pool_->CheckBusyResources();
+  EXPECT_EQ(2u, resource_pool_->total_resource_count());
+
+  // Only room for one unused resource, so the least recently released one
+  // is evicted along with its content.
+  resource_pool_->SetResourceUsageLimits(
+      std::numeric_limits<size_t>::max(), bytes, 1u);
+  EXPECT_EQ(1u, resource_pool_->total_resource_count());
+  EXPECT_FALSE(resource_pool_->TryAcquireResourceWithContentId(1u));
+  resource = resource_pool_->TryAcquireResourceWithContentId(2u);
+  EXPECT_TRUE(resource);
+  ReleaseAndCheck(resource.Pass());
+
+  // Expired resources lose their content too.
+  resource_pool_->EvictExpiredResources(
+      base::TimeTicks::Now() +
+      base::TimeDelta::FromMilliseconds(
+          ResourcePool::kResourceExpirationDelayMs + 1));
+  EXPECT_EQ(0u, resource_pool_->total_resource_count());
+  EXPECT_FALSE(resource_pool_->TryAcquireResourceWithContentId(2u));
+}
+
+TEST_F(ResourcePoolTest, EvictsExpiredResources) {
+  gfx::Size size(100, 100);
+  base::TimeDelta expiration_delay = base::TimeDelta::FromMilliseconds(
+      ResourcePool::kResourceExpirationDelayMs);
+
+  scoped_ptr<ScopedResource> busy = resource_pool_->AcquireResource(size);
+  ReleaseAndCheck(resource_pool_->AcquireResource(size));
+  base::TimeTicks now = base::TimeTicks::Now();
+  EXPECT_EQ(2u, resource_pool_->total_resource_count());
+
+  // Nothing has been unused for long enough yet.
+  resource_pool_->EvictExpiredResources(now);
+  EXPECT_EQ(2u, resource_pool_->total_resource_count());
+
+  // Only unused resources expire.
+  resource_pool_->EvictExpiredResources(
+      now + expiration_delay + base::TimeDelta::FromMilliseconds(1));
+  EXPECT_EQ(1u, resource_pool_->total_resource_count());
+  EXPECT_EQ(1u, resource_pool_->acquired_resource_count());
+  EXPECT_EQ(0u, resource_pool_->total_memory_usage_bytes() -
+                    resource_pool_->acquired_memory_usage_bytes());
+  ReleaseAndCheck(busy.Pass());
+}
+
+}  // namespace
+}  // namespace cc
@@ -14,6 +14,7 @@
 #include "base/strings/string_util.h"
 #include "cc/base/util.h"
 #include "cc/output/gl_renderer.h"  // For the GLC() macro.
+#include "cc/resources/compressed_bitmap.h"
 #include "cc/resources/platform_color.h"
 #include "cc/resources/returned_resource.h"
 #include "cc/resources/shared_bitmap_manager.h"
@@ -226,6 +227,7 @@ ResourceProvider::Resource::Resource()
       read_lock_fences_enabled(false),
       has_shared_bitmap_id(false),
       allow_overlay(false),
+      incompressible(false),
       read_lock_fence(NULL),
       size(),
       origin(Internal),
@@ -239,7 +241,8 @@ ResourceProvider::Resource::Resource()
       hint(TextureHintImmutable),
       type(InvalidType),
       format(RGBA_8888),
-      shared_bitmap(NULL) {
+      shared_bitmap(NULL),
+      compressed_bitmap(NULL) {
 }
 
 ResourceProvider::Resource::~Resource() {}
@@ -272,6 +275,7 @@ ResourceProvider::Resource::Resource(GLuint texture_id,
       read_lock_fences_enabled(false),
       has_shared_bitmap_id(false),
       allow_overlay(false),
+      incompressible(false),
       read_lock_fence(NULL),
       size(size),
       origin(origin),
@@ -285,7 +289,8 @@ ResourceProvider::Resource::Resource(GLuint texture_id,
       hint(hint),
       type(GLTexture),
       format(format),
-      shared_bitmap(NULL) {
+      shared_bitmap(NULL),
+      compressed_bitmap(NULL) {
   DCHECK(wrap_mode == GL_CLAMP_TO_EDGE || wrap_mode == GL_REPEAT);
   DCHECK_EQ(origin == Internal, !!texture_pool);
 }
@@ -315,6 +320,7 @@ ResourceProvider::Resource::Resource(uint8_t* pixels,
       read_lock_fences_enabled(false),
       has_shared_bitmap_id(!!bitmap),
       allow_overlay(false),
+      incompressible(false),
       read_lock_fence(NULL),
       size(size),
       origin(origin),
@@ -328,7 +334,8 @@ ResourceProvider::Resource::Resource(uint8_t* pixels,
       hint(TextureHintImmutable),
       type(Bitmap),
       format(RGBA_8888),
-      shared_bitmap(bitmap) {
+      shared_bitmap(bitmap),
+      compressed_bitmap(NULL) {
   DCHECK(wrap_mode == GL_CLAMP_TO_EDGE || wrap_mode == GL_REPEAT);
   DCHECK(origin == Delegated || pixels);
   if (bitmap)
@@ -359,6 +366,7 @@ ResourceProvider::Resource::Resource(const SharedBitmapId& bitmap_id,
       read_lock_fences_enabled(false),
       has_shared_bitmap_id(true),
       allow_overlay(false),
+      incompressible(false),
       read_lock_fence(NULL),
       size(size),
       origin(origin),
@@ -373,7 +381,8 @@ ResourceProvider::Resource::Resource(const SharedBitmapId& bitmap_id,
       type(Bitmap),
       format(RGBA_8888),
       shared_bitmap_id(bitmap_id),
-      shared_bitmap(NULL) {
+      shared_bitmap(NULL),
+      compressed_bitmap(NULL) {
   DCHECK(wrap_mode == GL_CLAMP_TO_EDGE || wrap_mode == GL_REPEAT);
 }
 
@@ -699,6 +708,7 @@ void ResourceProvider::DeleteResourceInternal(ResourceMap::iterator it,
     DCHECK(resource->origin == Resource::Internal);
     delete[] resource->pixels;
   }
+  delete resource->compressed_bitmap;
   resources_.erase(it);
 }
 
@@ -832,6 +842,7 @@ const ResourceProvider::Resource* ResourceProvider::LockForRead(ResourceId id) {
   DCHECK(resource->allocated);
 
   LazyCreate(resource);
+  LazyDecompress(resource);
 
   if (resource->type == GLTexture && !resource->gl_id) {
     DCHECK(resource->origin != Resource::Internal);
@@ -903,8 +914,10 @@ const ResourceProvider::Resource* ResourceProvider::LockForWrite(
   DCHECK(!resource->lost);
   DCHECK(ReadLockFenceHasPassed(resource));
   LazyAllocate(resource);
+  LazyDecompress(resource);
 
   resource->locked_for_write = true;
+  resource->incompressible = false;
   return resource;
 }
 
@@ -1401,6 +1414,7 @@ void ResourceProvider::TransferResource(GLES2Interface* gl,
   resource->allow_overlay = source->allow_overlay;
 
   if (source->type == Bitmap) {
+    LazyDecompress(source);
     resource->mailbox_holder.mailbox = source->shared_bitmap_id;
     resource->is_software = true;
   } else if (!source->mailbox.IsValid()) {
@@ -1854,6 +1868,33 @@ void ResourceProvider::LazyAllocate(Resource* resource) {
   }
 }
 
+void ResourceProvider::LazyDecompress(Resource* resource) {
+  DCHECK(resource);
+  if (!resource->compressed_bitmap)
+    return;
+  TRACE_EVENT0("cc", "ResourceProvider::LazyDecompress");
+  DCHECK_EQ(Bitmap, resource->type);
+  DCHECK(!resource->pixels);
+
+  scoped_ptr<SharedBitmap> bitmap;
+  if (resource->has_shared_bitmap_id && shared_bitmap_manager_)
+    bitmap = shared_bitmap_manager_->AllocateSharedBitmap(resource->size);
+  if (bitmap) {
+    resource->pixels = bitmap->pixels();
+    resource->shared_bitmap_id = bitmap->id();
+    resource->shared_bitmap = bitmap.release();
+  } else {
+    // Like in CreateBitmap(), fall back to memory that can't be shared.
+    resource->pixels =
+        new uint8_t[SharedBitmap::CheckedSizeInBytes(resource->size)];
+    resource->has_shared_bitmap_id = false;
+  }
+
+  resource->compressed_bitmap->Decompress(resource->pixels);
+  delete resource->compressed_bitmap;
+  resource->compressed_bitmap = NULL;
+}
+
 void ResourceProvider::BindImageForSampling(Resource* resource) {
   GLES2Interface* gl = ContextGL();
   DCHECK(resource->gl_id);
@@ -2050,6 +2091,53 @@ void ResourceProvider::CopyResource(ResourceId source_id, ResourceId dest_id) {
       new QueryFence(gl, source_resource->gl_read_lock_query_id));
 }
 
+bool ResourceProvider::CompressBitmap(ResourceId id) {
+  Resource* resource = GetResource(id);
+  if (resource->compressed_bitmap)
+    return true;
+  if (resource->type != Bitmap || resource->format != RGBA_8888 ||
+      !resource->pixels || !resource->allocated || resource->incompressible ||
+      resource->marked_for_deletion || !CanLockForWrite(id))
+    return false;
+
+  TRACE_EVENT0("cc", "ResourceProvider::CompressBitmap");
+  scoped_ptr<CompressedBitmap> compressed_bitmap =
+      CompressedBitmap::Create(resource->pixels, resource->size);
+  if (!compressed_bitmap) {
+    resource->incompressible = true;
+    return false;
+  }
+
+  // The shared memory is released along with the pixels, and the pixels are
+  // decompressed into a new one, with a new id. Nothing refers to the old id
+  // as the resource is not exported.
+  if (resource->shared_bitmap) {
+    delete resource->shared_bitmap;
+    resource->shared_bitmap = NULL;
+  } else {
+    delete[] resource->pixels;
+  }
+  resource->pixels = NULL;
+  resource->compressed_bitmap = compressed_bitmap.release();
+  return true;
+}
+
+void ResourceProvider::DecompressBitmap(ResourceId id) {
+  LazyDecompress(GetResource(id));
+}
+
+bool ResourceProvider::IsBitmapCompressed(ResourceId id) {
+  return !!GetResource(id)->compressed_bitmap;
+}
+
+size_t ResourceProvider::BitmapMemoryUsageBytes(ResourceId id) {
+  Resource* resource = GetResource(id);
+  DCHECK_EQ(Bitmap, resource->type);
+  if (resource->compressed_bitmap)
+    return resource->compressed_bitmap->bytes();
+  return SharedBitmap::CheckedSizeInBytes(resource->size);
+}
+
 void ResourceProvider::WaitSyncPointIfNeeded(ResourceId id) {
   Resource* resource = GetResource(id);
   DCHECK_EQ(resource->exported_count, 0);
@@ -48,6 +48,7 @@ class Vector2d;
 
 namespace cc {
 class BlockingTaskRunner;
+class CompressedBitmap;
 class IdAllocator;
 class SharedBitmap;
 class SharedBitmapManager;
@@ -369,6 +370,18 @@ class CC_EXPORT ResourceProvider {
   // Copy pixels from source to destination.
   void CopyResource(ResourceId source_id, ResourceId dest_id);
 
+  // Replaces the pixels of a bitmap resource that is not in use with a
+  // compressed copy, to save memory while it is not being drawn. The pixels
+  // are decompressed when the resource is next locked or sent to the parent.
+  // Returns false if the resource can't be compressed right now, or if its
+  // pixels don't compress.
+  bool CompressBitmap(ResourceId id);
+  // Decompresses a compressed bitmap resource ahead of it being drawn.
+  void DecompressBitmap(ResourceId id);
+  bool IsBitmapCompressed(ResourceId id);
+  // The memory used by a bitmap resource's pixels, compressed or not.
+  size_t BitmapMemoryUsageBytes(ResourceId id);
+
   void WaitSyncPointIfNeeded(ResourceId id);
 
   static GLint GetActiveTextureUnit(gpu::gles2::GLES2Interface* gl);
@@ -424,6 +437,8 @@ class CC_EXPORT ResourceProvider {
     bool read_lock_fences_enabled : 1;
     bool has_shared_bitmap_id : 1;
     bool allow_overlay : 1;
+    // Set when compressing the pixels failed, until they are written again.
+    bool incompressible : 1;
     scoped_refptr<Fence> read_lock_fence;
     gfx::Size size;
     Origin origin;
@@ -440,6 +455,8 @@ class CC_EXPORT ResourceProvider {
     ResourceFormat format;
     SharedBitmapId shared_bitmap_id;
     SharedBitmap* shared_bitmap;
+    // Owned. When set, |pixels| and |shared_bitmap| are NULL.
+    CompressedBitmap* compressed_bitmap;
     skia::RefPtr<SkSurface> sk_surface;
   };
   typedef base::hash_map<ResourceId, Resource> ResourceMap;
@@ -497,6 +514,7 @@ class CC_EXPORT ResourceProvider {
   void DestroyChildInternal(ChildMap::iterator it, DeleteStyle style);
   void LazyCreate(Resource* resource);
   void LazyAllocate(Resource* resource);
+  void LazyDecompress(Resource* resource);
 
   void BindImageForSampling(Resource* resource);
   // Binds the given GL resource to a texture target for sampling using the
@@ -7,6 +7,7 @@
 #include <algorithm>
 #include <map>
 #include <set>
+#include <vector>
 
 #include "base/bind.h"
 #include "base/containers/hash_tables.h"
@@ -1260,6 +1261,72 @@ TEST_P(ResourceProviderTest, TransferInvalidSoftware) {
   EXPECT_FALSE(returned_to_child[0].lost);
 }
 
+TEST_P(ResourceProviderTest, CompressSoftwareResource) {
+  if (GetParam() != ResourceProvider::Bitmap)
+    return;
+
+  gfx::Size size(16, 16);
+  ResourceFormat format = RGBA_8888;
+  size_t pixel_size = TextureSizeBytes(size, format);
+
+  ResourceProvider::ResourceId id = child_resource_provider_->CreateResource(
+      size, GL_CLAMP_TO_EDGE, ResourceProvider::TextureHintImmutable, format);
+  std::vector<uint8_t> data(pixel_size, 0x7f);
+  data[0] = 1;
+  gfx::Rect rect(size);
+  child_resource_provider_->SetPixels(
+      id, &data[0], rect, rect, gfx::Vector2d());
+  EXPECT_EQ(pixel_size, child_resource_provider_->BitmapMemoryUsageBytes(id));
+
+  EXPECT_TRUE(child_resource_provider_->CompressBitmap(id));
+  EXPECT_TRUE(child_resource_provider_->IsBitmapCompressed(id));
+  EXPECT_GT(pixel_size, child_resource_provider_->BitmapMemoryUsageBytes(id));
+
+  // Sending the resource to the parent decompresses it.
+  ReturnedResourceArray returned_to_child;
+  int child_id =
+      resource_provider_->CreateChild(GetReturnCallback(&returned_to_child));
+  {
+    ResourceProvider::ResourceIdArray resource_ids_to_transfer;
+    resource_ids_to_transfer.push_back(id);
+    TransferableResourceArray list;
+    child_resource_provider_->PrepareSendToParent(resource_ids_to_transfer,
+                                                  &list);
+    ASSERT_EQ(1u, list.size());
+    EXPECT_FALSE(child_resource_provider_->IsBitmapCompressed(id));
+    // Can't compress a resource that is in use by the parent.
+    EXPECT_FALSE(child_resource_provider_->CompressBitmap(id));
+    resource_provider_->ReceiveFromChild(child_id, list);
+  }
+
+  ResourceProvider::ResourceIdMap resource_map =
+      resource_provider_->GetChildToParentMap(child_id);
+  std::vector<uint8_t> result(pixel_size, 0);
+  GetResourcePixels(resource_provider_.get(),
+                    context(),
+                    resource_map[id],
+                    size,
+                    format,
+                    &result[0]);
+  EXPECT_EQ(data, result);
+
+  resource_provider_->DestroyChild(child_id);
+  ASSERT_EQ(1u, returned_to_child.size());
+  child_resource_provider_->ReceiveReturnsFromParent(returned_to_child);
+
+  // Compressing again, and decompressing by reading it.
+  EXPECT_TRUE(child_resource_provider_->CompressBitmap(id));
+  std::fill(result.begin(), result.end(), 0);
+  GetResourcePixels(child_resource_provider_.get(),
+                    child_context_,
+                    id,
+                    size,
+                    format,
+                    &result[0]);
+  EXPECT_EQ(data, result);
+  EXPECT_FALSE(child_resource_provider_->IsBitmapCompressed(id));
+}
+
 TEST_P(ResourceProviderTest, DeleteExportedResources) {
   gfx::Size size(1, 1);
   ResourceFormat format = RGBA_8888;
@@ -13,61 +13,6 @@
 namespace cc {
 namespace {
 
-// Helper class for iterating over all dependents of a task.
-class DependentIterator {
- public:
-  DependentIterator(TaskGraph* graph, const Task* task)
-      : graph_(graph),
-        task_(task),
-        current_index_(static_cast<size_t>(-1)),
-        current_node_(NULL) {
-    ++(*this);
-  }
-
-  TaskGraph::Node& operator->() const {
-    DCHECK_LT(current_index_, graph_->edges.size());
-    DCHECK_EQ(graph_->edges[current_index_].task, task_);
-    DCHECK(current_node_);
-    return *current_node_;
-  }
-
-  TaskGraph::Node& operator*() const {
-    DCHECK_LT(current_index_, graph_->edges.size());
-    DCHECK_EQ(graph_->edges[current_index_].task, task_);
-    DCHECK(current_node_);
-    return *current_node_;
-  }
-
-  // Note: Performance can be improved by keeping edges sorted.
-  DependentIterator& operator++() {
-    // Find next dependency edge for |task_|.
-    do {
-      ++current_index_;
-      if (current_index_ == graph_->edges.size())
-        return *this;
-    } while (graph_->edges[current_index_].task != task_);
-
-    // Now find the node for the dependent of this edge.
-    TaskGraph::Node::Vector::iterator it =
-        std::find_if(graph_->nodes.begin(),
-                     graph_->nodes.end(),
-                     TaskGraph::Node::TaskComparator(
-                         graph_->edges[current_index_].dependent));
-    DCHECK(it != graph_->nodes.end());
-    current_node_ = &(*it);
-
-    return *this;
-  }
-
-  operator bool() const { return current_index_ < graph_->edges.size(); }
-
- private:
-  TaskGraph* graph_;
-  const Task* task_;
-  size_t current_index_;
-  TaskGraph::Node* current_node_;
-};
-
 class DependencyMismatchComparator {
  public:
   explicit DependencyMismatchComparator(const TaskGraph* graph)
@@ -176,6 +121,19 @@ void TaskGraphRunner::ScheduleTasks(NamespaceToken token, TaskGraph* graph) {
                       DependencyMismatchComparator(graph)) ==
          graph->nodes.end());
 
+  // Index the new graph before acquiring |lock_| so that worker threads are
+  // not held up by it. Node pointers stay valid when the graph is swapped into
+  // its namespace below.
+  NodeEntryVector nodes;
+  nodes.reserve(graph->nodes.size());
+  for (TaskGraph::Node::Vector::iterator it = graph->nodes.begin();
+       it != graph->nodes.end();
+       ++it) {
+    nodes.push_back(NodeEntry(it->task, &(*it)));
+  }
+  std::sort(nodes.begin(), nodes.end(), CompareNodeEntryTask());
+  std::sort(graph->edges.begin(), graph->edges.end(), CompareEdgeTask());
+
   {
     base::AutoLock lock(lock_);
 
@@ -183,36 +141,37 @@ void TaskGraphRunner::ScheduleTasks(NamespaceToken token, TaskGraph* graph) {
 
     TaskNamespace& task_namespace = namespaces_[token.id_];
 
+    // Swap task graph.
+    task_namespace.graph.Swap(graph);
+    task_namespace.nodes.swap(nodes);
+
     // First adjust number of dependencies to reflect completed tasks.
     for (Task::Vector::iterator it = task_namespace.completed_tasks.begin();
          it != task_namespace.completed_tasks.end();
          ++it) {
-      for (DependentIterator node_it(graph, it->get()); node_it; ++node_it) {
-        TaskGraph::Node& node = *node_it;
-        DCHECK_LT(0u, node.dependencies);
-        node.dependencies--;
+      std::pair<TaskGraph::Edge::Vector::iterator,
+                TaskGraph::Edge::Vector::iterator> range =
+          std::equal_range(task_namespace.graph.edges.begin(),
+                           task_namespace.graph.edges.end(),
+                           TaskGraph::Edge(it->get(), NULL),
+                           CompareEdgeTask());
+      for (TaskGraph::Edge::Vector::iterator edge_it = range.first;
+           edge_it != range.second;
+           ++edge_it) {
+        TaskGraph::Node* node = FindNode(&task_namespace, edge_it->dependent);
+        DCHECK_LT(0u, node->dependencies);
+        node->dependencies--;
       }
     }
 
-    // Build new "ready to run" queue and remove nodes from old graph.
+    // Build new "ready to run" queue.
     task_namespace.ready_to_run_tasks.clear();
-    for (TaskGraph::Node::Vector::iterator it = graph->nodes.begin();
-         it != graph->nodes.end();
+    for (TaskGraph::Node::Vector::iterator it =
+             task_namespace.graph.nodes.begin();
+         it != task_namespace.graph.nodes.end();
          ++it) {
       TaskGraph::Node& node = *it;
 
-      // Remove any old nodes that are associated with this task. The result is
-      // that the old graph is left with all nodes not present in this graph,
-      // which we use below to determine what tasks need to be canceled.
-      TaskGraph::Node::Vector::iterator old_it =
-          std::find_if(task_namespace.graph.nodes.begin(),
-                       task_namespace.graph.nodes.end(),
-                       TaskGraph::Node::TaskComparator(node.task));
-      if (old_it != task_namespace.graph.nodes.end()) {
-        std::swap(*old_it, task_namespace.graph.nodes.back());
-        task_namespace.graph.nodes.pop_back();
-      }
-
       // Task is not ready to run if dependencies are not yet satisfied.
       if (node.dependencies)
         continue;
@@ -237,8 +196,21 @@ void TaskGraphRunner::ScheduleTasks(NamespaceToken token, TaskGraph* graph) {
                    task_namespace.ready_to_run_tasks.end(),
                    CompareTaskPriority);
 
-    // Swap task graph.
-    task_namespace.graph.Swap(graph);
+    // Remove old nodes that are associated with tasks in the new graph. The
+    // result is that the old graph is left with all nodes not present in the
+    // new graph, which we use below to determine what tasks need to be
+    // canceled.
+    TaskGraph::Node::Vector::iterator old_end = graph->nodes.begin();
+    for (TaskGraph::Node::Vector::iterator it = graph->nodes.begin();
+         it != graph->nodes.end();
+         ++it) {
+      if (!std::binary_search(task_namespace.nodes.begin(),
+                              task_namespace.nodes.end(),
+                              NodeEntry(it->task, NULL),
+                              CompareNodeEntryTask()))
+        *old_end++ = *it;
+    }
+    graph->nodes.erase(old_end, graph->nodes.end());
 
     // Determine what tasks in old graph need to be canceled.
     for (TaskGraph::Node::Vector::iterator it = graph->nodes.begin();
@@ -377,6 +349,19 @@ void TaskGraphRunner::RunUntilIdle() {
     RunTaskWithLockAcquired();
 }
 
+// static
+TaskGraph::Node* TaskGraphRunner::FindNode(TaskNamespace* task_namespace,
+                                           const Task* task) {
+  NodeEntryVector::iterator it =
+      std::lower_bound(task_namespace->nodes.begin(),
+                       task_namespace->nodes.end(),
+                       NodeEntry(task, NULL),
+                       CompareNodeEntryTask());
+  DCHECK(it != task_namespace->nodes.end());
+  DCHECK_EQ(task, it->first);
+  return it->second;
+}
+
 void TaskGraphRunner::RunTaskWithLockAcquired() {
   TRACE_EVENT0("toplevel", "TaskGraphRunner::RunTask");
 
@@ -410,8 +395,10 @@ void TaskGraphRunner::RunTaskWithLockAcquired() {
   // Add task to |running_tasks|.
   task_namespace->running_tasks.push_back(task.get());
 
-  // There may be more work available, so wake up another worker thread.
-  has_ready_to_run_tasks_cv_.Signal();
+  // If there is more work available, wake up another worker thread. Waking one
+  // up when there's nothing left for it to do just adds contention on |lock_|.
+  if (!ready_to_run_namespaces_.empty())
+    has_ready_to_run_tasks_cv_.Signal();
 
   // Call WillRun() before releasing |lock_| and running task.
   task->WillRun();
@@ -436,8 +423,15 @@ void TaskGraphRunner::RunTaskWithLockAcquired() {
   // Now iterate over all dependents to decrement dependencies and check if they
   // are ready to run.
   bool ready_to_run_namespaces_has_heap_properties = true;
-  for (DependentIterator it(&task_namespace->graph, task.get()); it; ++it) {
-    TaskGraph::Node& dependent_node = *it;
+  std::pair<TaskGraph::Edge::Vector::iterator,
+            TaskGraph::Edge::Vector::iterator> range =
+      std::equal_range(task_namespace->graph.edges.begin(),
+                       task_namespace->graph.edges.end(),
+                       TaskGraph::Edge(task.get(), NULL),
+                       CompareEdgeTask());
+  for (TaskGraph::Edge::Vector::iterator it = range.first; it != range.second;
+       ++it) {
+    TaskGraph::Node& dependent_node = *FindNode(task_namespace, it->dependent);
 
     DCHECK_LT(0u, dependent_node.dependencies);
     dependent_node.dependencies--;
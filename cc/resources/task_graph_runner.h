@@ -5,7 +5,9 @@
 #ifndef CC_RESOURCES_TASK_GRAPH_RUNNER_H_
 #define CC_RESOURCES_TASK_GRAPH_RUNNER_H_
 
+#include <functional>
 #include <map>
+#include <utility>
 #include <vector>
 
 #include "base/logging.h"
@@ -150,15 +152,25 @@ class CC_EXPORT TaskGraphRunner {
 
   typedef std::vector<const Task*> TaskVector;
 
+  // Maps a task to its node in a task graph. Vectors of these, and the edges
+  // of |TaskNamespace::graph|, are kept sorted by task so that they can be
+  // searched with a binary search.
+  typedef std::pair<const Task*, TaskGraph::Node*> NodeEntry;
+  typedef std::vector<NodeEntry> NodeEntryVector;
+
   struct TaskNamespace {
     typedef std::vector<TaskNamespace*> Vector;
 
     TaskNamespace();
     ~TaskNamespace();
 
-    // Current task graph.
+    // Current task graph. Its edges are sorted by task, so the dependents of a
+    // task can be found without scanning all edges.
     TaskGraph graph;
 
+    // Index of |graph.nodes|, sorted by task.
+    NodeEntryVector nodes;
+
     // Ordered set of tasks that are ready to run.
     PrioritizedTask::Vector ready_to_run_tasks;
 
@@ -189,6 +201,22 @@ class CC_EXPORT TaskGraphRunner {
                                b->ready_to_run_tasks.front());
   }
 
+  struct CompareNodeEntryTask {
+    bool operator()(const NodeEntry& a, const NodeEntry& b) const {
+      return std::less<const Task*>()(a.first, b.first);
+    }
+  };
+
+  struct CompareEdgeTask {
+    bool operator()(const TaskGraph::Edge& a, const TaskGraph::Edge& b) const {
+      return std::less<const Task*>()(a.task, b.task);
+    }
+  };
+
+  // Returns the node for |task| in |task_namespace|'s current graph.
+  static TaskGraph::Node* FindNode(TaskNamespace* task_namespace,
+                                   const Task* task);
+
   static bool HasFinishedRunningTasksInNamespace(
       const TaskNamespace* task_namespace) {
     return task_namespace->running_tasks.empty() &&
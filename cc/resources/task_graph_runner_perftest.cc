@@ -285,6 +285,7 @@ TEST_F(TaskGraphRunnerPerfTest, BuildTaskGraph) {
   RunBuildTaskGraphTest("2_32_0", 2, 32, 0);
   RunBuildTaskGraphTest("2_1_1", 2, 1, 1);
   RunBuildTaskGraphTest("2_32_1", 2, 32, 1);
+  RunBuildTaskGraphTest("2_256_2", 2, 256, 2);
 }
 
 TEST_F(TaskGraphRunnerPerfTest, ScheduleTasks) {
@@ -294,6 +295,7 @@ TEST_F(TaskGraphRunnerPerfTest, ScheduleTasks) {
   RunScheduleTasksTest("2_32_0", 2, 32, 0);
   RunScheduleTasksTest("2_1_1", 2, 1, 1);
   RunScheduleTasksTest("2_32_1", 2, 32, 1);
+  RunScheduleTasksTest("2_256_2", 2, 256, 2);
 }
 
 TEST_F(TaskGraphRunnerPerfTest, ScheduleAlternateTasks) {
@@ -303,6 +305,7 @@ TEST_F(TaskGraphRunnerPerfTest, ScheduleAlternateTasks) {
   RunScheduleAlternateTasksTest("2_32_0", 2, 32, 0);
   RunScheduleAlternateTasksTest("2_1_1", 2, 1, 1);
   RunScheduleAlternateTasksTest("2_32_1", 2, 32, 1);
+  RunScheduleAlternateTasksTest("2_256_2", 2, 256, 2);
 }
 
 TEST_F(TaskGraphRunnerPerfTest, ScheduleAndExecuteTasks) {
@@ -312,6 +315,7 @@ TEST_F(TaskGraphRunnerPerfTest, ScheduleAndExecuteTasks) {
   RunScheduleAndExecuteTasksTest("2_32_0", 2, 32, 0);
   RunScheduleAndExecuteTasksTest("2_1_1", 2, 1, 1);
   RunScheduleAndExecuteTasksTest("2_32_1", 2, 32, 1);
+  RunScheduleAndExecuteTasksTest("2_256_2", 2, 256, 2);
 }
 
 }  // namespace
@@ -61,6 +61,31 @@ void Tile::MarkRequiredForActivation() {
   tile_manager_->DidChangeTilePriority(this);
 }
 
+void Tile::SetPreviousTile(const Tile* previous_tile,
+                           const gfx::Rect& invalidated_content_rect) {
+  DCHECK(previous_tile->content_rect() == content_rect_);
+  DCHECK_EQ(previous_tile->contents_scale(), contents_scale_);
+
+  gfx::Rect invalidated_rect =
+      gfx::IntersectRects(invalidated_content_rect, content_rect_);
+  partial_raster_sources_.clear();
+  PartialRasterSource source = {previous_tile->id(), invalidated_rect};
+  partial_raster_sources_.push_back(source);
+
+  // Whatever |previous_tile| could be rastered from, this tile can be too, as
+  // long as both invalidations are repainted.
+  const PartialRasterSourceVector& previous_sources =
+      previous_tile->partial_raster_sources();
+  for (size_t i = 0; i < previous_sources.size() &&
+                         partial_raster_sources_.size() <
+                             kMaxPartialRasterSources;
+       ++i) {
+    PartialRasterSource earlier_source = previous_sources[i];
+    earlier_source.invalidated_content_rect.Union(invalidated_rect);
+    partial_raster_sources_.push_back(earlier_source);
+  }
+}
+
 void Tile::AsValueInto(base::debug::TracedValue* res) const {
   TracedValue::MakeDictIntoImplicitSnapshotWithCategory(
       TRACE_DISABLED_BY_DEFAULT("cc.debug"), res, "cc::Tile", this);
@@ -5,6 +5,8 @@
 #ifndef CC_RESOURCES_TILE_H_
 #define CC_RESOURCES_TILE_H_
 
+#include <vector>
+
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/memory/scoped_vector.h"
@@ -24,6 +26,18 @@ class CC_EXPORT Tile : public RefCountedManaged<Tile> {
 
   typedef uint64 Id;
 
+  // Content that an earlier tile at the same position rastered, and the part
+  // of this tile that differs from it.
+  struct PartialRasterSource {
+    Id content_id;
+    gfx::Rect invalidated_content_rect;
+  };
+  typedef std::vector<PartialRasterSource> PartialRasterSourceVector;
+
+  // The number of earlier tiles whose content is remembered. Two covers the
+  // resources of both the active tree and the tree it replaced.
+  static const size_t kMaxPartialRasterSources = 2;
+
   Id id() const {
     return id_;
   }
@@ -139,6 +153,18 @@ class CC_EXPORT Tile : public RefCountedManaged<Tile> {
     picture_pile_ = pile;
   }
 
+  // Records that this tile replaces |previous_tile|, whose content differs
+  // from this tile's only inside |invalidated_content_rect|. If a resource
+  // holding the previous content is still around when this tile is rastered,
+  // it can be reused and only the invalidated part repainted.
+  void SetPreviousTile(const Tile* previous_tile,
+                       const gfx::Rect& invalidated_content_rect);
+
+  // Most recent first.
+  const PartialRasterSourceVector& partial_raster_sources() const {
+    return partial_raster_sources_;
+  }
+
   size_t GPUMemoryUsageInBytes() const;
 
   gfx::Size size() const { return size_; }
@@ -191,6 +217,7 @@ class CC_EXPORT Tile : public RefCountedManaged<Tile> {
   int source_frame_number_;
   int flags_;
   bool is_shared_;
+  PartialRasterSourceVector partial_raster_sources_;
 
   Id id_;
   static Id s_next_id_;
@@ -32,12 +32,18 @@ namespace {
 // a tile is of solid color.
 const bool kUseColorEstimator = true;
 
+// Raster throughput samples are taken over at least this long, and each one
+// moves the estimate this far towards itself.
+const int kMinRasterThroughputSampleDurationMs = 50;
+const float kRasterThroughputSampleWeight = 0.25f;
+
 class RasterTaskImpl : public RasterTask {
  public:
   RasterTaskImpl(
       const Resource* resource,
       PicturePileImpl* picture_pile,
       const gfx::Rect& content_rect,
+      const gfx::Rect& invalidated_content_rect,
       float contents_scale,
       RasterMode raster_mode,
       TileResolution tile_resolution,
@@ -51,6 +57,7 @@ class RasterTaskImpl : public RasterTask {
       : RasterTask(resource, dependencies),
         picture_pile_(picture_pile),
         content_rect_(content_rect),
+        invalidated_content_rect_(invalidated_content_rect),
         contents_scale_(contents_scale),
         raster_mode_(raster_mode),
         tile_resolution_(tile_resolution),
@@ -68,7 +75,10 @@ class RasterTaskImpl : public RasterTask {
     DCHECK(picture_pile_.get());
     DCHECK(raster_buffer_);
 
-    if (analyze_picture_) {
+    // A partial raster draws into a resource that holds valid content
+    // already. Analyzing the whole tile would cost about as much as what is
+    // saved, so it is skipped.
+    if (analyze_picture_ && !IsPartialRaster()) {
       Analyze(picture_pile_.get());
       if (analysis_.is_solid_color)
         return;
@@ -94,6 +104,10 @@ class RasterTaskImpl : public RasterTask {
   virtual ~RasterTaskImpl() { DCHECK(!raster_buffer_); }
 
  private:
+  bool IsPartialRaster() const {
+    return invalidated_content_rect_ != content_rect_;
+  }
+
   void Analyze(const PicturePileImpl* picture_pile) {
     frame_viewer_instrumentation::ScopedAnalyzeTask analyze_task(
         tile_id_, tile_resolution_, source_frame_number_, layer_id_);
@@ -147,8 +161,16 @@ class RasterTaskImpl : public RasterTask {
     RenderingStatsInstrumentation* stats =
         tile_resolution_ == HIGH_RESOLUTION ? rendering_stats_ : NULL;
     DCHECK(picture_pile);
-    picture_pile->RasterToBitmap(
-        canvas.get(), content_rect_, contents_scale_, stats);
+    if (IsPartialRaster()) {
+      picture_pile->RasterInvalidationToBitmap(canvas.get(),
+                                               content_rect_,
+                                               invalidated_content_rect_,
+                                               contents_scale_,
+                                               stats);
+    } else {
+      picture_pile->RasterToBitmap(
+          canvas.get(), content_rect_, contents_scale_, stats);
+    }
 
     if (rendering_stats_->record_rendering_stats()) {
       base::TimeDelta current_rasterize_time =
@@ -167,6 +189,7 @@ class RasterTaskImpl : public RasterTask {
   PicturePileImpl::Analysis analysis_;
   scoped_refptr<PicturePileImpl> picture_pile_;
   gfx::Rect content_rect_;
+  gfx::Rect invalidated_content_rect_;
   float contents_scale_;
   RasterMode raster_mode_;
   TileResolution tile_resolution_;
@@ -224,6 +247,10 @@ class ImageDecodeTaskImpl : public ImageDecodeTask {
 
 const size_t kScheduledRasterTasksLimit = 32u;
 
+// Limits the number of tiles compressed each time memory is assigned, as the
+// compression runs on the compositor thread.
+const size_t kCompressedTilesPerAssignLimit = 8u;
+
 // Memory limit policy works by mapping some bin states to the NEVER bin.
 const ManagedTileBin kBinPolicyMap[NUM_TILE_MEMORY_LIMIT_POLICIES][NUM_BINS] = {
     // [ALLOW_NOTHING]
@@ -348,12 +375,16 @@ scoped_ptr<TileManager> TileManager::Create(
     base::SequencedTaskRunner* task_runner,
     ResourcePool* resource_pool,
     Rasterizer* rasterizer,
-    RenderingStatsInstrumentation* rendering_stats_instrumentation) {
+    RenderingStatsInstrumentation* rendering_stats_instrumentation,
+    bool use_partial_raster,
+    bool use_compressed_offscreen_tiles) {
   return make_scoped_ptr(new TileManager(client,
                                          task_runner,
                                          resource_pool,
                                          rasterizer,
-                                         rendering_stats_instrumentation));
+                                         rendering_stats_instrumentation,
+                                         use_partial_raster,
+                                         use_compressed_offscreen_tiles));
 }
 
 TileManager::TileManager(
@@ -361,7 +392,9 @@ TileManager::TileManager(
     const scoped_refptr<base::SequencedTaskRunner>& task_runner,
     ResourcePool* resource_pool,
     Rasterizer* rasterizer,
-    RenderingStatsInstrumentation* rendering_stats_instrumentation)
+    RenderingStatsInstrumentation* rendering_stats_instrumentation,
+    bool use_partial_raster,
+    bool use_compressed_offscreen_tiles)
     : client_(client),
       task_runner_(task_runner),
       resource_pool_(resource_pool),
@@ -376,6 +409,11 @@ TileManager::TileManager(
       did_initialize_visible_tile_(false),
       did_check_for_completed_tasks_since_last_schedule_tasks_(true),
       did_oom_on_last_assign_(false),
+      use_partial_raster_(use_partial_raster),
+      use_compressed_offscreen_tiles_(use_compressed_offscreen_tiles),
+      num_raster_tasks_in_flight_(0),
+      raster_sample_pixel_count_(0),
+      raster_throughput_in_content_pixels_per_second_(0.f),
       ready_to_activate_check_notifier_(
           task_runner_.get(),
           base::Bind(&TileManager::CheckIfReadyToActivate,
@@ -409,12 +447,17 @@ TileManager::~TileManager() {
 void TileManager::Release(Tile* tile) {
   DCHECK(TilePriority() == tile->combined_priority());
 
-  prioritized_tiles_dirty_ = true;
+  InvalidateTileBin(tile);
   released_tiles_.push_back(tile);
 }
 
 void TileManager::DidChangeTilePriority(Tile* tile) {
-  prioritized_tiles_dirty_ = true;
+  InvalidateTileBin(tile);
+}
+
+void TileManager::InvalidateTileBin(Tile* tile) {
+  if (!prioritized_tiles_dirty_)
+    tiles_with_invalid_bins_.insert(tile);
 }
 
 TaskSetCollection TileManager::TasksThatShouldBeForcedToComplete() const {
@@ -434,10 +477,6 @@ void TileManager::FreeResourcesForReleasedTiles() {
 }
 
 void TileManager::CleanUpReleasedTiles() {
-  // Make sure |prioritized_tiles_| doesn't contain any of the tiles
-  // we're about to delete.
-  DCHECK(prioritized_tiles_.IsEmpty());
-
   std::vector<Tile*>::iterator it = released_tiles_.begin();
   while (it != released_tiles_.end()) {
     Tile* tile = *it;
@@ -447,6 +486,10 @@ void TileManager::CleanUpReleasedTiles() {
       continue;
     }
 
+    // Make sure |prioritized_tiles_| doesn't contain the tile we're about to
+    // delete.
+    ManagedTileBin bin;
+    DCHECK(!prioritized_tiles_.GetTileBin(tile, &bin));
     DCHECK(!tile->HasResources());
     DCHECK(tiles_.find(tile->id()) != tiles_.end());
     tiles_.erase(tile->id());
@@ -459,14 +502,17 @@ void TileManager::CleanUpReleasedTiles() {
       image_decode_tasks_.erase(tile->layer_id());
     }
 
+    tiles_with_invalid_bins_.erase(tile);
     delete tile;
     it = released_tiles_.erase(it);
   }
 }
 
 void TileManager::UpdatePrioritizedTileSetIfNeeded() {
-  if (!prioritized_tiles_dirty_)
+  if (!prioritized_tiles_dirty_) {
+    UpdateInvalidatedTileBins();
     return;
+  }
 
   prioritized_tiles_.Clear();
 
@@ -474,9 +520,72 @@ void TileManager::UpdatePrioritizedTileSetIfNeeded() {
   CleanUpReleasedTiles();
 
   GetTilesWithAssignedBins(&prioritized_tiles_);
+  tiles_with_invalid_bins_.clear();
   prioritized_tiles_dirty_ = false;
 }
 
+void TileManager::UpdateInvalidatedTileBins() {
+  if (tiles_with_invalid_bins_.empty())
+    return;
+
+  TRACE_EVENT1("cc",
+               "TileManager::UpdateInvalidatedTileBins",
+               "count",
+               tiles_with_invalid_bins_.size());
+
+  FreeResourcesForReleasedTiles();
+
+  TileHashSet tiles_to_update;
+  tiles_to_update.swap(tiles_with_invalid_bins_);
+
+  // Released tiles are updated like any other tile. Their bin is NEVER_BIN,
+  // so unless they still have a raster task they leave the set here and are
+  // deleted by CleanUpReleasedTiles() below.
+  TileVector tiles_to_remove;
+  TileVector tiles_to_insert;
+  for (TileHashSet::iterator it = tiles_to_update.begin();
+       it != tiles_to_update.end();
+       ++it) {
+    Tile* tile = *it;
+    ManagedTileState& mts = tile->managed_state();
+    ManagedTileBin old_bin;
+    bool was_in_set = prioritized_tiles_.GetTileBin(tile, &old_bin);
+    TilePriority::PriorityBin old_priority_bin = mts.priority_bin;
+    TileResolution old_resolution = mts.resolution;
+    float old_distance_to_visible = mts.distance_to_visible;
+    bool old_required_for_activation = mts.required_for_activation;
+
+    bool is_in_set = AssignBinToTile(tile);
+
+    // Tiles that keep their bin and sort keys keep their place in the set.
+    if (was_in_set && is_in_set && old_bin == mts.bin &&
+        old_priority_bin == mts.priority_bin &&
+        old_resolution == mts.resolution &&
+        old_distance_to_visible == mts.distance_to_visible &&
+        old_required_for_activation == mts.required_for_activation)
+      continue;
+
+    if (was_in_set)
+      tiles_to_remove.push_back(tile);
+    if (is_in_set)
+      tiles_to_insert.push_back(tile);
+  }
+
+  prioritized_tiles_.RemoveTiles(tiles_to_remove);
+  for (TileVector::iterator it = tiles_to_insert.begin();
+       it != tiles_to_insert.end();
+       ++it) {
+    Tile* tile = *it;
+    prioritized_tiles_.InsertTile(tile, tile->managed_state().bin);
+  }
+
+  CleanUpReleasedTiles();
+
+  // Freeing resources above and in AssignBinToTile() doesn't change the bins
+  // that were just computed.
+  tiles_with_invalid_bins_.clear();
+}
+
 void TileManager::DidFinishRunningTasks(TaskSet task_set) {
   if (task_set == ALL) {
     TRACE_EVENT1("cc", "TileManager::DidFinishRunningTasks", "task_set", "ALL");
@@ -533,6 +642,7 @@ void TileManager::DidFinishRunningTasks(TaskSet task_set) {
           return;
 
         tile_version.set_rasterize_on_demand();
+        InvalidateTileBin(tile);
         client_->NotifyTileStateChanged(tile);
       }
     }
@@ -564,114 +674,120 @@ void TileManager::DidFinishRunningTasks(TaskSet task_set) {
 void TileManager::GetTilesWithAssignedBins(PrioritizedTileSet* tiles) {
   TRACE_EVENT0("cc", "TileManager::GetTilesWithAssignedBins");
 
-  const TileMemoryLimitPolicy memory_policy = global_state_.memory_limit_policy;
-  const TreePriority tree_priority = global_state_.tree_priority;
-
   // For each tree, bin into different categories of tiles.
   for (TileMap::const_iterator it = tiles_.begin(); it != tiles_.end(); ++it) {
     Tile* tile = it->second;
-    ManagedTileState& mts = tile->managed_state();
-
-    const ManagedTileState::TileVersion& tile_version =
-        tile->GetTileVersionForDrawing();
-    bool tile_is_ready_to_draw = tile_version.IsReadyToDraw();
-    bool tile_is_active = tile_is_ready_to_draw ||
-                          mts.tile_versions[mts.raster_mode].raster_task_.get();
-
-    // Get the active priority and bin.
-    TilePriority active_priority = tile->priority(ACTIVE_TREE);
-    ManagedTileBin active_bin = BinFromTilePriority(active_priority);
-
-    // Get the pending priority and bin.
-    TilePriority pending_priority = tile->priority(PENDING_TREE);
-    ManagedTileBin pending_bin = BinFromTilePriority(pending_priority);
-
-    bool pending_is_low_res = pending_priority.resolution == LOW_RESOLUTION;
-    bool pending_is_non_ideal =
-        pending_priority.resolution == NON_IDEAL_RESOLUTION;
-    bool active_is_non_ideal =
-        active_priority.resolution == NON_IDEAL_RESOLUTION;
-
-    // Adjust bin state based on if ready to draw.
-    active_bin = kBinReadyToDrawMap[tile_is_ready_to_draw][active_bin];
-    pending_bin = kBinReadyToDrawMap[tile_is_ready_to_draw][pending_bin];
-
-    // Adjust bin state based on if active.
-    active_bin = kBinIsActiveMap[tile_is_active][active_bin];
-    pending_bin = kBinIsActiveMap[tile_is_active][pending_bin];
-
-    // We never want to paint new non-ideal tiles, as we always have
-    // a high-res tile covering that content (paint that instead).
-    if (!tile_is_ready_to_draw && active_is_non_ideal)
-      active_bin = NEVER_BIN;
-    if (!tile_is_ready_to_draw && pending_is_non_ideal)
-      pending_bin = NEVER_BIN;
-
-    ManagedTileBin tree_bin[NUM_TREES];
-    tree_bin[ACTIVE_TREE] = kBinPolicyMap[memory_policy][active_bin];
-    tree_bin[PENDING_TREE] = kBinPolicyMap[memory_policy][pending_bin];
-
-    // Adjust pending bin state for low res tiles. This prevents pending tree
-    // low-res tiles from being initialized before high-res tiles.
-    if (pending_is_low_res)
-      tree_bin[PENDING_TREE] = std::max(tree_bin[PENDING_TREE], EVENTUALLY_BIN);
-
-    TilePriority tile_priority;
-    switch (tree_priority) {
-      case SAME_PRIORITY_FOR_BOTH_TREES:
-        mts.bin = std::min(tree_bin[ACTIVE_TREE], tree_bin[PENDING_TREE]);
-        tile_priority = tile->combined_priority();
-        break;
-      case SMOOTHNESS_TAKES_PRIORITY:
-        mts.bin = tree_bin[ACTIVE_TREE];
-        tile_priority = active_priority;
-        break;
-      case NEW_CONTENT_TAKES_PRIORITY:
-        mts.bin = tree_bin[PENDING_TREE];
-        tile_priority = pending_priority;
-        break;
-      default:
-        NOTREACHED();
-    }
-
-    // Bump up the priority if we determined it's NEVER_BIN on one tree,
-    // but is still required on the other tree.
-    bool is_in_never_bin_on_both_trees = tree_bin[ACTIVE_TREE] == NEVER_BIN &&
-                                         tree_bin[PENDING_TREE] == NEVER_BIN;
-
-    if (mts.bin == NEVER_BIN && !is_in_never_bin_on_both_trees)
-      mts.bin = tile_is_active ? AT_LAST_AND_ACTIVE_BIN : AT_LAST_BIN;
-
-    mts.resolution = tile_priority.resolution;
-    mts.priority_bin = tile_priority.priority_bin;
-    mts.distance_to_visible = tile_priority.distance_to_visible;
-    mts.required_for_activation = tile_priority.required_for_activation;
-
-    mts.visible_and_ready_to_draw =
-        tree_bin[ACTIVE_TREE] == NOW_AND_READY_TO_DRAW_BIN;
-
-    // Tiles that are required for activation shouldn't be in NEVER_BIN unless
-    // smoothness takes priority or memory policy allows nothing to be
-    // initialized.
-    DCHECK(!mts.required_for_activation || mts.bin != NEVER_BIN ||
-           tree_priority == SMOOTHNESS_TAKES_PRIORITY ||
-           memory_policy == ALLOW_NOTHING);
-
-    // If the tile is in NEVER_BIN and it does not have an active task, then we
-    // can release the resources early. If it does have the task however, we
-    // should keep it in the prioritized tile set to ensure that AssignGpuMemory
-    // can visit it.
-    if (mts.bin == NEVER_BIN &&
-        !mts.tile_versions[mts.raster_mode].raster_task_.get()) {
-      FreeResourcesForTileAndNotifyClientIfTileWasReadyToDraw(tile);
+    if (!AssignBinToTile(tile))
       continue;
-    }
 
     // Insert the tile into a priority set.
-    tiles->InsertTile(tile, mts.bin);
+    tiles->InsertTile(tile, tile->managed_state().bin);
   }
 }
 
+bool TileManager::AssignBinToTile(Tile* tile) {
+  const TileMemoryLimitPolicy memory_policy = global_state_.memory_limit_policy;
+  const TreePriority tree_priority = global_state_.tree_priority;
+
+  ManagedTileState& mts = tile->managed_state();
+  const ManagedTileState::TileVersion& tile_version =
+      tile->GetTileVersionForDrawing();
+  bool tile_is_ready_to_draw = tile_version.IsReadyToDraw();
+  bool tile_is_active = tile_is_ready_to_draw ||
+                        mts.tile_versions[mts.raster_mode].raster_task_.get();
+
+  // Get the active priority and bin.
+  TilePriority active_priority = tile->priority(ACTIVE_TREE);
+  ManagedTileBin active_bin = BinFromTilePriority(active_priority);
+
+  // Get the pending priority and bin.
+  TilePriority pending_priority = tile->priority(PENDING_TREE);
+  ManagedTileBin pending_bin = BinFromTilePriority(pending_priority);
+
+  bool pending_is_low_res = pending_priority.resolution == LOW_RESOLUTION;
+  bool pending_is_non_ideal =
+      pending_priority.resolution == NON_IDEAL_RESOLUTION;
+  bool active_is_non_ideal =
+      active_priority.resolution == NON_IDEAL_RESOLUTION;
+
+  // Adjust bin state based on if ready to draw.
+  active_bin = kBinReadyToDrawMap[tile_is_ready_to_draw][active_bin];
+  pending_bin = kBinReadyToDrawMap[tile_is_ready_to_draw][pending_bin];
+
+  // Adjust bin state based on if active.
+  active_bin = kBinIsActiveMap[tile_is_active][active_bin];
+  pending_bin = kBinIsActiveMap[tile_is_active][pending_bin];
+
+  // We never want to paint new non-ideal tiles, as we always have
+  // a high-res tile covering that content (paint that instead).
+  if (!tile_is_ready_to_draw && active_is_non_ideal)
+    active_bin = NEVER_BIN;
+  if (!tile_is_ready_to_draw && pending_is_non_ideal)
+    pending_bin = NEVER_BIN;
+
+  ManagedTileBin tree_bin[NUM_TREES];
+  tree_bin[ACTIVE_TREE] = kBinPolicyMap[memory_policy][active_bin];
+  tree_bin[PENDING_TREE] = kBinPolicyMap[memory_policy][pending_bin];
+
+  // Adjust pending bin state for low res tiles. This prevents pending tree
+  // low-res tiles from being initialized before high-res tiles.
+  if (pending_is_low_res)
+    tree_bin[PENDING_TREE] = std::max(tree_bin[PENDING_TREE], EVENTUALLY_BIN);
+
+  TilePriority tile_priority;
+  switch (tree_priority) {
+    case SAME_PRIORITY_FOR_BOTH_TREES:
+      mts.bin = std::min(tree_bin[ACTIVE_TREE], tree_bin[PENDING_TREE]);
+      tile_priority = tile->combined_priority();
+      break;
+    case SMOOTHNESS_TAKES_PRIORITY:
+      mts.bin = tree_bin[ACTIVE_TREE];
+      tile_priority = active_priority;
+      break;
+    case NEW_CONTENT_TAKES_PRIORITY:
+      mts.bin = tree_bin[PENDING_TREE];
+      tile_priority = pending_priority;
+      break;
+    default:
+      NOTREACHED();
+  }
+
+  // Bump up the priority if we determined it's NEVER_BIN on one tree,
+  // but is still required on the other tree.
+  bool is_in_never_bin_on_both_trees = tree_bin[ACTIVE_TREE] == NEVER_BIN &&
+                                       tree_bin[PENDING_TREE] == NEVER_BIN;
+
+  if (mts.bin == NEVER_BIN && !is_in_never_bin_on_both_trees)
+    mts.bin = tile_is_active ? AT_LAST_AND_ACTIVE_BIN : AT_LAST_BIN;
+
+  mts.resolution = tile_priority.resolution;
+  mts.priority_bin = tile_priority.priority_bin;
+  mts.distance_to_visible = tile_priority.distance_to_visible;
+  mts.required_for_activation = tile_priority.required_for_activation;
+
+  mts.visible_and_ready_to_draw =
+      tree_bin[ACTIVE_TREE] == NOW_AND_READY_TO_DRAW_BIN;
+
+  // Tiles that are required for activation shouldn't be in NEVER_BIN unless
+  // smoothness takes priority or memory policy allows nothing to be
+  // initialized.
+  DCHECK(!mts.required_for_activation || mts.bin != NEVER_BIN ||
+         tree_priority == SMOOTHNESS_TAKES_PRIORITY ||
+         memory_policy == ALLOW_NOTHING);
+
+  // If the tile is in NEVER_BIN and it does not have an active task, then we
+  // can release the resources early. If it does have the task however, we
+  // should keep it in the prioritized tile set to ensure that AssignGpuMemory
+  // can visit it.
+  if (mts.bin == NEVER_BIN &&
+      !mts.tile_versions[mts.raster_mode].raster_task_.get()) {
+    FreeResourcesForTileAndNotifyClientIfTileWasReadyToDraw(tile);
+    return false;
+  }
+
+  return true;
+}
+
 void TileManager::ManageTiles(const GlobalStateThatImpactsTilePriority& state) {
   TRACE_EVENT0("cc", "TileManager::ManageTiles");
 
@@ -789,6 +905,8 @@ void TileManager::AssignGpuMemoryToTiles(
   bool oomed_hard = false;
   bool have_hit_soft_memory = false;  // Soft memory comes after hard.
 
+  size_t compressions_left = kCompressedTilesPerAssignLimit;
+
   unsigned schedule_priority = 1u;
   for (PrioritizedTileSet::Iterator it(tiles, true); it; ++it) {
     Tile* tile = *it;
@@ -796,7 +914,11 @@ void TileManager::AssignGpuMemoryToTiles(
 
     mts.scheduled_priority = schedule_priority++;
 
-    mts.raster_mode = tile->DetermineOverallRasterMode();
+    RasterMode raster_mode = tile->DetermineOverallRasterMode();
+    if (mts.raster_mode != raster_mode) {
+      mts.raster_mode = raster_mode;
+      InvalidateTileBin(tile);
+    }
 
     ManagedTileState::TileVersion& tile_version =
         mts.tile_versions[mts.raster_mode];
@@ -825,10 +947,17 @@ void TileManager::AssignGpuMemoryToTiles(
     size_t tile_bytes = 0;
     size_t tile_resources = 0;
 
+    // Tiles that are not about to be drawn are kept compressed, so that
+    // more of them fit in the budget instead of being evicted and
+    // rasterized again when they come back into view.
+    if (use_compressed_offscreen_tiles_)
+      UpdateCompressionForTile(tile, &compressions_left);
+
     // It costs to maintain a resource.
     for (int mode = 0; mode < NUM_RASTER_MODES; ++mode) {
       if (mts.tile_versions[mode].resource_) {
-        tile_bytes += bytes_if_allocated;
+        tile_bytes += BytesConsumedByResource(
+            tile, mts.tile_versions[mode].resource_.get());
         tile_resources++;
       }
     }
@@ -854,8 +983,10 @@ void TileManager::AssignGpuMemoryToTiles(
       // This tile was already on screen and now its resources have been
       // released. In order to prevent checkerboarding, set this tile as
       // rasterize on demand immediately.
-      if (mts.visible_and_ready_to_draw)
+      if (mts.visible_and_ready_to_draw) {
         tile_version.set_rasterize_on_demand();
+        InvalidateTileBin(tile);
+      }
 
       oomed_soft = true;
       if (tile_uses_hard_limit) {
@@ -917,16 +1048,54 @@ void TileManager::AssignGpuMemoryToTiles(
   memory_stats_from_last_assign_.bytes_over = bytes_that_exceeded_memory_budget;
 }
 
+size_t TileManager::BytesConsumedByResource(
+    const Tile* tile,
+    const ScopedResource* resource) const {
+  if (!use_compressed_offscreen_tiles_)
+    return BytesConsumedIfAllocated(tile);
+  return resource_pool_->resource_provider()->BitmapMemoryUsageBytes(
+      resource->id());
+}
+
+void TileManager::UpdateCompressionForTile(Tile* tile,
+                                           size_t* compressions_left) {
+  ManagedTileState& mts = tile->managed_state();
+  ResourceProvider* resource_provider = resource_pool_->resource_provider();
+  // Decompress tiles that are about to be drawn now, rather than during the
+  // draw.
+  bool needs_pixels = mts.bin <= NOW_BIN;
+  for (int mode = 0; mode < NUM_RASTER_MODES; ++mode) {
+    ScopedResource* resource = mts.tile_versions[mode].resource_.get();
+    if (!resource)
+      continue;
+    if (needs_pixels) {
+      resource_provider->DecompressBitmap(resource->id());
+      continue;
+    }
+    if (!*compressions_left ||
+        resource_provider->IsBitmapCompressed(resource->id()))
+      continue;
+    resource_provider->CompressBitmap(resource->id());
+    --*compressions_left;
+  }
+}
+
 void TileManager::FreeResourceForTile(Tile* tile, RasterMode mode) {
   ManagedTileState& mts = tile->managed_state();
   if (mts.tile_versions[mode].resource_) {
-    resource_pool_->ReleaseResource(mts.tile_versions[mode].resource_.Pass());
+    if (use_partial_raster_ && mode == HIGH_QUALITY_RASTER_MODE) {
+      resource_pool_->ReleaseResourceWithContentId(
+          mts.tile_versions[mode].resource_.Pass(), tile->id());
+    } else {
+      resource_pool_->ReleaseResource(mts.tile_versions[mode].resource_.Pass());
+    }
 
     DCHECK_GE(bytes_releasable_, BytesConsumedIfAllocated(tile));
     DCHECK_GE(resources_releasable_, 1u);
 
     bytes_releasable_ -= BytesConsumedIfAllocated(tile);
     --resources_releasable_;
+    InvalidateTileBin(tile);
   }
 }
 
@@ -985,8 +1154,10 @@ void TileManager::ScheduleTasks(
     DCHECK(tile_version.requires_resource());
     DCHECK(!tile_version.resource_);
 
-    if (!tile_version.raster_task_.get())
+    if (!tile_version.raster_task_.get()) {
       tile_version.raster_task_ = CreateRasterTask(tile);
+      InvalidateTileBin(tile);
+    }
 
     TaskSetCollection task_sets;
     if (tile->required_for_activation())
@@ -1029,15 +1200,27 @@ scoped_refptr<ImageDecodeTask> TileManager::CreateImageDecodeTask(
 scoped_refptr<RasterTask> TileManager::CreateRasterTask(Tile* tile) {
   ManagedTileState& mts = tile->managed_state();
 
-  scoped_ptr<ScopedResource> resource =
-      resource_pool_->AcquireResource(tile->size());
+  scoped_ptr<ScopedResource> resource;
+  gfx::Rect invalidated_content_rect = tile->content_rect();
+  if (use_partial_raster_ && mts.raster_mode == HIGH_QUALITY_RASTER_MODE)
+    resource = AcquireResourceForPartialRaster(tile, &invalidated_content_rect);
+  if (!resource)
+    resource = resource_pool_->AcquireResource(tile->size());
   const ScopedResource* const_resource = resource.get();
 
-  // Create and queue all image decode tasks that this tile depends on.
+  int64 raster_pixel_count = invalidated_content_rect.size().GetArea();
+  if (num_raster_tasks_in_flight_++ == 0) {
+    raster_sample_start_time_ = base::TimeTicks::Now();
+    raster_sample_pixel_count_ = 0;
+  }
+
+  // Create and queue all image decode tasks that this tile depends on. Only
+  // the part of the tile that is rastered needs its images decoded.
   ImageDecodeTask::Vector decode_tasks;
   PixelRefTaskMap& existing_pixel_refs = image_decode_tasks_[tile->layer_id()];
-  for (PicturePileImpl::PixelRefIterator iter(
-           tile->content_rect(), tile->contents_scale(), tile->picture_pile());
+  for (PicturePileImpl::PixelRefIterator iter(invalidated_content_rect,
+                                              tile->contents_scale(),
+                                              tile->picture_pile());
        iter;
        ++iter) {
     SkPixelRef* pixel_ref = *iter;
@@ -1061,6 +1244,7 @@ scoped_refptr<RasterTask> TileManager::CreateRasterTask(Tile* tile) {
       new RasterTaskImpl(const_resource,
                          tile->picture_pile(),
                          tile->content_rect(),
+                         invalidated_content_rect,
                          tile->contents_scale(),
                          mts.raster_mode,
                          mts.resolution,
@@ -1073,10 +1257,37 @@ scoped_refptr<RasterTask> TileManager::CreateRasterTask(Tile* tile) {
                                     base::Unretained(this),
                                     tile->id(),
                                     base::Passed(&resource),
-                                    mts.raster_mode),
+                                    mts.raster_mode,
+                                    raster_pixel_count),
                          &decode_tasks));
 }
 
+scoped_ptr<ScopedResource> TileManager::AcquireResourceForPartialRaster(
+    Tile* tile,
+    gfx::Rect* invalidated_content_rect) {
+  // A resource that still holds this tile's own content, e.g. after it was
+  // released under memory pressure, doesn't need anything repainted.
+  scoped_ptr<ScopedResource> resource =
+      resource_pool_->TryAcquireResourceWithContentId(tile->id());
+  if (resource) {
+    *invalidated_content_rect = gfx::Rect();
+    return resource.Pass();
+  }
+
+  const Tile::PartialRasterSourceVector& sources =
+      tile->partial_raster_sources();
+  for (size_t i = 0; i < sources.size(); ++i) {
+    resource =
+        resource_pool_->TryAcquireResourceWithContentId(sources[i].content_id);
+    if (resource) {
+      DCHECK(resource->size() == tile->size());
+      *invalidated_content_rect = sources[i].invalidated_content_rect;
+      return resource.Pass();
+    }
+  }
+  return scoped_ptr<ScopedResource>();
+}
+
 void TileManager::OnImageDecodeTaskCompleted(int layer_id,
                                              SkPixelRef* pixel_ref,
                                              bool was_canceled) {
@@ -1101,16 +1312,24 @@ void TileManager::OnRasterTaskCompleted(
     Tile::Id tile_id,
     scoped_ptr<ScopedResource> resource,
     RasterMode raster_mode,
+    int64 raster_pixel_count,
     const PicturePileImpl::Analysis& analysis,
     bool was_canceled) {
   DCHECK(tiles_.find(tile_id) != tiles_.end());
 
+  DCHECK_GT(num_raster_tasks_in_flight_, 0u);
+  --num_raster_tasks_in_flight_;
+  if (!was_canceled)
+    raster_sample_pixel_count_ += raster_pixel_count;
+  UpdateRasterThroughput();
+
   Tile* tile = tiles_[tile_id];
   ManagedTileState& mts = tile->managed_state();
   ManagedTileState::TileVersion& tile_version = mts.tile_versions[raster_mode];
   DCHECK(tile_version.raster_task_.get());
   orphan_raster_tasks_.push_back(tile_version.raster_task_);
   tile_version.raster_task_ = NULL;
+  InvalidateTileBin(tile);
 
   if (was_canceled) {
     ++update_visible_tiles_stats_.canceled_count;
@@ -1138,6 +1357,30 @@ void TileManager::OnRasterTaskCompleted(
   client_->NotifyTileStateChanged(tile);
 }
 
+void TileManager::UpdateRasterThroughput() {
+  base::TimeDelta elapsed = base::TimeTicks::Now() - raster_sample_start_time_;
+  if (elapsed < base::TimeDelta::FromMilliseconds(
+                    kMinRasterThroughputSampleDurationMs)) {
+    // Short bursts of raster work are dominated by scheduling latency, so
+    // they are dropped rather than sampled.
+    if (!num_raster_tasks_in_flight_)
+      raster_sample_pixel_count_ = 0;
+    return;
+  }
+
+  float sample = raster_sample_pixel_count_ / elapsed.InSecondsF();
+  if (raster_throughput_in_content_pixels_per_second_ == 0.f) {
+    raster_throughput_in_content_pixels_per_second_ = sample;
+  } else {
+    raster_throughput_in_content_pixels_per_second_ +=
+        kRasterThroughputSampleWeight *
+        (sample - raster_throughput_in_content_pixels_per_second_);
+  }
+
+  raster_sample_start_time_ = base::TimeTicks::Now();
+  raster_sample_pixel_count_ = 0;
+}
+
 scoped_refptr<Tile> TileManager::CreateTile(PicturePileImpl* picture_pile,
                                             const gfx::Size& tile_size,
                                             const gfx::Rect& content_rect,
@@ -1157,7 +1400,7 @@ scoped_refptr<Tile> TileManager::CreateTile(PicturePileImpl* picture_pile,
 
   tiles_[tile->id()] = tile.get();
   used_layer_counts_[tile->layer_id()]++;
-  prioritized_tiles_dirty_ = true;
+  InvalidateTileBin(tile.get());
   return tile;
 }
 
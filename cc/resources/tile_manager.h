@@ -99,7 +99,9 @@ class CC_EXPORT TileManager : public RasterizerClient,
       base::SequencedTaskRunner* task_runner,
       ResourcePool* resource_pool,
       Rasterizer* rasterizer,
-      RenderingStatsInstrumentation* rendering_stats_instrumentation);
+      RenderingStatsInstrumentation* rendering_stats_instrumentation,
+      bool use_partial_raster,
+      bool use_compressed_offscreen_tiles);
   virtual ~TileManager();
 
   void ManageTiles(const GlobalStateThatImpactsTilePriority& state);
@@ -122,6 +124,12 @@ class CC_EXPORT TileManager : public RasterizerClient,
     return memory_stats_from_last_assign_;
   }
 
+  // The number of content pixels rastered per second while raster tasks were
+  // outstanding, averaged over recent samples. Zero until the first sample.
+  float raster_throughput_in_content_pixels_per_second() const {
+    return raster_throughput_in_content_pixels_per_second_;
+  }
+
   void InitializeTilesWithResourcesForTesting(const std::vector<Tile*>& tiles) {
     for (size_t i = 0; i < tiles.size(); ++i) {
       ManagedTileState& mts = tiles[i]->managed_state();
@@ -157,8 +165,15 @@ class CC_EXPORT TileManager : public RasterizerClient,
 
   void SetRasterizerForTesting(Rasterizer* rasterizer);
 
+  scoped_ptr<ScopedResource> AcquireResourceForPartialRasterForTesting(
+      Tile* tile,
+      gfx::Rect* invalidated_content_rect) {
+    return AcquireResourceForPartialRaster(tile, invalidated_content_rect);
+  }
+
   void FreeResourcesAndCleanUpReleasedTilesForTesting() {
     prioritized_tiles_.Clear();
+    prioritized_tiles_dirty_ = true;
     FreeResourcesForReleasedTiles();
     CleanUpReleasedTiles();
   }
@@ -177,7 +192,9 @@ class CC_EXPORT TileManager : public RasterizerClient,
               const scoped_refptr<base::SequencedTaskRunner>& task_runner,
               ResourcePool* resource_pool,
               Rasterizer* rasterizer,
-              RenderingStatsInstrumentation* rendering_stats_instrumentation);
+              RenderingStatsInstrumentation* rendering_stats_instrumentation,
+              bool use_partial_raster,
+              bool use_compressed_offscreen_tiles);
 
   // Methods called by Tile
   friend class Tile;
@@ -205,20 +222,34 @@ class CC_EXPORT TileManager : public RasterizerClient,
   void GetTilesWithAssignedBins(PrioritizedTileSet* tiles);
 
  private:
+  // Computes the bin and sort keys of |tile| from its priorities and state.
+  // Returns false if the tile doesn't belong in a PrioritizedTileSet, in which
+  // case its resources have been freed.
+  bool AssignBinToTile(Tile* tile);
+  // Marks the bin of |tile| as out of date. Only these tiles are re-binned
+  // by UpdatePrioritizedTileSetIfNeeded() unless the whole set is dirty.
+  void InvalidateTileBin(Tile* tile);
+  void UpdateInvalidatedTileBins();
+
   void OnImageDecodeTaskCompleted(int layer_id,
                                   SkPixelRef* pixel_ref,
                                   bool was_canceled);
   void OnRasterTaskCompleted(Tile::Id tile,
                              scoped_ptr<ScopedResource> resource,
                              RasterMode raster_mode,
+                             int64 raster_pixel_count,
                              const PicturePileImpl::Analysis& analysis,
                              bool was_canceled);
+  void UpdateRasterThroughput();
 
   inline size_t BytesConsumedIfAllocated(const Tile* tile) const {
     return Resource::MemorySizeBytes(tile->size(),
                                      resource_pool_->resource_format());
   }
 
+  size_t BytesConsumedByResource(const Tile* tile,
+                                 const ScopedResource* resource) const;
+  void UpdateCompressionForTile(Tile* tile, size_t* compressions_left);
   void FreeResourceForTile(Tile* tile, RasterMode mode);
   void FreeResourcesForTile(Tile* tile);
   void FreeUnusedResourcesForTile(Tile* tile);
@@ -226,6 +257,12 @@ class CC_EXPORT TileManager : public RasterizerClient,
   scoped_refptr<ImageDecodeTask> CreateImageDecodeTask(Tile* tile,
                                                        SkPixelRef* pixel_ref);
   scoped_refptr<RasterTask> CreateRasterTask(Tile* tile);
+  // Returns a resource that holds earlier content for |tile|, or NULL if none
+  // is available. On success, |invalidated_content_rect| is set to the part
+  // of the tile that still needs to be rastered.
+  scoped_ptr<ScopedResource> AcquireResourceForPartialRaster(
+      Tile* tile,
+      gfx::Rect* invalidated_content_rect);
   void UpdatePrioritizedTileSetIfNeeded();
 
   bool IsReadyToActivate() const;
@@ -241,7 +278,11 @@ class CC_EXPORT TileManager : public RasterizerClient,
   TileMap tiles_;
 
   PrioritizedTileSet prioritized_tiles_;
+  // Set when every tile needs to be re-binned, e.g. after the global state
+  // changed. Otherwise only |tiles_with_invalid_bins_| are updated.
   bool prioritized_tiles_dirty_;
+  typedef base::hash_set<Tile*> TileHashSet;
+  TileHashSet tiles_with_invalid_bins_;
 
   bool all_tiles_that_need_to_be_rasterized_have_memory_;
   bool all_tiles_required_for_activation_have_memory_;
@@ -258,6 +299,17 @@ class CC_EXPORT TileManager : public RasterizerClient,
   bool did_check_for_completed_tasks_since_last_schedule_tasks_;
   bool did_oom_on_last_assign_;
 
+  // When set, high quality resources are released to |resource_pool_| tagged
+  // with the id of their tile, and tiles that replace an invalidated tile
+  // only repaint the invalidation into a resource holding earlier content.
+  // This requires a rasterizer that draws directly into the resource.
+  const bool use_partial_raster_;
+
+  // When set, the bitmaps of ready tiles that are not about to be drawn are
+  // kept compressed, and are charged for their compressed size. Only used
+  // with software compositing.
+  const bool use_compressed_offscreen_tiles_;
+
   typedef base::hash_map<uint32_t, scoped_refptr<ImageDecodeTask> >
       PixelRefTaskMap;
   typedef base::hash_map<int, PixelRefTaskMap> LayerPixelRefTaskMap;
@@ -277,6 +329,12 @@ class CC_EXPORT TileManager : public RasterizerClient,
 
   std::vector<scoped_refptr<RasterTask> > orphan_raster_tasks_;
 
+  // Raster throughput is sampled over the time raster tasks are outstanding.
+  size_t num_raster_tasks_in_flight_;
+  base::TimeTicks raster_sample_start_time_;
+  int64 raster_sample_pixel_count_;
+  float raster_throughput_in_content_pixels_per_second_;
+
   UniqueNotifier ready_to_activate_check_notifier_;
 
   DISALLOW_COPY_AND_ASSIGN(TileManager);
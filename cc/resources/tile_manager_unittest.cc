@@ -30,7 +30,8 @@ class TileManagerTest : public testing::TestWithParam<bool>,
   TileManagerTest()
       : memory_limit_policy_(ALLOW_ANYTHING),
         max_tiles_(0),
-        ready_to_activate_(false) {}
+        ready_to_activate_(false),
+        use_partial_raster_(false) {}
 
   void Initialize(int max_tiles,
                   TileMemoryLimitPolicy memory_limit_policy,
@@ -48,8 +49,8 @@ class TileManagerTest : public testing::TestWithParam<bool>,
                                                   false);
     resource_pool_ = ResourcePool::Create(
         resource_provider_.get(), GL_TEXTURE_2D, RGBA_8888);
-    tile_manager_ =
-        make_scoped_ptr(new FakeTileManager(this, resource_pool_.get()));
+    tile_manager_ = make_scoped_ptr(
+        new FakeTileManager(this, resource_pool_.get(), use_partial_raster_));
 
     memory_limit_policy_ = memory_limit_policy;
     max_tiles_ = max_tiles;
@@ -136,6 +137,13 @@ class TileManagerTest : public testing::TestWithParam<bool>,
   }
 
   FakeTileManager* tile_manager() { return tile_manager_.get(); }
+  ResourcePool* resource_pool() { return resource_pool_.get(); }
+  PicturePileImpl* picture_pile() { return picture_pile_.get(); }
+
+  // Must be called before Initialize().
+  void set_use_partial_raster(bool use_partial_raster) {
+    use_partial_raster_ = use_partial_raster;
+  }
 
   int AssignedMemoryCount(const TileVector& tiles) {
     int has_memory_count = 0;
@@ -169,6 +177,7 @@ class TileManagerTest : public testing::TestWithParam<bool>,
   TileMemoryLimitPolicy memory_limit_policy_;
   int max_tiles_;
   bool ready_to_activate_;
+  bool use_partial_raster_;
   std::vector<PictureLayerImpl*> picture_layers_;
 };
 
@@ -477,6 +486,47 @@ TEST_P(TileManagerTest, TotalOOMMemoryToNewContent) {
 
 // If true, the max tile limit should be applied as bytes; if false,
 // as num_resources_limit.
+TEST_P(TileManagerTest, InvalidatedTileReusesPreviousResource) {
+  set_use_partial_raster(true);
+  Initialize(10, ALLOW_ANYTHING, SMOOTHNESS_TAKES_PRIORITY);
+  gfx::Size tile_size(100, 100);
+  gfx::Rect content_rect(tile_size);
+
+  scoped_refptr<Tile> previous_tile = tile_manager()->CreateTile(
+      picture_pile(), tile_size, content_rect, 1.0, 0, 0, 0);
+  std::vector<Tile*> previous_tiles(1, previous_tile.get());
+  tile_manager()->InitializeTilesWithResourcesForTesting(previous_tiles);
+  ResourceProvider::ResourceId previous_resource_id =
+      previous_tile->GetTileVersionForTesting(HIGH_QUALITY_RASTER_MODE)
+          .get_resource_id();
+
+  // The tile is invalidated and replaced, and its resource is released
+  // tagged with its content.
+  scoped_refptr<Tile> tile = tile_manager()->CreateTile(
+      picture_pile(), tile_size, content_rect, 1.0, 0, 0, 0);
+  gfx::Rect invalidation(10, 10, 20, 20);
+  tile->SetPreviousTile(previous_tile.get(), invalidation);
+  tile_manager()->ReleaseTileResourcesForTesting(previous_tiles);
+  resource_pool()->CheckBusyResources();
+
+  gfx::Rect invalidated_content_rect;
+  scoped_ptr<ScopedResource> resource =
+      tile_manager()->AcquireResourceForPartialRasterForTesting(
+          tile.get(), &invalidated_content_rect);
+  ASSERT_TRUE(resource);
+  EXPECT_EQ(previous_resource_id, resource->id());
+  EXPECT_EQ(invalidation, invalidated_content_rect);
+
+  // The content can only be taken back once.
+  scoped_refptr<Tile> other_tile = tile_manager()->CreateTile(
+      picture_pile(), tile_size, content_rect, 1.0, 0, 0, 0);
+  other_tile->SetPreviousTile(previous_tile.get(), invalidation);
+  EXPECT_FALSE(tile_manager()->AcquireResourceForPartialRasterForTesting(
+      other_tile.get(), &invalidated_content_rect));
+
+  resource_pool()->ReleaseResource(resource.Pass());
+}
+
 INSTANTIATE_TEST_CASE_P(TileManagerTests,
                         TileManagerTest,
                         ::testing::Values(true, false));
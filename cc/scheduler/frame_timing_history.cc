@@ -0,0 +1,279 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "cc/scheduler/frame_timing_history.h"
+
+#include "base/debug/trace_event.h"
+#include "base/debug/trace_event_argument.h"
+#include "base/logging.h"
+
+namespace cc {
+
+namespace {
+
+// The percentiles that are dumped for each stage.
+const double kDumpedPercentiles[] = {50.0, 90.0, 99.0};
+
+}  // namespace
+
+FrameTimingHistory::Record::Record()
+    : num_resources(0),
+      did_commit(false),
+      did_activate(false),
+      did_draw(false),
+      did_swap(false),
+      did_receive_swap_ack(false) {
+}
+
+scoped_refptr<base::debug::ConvertableToTraceFormat>
+FrameTimingHistory::Record::AsValue() const {
+  scoped_refptr<base::debug::TracedValue> state =
+      new base::debug::TracedValue();
+  AsValueInto(state.get());
+  return state;
+}
+
+void FrameTimingHistory::Record::AsValueInto(
+    base::debug::TracedValue* state) const {
+  state->SetDouble("frame_time_us", frame_time.ToInternalValue());
+  state->SetDouble("begin_frame_latency_ms",
+                   (begin_impl_frame_time - frame_time).InMillisecondsF());
+  if (did_commit)
+    state->SetDouble("commit_duration_ms", commit_duration.InMillisecondsF());
+  if (did_activate) {
+    state->SetDouble("activation_duration_ms",
+                     activation_duration.InMillisecondsF());
+  }
+  state->SetDouble("draw_duration_ms", draw_duration.InMillisecondsF());
+  if (did_receive_swap_ack) {
+    state->SetDouble("swap_ack_duration_ms",
+                     swap_ack_duration.InMillisecondsF());
+  }
+  state->SetDouble("raster_duration_ms", raster_duration.InMillisecondsF());
+  state->SetDouble("total_duration_ms", total_duration.InMillisecondsF());
+  state->SetInteger("num_resources", num_resources);
+  state->SetBoolean("did_swap", did_swap);
+}
+
+FrameTimingHistory::FrameTimingHistory(size_t max_size)
+    : max_size_(max_size), has_current_frame_(false), is_drawing_(false) {
+  for (int i = 0; i < STAGE_COUNT; ++i)
+    stage_histories_.push_back(make_scoped_ptr(
+        new RollingTimeDeltaHistory(max_size)));
+}
+
+FrameTimingHistory::~FrameTimingHistory() {
+}
+
+// static
+const char* FrameTimingHistory::StageToString(Stage stage) {
+  switch (stage) {
+    case STAGE_BEGIN_FRAME:
+      return "begin_frame";
+    case STAGE_COMMIT:
+      return "commit";
+    case STAGE_ACTIVATION:
+      return "activation";
+    case STAGE_DRAW:
+      return "draw";
+    case STAGE_SWAP_ACK:
+      return "swap_ack";
+    case STAGE_RASTER:
+      return "raster";
+    case STAGE_TOTAL:
+      return "total";
+    case STAGE_COUNT:
+      break;
+  }
+  NOTREACHED();
+  return "???";
+}
+
+void FrameTimingHistory::WillBeginImplFrame(base::TimeTicks frame_time,
+                                            base::TimeTicks now) {
+  // A frame that drew but never swapped, such as one without damage, is done
+  // once the next one starts. Frames that didn't draw are not interesting.
+  if (has_current_frame_ && current_frame_.did_draw)
+    FinishFrame(&current_frame_, draw_end_time_);
+
+  current_frame_ = Record();
+  current_frame_.frame_time = frame_time;
+  current_frame_.begin_impl_frame_time = now;
+  has_current_frame_ = true;
+  is_drawing_ = false;
+}
+
+void FrameTimingHistory::DidCommit(base::TimeTicks start_time,
+                                   base::TimeTicks end_time) {
+  if (!has_current_frame_)
+    return;
+  current_frame_.commit_duration += end_time - start_time;
+  current_frame_.did_commit = true;
+}
+
+void FrameTimingHistory::DidActivateSyncTree(base::TimeTicks start_time,
+                                             base::TimeTicks end_time) {
+  if (!has_current_frame_)
+    return;
+  current_frame_.activation_duration += end_time - start_time;
+  current_frame_.did_activate = true;
+}
+
+void FrameTimingHistory::WillDraw(base::TimeTicks start_time) {
+  if (!has_current_frame_)
+    return;
+  is_drawing_ = true;
+  draw_start_time_ = start_time;
+}
+
+void FrameTimingHistory::DidDraw(base::TimeTicks end_time) {
+  if (!has_current_frame_ || !is_drawing_)
+    return;
+  is_drawing_ = false;
+  current_frame_.draw_duration += end_time - draw_start_time_;
+  current_frame_.did_draw = true;
+  draw_end_time_ = end_time;
+  if (!current_frame_.did_swap)
+    return;
+  if (!current_frame_.did_receive_swap_ack) {
+    WaitForSwapAck();
+    return;
+  }
+  // The swap was acked before the draw returned.
+  has_current_frame_ = false;
+  FinishFrame(&current_frame_, end_time);
+}
+
+void FrameTimingHistory::DidAbortDraw() {
+  if (!is_drawing_)
+    return;
+  is_drawing_ = false;
+  current_frame_.did_swap = false;
+  current_frame_.did_receive_swap_ack = false;
+}
+
+void FrameTimingHistory::SetDrawStats(size_t num_resources,
+                                      base::TimeDelta raster_duration) {
+  if (!has_current_frame_)
+    return;
+  current_frame_.num_resources = num_resources;
+  current_frame_.raster_duration += raster_duration;
+}
+
+void FrameTimingHistory::DidSwapBuffers() {
+  if (!has_current_frame_)
+    return;
+  if (is_drawing_) {
+    // The draw isn't over yet, so its duration is only known in DidDraw().
+    current_frame_.did_swap = true;
+    return;
+  }
+  if (!current_frame_.did_draw)
+    return;
+  current_frame_.did_swap = true;
+  WaitForSwapAck();
+}
+
+void FrameTimingHistory::DidSwapBuffersComplete(base::TimeTicks now) {
+  if (pending_swap_acks_.empty()) {
+    if (has_current_frame_ && is_drawing_ && current_frame_.did_swap)
+      current_frame_.did_receive_swap_ack = true;
+    return;
+  }
+  Record record = pending_swap_acks_.front().first;
+  record.swap_ack_duration = now - pending_swap_acks_.front().second;
+  record.did_receive_swap_ack = true;
+  pending_swap_acks_.pop_front();
+  FinishFrame(&record, now);
+}
+
+void FrameTimingHistory::DidLoseOutputSurface() {
+  has_current_frame_ = false;
+  is_drawing_ = false;
+  pending_swap_acks_.clear();
+}
+
+base::TimeDelta FrameTimingHistory::Percentile(Stage stage,
+                                               double percent) const {
+  DCHECK_LT(stage, STAGE_COUNT);
+  return stage_histories_[stage]->Percentile(percent);
+}
+
+void FrameTimingHistory::WaitForSwapAck() {
+  pending_swap_acks_.push_back(std::make_pair(current_frame_, draw_end_time_));
+  has_current_frame_ = false;
+}
+
+void FrameTimingHistory::FinishFrame(Record* record,
+                                     base::TimeTicks end_time) {
+  record->total_duration = end_time - record->begin_impl_frame_time;
+
+  stage_histories_[STAGE_BEGIN_FRAME]->InsertSample(
+      record->begin_impl_frame_time - record->frame_time);
+  if (record->did_commit)
+    stage_histories_[STAGE_COMMIT]->InsertSample(record->commit_duration);
+  if (record->did_activate) {
+    stage_histories_[STAGE_ACTIVATION]->InsertSample(
+        record->activation_duration);
+  }
+  stage_histories_[STAGE_DRAW]->InsertSample(record->draw_duration);
+  if (record->did_receive_swap_ack)
+    stage_histories_[STAGE_SWAP_ACK]->InsertSample(record->swap_ack_duration);
+  // Raster time is only known when rendering stats are being recorded.
+  if (record->raster_duration > base::TimeDelta())
+    stage_histories_[STAGE_RASTER]->InsertSample(record->raster_duration);
+  stage_histories_[STAGE_TOTAL]->InsertSample(record->total_duration);
+
+  TRACE_EVENT_INSTANT1(TRACE_DISABLED_BY_DEFAULT("cc.debug.scheduler"),
+                       "FrameTimingHistory::Frame",
+                       TRACE_EVENT_SCOPE_THREAD,
+                       "frame",
+                       record->AsValue());
+
+  if (max_size_ == 0)
+    return;
+  if (records_.size() == max_size_)
+    records_.pop_front();
+  records_.push_back(*record);
+}
+
+scoped_refptr<base::debug::ConvertableToTraceFormat>
+FrameTimingHistory::AsValue() const {
+  scoped_refptr<base::debug::TracedValue> state =
+      new base::debug::TracedValue();
+  AsValueInto(state.get());
+  return state;
+}
+
+void FrameTimingHistory::AsValueInto(base::debug::TracedValue* state) const {
+  SummaryAsValueInto(state);
+  state->BeginArray("records");
+  for (std::deque<Record>::const_iterator it = records_.begin();
+       it != records_.end();
+       ++it) {
+    state->BeginDictionary();
+    it->AsValueInto(state);
+    state->EndDictionary();
+  }
+  state->EndArray();
+}
+
+void FrameTimingHistory::SummaryAsValueInto(
+    base::debug::TracedValue* state) const {
+  state->SetInteger("num_records", records_.size());
+  state->SetInteger("pending_swap_acks", pending_swap_acks_.size());
+  state->BeginDictionary("percentiles_ms");
+  for (int i = 0; i < STAGE_COUNT; ++i) {
+    Stage stage = static_cast<Stage>(i);
+    state->BeginArray(StageToString(stage));
+    for (size_t j = 0; j < arraysize(kDumpedPercentiles); ++j) {
+      state->AppendDouble(
+          Percentile(stage, kDumpedPercentiles[j]).InMillisecondsF());
+    }
+    state->EndArray();
+  }
+  state->EndDictionary();
+}
+
+}  // namespace cc
@@ -0,0 +1,135 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CC_SCHEDULER_FRAME_TIMING_HISTORY_H_
+#define CC_SCHEDULER_FRAME_TIMING_HISTORY_H_
+
+#include <deque>
+#include <utility>
+
+#include "base/basictypes.h"
+#include "base/memory/ref_counted.h"
+#include "base/time/time.h"
+#include "cc/base/cc_export.h"
+#include "cc/base/rolling_time_delta_history.h"
+#include "cc/base/scoped_ptr_vector.h"
+
+namespace base {
+namespace debug {
+class ConvertableToTraceFormat;
+class TracedValue;
+}
+}
+
+namespace cc {
+
+// Breaks each frame the scheduler draws down into its stages: when the
+// BeginImplFrame arrived, how long the commit, activation and draw done during
+// it took, and how long it took for the swap to be acked. Each finished frame
+// is emitted as a trace event, and the stages are kept in rolling histories so
+// that percentiles can be dumped for attributing jank.
+class CC_EXPORT FrameTimingHistory {
+ public:
+  enum Stage {
+    STAGE_BEGIN_FRAME,
+    STAGE_COMMIT,
+    STAGE_ACTIVATION,
+    STAGE_DRAW,
+    STAGE_SWAP_ACK,
+    STAGE_RASTER,
+    STAGE_TOTAL,
+    STAGE_COUNT
+  };
+
+  struct CC_EXPORT Record {
+    Record();
+
+    scoped_refptr<base::debug::ConvertableToTraceFormat> AsValue() const;
+    void AsValueInto(base::debug::TracedValue* state) const;
+
+    // The time the frame was meant to start at, from the BeginFrameArgs.
+    base::TimeTicks frame_time;
+    // The time the scheduler actually started the frame.
+    base::TimeTicks begin_impl_frame_time;
+    // Stages that did not happen during this frame are zero and their flags
+    // below are false.
+    base::TimeDelta commit_duration;
+    base::TimeDelta activation_duration;
+    base::TimeDelta draw_duration;
+    // From the end of the draw until the swap was acked.
+    base::TimeDelta swap_ack_duration;
+    // Raster work that finished since the previous draw, when rendering stats
+    // are being recorded.
+    base::TimeDelta raster_duration;
+    // From the BeginImplFrame until the swap ack, or until the end of the
+    // draw if there was no swap.
+    base::TimeDelta total_duration;
+    size_t num_resources;
+    bool did_commit;
+    bool did_activate;
+    bool did_draw;
+    bool did_swap;
+    bool did_receive_swap_ack;
+  };
+
+  explicit FrameTimingHistory(size_t max_size);
+  ~FrameTimingHistory();
+
+  static const char* StageToString(Stage stage);
+
+  void WillBeginImplFrame(base::TimeTicks frame_time, base::TimeTicks now);
+  void DidCommit(base::TimeTicks start_time, base::TimeTicks end_time);
+  void DidActivateSyncTree(base::TimeTicks start_time,
+                           base::TimeTicks end_time);
+  // The swap of a frame is reported while it is drawing, so DidSwapBuffers()
+  // may come between WillDraw() and DidDraw(), and so may its ack. The frame
+  // waits for its swap ack once the draw has ended.
+  void WillDraw(base::TimeTicks start_time);
+  void DidDraw(base::TimeTicks end_time);
+  void DidAbortDraw();
+  void SetDrawStats(size_t num_resources, base::TimeDelta raster_duration);
+  void DidSwapBuffers();
+  void DidSwapBuffersComplete(base::TimeTicks now);
+  // Drops the frame in progress and any frames still waiting on a swap ack,
+  // which will never arrive.
+  void DidLoseOutputSurface();
+
+  // Finished frames, oldest first.
+  const std::deque<Record>& records() const { return records_; }
+  base::TimeDelta Percentile(Stage stage, double percent) const;
+
+  scoped_refptr<base::debug::ConvertableToTraceFormat> AsValue() const;
+  void AsValueInto(base::debug::TracedValue* state) const;
+  // Only the percentiles of each stage, without the individual records.
+  void SummaryAsValueInto(base::debug::TracedValue* state) const;
+
+ private:
+  // Moves the current frame, which has drawn and swapped, to the frames
+  // waiting for swap acks.
+  void WaitForSwapAck();
+  void FinishFrame(Record* record, base::TimeTicks end_time);
+
+  size_t max_size_;
+  std::deque<Record> records_;
+  // Indexed by Stage.
+  ScopedPtrVector<RollingTimeDeltaHistory> stage_histories_;
+
+  // The frame the scheduler is currently in, if any.
+  bool has_current_frame_;
+  Record current_frame_;
+  // Set between WillDraw() and DidDraw() or DidAbortDraw().
+  bool is_drawing_;
+  base::TimeTicks draw_start_time_;
+  base::TimeTicks draw_end_time_;
+
+  // Frames that have swapped, paired with the time their draw ended, waiting
+  // for their swap acks in order.
+  std::deque<std::pair<Record, base::TimeTicks> > pending_swap_acks_;
+
+  DISALLOW_COPY_AND_ASSIGN(FrameTimingHistory);
+};
+
+}  // namespace cc
+
+#endif  // CC_SCHEDULER_FRAME_TIMING_HISTORY_H_
@@ -0,0 +1,197 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "cc/scheduler/frame_timing_history.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace cc {
+namespace {
+
+base::TimeTicks Ms(int64 ms) {
+  return base::TimeTicks() + base::TimeDelta::FromMilliseconds(ms);
+}
+
+TEST(FrameTimingHistoryTest, RecordsAllStages) {
+  FrameTimingHistory history(10);
+
+  history.WillBeginImplFrame(Ms(100), Ms(101));
+  history.DidCommit(Ms(102), Ms(105));
+  history.DidActivateSyncTree(Ms(105), Ms(106));
+  history.SetDrawStats(7, base::TimeDelta::FromMilliseconds(4));
+  history.WillDraw(Ms(110));
+  history.DidDraw(Ms(112));
+  history.DidSwapBuffers();
+  EXPECT_TRUE(history.records().empty());
+
+  history.DidSwapBuffersComplete(Ms(120));
+  ASSERT_EQ(1u, history.records().size());
+  const FrameTimingHistory::Record& record = history.records().back();
+  EXPECT_EQ(Ms(100), record.frame_time);
+  EXPECT_EQ(Ms(101), record.begin_impl_frame_time);
+  EXPECT_TRUE(record.did_commit);
+  EXPECT_EQ(3, record.commit_duration.InMilliseconds());
+  EXPECT_TRUE(record.did_activate);
+  EXPECT_EQ(1, record.activation_duration.InMilliseconds());
+  EXPECT_TRUE(record.did_draw);
+  EXPECT_EQ(2, record.draw_duration.InMilliseconds());
+  EXPECT_TRUE(record.did_receive_swap_ack);
+  EXPECT_EQ(8, record.swap_ack_duration.InMilliseconds());
+  EXPECT_EQ(4, record.raster_duration.InMilliseconds());
+  EXPECT_EQ(19, record.total_duration.InMilliseconds());
+  EXPECT_EQ(7u, record.num_resources);
+
+  EXPECT_EQ(base::TimeDelta::FromMilliseconds(1),
+            history.Percentile(FrameTimingHistory::STAGE_BEGIN_FRAME, 50.0));
+  EXPECT_EQ(base::TimeDelta::FromMilliseconds(19),
+            history.Percentile(FrameTimingHistory::STAGE_TOTAL, 50.0));
+}
+
+TEST(FrameTimingHistoryTest, SwapDuringDrawWaitsForAck) {
+  FrameTimingHistory history(10);
+
+  // The scheduler's client swaps before the draw returns.
+  history.WillBeginImplFrame(Ms(100), Ms(100));
+  history.WillDraw(Ms(105));
+  history.DidSwapBuffers();
+  history.DidDraw(Ms(108));
+  EXPECT_TRUE(history.records().empty());
+
+  // The frame is not closed by the next one, but by its swap ack.
+  history.WillBeginImplFrame(Ms(116), Ms(116));
+  EXPECT_TRUE(history.records().empty());
+  history.DidSwapBuffersComplete(Ms(120));
+  ASSERT_EQ(1u, history.records().size());
+  const FrameTimingHistory::Record& record = history.records().back();
+  EXPECT_TRUE(record.did_draw);
+  EXPECT_EQ(3, record.draw_duration.InMilliseconds());
+  EXPECT_TRUE(record.did_swap);
+  EXPECT_TRUE(record.did_receive_swap_ack);
+  EXPECT_EQ(12, record.swap_ack_duration.InMilliseconds());
+  EXPECT_EQ(20, record.total_duration.InMilliseconds());
+}
+
+TEST(FrameTimingHistoryTest, SwapAckedDuringDraw) {
+  FrameTimingHistory history(10);
+
+  history.WillBeginImplFrame(Ms(100), Ms(100));
+  history.WillDraw(Ms(105));
+  history.DidSwapBuffers();
+  history.DidSwapBuffersComplete(Ms(106));
+  history.DidDraw(Ms(108));
+  ASSERT_EQ(1u, history.records().size());
+  EXPECT_TRUE(history.records().back().did_receive_swap_ack);
+  EXPECT_EQ(base::TimeDelta(), history.records().back().swap_ack_duration);
+  EXPECT_EQ(8, history.records().back().total_duration.InMilliseconds());
+
+  // Nothing is left waiting for an ack.
+  history.WillBeginImplFrame(Ms(116), Ms(116));
+  history.WillDraw(Ms(120));
+  history.DidSwapBuffers();
+  history.DidDraw(Ms(121));
+  history.DidSwapBuffersComplete(Ms(125));
+  ASSERT_EQ(2u, history.records().size());
+  EXPECT_EQ(4, history.records().back().swap_ack_duration.InMilliseconds());
+}
+
+TEST(FrameTimingHistoryTest, AbortedDrawIsNotRecorded) {
+  FrameTimingHistory history(10);
+
+  history.WillBeginImplFrame(Ms(100), Ms(100));
+  history.WillDraw(Ms(105));
+  history.DidAbortDraw();
+  history.DidSwapBuffersComplete(Ms(110));
+  history.WillBeginImplFrame(Ms(116), Ms(116));
+  EXPECT_TRUE(history.records().empty());
+}
+
+TEST(FrameTimingHistoryTest, FramesWithoutDrawAreDropped) {
+  FrameTimingHistory history(10);
+
+  history.WillBeginImplFrame(Ms(100), Ms(100));
+  history.DidCommit(Ms(101), Ms(102));
+  history.WillBeginImplFrame(Ms(116), Ms(116));
+  history.DidSwapBuffersComplete(Ms(117));
+  EXPECT_TRUE(history.records().empty());
+  EXPECT_EQ(base::TimeDelta(),
+            history.Percentile(FrameTimingHistory::STAGE_COMMIT, 50.0));
+}
+
+TEST(FrameTimingHistoryTest, FrameWithoutSwapFinishesAtNextFrame) {
+  FrameTimingHistory history(10);
+
+  history.WillBeginImplFrame(Ms(100), Ms(100));
+  history.WillDraw(Ms(105));
+  history.DidDraw(Ms(108));
+  EXPECT_TRUE(history.records().empty());
+
+  history.WillBeginImplFrame(Ms(116), Ms(116));
+  ASSERT_EQ(1u, history.records().size());
+  EXPECT_FALSE(history.records().back().did_swap);
+  EXPECT_FALSE(history.records().back().did_commit);
+  EXPECT_EQ(8, history.records().back().total_duration.InMilliseconds());
+}
+
+TEST(FrameTimingHistoryTest, SwapAcksMatchFramesInOrder) {
+  FrameTimingHistory history(10);
+
+  history.WillBeginImplFrame(Ms(100), Ms(100));
+  history.WillDraw(Ms(105));
+  history.DidDraw(Ms(106));
+  history.DidSwapBuffers();
+  history.WillBeginImplFrame(Ms(116), Ms(116));
+  history.WillDraw(Ms(120));
+  history.DidDraw(Ms(121));
+  history.DidSwapBuffers();
+
+  history.DidSwapBuffersComplete(Ms(125));
+  history.DidSwapBuffersComplete(Ms(130));
+  ASSERT_EQ(2u, history.records().size());
+  EXPECT_EQ(19, history.records()[0].swap_ack_duration.InMilliseconds());
+  EXPECT_EQ(9, history.records()[1].swap_ack_duration.InMilliseconds());
+
+  // An ack without a pending swap is ignored.
+  history.DidSwapBuffersComplete(Ms(140));
+  EXPECT_EQ(2u, history.records().size());
+}
+
+TEST(FrameTimingHistoryTest, LostOutputSurfaceDropsPendingSwaps) {
+  FrameTimingHistory history(10);
+
+  history.WillBeginImplFrame(Ms(100), Ms(100));
+  history.WillDraw(Ms(105));
+  history.DidDraw(Ms(106));
+  history.DidSwapBuffers();
+  history.DidLoseOutputSurface();
+  history.DidSwapBuffersComplete(Ms(120));
+  EXPECT_TRUE(history.records().empty());
+}
+
+TEST(FrameTimingHistoryTest, KeepsLimitedRecordsAndPercentiles) {
+  FrameTimingHistory history(4);
+
+  for (int i = 1; i <= 10; ++i) {
+    int64 frame_start = i * 100;
+    history.WillBeginImplFrame(Ms(frame_start), Ms(frame_start));
+    history.WillDraw(Ms(frame_start));
+    history.DidDraw(Ms(frame_start + i));
+    history.DidSwapBuffers();
+    history.DidSwapBuffersComplete(Ms(frame_start + i));
+  }
+
+  // Only the last four frames, with draws of 7 to 10ms, are kept.
+  ASSERT_EQ(4u, history.records().size());
+  EXPECT_EQ(7, history.records().front().draw_duration.InMilliseconds());
+  EXPECT_EQ(10, history.records().back().draw_duration.InMilliseconds());
+  EXPECT_EQ(base::TimeDelta::FromMilliseconds(8),
+            history.Percentile(FrameTimingHistory::STAGE_DRAW, 50.0));
+  EXPECT_EQ(base::TimeDelta::FromMilliseconds(10),
+            history.Percentile(FrameTimingHistory::STAGE_DRAW, 100.0));
+  // No raster time was reported.
+  EXPECT_EQ(base::TimeDelta(),
+            history.Percentile(FrameTimingHistory::STAGE_RASTER, 50.0));
+}
+
+}  // namespace
+}  // namespace cc
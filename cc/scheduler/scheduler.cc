@@ -17,6 +17,13 @@
 
 namespace cc {
 
+namespace {
+
+// The number of drawn frames that are kept for the frame timing history.
+const size_t kFrameTimingHistorySize = 60;
+
+}  // namespace
+
 Scheduler::SyntheticBeginFrameSource::SyntheticBeginFrameSource(
     Scheduler* scheduler,
     scoped_refptr<DelayBasedTimeSource> time_source)
@@ -84,6 +91,7 @@ Scheduler::Scheduler(
       state_machine_(scheduler_settings),
       inside_process_scheduled_actions_(false),
       inside_action_(SchedulerStateMachine::ACTION_NONE),
+      frame_timing_history_(kFrameTimingHistorySize),
       weak_factory_(this) {
   TRACE_EVENT1(TRACE_DISABLED_BY_DEFAULT("cc.debug.scheduler"),
                "Scheduler::Scheduler",
@@ -198,6 +206,7 @@ void Scheduler::SetMaxSwapsPending(int max) {
 
 void Scheduler::DidSwapBuffers() {
   state_machine_.DidSwapBuffers();
+  frame_timing_history_.DidSwapBuffers();
 
   // There is no need to call ProcessScheduledActions here because
   // swapping should not trigger any new actions.
@@ -213,9 +222,15 @@ void Scheduler::SetSwapUsedIncompleteTile(bool used_incomplete_tile) {
 
 void Scheduler::DidSwapBuffersComplete() {
   state_machine_.DidSwapBuffersComplete();
+  frame_timing_history_.DidSwapBuffersComplete(Now());
   ProcessScheduledActions();
 }
 
+void Scheduler::SetDrawStats(size_t num_resources,
+                             base::TimeDelta raster_duration) {
+  frame_timing_history_.SetDrawStats(num_resources, raster_duration);
+}
+
 void Scheduler::SetImplLatencyTakesPriority(bool impl_latency_takes_priority) {
   state_machine_.SetImplLatencyTakesPriority(impl_latency_takes_priority);
   ProcessScheduledActions();
@@ -240,6 +255,7 @@ void Scheduler::DidManageTiles() {
 void Scheduler::DidLoseOutputSurface() {
   TRACE_EVENT0("cc", "Scheduler::DidLoseOutputSurface");
   state_machine_.DidLoseOutputSurface();
+  frame_timing_history_.DidLoseOutputSurface();
   last_set_needs_begin_frame_ = false;
   if (!settings_.begin_frame_scheduling_enabled) {
     synthetic_begin_frame_source_->SetNeedsBeginFrame(false,
@@ -533,6 +549,7 @@ void Scheduler::BeginImplFrame(const BeginFrameArgs& args) {
     state_machine_.SetSkipNextBeginMainFrameToReduceLatency();
   }
 
+  frame_timing_history_.WillBeginImplFrame(args.frame_time, Now());
   client_->WillBeginImplFrame(begin_impl_frame_args_);
   state_machine_.OnBeginImplFrame(begin_impl_frame_args_);
   devtools_instrumentation::DidBeginFrame(layer_tree_host_id_);
@@ -625,10 +642,26 @@ void Scheduler::PollToAdvanceCommitState() {
 }
 
 void Scheduler::DrawAndSwapIfPossible() {
+  // The client may swap, and so call DidSwapBuffers(), before returning.
+  frame_timing_history_.WillDraw(Now());
   DrawResult result = client_->ScheduledActionDrawAndSwapIfPossible();
+  DidDrawAndSwap(result);
   state_machine_.DidDrawIfPossibleCompleted(result);
 }
 
+void Scheduler::DrawAndSwapForced() {
+  frame_timing_history_.WillDraw(Now());
+  DrawResult result = client_->ScheduledActionDrawAndSwapForced();
+  DidDrawAndSwap(result);
+}
+
+void Scheduler::DidDrawAndSwap(DrawResult result) {
+  if (result == DRAW_SUCCESS)
+    frame_timing_history_.DidDraw(Now());
+  else
+    frame_timing_history_.DidAbortDraw();
+}
+
 void Scheduler::ProcessScheduledActions() {
   // We do not allow ProcessScheduledActions to be recursive.
   // The top-level call will iteratively execute the next action for us anyway.
@@ -659,20 +692,26 @@ void Scheduler::ProcessScheduledActions() {
       case SchedulerStateMachine::ACTION_SEND_BEGIN_MAIN_FRAME:
         client_->ScheduledActionSendBeginMainFrame();
         break;
-      case SchedulerStateMachine::ACTION_COMMIT:
+      case SchedulerStateMachine::ACTION_COMMIT: {
+        base::TimeTicks start_time = Now();
         client_->ScheduledActionCommit();
+        frame_timing_history_.DidCommit(start_time, Now());
         break;
+      }
       case SchedulerStateMachine::ACTION_UPDATE_VISIBLE_TILES:
         client_->ScheduledActionUpdateVisibleTiles();
         break;
-      case SchedulerStateMachine::ACTION_ACTIVATE_SYNC_TREE:
+      case SchedulerStateMachine::ACTION_ACTIVATE_SYNC_TREE: {
+        base::TimeTicks start_time = Now();
         client_->ScheduledActionActivateSyncTree();
+        frame_timing_history_.DidActivateSyncTree(start_time, Now());
         break;
+      }
       case SchedulerStateMachine::ACTION_DRAW_AND_SWAP_IF_POSSIBLE:
         DrawAndSwapIfPossible();
         break;
       case SchedulerStateMachine::ACTION_DRAW_AND_SWAP_FORCED:
-        client_->ScheduledActionDrawAndSwapForced();
+        DrawAndSwapForced();
         break;
       case SchedulerStateMachine::ACTION_DRAW_AND_SWAP_ABORT:
         // No action is actually performed, but this allows the state machine to
@@ -751,6 +790,10 @@ void Scheduler::AsValueInto(base::debug::TracedValue* state) const {
       "commit_to_activate_duration_estimate_ms",
       client_->CommitToActivateDurationEstimate().InMillisecondsF());
   state->EndDictionary();
+
+  state->BeginDictionary("frame_timing_history");
+  frame_timing_history_.SummaryAsValueInto(state);
+  state->EndDictionary();
 }
 
 bool Scheduler::CanCommitAndActivateBeforeDeadline() const {
@@ -16,6 +16,7 @@
 #include "cc/output/begin_frame_args.h"
 #include "cc/scheduler/delay_based_time_source.h"
 #include "cc/scheduler/draw_result.h"
+#include "cc/scheduler/frame_timing_history.h"
 #include "cc/scheduler/scheduler_settings.h"
 #include "cc/scheduler/scheduler_state_machine.h"
 
@@ -89,6 +90,11 @@ class CC_EXPORT Scheduler {
   void SetSwapUsedIncompleteTile(bool used_incomplete_tile);
   void DidSwapBuffersComplete();
 
+  // Adds the number of resources in use and the raster time since the
+  // previous draw to the record of the frame being drawn. Should be called
+  // from within ScheduledActionDrawAndSwap*().
+  void SetDrawStats(size_t num_resources, base::TimeDelta raster_duration);
+
   void SetImplLatencyTakesPriority(bool impl_latency_takes_priority);
 
   void NotifyReadyToCommit();
@@ -130,6 +136,11 @@ class CC_EXPORT Scheduler {
   scoped_refptr<base::debug::ConvertableToTraceFormat> AsValue() const;
   void AsValueInto(base::debug::TracedValue* state) const;
 
+  // A per-frame breakdown of the most recently drawn frames.
+  const FrameTimingHistory& frame_timing_history() const {
+    return frame_timing_history_;
+  }
+
   void SetContinuousPainting(bool continuous_painting) {
     state_machine_.SetContinuousPainting(continuous_painting);
   }
@@ -201,6 +212,8 @@ class CC_EXPORT Scheduler {
   bool inside_process_scheduled_actions_;
   SchedulerStateMachine::Action inside_action_;
 
+  FrameTimingHistory frame_timing_history_;
+
   base::TimeDelta VSyncInterval() { return vsync_interval_; }
 
  private:
@@ -214,6 +227,8 @@ class CC_EXPORT Scheduler {
   void SetupNextBeginFrameWhenVSyncThrottlingDisabled(bool needs_begin_frame);
   void SetupPollingMechanisms(bool needs_begin_frame);
   void DrawAndSwapIfPossible();
+  void DrawAndSwapForced();
+  void DidDrawAndSwap(DrawResult result);
   void ProcessScheduledActions();
   bool CanCommitAndActivateBeforeDeadline() const;
   void AdvanceCommitStateIfPossible();
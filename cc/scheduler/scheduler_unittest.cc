@@ -1943,5 +1943,51 @@ TEST(SchedulerTest, ScheduledActionActivateAfterBecomingInvisible) {
   EXPECT_SINGLE_ACTION("ScheduledActionActivateSyncTree", client);
 }
 
+TEST(SchedulerTest, FrameTimingHistoryRecordsDrawnFrames) {
+  FakeSchedulerClient client;
+  SchedulerSettings scheduler_settings;
+  TestScheduler* scheduler = client.CreateScheduler(scheduler_settings);
+  scheduler->SetCanStart();
+  scheduler->SetVisible(true);
+  scheduler->SetCanDraw(true);
+
+  EXPECT_SINGLE_ACTION("ScheduledActionBeginOutputSurfaceCreation", client);
+  InitializeOutputSurfaceAndFirstCommit(scheduler, &client);
+  client.SetAutomaticSwapAck(false);
+  const FrameTimingHistory& history = scheduler->frame_timing_history();
+  size_t num_records = history.records().size();
+
+  client.Reset();
+  scheduler->SetNeedsCommit();
+  EXPECT_SINGLE_ACTION("SetNeedsBeginFrame", client);
+
+  client.Reset();
+  client.AdvanceFrame();
+  EXPECT_ACTION("WillBeginImplFrame", client, 0, 2);
+  EXPECT_ACTION("ScheduledActionSendBeginMainFrame", client, 1, 2);
+
+  client.Reset();
+  scheduler->NotifyBeginMainFrameStarted();
+  scheduler->NotifyReadyToCommit();
+  EXPECT_SINGLE_ACTION("ScheduledActionCommit", client);
+
+  // The frame draws at the deadline, but isn't finished until it is acked.
+  client.Reset();
+  client.task_runner().RunTasksWhile(client.ImplFrameDeadlinePending(true));
+  EXPECT_TRUE(client.HasAction("ScheduledActionDrawAndSwapIfPossible"));
+  EXPECT_EQ(num_records, history.records().size());
+
+  client.now_src()->AdvanceNow(base::TimeDelta::FromMilliseconds(5));
+  scheduler->DidSwapBuffersComplete();
+  ASSERT_EQ(num_records + 1, history.records().size());
+  const FrameTimingHistory::Record& record = history.records().back();
+  EXPECT_TRUE(record.did_commit);
+  EXPECT_FALSE(record.did_activate);
+  EXPECT_TRUE(record.did_draw);
+  EXPECT_TRUE(record.did_swap);
+  EXPECT_TRUE(record.did_receive_swap_ack);
+  EXPECT_EQ(base::TimeDelta::FromMilliseconds(5), record.swap_ack_duration);
+}
+
 }  // namespace
 }  // namespace cc
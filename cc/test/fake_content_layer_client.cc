@@ -4,11 +4,42 @@
 
 #include "cc/test/fake_content_layer_client.h"
 
+#include "cc/resources/display_item_list.h"
 #include "third_party/skia/include/core/SkCanvas.h"
+#include "third_party/skia/include/core/SkPictureRecorder.h"
+#include "ui/gfx/rect_conversions.h"
 #include "ui/gfx/skia_util.h"
 
 namespace cc {
 
+namespace {
+
+// Returns the layer space rect that drawing |rect| with |paint| can touch,
+// clipped to |clip|.
+gfx::Rect ItemRect(const SkRect& rect,
+                   const SkPaint& paint,
+                   const gfx::Rect& clip) {
+  gfx::Rect item_rect = clip;
+  if (paint.canComputeFastBounds()) {
+    SkRect storage;
+    item_rect.Intersect(gfx::ToEnclosingRect(
+        gfx::SkRectToRectF(paint.computeFastBounds(rect, &storage))));
+  }
+  return item_rect;
+}
+
+// Starts recording an item covering |item_rect|. The returned canvas is in
+// layer space.
+SkCanvas* BeginItem(SkPictureRecorder* recorder, const gfx::Rect& item_rect) {
+  SkCanvas* canvas = recorder->beginRecording(
+      item_rect.width(), item_rect.height(), NULL);
+  canvas->translate(-item_rect.x(), -item_rect.y());
+  canvas->clipRect(gfx::RectToSkRect(item_rect));
+  return canvas;
+}
+
+}  // namespace
+
 FakeContentLayerClient::FakeContentLayerClient()
     : fill_with_nonsolid_color_(false), last_canvas_(NULL) {
 }
@@ -54,6 +85,71 @@ void FakeContentLayerClient::PaintContents(
   }
 }
 
+scoped_refptr<DisplayItemList>
+FakeContentLayerClient::PaintContentsToDisplayList(
+    const gfx::Rect& clip,
+    ContentLayerClient::GraphicsContextStatus gc_status) {
+  last_context_status_ = gc_status;
+
+  scoped_refptr<DisplayItemList> display_list = DisplayItemList::Create();
+  for (RectPaintVector::const_iterator it = draw_rects_.begin();
+      it != draw_rects_.end(); ++it) {
+    const gfx::RectF& draw_rect = it->first;
+    const SkPaint& paint = it->second;
+    gfx::Rect item_rect =
+        ItemRect(gfx::RectFToSkRect(draw_rect), paint, clip);
+    if (item_rect.IsEmpty())
+      continue;
+
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = BeginItem(&recorder, item_rect);
+    canvas->drawRectCoords(draw_rect.x(),
+                           draw_rect.y(),
+                           draw_rect.right(),
+                           draw_rect.bottom(),
+                           paint);
+    display_list->AppendItem(skia::AdoptRef(recorder.endRecording()),
+                             item_rect.origin());
+  }
+
+  for (BitmapVector::const_iterator it = draw_bitmaps_.begin();
+      it != draw_bitmaps_.end(); ++it) {
+    SkRect bitmap_rect = SkRect::MakeXYWH(it->point.x(),
+                                          it->point.y(),
+                                          it->bitmap.width(),
+                                          it->bitmap.height());
+    gfx::Rect item_rect = ItemRect(bitmap_rect, it->paint, clip);
+    if (item_rect.IsEmpty())
+      continue;
+
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = BeginItem(&recorder, item_rect);
+    canvas->drawBitmap(it->bitmap, it->point.x(), it->point.y(), &it->paint);
+    display_list->AppendItem(skia::AdoptRef(recorder.endRecording()),
+                             item_rect.origin());
+  }
+
+  if (fill_with_nonsolid_color_) {
+    gfx::RectF draw_rect = clip;
+    draw_rect.Inset(draw_rect.width() / 4.0f, draw_rect.height() / 4.0f);
+    SkPaint paint;
+    gfx::Rect item_rect =
+        ItemRect(gfx::RectFToSkRect(draw_rect), paint, clip);
+    if (!item_rect.IsEmpty()) {
+      SkPictureRecorder recorder;
+      SkCanvas* canvas = BeginItem(&recorder, item_rect);
+      canvas->drawRectCoords(draw_rect.x(),
+                             draw_rect.y(),
+                             draw_rect.right(),
+                             draw_rect.bottom(),
+                             paint);
+      display_list->AppendItem(skia::AdoptRef(recorder.endRecording()),
+                               item_rect.origin());
+    }
+  }
+  return display_list;
+}
+
 bool FakeContentLayerClient::FillsBoundsCompletely() const { return false; }
 
 }  // namespace cc
@@ -19,7 +19,9 @@ FakePictureLayerTilingClient::FakePictureLayerTilingClient()
       allow_create_tile_(true),
       max_tiles_for_interest_area_(10000),
       skewport_target_time_in_seconds_(1.0f),
-      skewport_extrapolation_limit_in_content_pixels_(2000) {
+      skewport_extrapolation_limit_in_content_pixels_(2000),
+      use_predictive_skewport_(false),
+      raster_throughput_in_content_pixels_per_second_(0.f) {
 }
 
 FakePictureLayerTilingClient::FakePictureLayerTilingClient(
@@ -33,7 +35,9 @@ FakePictureLayerTilingClient::FakePictureLayerTilingClient(
       recycled_twin_tiling_(NULL),
       allow_create_tile_(true),
       max_tiles_for_interest_area_(10000),
-      skewport_target_time_in_seconds_(1.0f) {
+      skewport_target_time_in_seconds_(1.0f),
+      use_predictive_skewport_(false),
+      raster_throughput_in_content_pixels_per_second_(0.f) {
 }
 
 FakePictureLayerTilingClient::~FakePictureLayerTilingClient() {
@@ -73,6 +77,16 @@ int FakePictureLayerTilingClient::GetSkewportExtrapolationLimitInContentPixels()
   return skewport_extrapolation_limit_in_content_pixels_;
 }
 
+bool FakePictureLayerTilingClient::UsePredictiveSkewport() const {
+  return use_predictive_skewport_;
+}
+
+float
+FakePictureLayerTilingClient::GetRasterThroughputInContentPixelsPerSecond()
+    const {
+  return raster_throughput_in_content_pixels_per_second_;
+}
+
 const Region* FakePictureLayerTilingClient::GetInvalidation() {
   return &invalidation_;
 }
@@ -29,6 +29,8 @@ class FakePictureLayerTilingClient : public PictureLayerTilingClient {
   virtual size_t GetMaxTilesForInterestArea() const OVERRIDE;
   virtual float GetSkewportTargetTimeInSeconds() const OVERRIDE;
   virtual int GetSkewportExtrapolationLimitInContentPixels() const OVERRIDE;
+  virtual bool UsePredictiveSkewport() const OVERRIDE;
+  virtual float GetRasterThroughputInContentPixelsPerSecond() const OVERRIDE;
 
   void SetTileSize(const gfx::Size& tile_size);
   gfx::Size TileSize() const { return tile_size_; }
@@ -56,6 +58,10 @@ class FakePictureLayerTilingClient : public PictureLayerTilingClient {
   void set_skewport_extrapolation_limit_in_content_pixels(int limit) {
     skewport_extrapolation_limit_in_content_pixels_ = limit;
   }
+  void set_use_predictive_skewport(bool use) { use_predictive_skewport_ = use; }
+  void set_raster_throughput_in_content_pixels_per_second(float throughput) {
+    raster_throughput_in_content_pixels_per_second_ = throughput;
+  }
   void set_tree(WhichTree tree) { tree_ = tree; }
 
   TileManager* tile_manager() const {
@@ -76,6 +82,8 @@ class FakePictureLayerTilingClient : public PictureLayerTilingClient {
   size_t max_tiles_for_interest_area_;
   float skewport_target_time_in_seconds_;
   int skewport_extrapolation_limit_in_content_pixels_;
+  bool use_predictive_skewport_;
+  float raster_throughput_in_content_pixels_per_second_;
   WhichTree tree_;
 };
 
@@ -85,7 +85,7 @@ void FakePicturePileImpl::AddRecordingAt(int x, int y) {
 
   scoped_refptr<Picture> picture(Picture::Create(
       bounds, &client_, tile_grid_info_, true, Picture::RECORD_NORMALLY));
-  picture_map_[std::pair<int, int>(x, y)].SetPicture(picture);
+  GetOrCreatePictureInfo(PictureMapKey(x, y)).SetPicture(picture);
   EXPECT_TRUE(HasRecordingAt(x, y));
 
   has_any_recordings_ = true;
@@ -99,7 +99,7 @@ void FakePicturePileImpl::RemoveRecordingAt(int x, int y) {
 
   if (!HasRecordingAt(x, y))
     return;
-  picture_map_.erase(std::pair<int, int>(x, y));
+  ErasePictureInfo(PictureMapKey(x, y));
   EXPECT_FALSE(HasRecordingAt(x, y));
 }
 
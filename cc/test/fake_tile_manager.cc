@@ -69,7 +69,9 @@ FakeTileManager::FakeTileManager(TileManagerClient* client)
                   base::MessageLoopProxy::current(),
                   NULL,
                   g_fake_rasterizer.Pointer(),
-                  NULL) {}
+                  NULL,
+                  false,
+                  false) {}
 
 FakeTileManager::FakeTileManager(TileManagerClient* client,
                                  ResourcePool* resource_pool)
@@ -77,7 +79,20 @@ FakeTileManager::FakeTileManager(TileManagerClient* client,
                   base::MessageLoopProxy::current(),
                   resource_pool,
                   g_fake_rasterizer.Pointer(),
-                  NULL) {}
+                  NULL,
+                  false,
+                  false) {}
+
+FakeTileManager::FakeTileManager(TileManagerClient* client,
+                                 ResourcePool* resource_pool,
+                                 bool use_partial_raster)
+    : TileManager(client,
+                  base::MessageLoopProxy::current(),
+                  resource_pool,
+                  g_fake_rasterizer.Pointer(),
+                  NULL,
+                  use_partial_raster,
+                  false) {}
 
 FakeTileManager::~FakeTileManager() {}
 
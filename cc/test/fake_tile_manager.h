@@ -16,6 +16,9 @@ class FakeTileManager : public TileManager {
  public:
   explicit FakeTileManager(TileManagerClient* client);
   FakeTileManager(TileManagerClient* client, ResourcePool* resource_pool);
+  FakeTileManager(TileManagerClient* client,
+                  ResourcePool* resource_pool,
+                  bool use_partial_raster);
   virtual ~FakeTileManager();
 
   bool HasBeenAssignedMemory(Tile* tile);
@@ -115,6 +115,16 @@ class SoftwareRendererWithExpandedViewport : public SoftwareRenderer {
       : SoftwareRenderer(client, settings, output_surface, resource_provider) {}
 };
 
+// Wrapper for a software renderer that draws quads in bands on worker threads.
+class SoftwareRendererWithParallelDraw : public SoftwareRenderer {
+ public:
+  SoftwareRendererWithParallelDraw(RendererClient* client,
+                                   const LayerTreeSettings* settings,
+                                   OutputSurface* output_surface,
+                                   ResourceProvider* resource_provider)
+      : SoftwareRenderer(client, settings, output_surface, resource_provider) {}
+};
+
 template<>
 inline void RendererPixelTest<GLRenderer>::SetUp() {
   SetUpGLRenderer(false);
@@ -183,6 +193,24 @@ inline bool RendererPixelTest<
   return true;
 }
 
+template <>
+inline void RendererPixelTest<SoftwareRendererWithParallelDraw>::SetUp() {
+  settings_.use_parallel_software_draw = true;
+  SetUpSoftwareRenderer();
+}
+
+template <>
+inline bool RendererPixelTest<
+    SoftwareRendererWithParallelDraw>::UseSkiaGPUBackend() const {
+  return false;
+}
+
+template <>
+inline bool RendererPixelTest<
+    SoftwareRendererWithParallelDraw>::ExpandedViewport() const {
+  return false;
+}
+
 typedef RendererPixelTest<GLRenderer> GLRendererPixelTest;
 typedef RendererPixelTest<SoftwareRenderer> SoftwareRendererPixelTest;
 
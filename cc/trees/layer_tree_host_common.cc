@@ -6,6 +6,8 @@
 
 #include <algorithm>
 
+#include "base/atomicops.h"
+#include "base/containers/scoped_ptr_hash_map.h"
 #include "base/debug/trace_event.h"
 #include "cc/base/math_util.h"
 #include "cc/layers/heads_up_display_layer_impl.h"
@@ -14,6 +16,7 @@
 #include "cc/layers/layer_iterator.h"
 #include "cc/layers/render_surface.h"
 #include "cc/layers/render_surface_impl.h"
+#include "cc/resources/task_graph_runner.h"
 #include "cc/trees/layer_sorter.h"
 #include "cc/trees/layer_tree_impl.h"
 #include "ui/gfx/rect_conversions.h"
@@ -64,27 +67,44 @@ static gfx::Vector2dF GetEffectiveTotalScrollOffset(LayerType* layer) {
   return offset;
 }
 
-inline gfx::Rect CalculateVisibleRectWithCachedLayerRect(
+// Computes the visible rect of a layer, if it can be done without projecting
+// the target surface rect into layer space. Otherwise returns false, and sets
+// |minimal_surface_rect| to the part of the target surface rect that has to be
+// projected with ProjectVisibleRect().
+inline bool CalculateVisibleRectWithoutProjection(
     const gfx::Rect& target_surface_rect,
     const gfx::Rect& layer_bound_rect,
     const gfx::Rect& layer_rect_in_target_space,
-    const gfx::Transform& transform) {
-  if (layer_rect_in_target_space.IsEmpty())
-    return gfx::Rect();
+    gfx::Rect* visible_rect,
+    gfx::Rect* minimal_surface_rect) {
+  if (layer_rect_in_target_space.IsEmpty()) {
+    *visible_rect = gfx::Rect();
+    return true;
+  }
 
   // Is this layer fully contained within the target surface?
-  if (target_surface_rect.Contains(layer_rect_in_target_space))
-    return layer_bound_rect;
+  if (target_surface_rect.Contains(layer_rect_in_target_space)) {
+    *visible_rect = layer_bound_rect;
+    return true;
+  }
 
   // If the layer doesn't fill up the entire surface, then find the part of
   // the surface rect where the layer could be visible. This avoids trying to
   // project surface rect points that are behind the projection point.
-  gfx::Rect minimal_surface_rect = target_surface_rect;
-  minimal_surface_rect.Intersect(layer_rect_in_target_space);
+  *minimal_surface_rect = target_surface_rect;
+  minimal_surface_rect->Intersect(layer_rect_in_target_space);
+
+  if (minimal_surface_rect->IsEmpty()) {
+    *visible_rect = gfx::Rect();
+    return true;
+  }
 
-  if (minimal_surface_rect.IsEmpty())
-    return gfx::Rect();
+  return false;
+}
 
+inline gfx::Rect ProjectVisibleRect(const gfx::Rect& minimal_surface_rect,
+                                    const gfx::Rect& layer_bound_rect,
+                                    const gfx::Transform& transform) {
   // Project the corners of the target surface rect into the layer space.
   // This bounding rectangle may be larger than it needs to be (being
   // axis-aligned), but is a reasonable filter on the space to consider.
@@ -104,6 +124,23 @@ inline gfx::Rect CalculateVisibleRectWithCachedLayerRect(
   return layer_rect;
 }
 
+inline gfx::Rect CalculateVisibleRectWithCachedLayerRect(
+    const gfx::Rect& target_surface_rect,
+    const gfx::Rect& layer_bound_rect,
+    const gfx::Rect& layer_rect_in_target_space,
+    const gfx::Transform& transform) {
+  gfx::Rect visible_rect;
+  gfx::Rect minimal_surface_rect;
+  if (CalculateVisibleRectWithoutProjection(target_surface_rect,
+                                            layer_bound_rect,
+                                            layer_rect_in_target_space,
+                                            &visible_rect,
+                                            &minimal_surface_rect))
+    return visible_rect;
+  return ProjectVisibleRect(
+      minimal_surface_rect, layer_bound_rect, transform);
+}
+
 gfx::Rect LayerTreeHostCommon::CalculateVisibleRect(
     const gfx::Rect& target_surface_rect,
     const gfx::Rect& layer_bound_rect,
@@ -376,17 +413,38 @@ static inline bool LayerClipsSubtree(LayerType* layer) {
   return layer->masks_to_bounds() || layer->mask_layer();
 }
 
+// A layer whose visible content rect can only be found by projecting part of
+// its target surface into layer space. Finding the inverse of the draw
+// transform and projecting through it is the most expensive part of computing
+// draw properties, and doesn't depend on any other layer, so these are
+// collected into a flat list during the recursion and computed afterwards,
+// possibly on several threads (see ProcessVisibleRectRequests()).
+template <typename LayerType>
+struct VisibleRectRequest {
+  VisibleRectRequest(LayerType* layer, const gfx::Rect& minimal_surface_rect)
+      : layer(layer), minimal_surface_rect(minimal_surface_rect) {}
+
+  LayerType* layer;
+  gfx::Rect minimal_surface_rect;
+};
+
 template <typename LayerType>
-static gfx::Rect CalculateVisibleContentRect(
+static void CalculateVisibleContentRect(
     LayerType* layer,
     const gfx::Rect& clip_rect_of_target_surface_in_target_space,
-    const gfx::Rect& layer_rect_in_target_space) {
+    const gfx::Rect& layer_rect_in_target_space,
+    std::vector<VisibleRectRequest<LayerType> >* visible_rect_requests) {
   DCHECK(layer->render_target());
 
+  gfx::Rect& visible_content_rect =
+      layer->draw_properties().visible_content_rect;
+
   // Nothing is visible if the layer bounds are empty.
   if (!layer->DrawsContent() || layer->content_bounds().IsEmpty() ||
-      layer->drawable_content_rect().IsEmpty())
-    return gfx::Rect();
+      layer->drawable_content_rect().IsEmpty()) {
+    visible_content_rect = gfx::Rect();
+    return;
+  }
 
   // Compute visible bounds in target surface space.
   gfx::Rect visible_rect_in_target_surface_space =
@@ -406,14 +464,134 @@ static gfx::Rect CalculateVisibleContentRect(
         clip_rect_of_target_surface_in_target_space);
   }
 
-  if (visible_rect_in_target_surface_space.IsEmpty())
-    return gfx::Rect();
+  if (visible_rect_in_target_surface_space.IsEmpty()) {
+    visible_content_rect = gfx::Rect();
+    return;
+  }
 
-  return CalculateVisibleRectWithCachedLayerRect(
-      visible_rect_in_target_surface_space,
-      gfx::Rect(layer->content_bounds()),
-      layer_rect_in_target_space,
-      layer->draw_transform());
+  gfx::Rect minimal_surface_rect;
+  if (CalculateVisibleRectWithoutProjection(
+          visible_rect_in_target_surface_space,
+          gfx::Rect(layer->content_bounds()),
+          layer_rect_in_target_space,
+          &visible_content_rect,
+          &minimal_surface_rect))
+    return;
+
+  visible_rect_requests->push_back(
+      VisibleRectRequest<LayerType>(layer, minimal_surface_rect));
+}
+
+template <typename LayerType>
+static void ComputeVisibleRectsForRequests(
+    const VisibleRectRequest<LayerType>* begin,
+    const VisibleRectRequest<LayerType>* end) {
+  for (const VisibleRectRequest<LayerType>* it = begin; it != end; ++it) {
+    LayerType* layer = it->layer;
+    layer->draw_properties().visible_content_rect =
+        ProjectVisibleRect(it->minimal_surface_rect,
+                           gfx::Rect(layer->content_bounds()),
+                           layer->draw_transform());
+  }
+}
+
+// Hands out chunks of a list of visible rect requests to whichever thread asks
+// for one next.
+template <typename LayerType>
+class VisibleRectWork {
+ public:
+  VisibleRectWork(const std::vector<VisibleRectRequest<LayerType> >* requests,
+                  size_t chunk_size)
+      : requests_(requests), chunk_size_(chunk_size), next_chunk_(0) {}
+
+  // Computes chunks until there are none left.
+  void Run() {
+    const size_t num_requests = requests_->size();
+    const VisibleRectRequest<LayerType>* requests = &requests_->front();
+    while (true) {
+      size_t begin =
+          static_cast<size_t>(
+              base::subtle::NoBarrier_AtomicIncrement(&next_chunk_, 1) - 1) *
+          chunk_size_;
+      if (begin >= num_requests)
+        return;
+      size_t end = std::min(begin + chunk_size_, num_requests);
+      ComputeVisibleRectsForRequests(requests + begin, requests + end);
+    }
+  }
+
+ private:
+  const std::vector<VisibleRectRequest<LayerType> >* requests_;
+  const size_t chunk_size_;
+  base::subtle::Atomic32 next_chunk_;
+
+  DISALLOW_COPY_AND_ASSIGN(VisibleRectWork);
+};
+
+template <typename LayerType>
+class VisibleRectTask : public Task {
+ public:
+  explicit VisibleRectTask(VisibleRectWork<LayerType>* work) : work_(work) {}
+
+  // Overridden from Task:
+  virtual void RunOnWorkerThread() OVERRIDE { work_->Run(); }
+
+ private:
+  virtual ~VisibleRectTask() {}
+
+  VisibleRectWork<LayerType>* work_;
+
+  DISALLOW_COPY_AND_ASSIGN(VisibleRectTask);
+};
+
+// Requests are handed out in chunks of this size.
+static const size_t kVisibleRectRequestsPerChunk = 32;
+// Maximum number of worker tasks that help the calling thread.
+static const size_t kMaxVisibleRectTasks = 3;
+
+template <typename LayerType>
+static void ProcessVisibleRectRequests(
+    const std::vector<VisibleRectRequest<LayerType> >& requests,
+    TaskGraphRunner* task_graph_runner) {
+  if (requests.empty())
+    return;
+
+  size_t num_chunks =
+      (requests.size() + kVisibleRectRequestsPerChunk - 1) /
+      kVisibleRectRequestsPerChunk;
+  if (!task_graph_runner || num_chunks < 2) {
+    ComputeVisibleRectsForRequests(&requests.front(),
+                                   &requests.front() + requests.size());
+    return;
+  }
+
+  TRACE_EVENT1("cc",
+               "LayerTreeHostCommon::ProcessVisibleRectRequests",
+               "num_requests",
+               requests.size());
+
+  VisibleRectWork<LayerType> work(&requests, kVisibleRectRequestsPerChunk);
+
+  NamespaceToken token = task_graph_runner->GetNamespaceToken();
+  Task::Vector tasks;
+  TaskGraph graph;
+  for (size_t i = 0; i < std::min(num_chunks - 1, kMaxVisibleRectTasks); ++i) {
+    scoped_refptr<Task> task(new VisibleRectTask<LayerType>(&work));
+    graph.nodes.push_back(TaskGraph::Node(task.get(), 0u, 0u));
+    tasks.push_back(task);
+  }
+  task_graph_runner->ScheduleTasks(token, &graph);
+
+  // The calling thread takes chunks too, so this finishes even if no worker
+  // gets to our tasks. Once there is nothing left to hand out, cancel the
+  // tasks that haven't started and wait for the ones that have.
+  work.Run();
+  TaskGraph empty;
+  task_graph_runner->ScheduleTasks(token, &empty);
+  task_graph_runner->WaitForTasksToFinishRunning(token);
+  Task::Vector completed_tasks;
+  task_graph_runner->CollectCompletedTasks(token, &completed_tasks);
+  DCHECK_EQ(tasks.size(), completed_tasks.size());
 }
 
 static inline bool TransformToParentIsKnown(LayerImpl* layer) { return true; }
@@ -1186,11 +1364,13 @@ static inline void RemoveSurfaceForEarlyExit(
 struct PreCalculateMetaInformationRecursiveData {
   bool layer_or_descendant_has_copy_request;
   bool layer_or_descendant_has_input_handler;
+  bool layer_or_descendant_has_untracked_dependencies;
   int num_unclipped_descendants;
 
   PreCalculateMetaInformationRecursiveData()
       : layer_or_descendant_has_copy_request(false),
         layer_or_descendant_has_input_handler(false),
+        layer_or_descendant_has_untracked_dependencies(false),
         num_unclipped_descendants(0) {}
 
   void Merge(const PreCalculateMetaInformationRecursiveData& data) {
@@ -1198,17 +1378,26 @@ struct PreCalculateMetaInformationRecursiveData {
         data.layer_or_descendant_has_copy_request;
     layer_or_descendant_has_input_handler |=
         data.layer_or_descendant_has_input_handler;
+    layer_or_descendant_has_untracked_dependencies |=
+        data.layer_or_descendant_has_untracked_dependencies;
     num_unclipped_descendants +=
         data.num_unclipped_descendants;
   }
 };
 
+static inline void UpdateAnimationStateForDrawProperties(Layer* layer) {}
+
+static inline void UpdateAnimationStateForDrawProperties(LayerImpl* layer) {
+  layer->UpdateAnimationStateForDrawProperties();
+}
+
 // Recursively walks the layer tree to compute any information that is needed
 // before doing the main recursion.
 template <typename LayerType>
 static void PreCalculateMetaInformation(
     LayerType* layer,
     PreCalculateMetaInformationRecursiveData* recursive_data) {
+  UpdateAnimationStateForDrawProperties(layer);
 
   layer->draw_properties().sorted_for_recursion = false;
   layer->draw_properties().has_child_with_a_scroll_parent = false;
@@ -1247,12 +1436,17 @@ static void PreCalculateMetaInformation(
       layer->have_wheel_event_handlers())
     recursive_data->layer_or_descendant_has_input_handler = true;
 
+  if (layer->clip_parent() || layer->HasContributingDelegatedRenderPasses())
+    recursive_data->layer_or_descendant_has_untracked_dependencies = true;
+
   layer->draw_properties().num_unclipped_descendants =
       recursive_data->num_unclipped_descendants;
   layer->draw_properties().layer_or_descendant_has_copy_request =
       recursive_data->layer_or_descendant_has_copy_request;
   layer->draw_properties().layer_or_descendant_has_input_handler =
       recursive_data->layer_or_descendant_has_input_handler;
+  layer->draw_properties().layer_or_descendant_has_untracked_dependencies =
+      recursive_data->layer_or_descendant_has_untracked_dependencies;
 }
 
 static void RoundTranslationComponents(gfx::Transform* transform) {
@@ -1269,6 +1463,8 @@ struct SubtreeGlobals {
   const LayerType* page_scale_application_layer;
   bool can_adjust_raster_scales;
   bool can_render_to_separate_surface;
+  std::vector<VisibleRectRequest<LayerType> >* visible_rect_requests;
+  DrawPropertiesCache::Data* draw_properties_cache;
 };
 
 template<typename LayerType>
@@ -1442,6 +1638,537 @@ static void SortLayerListContributions(
     (*unsorted)[i + start_index_for_all_contributions] = buffer[i];
 }
 
+// The results of CalculateDrawPropertiesInternal() for one LayerImpl subtree,
+// together with the inputs from outside the subtree that they depend on.
+//
+// What the subtree appended to the layer lists isn't copied, as that would
+// store every layer once per ancestor. Each record only notes what its own
+// layer appended, and ReuseCachedSubtree() rebuilds the rest from the records
+// of the layers below, which are current whenever the subtree is clean. Only
+// additions that were reordered after being appended are copied.
+struct CachedSubtree {
+  CachedSubtree()
+      : parent_draw_opacity(0.f),
+        parent_draw_opacity_is_animating(false),
+        parent_screen_space_opacity_is_animating(false),
+        parent_draw_transform_is_animating(false),
+        parent_screen_space_transform_is_animating(false),
+        parent_render_target(NULL),
+        cacheable(false),
+        layer_or_descendant_has_input_handler(false),
+        last_update(0),
+        children_visited(false),
+        added_to_layer_list(false),
+        added_to_render_surface_layer_list(false),
+        updated_accumulated_surface_state(false),
+        layer_list_additions_were_sorted(false),
+        render_surface_layer_list_additions_were_sorted(false) {}
+
+  DataForRecursion<LayerImpl> data_from_ancestor;
+  float parent_draw_opacity;
+  bool parent_draw_opacity_is_animating;
+  bool parent_screen_space_opacity_is_animating;
+  bool parent_draw_transform_is_animating;
+  bool parent_screen_space_transform_is_animating;
+  LayerImpl* parent_render_target;
+  bool cacheable;
+  // This is recomputed on every update, so the subtree may have gained or
+  // lost an input handler without being marked dirty.
+  bool layer_or_descendant_has_input_handler;
+
+  // The update that last computed or reused the subtree.
+  int last_update;
+  // False if the layer's subtree was skipped.
+  bool children_visited;
+  // Whether the layer appended itself to its target's layer list, and its
+  // render surface to the render surface layer list.
+  bool added_to_layer_list;
+  bool added_to_render_surface_layer_list;
+  // Whether the layer's drawable content rect was accumulated into the
+  // surface that its parent draws into.
+  bool updated_accumulated_surface_state;
+
+  // Set when children with scroll parents reordered the subtree's additions,
+  // or when the layer is the root of a 3d rendering context and sorted them.
+  bool layer_list_additions_were_sorted;
+  bool render_surface_layer_list_additions_were_sorted;
+  LayerImplList sorted_layer_list_additions;
+  LayerImplList sorted_render_surface_layer_list_additions;
+};
+
+struct DrawPropertiesCache::Data {
+  Data()
+      : max_texture_size(0),
+        device_scale_factor(0.f),
+        page_scale_factor(0.f),
+        page_scale_application_layer(NULL),
+        can_adjust_raster_scales(false),
+        can_render_to_separate_surface(false),
+        update_count(0),
+        last_accumulated_surface_state_update(NULL),
+        num_reused_subtrees(0) {}
+
+  // The globals the cached subtrees were computed with.
+  int max_texture_size;
+  float device_scale_factor;
+  float page_scale_factor;
+  const LayerImpl* page_scale_application_layer;
+  bool can_adjust_raster_scales;
+  bool can_render_to_separate_surface;
+
+  // Keyed by the id of the subtree's root layer.
+  base::ScopedPtrHashMap<int, CachedSubtree> subtrees;
+
+  // The number of the current update.
+  int update_count;
+  // The layer whose drawable content rect was accumulated last in the current
+  // update.
+  const LayerImpl* last_accumulated_surface_state_update;
+  // The number of subtrees that the current update reused.
+  size_t num_reused_subtrees;
+};
+
+DrawPropertiesCache::DrawPropertiesCache() : data_(new Data) {}
+
+DrawPropertiesCache::~DrawPropertiesCache() {}
+
+void DrawPropertiesCache::Clear() {
+  data_.reset(new Data);
+}
+
+size_t DrawPropertiesCache::num_reused_subtrees_for_testing() const {
+  return data_->num_reused_subtrees;
+}
+
+static void PrepareDrawPropertiesCache(
+    DrawPropertiesCache::Data* cache,
+    const SubtreeGlobals<LayerImpl>& globals) {
+  if (cache->max_texture_size != globals.max_texture_size ||
+      cache->device_scale_factor != globals.device_scale_factor ||
+      cache->page_scale_factor != globals.page_scale_factor ||
+      cache->page_scale_application_layer !=
+          globals.page_scale_application_layer ||
+      cache->can_adjust_raster_scales != globals.can_adjust_raster_scales ||
+      cache->can_render_to_separate_surface !=
+          globals.can_render_to_separate_surface) {
+    cache->subtrees.clear();
+    cache->max_texture_size = globals.max_texture_size;
+    cache->device_scale_factor = globals.device_scale_factor;
+    cache->page_scale_factor = globals.page_scale_factor;
+    cache->page_scale_application_layer = globals.page_scale_application_layer;
+    cache->can_adjust_raster_scales = globals.can_adjust_raster_scales;
+    cache->can_render_to_separate_surface =
+        globals.can_render_to_separate_surface;
+  }
+  ++cache->update_count;
+  cache->last_accumulated_surface_state_update = NULL;
+  cache->num_reused_subtrees = 0;
+}
+
+static inline void NoteAccumulatedSurfaceStateUpdate(
+    Layer* layer,
+    const SubtreeGlobals<Layer>& globals) {}
+
+static inline void NoteAccumulatedSurfaceStateUpdate(
+    LayerImpl* layer,
+    const SubtreeGlobals<LayerImpl>& globals) {
+  DrawPropertiesCache::Data* cache = globals.draw_properties_cache;
+  if (cache)
+    cache->last_accumulated_surface_state_update = layer;
+}
+
+// A scroll child is clipped by its scroll parent rather than by its ancestors,
+// so it has to be recomputed along with its scroll parent. Scroll parents are
+// visited first, see SortChildrenForRecursion().
+static void MarkScrollChildrenDirty(LayerImpl* layer) {
+  std::set<LayerImpl*>* scroll_children = layer->scroll_children();
+  if (!scroll_children)
+    return;
+  for (std::set<LayerImpl*>::iterator it = scroll_children->begin();
+       it != scroll_children->end();
+       ++it)
+    (*it)->MarkDrawPropertiesDirty();
+}
+
+static bool DataForRecursionIsEqual(const DataForRecursion<LayerImpl>& a,
+                                    const DataForRecursion<LayerImpl>& b) {
+  return a.parent_matrix == b.parent_matrix &&
+         a.full_hierarchy_matrix == b.full_hierarchy_matrix &&
+         a.scroll_compensation_matrix == b.scroll_compensation_matrix &&
+         a.fixed_container == b.fixed_container &&
+         a.clip_rect_in_target_space == b.clip_rect_in_target_space &&
+         a.clip_rect_of_target_surface_in_target_space ==
+             b.clip_rect_of_target_surface_in_target_space &&
+         a.maximum_animation_contents_scale ==
+             b.maximum_animation_contents_scale &&
+         a.ancestor_is_animating_scale == b.ancestor_is_animating_scale &&
+         a.ancestor_clips_subtree == b.ancestor_clips_subtree &&
+         a.nearest_occlusion_immune_ancestor_surface ==
+             b.nearest_occlusion_immune_ancestor_surface &&
+         a.in_subtree_of_page_scale_application_layer ==
+             b.in_subtree_of_page_scale_application_layer &&
+         a.subtree_can_use_lcd_text == b.subtree_can_use_lcd_text &&
+         a.subtree_is_visible_from_ancestor ==
+             b.subtree_is_visible_from_ancestor;
+}
+
+static bool CanReuseCachedSubtree(
+    const CachedSubtree& cached,
+    LayerImpl* layer,
+    const DataForRecursion<LayerImpl>& data_from_ancestor) {
+  if (!cached.cacheable || layer->draw_properties_dirty() ||
+      layer->descendant_draw_properties_dirty())
+    return false;
+
+  // The clip of a scroll child isn't part of the inputs compared below.
+  if (layer->scroll_parent())
+    return false;
+
+  // These are recomputed on every update, so a subtree may have gained a copy
+  // request or an input handler without being marked dirty.
+  const DrawProperties<LayerImpl>& draw_properties = layer->draw_properties();
+  if (draw_properties.layer_or_descendant_has_copy_request ||
+      draw_properties.layer_or_descendant_has_untracked_dependencies ||
+      draw_properties.layer_or_descendant_has_input_handler !=
+          cached.layer_or_descendant_has_input_handler)
+    return false;
+
+  LayerImpl* parent = layer->parent();
+  return parent->draw_opacity() == cached.parent_draw_opacity &&
+         parent->draw_opacity_is_animating() ==
+             cached.parent_draw_opacity_is_animating &&
+         parent->screen_space_opacity_is_animating() ==
+             cached.parent_screen_space_opacity_is_animating &&
+         parent->draw_transform_is_animating() ==
+             cached.parent_draw_transform_is_animating &&
+         parent->screen_space_transform_is_animating() ==
+             cached.parent_screen_space_transform_is_animating &&
+         parent->render_target() == cached.parent_render_target &&
+         DataForRecursionIsEqual(data_from_ancestor,
+                                 cached.data_from_ancestor);
+}
+
+static void RecordCachedSubtree(
+    LayerImpl* layer,
+    const DataForRecursion<LayerImpl>& data_from_ancestor,
+    const LayerImplList& render_surface_layer_list,
+    size_t render_surface_layer_list_start,
+    const LayerImplList& layer_list,
+    size_t layer_list_start,
+    DrawPropertiesCache::Data* cache) {
+  CachedSubtree* cached = cache->subtrees.get(layer->id());
+  if (!cached) {
+    cached = new CachedSubtree;
+    cache->subtrees.set(layer->id(), make_scoped_ptr(cached));
+  }
+
+  LayerImpl* parent = layer->parent();
+  const DrawProperties<LayerImpl>& draw_properties = layer->draw_properties();
+  cached->data_from_ancestor = data_from_ancestor;
+  cached->parent_draw_opacity = parent->draw_opacity();
+  cached->parent_draw_opacity_is_animating =
+      parent->draw_opacity_is_animating();
+  cached->parent_screen_space_opacity_is_animating =
+      parent->screen_space_opacity_is_animating();
+  cached->parent_draw_transform_is_animating =
+      parent->draw_transform_is_animating();
+  cached->parent_screen_space_transform_is_animating =
+      parent->screen_space_transform_is_animating();
+  cached->parent_render_target = parent->render_target();
+  cached->cacheable =
+      !draw_properties.layer_or_descendant_has_copy_request &&
+      !draw_properties.layer_or_descendant_has_untracked_dependencies;
+  cached->layer_or_descendant_has_input_handler =
+      draw_properties.layer_or_descendant_has_input_handler;
+
+  // All children are visited, if any is, and each was recorded or reused.
+  cached->last_update = cache->update_count;
+  cached->children_visited = false;
+  if (!layer->children().empty()) {
+    CachedSubtree* first_child =
+        cache->subtrees.get(layer->children()[0]->id());
+    cached->children_visited =
+        first_child && first_child->last_update == cache->update_count;
+  }
+
+  // A layer appends itself before anything in its subtree does.
+  cached->added_to_layer_list = !layer->render_surface() &&
+                                layer_list.size() > layer_list_start &&
+                                layer_list[layer_list_start] == layer;
+  cached->added_to_render_surface_layer_list =
+      layer->render_surface() &&
+      render_surface_layer_list.size() > render_surface_layer_list_start &&
+      render_surface_layer_list[render_surface_layer_list_start] == layer;
+  cached->updated_accumulated_surface_state =
+      cache->last_accumulated_surface_state_update == layer;
+
+  // A layer is only copied by the ancestors that reordered it, which are
+  // few even in deep trees.
+  cached->layer_list_additions_were_sorted =
+      !layer->render_surface() &&
+      (draw_properties.has_child_with_a_scroll_parent ||
+       (layer->Is3dSorted() && !LayerIsInExisting3DRenderingContext(layer)));
+  if (cached->layer_list_additions_were_sorted) {
+    cached->sorted_layer_list_additions.assign(
+        layer_list.begin() + layer_list_start, layer_list.end());
+  } else {
+    cached->sorted_layer_list_additions.clear();
+  }
+  cached->render_surface_layer_list_additions_were_sorted =
+      draw_properties.has_child_with_a_scroll_parent;
+  if (cached->render_surface_layer_list_additions_were_sorted) {
+    cached->sorted_render_surface_layer_list_additions.assign(
+        render_surface_layer_list.begin() + render_surface_layer_list_start,
+        render_surface_layer_list.end());
+  } else {
+    cached->sorted_render_surface_layer_list_additions.clear();
+  }
+}
+
+// Appends what |layer|'s subtree added to its target's layer list and to the
+// render surface layer list when it was last computed, in the same order, and
+// the layers whose drawable content rects were accumulated into its target
+// surface. A NULL list is skipped.
+static void CollectCachedSubtreeAdditions(
+    LayerImpl* layer,
+    const DrawPropertiesCache::Data& cache,
+    LayerImplList* layer_list,
+    LayerImplList* render_surface_layer_list,
+    LayerImplList* accumulated_surface_state_contributors) {
+  const CachedSubtree* cached = cache.subtrees.get(layer->id());
+  DCHECK(cached);
+
+  // The layers below a render surface draw into the surface instead.
+  LayerImplList* children_layer_list =
+      layer->render_surface() ? NULL : layer_list;
+  LayerImplList* children_render_surface_layer_list =
+      render_surface_layer_list;
+  LayerImplList* children_accumulated_surface_state_contributors =
+      layer->render_surface() ? NULL : accumulated_surface_state_contributors;
+
+  if (layer_list) {
+    if (cached->layer_list_additions_were_sorted) {
+      layer_list->insert(layer_list->end(),
+                         cached->sorted_layer_list_additions.begin(),
+                         cached->sorted_layer_list_additions.end());
+      children_layer_list = NULL;
+    } else if (cached->added_to_layer_list) {
+      layer_list->push_back(layer);
+    }
+  }
+
+  if (render_surface_layer_list) {
+    if (cached->render_surface_layer_list_additions_were_sorted) {
+      render_surface_layer_list->insert(
+          render_surface_layer_list->end(),
+          cached->sorted_render_surface_layer_list_additions.begin(),
+          cached->sorted_render_surface_layer_list_additions.end());
+      children_render_surface_layer_list = NULL;
+    } else if (cached->added_to_render_surface_layer_list) {
+      render_surface_layer_list->push_back(layer);
+    } else if (layer->render_surface()) {
+      // The surface was removed for being empty, along with any surfaces
+      // below it.
+      children_render_surface_layer_list = NULL;
+    }
+  }
+
+  if (cached->children_visited &&
+      (children_layer_list || children_render_surface_layer_list ||
+       children_accumulated_surface_state_contributors)) {
+    // Contributions are accumulated in the order the children were visited.
+    std::vector<LayerImpl*> sorted_children;
+    if (layer->draw_properties().has_child_with_a_scroll_parent)
+      SortChildrenForRecursion(&sorted_children, *layer);
+    for (size_t i = 0; i < layer->children().size(); ++i) {
+      LayerImpl* child =
+          layer->draw_properties().has_child_with_a_scroll_parent
+              ? sorted_children[i]
+              : layer->children()[i];
+      CollectCachedSubtreeAdditions(
+          child,
+          cache,
+          children_layer_list,
+          children_render_surface_layer_list,
+          children_accumulated_surface_state_contributors);
+      // Matches the contributing surface check after the recursion in
+      // CalculateDrawPropertiesInternal().
+      if (children_layer_list && child->render_surface() &&
+          !child->render_surface()->layer_list().empty() &&
+          !child->render_surface()->content_rect().IsEmpty())
+        children_layer_list->push_back(child);
+    }
+  }
+
+  if (accumulated_surface_state_contributors &&
+      cached->updated_accumulated_surface_state)
+    accumulated_surface_state_contributors->push_back(layer);
+}
+
+static void ReuseCachedSubtree(
+    LayerImpl* layer,
+    const SubtreeGlobals<LayerImpl>& globals,
+    LayerImplList* render_surface_layer_list,
+    LayerImplList* layer_list,
+    std::vector<AccumulatedSurfaceState<LayerImpl> >* accumulated_surface_state,
+    int current_render_surface_layer_list_id) {
+  DrawPropertiesCache::Data* cache = globals.draw_properties_cache;
+  size_t layer_list_start = layer_list->size();
+  size_t render_surface_layer_list_start = render_surface_layer_list->size();
+  LayerImplList accumulated_surface_state_contributors;
+  CollectCachedSubtreeAdditions(layer,
+                                *cache,
+                                layer_list,
+                                render_surface_layer_list,
+                                &accumulated_surface_state_contributors);
+
+  // Surfaces that contribute to a layer list only have their masks marked;
+  // the owner itself is marked in its own surface's layer list.
+  for (size_t i = layer_list_start; i < layer_list->size(); ++i) {
+    LayerImpl* added_layer = (*layer_list)[i];
+    if (added_layer->render_surface()) {
+      MarkMasksWithRenderSurfaceLayerListId(
+          added_layer, current_render_surface_layer_list_id);
+    } else {
+      MarkLayerWithRenderSurfaceLayerListId(
+          added_layer, current_render_surface_layer_list_id);
+    }
+  }
+  for (size_t i = render_surface_layer_list_start;
+       i < render_surface_layer_list->size();
+       ++i) {
+    LayerImpl* owner = (*render_surface_layer_list)[i];
+    const LayerImplList& surface_layer_list =
+        owner->render_surface()->layer_list();
+    for (size_t j = 0; j < surface_layer_list.size(); ++j) {
+      LayerImpl* surface_layer = surface_layer_list[j];
+      if (surface_layer != owner && surface_layer->render_surface()) {
+        MarkMasksWithRenderSurfaceLayerListId(
+            surface_layer, current_render_surface_layer_list_id);
+      } else {
+        MarkLayerWithRenderSurfaceLayerListId(
+            surface_layer, current_render_surface_layer_list_id);
+      }
+    }
+  }
+
+  // Replay the contributions to the target surface's drawable content rect,
+  // the same way CalculateDrawPropertiesInternal() computes them.
+  for (size_t i = 0; i < accumulated_surface_state_contributors.size(); ++i) {
+    LayerImpl* contributor = accumulated_surface_state_contributors[i];
+    gfx::Rect local_drawable_content_rect_of_subtree =
+        accumulated_surface_state->back().drawable_content_rect;
+    if (!contributor->render_surface() && contributor->DrawsContent()) {
+      local_drawable_content_rect_of_subtree.Union(
+          contributor->drawable_content_rect());
+    }
+    UpdateAccumulatedSurfaceState<LayerImpl>(
+        contributor,
+        local_drawable_content_rect_of_subtree,
+        accumulated_surface_state);
+    NoteAccumulatedSurfaceStateUpdate(contributor, globals);
+  }
+
+  cache->subtrees.get(layer->id())->last_update = cache->update_count;
+  ++cache->num_reused_subtrees;
+}
+
+// Called once the draw properties of |layer|'s subtree have been recomputed.
+// Descendants that were not visited (e.g., because |layer| is hidden) keep
+// their dirty bits, so |layer| is recomputed until they are.
+static void ClearDrawPropertiesDirty(LayerImpl* layer) {
+  layer->set_draw_properties_dirty(false);
+  bool descendant_draw_properties_dirty = false;
+  for (size_t i = 0; i < layer->children().size(); ++i) {
+    LayerImpl* child = layer->children()[i];
+    descendant_draw_properties_dirty |=
+        child->draw_properties_dirty() ||
+        child->descendant_draw_properties_dirty();
+  }
+  layer->set_descendant_draw_properties_dirty(descendant_draw_properties_dirty);
+}
+
+template <typename LayerType>
+static void CalculateDrawPropertiesInternal(
+    LayerType* layer,
+    const SubtreeGlobals<LayerType>& globals,
+    const DataForRecursion<LayerType>& data_from_ancestor,
+    typename LayerType::RenderSurfaceListType* render_surface_layer_list,
+    typename LayerType::LayerListType* layer_list,
+    std::vector<AccumulatedSurfaceState<LayerType> >* accumulated_surface_state,
+    int current_render_surface_layer_list_id);
+
+static void CalculateDrawPropertiesForChild(
+    Layer* child,
+    const SubtreeGlobals<Layer>& globals,
+    const DataForRecursion<Layer>& data_from_ancestor,
+    RenderSurfaceLayerList* render_surface_layer_list,
+    LayerList* layer_list,
+    std::vector<AccumulatedSurfaceState<Layer> >* accumulated_surface_state,
+    int current_render_surface_layer_list_id) {
+  CalculateDrawPropertiesInternal<Layer>(child,
+                                         globals,
+                                         data_from_ancestor,
+                                         render_surface_layer_list,
+                                         layer_list,
+                                         accumulated_surface_state,
+                                         current_render_surface_layer_list_id);
+}
+
+static void CalculateDrawPropertiesForChild(
+    LayerImpl* child,
+    const SubtreeGlobals<LayerImpl>& globals,
+    const DataForRecursion<LayerImpl>& data_from_ancestor,
+    LayerImplList* render_surface_layer_list,
+    LayerImplList* layer_list,
+    std::vector<AccumulatedSurfaceState<LayerImpl> >* accumulated_surface_state,
+    int current_render_surface_layer_list_id) {
+  DrawPropertiesCache::Data* cache = globals.draw_properties_cache;
+  if (!cache) {
+    CalculateDrawPropertiesInternal<LayerImpl>(
+        child,
+        globals,
+        data_from_ancestor,
+        render_surface_layer_list,
+        layer_list,
+        accumulated_surface_state,
+        current_render_surface_layer_list_id);
+    return;
+  }
+
+  CachedSubtree* cached = cache->subtrees.get(child->id());
+  if (cached && CanReuseCachedSubtree(*cached, child, data_from_ancestor)) {
+    ReuseCachedSubtree(child,
+                       globals,
+                       render_surface_layer_list,
+                       layer_list,
+                       accumulated_surface_state,
+                       current_render_surface_layer_list_id);
+    return;
+  }
+
+  MarkScrollChildrenDirty(child);
+  size_t render_surface_layer_list_start = render_surface_layer_list->size();
+  size_t layer_list_start = layer_list->size();
+  CalculateDrawPropertiesInternal<LayerImpl>(
+      child,
+      globals,
+      data_from_ancestor,
+      render_surface_layer_list,
+      layer_list,
+      accumulated_surface_state,
+      current_render_surface_layer_list_id);
+  RecordCachedSubtree(child,
+                      data_from_ancestor,
+                      *render_surface_layer_list,
+                      render_surface_layer_list_start,
+                      *layer_list,
+                      layer_list_start,
+                      cache);
+
+  ClearDrawPropertiesDirty(child);
+}
+
 // Recursively walks the layer tree starting at the given node and computes all
 // the necessary transformations, clip rects, render surfaces, etc.
 template <typename LayerType>
@@ -2135,7 +2862,7 @@ static void CalculateDrawPropertiesInternal(
     child->draw_properties().index_of_first_render_surface_layer_list_addition =
         render_surface_layer_list->size();
 
-    CalculateDrawPropertiesInternal<LayerType>(
+    CalculateDrawPropertiesForChild(
         child,
         globals,
         data_for_children,
@@ -2206,8 +2933,11 @@ static void CalculateDrawPropertiesInternal(
   }
 
   // Compute the layer's visible content rect (the rect is in content space).
-  layer_draw_properties.visible_content_rect = CalculateVisibleContentRect(
-      layer, clip_rect_of_target_surface_in_target_space, rect_in_target_space);
+  // This may be deferred until after the recursion; see VisibleRectRequest.
+  CalculateVisibleContentRect(layer,
+                              clip_rect_of_target_surface_in_target_space,
+                              rect_in_target_space,
+                              globals.visible_rect_requests);
 
   // Compute the remaining properties for the render surface, if the layer has
   // one.
@@ -2327,6 +3057,7 @@ static void CalculateDrawPropertiesInternal(
 
   UpdateAccumulatedSurfaceState<LayerType>(
       layer, local_drawable_content_rect_of_subtree, accumulated_surface_state);
+  NoteAccumulatedSurfaceStateUpdate(layer, globals);
 
   if (layer->HasContributingDelegatedRenderPasses()) {
     layer->render_target()->render_surface()->
@@ -2371,6 +3102,8 @@ static void ProcessCalcDrawPropsInputs(
   globals->can_render_to_separate_surface =
       inputs.can_render_to_separate_surface;
   globals->can_adjust_raster_scales = inputs.can_adjust_raster_scales;
+  globals->visible_rect_requests = NULL;
+  globals->draw_properties_cache = NULL;
 
   data_for_recursion->parent_matrix = scaled_device_transform;
   data_for_recursion->full_hierarchy_matrix = identity_matrix;
@@ -2395,6 +3128,12 @@ void LayerTreeHostCommon::CalculateDrawProperties(
   DataForRecursion<Layer> data_for_recursion;
   ProcessCalcDrawPropsInputs(*inputs, &globals, &data_for_recursion);
 
+  std::vector<VisibleRectRequest<Layer> > visible_rect_requests;
+  globals.visible_rect_requests = &visible_rect_requests;
+
+  // Layer trees are recomputed on every commit, so there is nothing to reuse.
+  DCHECK(!inputs->draw_properties_cache);
+
   PreCalculateMetaInformationRecursiveData recursive_data;
   PreCalculateMetaInformation(inputs->root_layer, &recursive_data);
   std::vector<AccumulatedSurfaceState<Layer> > accumulated_surface_state;
@@ -2406,6 +3145,8 @@ void LayerTreeHostCommon::CalculateDrawProperties(
       &dummy_layer_list,
       &accumulated_surface_state,
       inputs->current_render_surface_layer_list_id);
+  ProcessVisibleRectRequests(visible_rect_requests,
+                             inputs->task_graph_runner);
 
   // The dummy layer list should not have been used.
   DCHECK_EQ(0u, dummy_layer_list.size());
@@ -2424,6 +3165,14 @@ void LayerTreeHostCommon::CalculateDrawProperties(
   LayerSorter layer_sorter;
   globals.layer_sorter = &layer_sorter;
 
+  std::vector<VisibleRectRequest<LayerImpl> > visible_rect_requests;
+  globals.visible_rect_requests = &visible_rect_requests;
+
+  if (inputs->draw_properties_cache) {
+    globals.draw_properties_cache = inputs->draw_properties_cache->data();
+    PrepareDrawPropertiesCache(globals.draw_properties_cache, globals);
+  }
+
   PreCalculateMetaInformationRecursiveData recursive_data;
   PreCalculateMetaInformation(inputs->root_layer, &recursive_data);
   std::vector<AccumulatedSurfaceState<LayerImpl> >
@@ -2436,6 +3185,12 @@ void LayerTreeHostCommon::CalculateDrawProperties(
       &dummy_layer_list,
       &accumulated_surface_state,
       inputs->current_render_surface_layer_list_id);
+  ProcessVisibleRectRequests(visible_rect_requests,
+                             inputs->task_graph_runner);
+
+  // The root is never reused from the cache, but is always recomputed.
+  if (globals.draw_properties_cache)
+    ClearDrawPropertiesDirty(inputs->root_layer);
 
   // The dummy layer list should not have been used.
   DCHECK_EQ(0u, dummy_layer_list.size());
@@ -10,6 +10,7 @@
 
 #include "base/bind.h"
 #include "base/memory/ref_counted.h"
+#include "base/memory/scoped_ptr.h"
 #include "cc/base/cc_export.h"
 #include "cc/base/scoped_ptr_vector.h"
 #include "cc/layers/layer_lists.h"
@@ -22,6 +23,34 @@ namespace cc {
 class LayerImpl;
 class Layer;
 class SwapPromise;
+class TaskGraphRunner;
+
+// Remembers the results of a CalculateDrawProperties() call on a LayerImpl
+// tree, so that the next call can reuse the results for subtrees whose layers
+// have no dirty draw properties (see LayerImpl::draw_properties_dirty()) and
+// whose inputs from their ancestors did not change. The owner must Clear() the
+// cache whenever layers are added, removed or destroyed, or change without
+// being marked dirty.
+class CC_EXPORT DrawPropertiesCache {
+ public:
+  struct Data;
+
+  DrawPropertiesCache();
+  ~DrawPropertiesCache();
+
+  void Clear();
+
+  Data* data() { return data_.get(); }
+
+  // The number of subtrees that the last CalculateDrawProperties() call
+  // reused instead of recomputing.
+  size_t num_reused_subtrees_for_testing() const;
+
+ private:
+  scoped_ptr<Data> data_;
+
+  DISALLOW_COPY_AND_ASSIGN(DrawPropertiesCache);
+};
 
 class CC_EXPORT LayerTreeHostCommon {
  public:
@@ -56,7 +85,9 @@ class CC_EXPORT LayerTreeHostCommon {
           can_adjust_raster_scales(can_adjust_raster_scales),
           render_surface_layer_list(render_surface_layer_list),
           current_render_surface_layer_list_id(
-              current_render_surface_layer_list_id) {}
+              current_render_surface_layer_list_id),
+          task_graph_runner(NULL),
+          draw_properties_cache(NULL) {}
 
     LayerType* root_layer;
     gfx::Size device_viewport_size;
@@ -70,6 +101,14 @@ class CC_EXPORT LayerTreeHostCommon {
     bool can_adjust_raster_scales;
     RenderSurfaceLayerListType* render_surface_layer_list;
     int current_render_surface_layer_list_id;
+    // If set, the visible content rects of layers that need projecting are
+    // computed in parallel, using this runner's worker threads to help the
+    // calling thread.
+    TaskGraphRunner* task_graph_runner;
+    // If set, draw properties of unchanged subtrees are reused from the
+    // previous update instead of being recomputed. Only supported for
+    // LayerImpl trees.
+    DrawPropertiesCache* draw_properties_cache;
   };
 
   template <typename LayerType, typename RenderSurfaceLayerListType>
@@ -20,6 +20,7 @@
 #include "cc/output/bsp_tree.h"
 #include "cc/quads/draw_polygon.h"
 #include "cc/quads/draw_quad.h"
+#include "cc/resources/raster_worker_pool.h"
 #include "cc/test/fake_content_layer_client.h"
 #include "cc/test/fake_layer_tree_host_client.h"
 #include "cc/test/layer_tree_json_parser.h"
@@ -117,10 +118,17 @@ class CalcDrawPropsMainTest : public LayerTreeHostCommonPerfTest {
 
 class CalcDrawPropsImplTest : public LayerTreeHostCommonPerfTest {
  public:
+  CalcDrawPropsImplTest() : task_graph_runner_(NULL) {}
+
   void RunCalcDrawProps() {
     RunTestWithImplSidePainting();
   }
 
+  void RunCalcDrawPropsInParallel() {
+    task_graph_runner_ = RasterWorkerPool::GetTaskGraphRunner();
+    RunTestWithImplSidePainting();
+  }
+
   virtual void BeginTest() OVERRIDE {
     PostSetNeedsCommitToMainThread();
   }
@@ -161,8 +169,12 @@ class CalcDrawPropsImplTest : public LayerTreeHostCommonPerfTest {
         host_impl->settings().layer_transforms_should_scale_layer_contents,
         &update_list,
         0);
+    inputs.task_graph_runner = task_graph_runner_;
     LayerTreeHostCommon::CalculateDrawProperties(&inputs);
   }
+
+ private:
+  TaskGraphRunner* task_graph_runner_;
 };
 
 class LayerSorterMainTest : public CalcDrawPropsImplTest {
@@ -316,6 +328,18 @@ TEST_F(CalcDrawPropsImplTest, TouchRegionHeavy) {
   RunCalcDrawProps();
 }
 
+TEST_F(CalcDrawPropsImplTest, HeavyPageParallel) {
+  SetTestName("heavy_page_parallel");
+  ReadTestFile("heavy_layer_tree");
+  RunCalcDrawPropsInParallel();
+}
+
+TEST_F(CalcDrawPropsImplTest, TouchRegionHeavyParallel) {
+  SetTestName("touch_region_heavy_parallel");
+  ReadTestFile("touch_region_heavy");
+  RunCalcDrawPropsInParallel();
+}
+
 TEST_F(LayerSorterMainTest, LayerSorterCubes) {
   SetTestName("layer_sort_cubes");
   ReadTestFile("layer_sort_cubes");
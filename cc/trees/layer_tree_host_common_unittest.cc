@@ -6,9 +6,11 @@
 
 #include <set>
 
+#include "base/threading/simple_thread.h"
 #include "cc/animation/layer_animation_controller.h"
 #include "cc/animation/transform_operations.h"
 #include "cc/base/math_util.h"
+#include "cc/base/scoped_ptr_deque.h"
 #include "cc/layers/content_layer.h"
 #include "cc/layers/content_layer_client.h"
 #include "cc/layers/layer.h"
@@ -19,6 +21,7 @@
 #include "cc/layers/render_surface_impl.h"
 #include "cc/output/copy_output_request.h"
 #include "cc/output/copy_output_result.h"
+#include "cc/resources/task_graph_runner.h"
 #include "cc/test/animation_test_common.h"
 #include "cc/test/fake_impl_proxy.h"
 #include "cc/test/fake_layer_tree_host.h"
@@ -8615,5 +8618,528 @@ TEST_F(LayerTreeHostCommonTest, VisibleContentRectInChildRenderSurface) {
   EXPECT_EQ(gfx::Rect(768 / 2, 582 / 2), content->visible_content_rect());
 }
 
+// Runs the tasks of a TaskGraphRunner on a few threads of its own.
+class TestTaskGraphRunnerWorkers
+    : public base::DelegateSimpleThread::Delegate {
+ public:
+  explicit TestTaskGraphRunnerWorkers(int num_threads) {
+    for (int i = 0; i < num_threads; ++i) {
+      scoped_ptr<base::DelegateSimpleThread> worker = make_scoped_ptr(
+          new base::DelegateSimpleThread(this, "TestWorker"));
+      worker->Start();
+      workers_.push_back(worker.Pass());
+    }
+  }
+
+  virtual ~TestTaskGraphRunnerWorkers() {
+    task_graph_runner_.Shutdown();
+    while (!workers_.empty())
+      workers_.take_front()->Join();
+  }
+
+  TaskGraphRunner* task_graph_runner() { return &task_graph_runner_; }
+
+  // Overridden from base::DelegateSimpleThread::Delegate:
+  virtual void Run() OVERRIDE { task_graph_runner_.Run(); }
+
+ private:
+  TaskGraphRunner task_graph_runner_;
+  ScopedPtrDeque<base::DelegateSimpleThread> workers_;
+
+  DISALLOW_COPY_AND_ASSIGN(TestTaskGraphRunnerWorkers);
+};
+
+TEST_F(LayerTreeHostCommonTest, ParallelVisibleContentRectsMatchSerial) {
+  // + root
+  //   + clip: masks to bounds
+  //   | + 40 rotated layers, partially clipped
+  //   + surface: transformed render surface, masks to bounds
+  //   | + 40 rotated layers, partially clipped
+  //   + perspective
+  //     + 40 layers rotated in 3d, partially off screen
+  const gfx::Transform identity_matrix;
+  scoped_refptr<Layer> root = Layer::Create();
+  SetLayerPropertiesForTesting(root.get(),
+                               identity_matrix,
+                               gfx::Point3F(),
+                               gfx::PointF(),
+                               gfx::Size(200, 200),
+                               true,
+                               false);
+
+  scoped_refptr<Layer> clip = Layer::Create();
+  SetLayerPropertiesForTesting(clip.get(),
+                               identity_matrix,
+                               gfx::Point3F(),
+                               gfx::PointF(),
+                               gfx::Size(100, 100),
+                               true,
+                               false);
+  clip->SetMasksToBounds(true);
+  root->AddChild(clip);
+
+  gfx::Transform surface_transform;
+  surface_transform.Rotate(15.0);
+  scoped_refptr<Layer> surface = Layer::Create();
+  SetLayerPropertiesForTesting(surface.get(),
+                               surface_transform,
+                               gfx::Point3F(50.f, 50.f, 0.f),
+                               gfx::PointF(100.f, 0.f),
+                               gfx::Size(100, 100),
+                               true,
+                               false);
+  surface->SetMasksToBounds(true);
+  surface->SetForceRenderSurface(true);
+  root->AddChild(surface);
+
+  gfx::Transform perspective_transform;
+  perspective_transform.ApplyPerspectiveDepth(200.0);
+  scoped_refptr<Layer> perspective = Layer::Create();
+  SetLayerPropertiesForTesting(perspective.get(),
+                               perspective_transform,
+                               gfx::Point3F(50.f, 50.f, 0.f),
+                               gfx::PointF(0.f, 100.f),
+                               gfx::Size(100, 100),
+                               true,
+                               false);
+  root->AddChild(perspective);
+
+  std::vector<scoped_refptr<Layer> > layers;
+  for (int i = 0; i < 40; ++i) {
+    // Each layer sticks out of the bottom right of its parent.
+    gfx::PointF position(50.f + i % 40, 50.f + (i * 7) % 40);
+
+    gfx::Transform rotation;
+    rotation.Rotate(i * 9.0);
+    scoped_refptr<LayerWithForcedDrawsContent> clipped =
+        make_scoped_refptr(new LayerWithForcedDrawsContent());
+    SetLayerPropertiesForTesting(clipped.get(),
+                                 rotation,
+                                 gfx::Point3F(30.f, 30.f, 0.f),
+                                 position,
+                                 gfx::Size(60, 60),
+                                 true,
+                                 false);
+    clip->AddChild(clipped);
+    layers.push_back(clipped);
+
+    scoped_refptr<LayerWithForcedDrawsContent> in_surface =
+        make_scoped_refptr(new LayerWithForcedDrawsContent());
+    SetLayerPropertiesForTesting(in_surface.get(),
+                                 rotation,
+                                 gfx::Point3F(30.f, 30.f, 0.f),
+                                 position,
+                                 gfx::Size(60, 60),
+                                 true,
+                                 false);
+    surface->AddChild(in_surface);
+    layers.push_back(in_surface);
+
+    gfx::Transform rotation_3d;
+    rotation_3d.RotateAboutYAxis(i * 4.0 - 80.0);
+    scoped_refptr<LayerWithForcedDrawsContent> projected =
+        make_scoped_refptr(new LayerWithForcedDrawsContent());
+    SetLayerPropertiesForTesting(projected.get(),
+                                 rotation_3d,
+                                 gfx::Point3F(30.f, 30.f, 0.f),
+                                 position,
+                                 gfx::Size(60, 60),
+                                 true,
+                                 false);
+    perspective->AddChild(projected);
+    layers.push_back(projected);
+  }
+
+  scoped_ptr<FakeLayerTreeHost> host(CreateFakeLayerTreeHost());
+  host->SetRootLayer(root);
+
+  {
+    RenderSurfaceLayerList render_surface_layer_list;
+    LayerTreeHostCommon::CalcDrawPropsMainInputsForTesting inputs(
+        root.get(), root->bounds(), &render_surface_layer_list);
+    LayerTreeHostCommon::CalculateDrawProperties(&inputs);
+  }
+  std::vector<gfx::Rect> serial_visible_content_rects;
+  size_t num_partially_visible_layers = 0;
+  for (size_t i = 0; i < layers.size(); ++i) {
+    gfx::Rect visible_content_rect = layers[i]->visible_content_rect();
+    serial_visible_content_rects.push_back(visible_content_rect);
+    if (!visible_content_rect.IsEmpty() &&
+        visible_content_rect != gfx::Rect(layers[i]->content_bounds()))
+      ++num_partially_visible_layers;
+    layers[i]->draw_properties().visible_content_rect = gfx::Rect();
+  }
+  // Partially visible layers have their visible content rects projected.
+  // There are enough of them to be split between several threads.
+  EXPECT_LT(64u, num_partially_visible_layers);
+
+  TestTaskGraphRunnerWorkers workers(3);
+  {
+    RenderSurfaceLayerList render_surface_layer_list;
+    LayerTreeHostCommon::CalcDrawPropsMainInputsForTesting inputs(
+        root.get(), root->bounds(), &render_surface_layer_list);
+    inputs.task_graph_runner = workers.task_graph_runner();
+    LayerTreeHostCommon::CalculateDrawProperties(&inputs);
+  }
+  for (size_t i = 0; i < layers.size(); ++i) {
+    EXPECT_EQ(serial_visible_content_rects[i],
+              layers[i]->visible_content_rect())
+        << "layer " << i;
+  }
+}
+
+TEST_F(LayerTreeHostCommonTest, IncrementalUpdateReusesCleanSubtrees) {
+  FakeImplProxy proxy;
+  TestSharedBitmapManager shared_bitmap_manager;
+  FakeLayerTreeHostImpl host_impl(&proxy, &shared_bitmap_manager);
+  host_impl.CreatePendingTree();
+  const gfx::Transform identity_matrix;
+
+  scoped_ptr<LayerImpl> root = LayerImpl::Create(host_impl.pending_tree(), 1);
+  SetLayerPropertiesForTesting(root.get(),
+                               identity_matrix,
+                               gfx::Point3F(),
+                               gfx::PointF(),
+                               gfx::Size(100, 100),
+                               true,
+                               false);
+  root->SetDrawsContent(true);
+
+  scoped_ptr<LayerImpl> surface =
+      LayerImpl::Create(host_impl.pending_tree(), 2);
+  SetLayerPropertiesForTesting(surface.get(),
+                               identity_matrix,
+                               gfx::Point3F(),
+                               gfx::PointF(10.f, 10.f),
+                               gfx::Size(30, 30),
+                               true,
+                               false);
+  surface->SetDrawsContent(true);
+  surface->SetForceRenderSurface(true);
+
+  scoped_ptr<LayerImpl> surface_child =
+      LayerImpl::Create(host_impl.pending_tree(), 3);
+  SetLayerPropertiesForTesting(surface_child.get(),
+                               identity_matrix,
+                               gfx::Point3F(),
+                               gfx::PointF(20.f, 20.f),
+                               gfx::Size(30, 30),
+                               true,
+                               false);
+  surface_child->SetDrawsContent(true);
+
+  scoped_ptr<LayerImpl> sibling =
+      LayerImpl::Create(host_impl.pending_tree(), 4);
+  SetLayerPropertiesForTesting(sibling.get(),
+                               identity_matrix,
+                               gfx::Point3F(),
+                               gfx::PointF(),
+                               gfx::Size(10, 10),
+                               true,
+                               false);
+  sibling->SetDrawsContent(true);
+
+  LayerImpl* surface_ptr = surface.get();
+  LayerImpl* surface_child_ptr = surface_child.get();
+  LayerImpl* sibling_ptr = sibling.get();
+  surface->AddChild(surface_child.Pass());
+  root->AddChild(surface.Pass());
+  root->AddChild(sibling.Pass());
+
+  DrawPropertiesCache cache;
+  {
+    LayerImplList render_surface_layer_list;
+    LayerTreeHostCommon::CalcDrawPropsImplInputsForTesting inputs(
+        root.get(), root->bounds(), &render_surface_layer_list);
+    inputs.current_render_surface_layer_list_id = 1;
+    inputs.draw_properties_cache = &cache;
+    LayerTreeHostCommon::CalculateDrawProperties(&inputs);
+    ASSERT_EQ(2u, render_surface_layer_list.size());
+    EXPECT_EQ(0u, cache.num_reused_subtrees_for_testing());
+  }
+  EXPECT_FALSE(surface_ptr->draw_properties_dirty());
+  EXPECT_FALSE(root->descendant_draw_properties_dirty());
+
+  // Only the sibling changes, so the surface's subtree is reused.
+  sibling_ptr->SetPosition(gfx::PointF(50.f, 50.f));
+  EXPECT_TRUE(sibling_ptr->draw_properties_dirty());
+  EXPECT_TRUE(root->descendant_draw_properties_dirty());
+  EXPECT_FALSE(surface_ptr->draw_properties_dirty());
+
+  LayerImplList render_surface_layer_list;
+  LayerTreeHostCommon::CalcDrawPropsImplInputsForTesting inputs(
+      root.get(), root->bounds(), &render_surface_layer_list);
+  inputs.current_render_surface_layer_list_id = 2;
+  inputs.draw_properties_cache = &cache;
+  LayerTreeHostCommon::CalculateDrawProperties(&inputs);
+  EXPECT_EQ(1u, cache.num_reused_subtrees_for_testing());
+
+  ASSERT_EQ(2u, render_surface_layer_list.size());
+  EXPECT_EQ(root.get(), render_surface_layer_list[0]);
+  EXPECT_EQ(surface_ptr, render_surface_layer_list[1]);
+  ASSERT_EQ(3u, root->render_surface()->layer_list().size());
+  EXPECT_EQ(surface_ptr, root->render_surface()->layer_list()[1]);
+  EXPECT_EQ(sibling_ptr, root->render_surface()->layer_list()[2]);
+  ASSERT_EQ(2u, surface_ptr->render_surface()->layer_list().size());
+
+  // Reused layers are still marked as drawn in this update.
+  EXPECT_EQ(2,
+            surface_ptr->draw_properties()
+                .last_drawn_render_surface_layer_list_id);
+  EXPECT_EQ(2,
+            surface_child_ptr->draw_properties()
+                .last_drawn_render_surface_layer_list_id);
+
+  EXPECT_EQ(gfx::Rect(50, 50, 10, 10), sibling_ptr->drawable_content_rect());
+  EXPECT_EQ(gfx::Rect(10, 10, 50, 50),
+            surface_ptr->render_surface()->DrawableContentRect());
+  EXPECT_FALSE(sibling_ptr->draw_properties_dirty());
+  EXPECT_FALSE(root->descendant_draw_properties_dirty());
+}
+
+
+TEST_F(LayerTreeHostCommonTest, IncrementalUpdateReusesAnimatingSubtrees) {
+  FakeImplProxy proxy;
+  TestSharedBitmapManager shared_bitmap_manager;
+  FakeLayerTreeHostImpl host_impl(&proxy, &shared_bitmap_manager);
+  host_impl.CreatePendingTree();
+  const gfx::Transform identity_matrix;
+
+  scoped_ptr<LayerImpl> root = LayerImpl::Create(host_impl.pending_tree(), 1);
+  SetLayerPropertiesForTesting(root.get(),
+                               identity_matrix,
+                               gfx::Point3F(),
+                               gfx::PointF(),
+                               gfx::Size(100, 100),
+                               true,
+                               false);
+  root->SetDrawsContent(true);
+
+  scoped_ptr<LayerImpl> animated =
+      LayerImpl::Create(host_impl.pending_tree(), 2);
+  SetLayerPropertiesForTesting(animated.get(),
+                               identity_matrix,
+                               gfx::Point3F(),
+                               gfx::PointF(10.f, 10.f),
+                               gfx::Size(30, 30),
+                               true,
+                               false);
+  animated->SetDrawsContent(true);
+
+  scoped_ptr<LayerImpl> animated_child =
+      LayerImpl::Create(host_impl.pending_tree(), 3);
+  SetLayerPropertiesForTesting(animated_child.get(),
+                               identity_matrix,
+                               gfx::Point3F(),
+                               gfx::PointF(5.f, 5.f),
+                               gfx::Size(10, 10),
+                               true,
+                               false);
+  animated_child->SetDrawsContent(true);
+
+  scoped_ptr<LayerImpl> sibling =
+      LayerImpl::Create(host_impl.pending_tree(), 4);
+  SetLayerPropertiesForTesting(sibling.get(),
+                               identity_matrix,
+                               gfx::Point3F(),
+                               gfx::PointF(),
+                               gfx::Size(10, 10),
+                               true,
+                               false);
+  sibling->SetDrawsContent(true);
+
+  LayerImpl* animated_ptr = animated.get();
+  LayerImpl* animated_child_ptr = animated_child.get();
+  animated->AddChild(animated_child.Pass());
+  root->AddChild(animated.Pass());
+  root->AddChild(sibling.Pass());
+
+  DrawPropertiesCache cache;
+  int render_surface_layer_list_id = 0;
+  {
+    LayerImplList render_surface_layer_list;
+    LayerTreeHostCommon::CalcDrawPropsImplInputsForTesting inputs(
+        root.get(), root->bounds(), &render_surface_layer_list);
+    inputs.current_render_surface_layer_list_id =
+        ++render_surface_layer_list_id;
+    inputs.draw_properties_cache = &cache;
+    LayerTreeHostCommon::CalculateDrawProperties(&inputs);
+    EXPECT_EQ(0u, cache.num_reused_subtrees_for_testing());
+  }
+  EXPECT_FALSE(animated_child_ptr->screen_space_transform_is_animating());
+
+  // Starting an animation doesn't go through the layer's setters, but the
+  // animating subtree is still recomputed.
+  int animation_id = AddAnimatedTransformToLayer(animated_ptr, 10.0, 30, 0);
+  {
+    LayerImplList render_surface_layer_list;
+    LayerTreeHostCommon::CalcDrawPropsImplInputsForTesting inputs(
+        root.get(), root->bounds(), &render_surface_layer_list);
+    inputs.current_render_surface_layer_list_id =
+        ++render_surface_layer_list_id;
+    inputs.draw_properties_cache = &cache;
+    LayerTreeHostCommon::CalculateDrawProperties(&inputs);
+    EXPECT_EQ(1u, cache.num_reused_subtrees_for_testing());
+  }
+  EXPECT_TRUE(animated_child_ptr->screen_space_transform_is_animating());
+
+  // While the animation runs without changing the transform, the subtree is
+  // reused.
+  {
+    LayerImplList render_surface_layer_list;
+    LayerTreeHostCommon::CalcDrawPropsImplInputsForTesting inputs(
+        root.get(), root->bounds(), &render_surface_layer_list);
+    inputs.current_render_surface_layer_list_id =
+        ++render_surface_layer_list_id;
+    inputs.draw_properties_cache = &cache;
+    LayerTreeHostCommon::CalculateDrawProperties(&inputs);
+    EXPECT_EQ(2u, cache.num_reused_subtrees_for_testing());
+    EXPECT_EQ(3u, root->render_surface()->layer_list().size());
+  }
+  EXPECT_TRUE(animated_child_ptr->screen_space_transform_is_animating());
+
+  animated_ptr->layer_animation_controller()->RemoveAnimation(animation_id);
+  {
+    LayerImplList render_surface_layer_list;
+    LayerTreeHostCommon::CalcDrawPropsImplInputsForTesting inputs(
+        root.get(), root->bounds(), &render_surface_layer_list);
+    inputs.current_render_surface_layer_list_id =
+        ++render_surface_layer_list_id;
+    inputs.draw_properties_cache = &cache;
+    LayerTreeHostCommon::CalculateDrawProperties(&inputs);
+    EXPECT_EQ(1u, cache.num_reused_subtrees_for_testing());
+  }
+  EXPECT_FALSE(animated_child_ptr->screen_space_transform_is_animating());
+}
+
+TEST_F(LayerTreeHostCommonTest, IncrementalUpdateRecomputesScrollChildren) {
+  // + root
+  //   + container
+  //   | + clip
+  //   | | + scroll_parent
+  //   | + scroll_child
+  //   + sibling
+  FakeImplProxy proxy;
+  TestSharedBitmapManager shared_bitmap_manager;
+  FakeLayerTreeHostImpl host_impl(&proxy, &shared_bitmap_manager);
+  host_impl.CreatePendingTree();
+  const gfx::Transform identity_matrix;
+
+  scoped_ptr<LayerImpl> root = LayerImpl::Create(host_impl.pending_tree(), 1);
+  scoped_ptr<LayerImpl> container =
+      LayerImpl::Create(host_impl.pending_tree(), 2);
+  scoped_ptr<LayerImpl> clip = LayerImpl::Create(host_impl.pending_tree(), 3);
+  scoped_ptr<LayerImpl> scroll_parent =
+      LayerImpl::Create(host_impl.pending_tree(), 4);
+  scoped_ptr<LayerImpl> scroll_child =
+      LayerImpl::Create(host_impl.pending_tree(), 5);
+  scoped_ptr<LayerImpl> sibling =
+      LayerImpl::Create(host_impl.pending_tree(), 6);
+
+  SetLayerPropertiesForTesting(root.get(),
+                               identity_matrix,
+                               gfx::Point3F(),
+                               gfx::PointF(),
+                               gfx::Size(100, 100),
+                               true,
+                               false);
+  SetLayerPropertiesForTesting(clip.get(),
+                               identity_matrix,
+                               gfx::Point3F(),
+                               gfx::PointF(),
+                               gfx::Size(30, 30),
+                               true,
+                               false);
+  SetLayerPropertiesForTesting(scroll_parent.get(),
+                               identity_matrix,
+                               gfx::Point3F(),
+                               gfx::PointF(),
+                               gfx::Size(50, 50),
+                               true,
+                               false);
+  SetLayerPropertiesForTesting(container.get(),
+                               identity_matrix,
+                               gfx::Point3F(),
+                               gfx::PointF(),
+                               gfx::Size(100, 100),
+                               true,
+                               false);
+  SetLayerPropertiesForTesting(scroll_child.get(),
+                               identity_matrix,
+                               gfx::Point3F(),
+                               gfx::PointF(),
+                               gfx::Size(100, 100),
+                               true,
+                               false);
+  SetLayerPropertiesForTesting(sibling.get(),
+                               identity_matrix,
+                               gfx::Point3F(),
+                               gfx::PointF(),
+                               gfx::Size(10, 10),
+                               true,
+                               false);
+  clip->SetMasksToBounds(true);
+  scroll_parent->SetDrawsContent(true);
+  scroll_child->SetDrawsContent(true);
+  sibling->SetDrawsContent(true);
+
+  scroll_child->SetScrollParent(scroll_parent.get());
+  scoped_ptr<std::set<LayerImpl*> > scroll_children(new std::set<LayerImpl*>);
+  scroll_children->insert(scroll_child.get());
+  scroll_parent->SetScrollChildren(scroll_children.release());
+
+  LayerImpl* clip_ptr = clip.get();
+  LayerImpl* scroll_child_ptr = scroll_child.get();
+  LayerImpl* sibling_ptr = sibling.get();
+  clip->AddChild(scroll_parent.Pass());
+  container->AddChild(clip.Pass());
+  container->AddChild(scroll_child.Pass());
+  root->AddChild(container.Pass());
+  root->AddChild(sibling.Pass());
+
+  DrawPropertiesCache cache;
+  int render_surface_layer_list_id = 0;
+  {
+    LayerImplList render_surface_layer_list;
+    LayerTreeHostCommon::CalcDrawPropsImplInputsForTesting inputs(
+        root.get(), root->bounds(), &render_surface_layer_list);
+    inputs.current_render_surface_layer_list_id =
+        ++render_surface_layer_list_id;
+    inputs.draw_properties_cache = &cache;
+    LayerTreeHostCommon::CalculateDrawProperties(&inputs);
+  }
+  EXPECT_EQ(gfx::Rect(0, 0, 30, 30), scroll_child_ptr->clip_rect());
+
+  // The subtree containing the scroll parent and child is reused as a whole.
+  sibling_ptr->SetPosition(gfx::PointF(50.f, 50.f));
+  {
+    LayerImplList render_surface_layer_list;
+    LayerTreeHostCommon::CalcDrawPropsImplInputsForTesting inputs(
+        root.get(), root->bounds(), &render_surface_layer_list);
+    inputs.current_render_surface_layer_list_id =
+        ++render_surface_layer_list_id;
+    inputs.draw_properties_cache = &cache;
+    LayerTreeHostCommon::CalculateDrawProperties(&inputs);
+    EXPECT_EQ(1u, cache.num_reused_subtrees_for_testing());
+    EXPECT_EQ(3u, root->render_surface()->layer_list().size());
+  }
+  EXPECT_EQ(gfx::Rect(0, 0, 30, 30), scroll_child_ptr->clip_rect());
+
+  // When the scroll parent is recomputed, the scroll child's clip follows.
+  clip_ptr->SetBounds(gfx::Size(20, 20));
+  {
+    LayerImplList render_surface_layer_list;
+    LayerTreeHostCommon::CalcDrawPropsImplInputsForTesting inputs(
+        root.get(), root->bounds(), &render_surface_layer_list);
+    inputs.current_render_surface_layer_list_id =
+        ++render_surface_layer_list_id;
+    inputs.draw_properties_cache = &cache;
+    LayerTreeHostCommon::CalculateDrawProperties(&inputs);
+    EXPECT_EQ(1u, cache.num_reused_subtrees_for_testing());
+  }
+  EXPECT_EQ(gfx::Rect(0, 0, 20, 20), scroll_child_ptr->clip_rect());
+  EXPECT_FALSE(root->descendant_draw_properties_dirty());
+}
+
 }  // namespace
 }  // namespace cc
@@ -337,7 +337,7 @@ void LayerTreeHostImpl::CommitComplete() {
 
   if (pending_tree_)
     pending_tree_->ApplyScrollDeltasSinceBeginMainFrame();
-  sync_tree()->set_needs_update_draw_properties();
+  sync_tree()->set_needs_update_draw_properties_for_dirty_layers();
 
   if (settings_.impl_side_painting) {
     // Impl-side painting needs an update immediately post-commit to have the
@@ -729,6 +729,8 @@ DrawResult LayerTreeHostImpl::CalculateRenderPasses(
       active_tree_->root_layer()->render_surface()->content_rect());
   occlusion_tracker.set_minimum_tracking_size(
       settings_.minimum_occlusion_tracking_size);
+  occlusion_tracker.set_use_screen_space_coverage(
+      settings_.use_occlusion_coverage_map);
 
   if (debug_state_.show_occluding_rects) {
     occlusion_tracker.set_occluding_screen_space_rects_container(
@@ -793,9 +795,8 @@ DrawResult LayerTreeHostImpl::CalculateRenderPasses(
                                        &append_quads_data);
     } else if (it.represents_itself() &&
                !it->visible_content_rect().IsEmpty()) {
-      bool occluded =
-          occlusion_tracker.GetCurrentOcclusionForLayer(it->draw_transform())
-              .IsOccluded(it->visible_content_rect());
+      bool occluded = occlusion_tracker.IsOccluded(it->visible_content_rect(),
+                                                   it->draw_transform());
       if (!occluded && it->WillDraw(draw_mode, resource_provider_.get())) {
         DCHECK_EQ(active_tree_, it->layer_tree_impl());
 
@@ -833,6 +834,8 @@ DrawResult LayerTreeHostImpl::CalculateRenderPasses(
         append_quads_data.visible_content_area);
     rendering_stats_instrumentation_->AddApproximatedVisibleContentArea(
         append_quads_data.approximated_visible_content_area);
+    rendering_stats_instrumentation_->AddCheckerboardedVisibleContentArea(
+        append_quads_data.checkerboarded_visible_content_area);
 
     num_missing_tiles += append_quads_data.num_missing_tiles;
     num_incomplete_tiles += append_quads_data.num_incomplete_tiles;
@@ -1934,6 +1937,9 @@ void LayerTreeHostImpl::CreateAndSetTileManager() {
   DCHECK(resource_provider_);
   DCHECK(proxy_->ImplThreadTaskRunner());
 
+  // Partial raster only works when the raster buffer is the resource itself,
+  // so that content outside of the invalidation is kept.
+  bool rasterizer_keeps_resource_contents = false;
   ContextProvider* context_provider = output_surface_->context_provider();
   if (!context_provider) {
     resource_pool_ =
@@ -1945,6 +1951,7 @@ void LayerTreeHostImpl::CreateAndSetTileManager() {
         BitmapRasterWorkerPool::Create(proxy_->ImplThreadTaskRunner(),
                                        RasterWorkerPool::GetTaskGraphRunner(),
                                        resource_provider_.get());
+    rasterizer_keeps_resource_contents = true;
   } else if (use_gpu_rasterization_) {
     resource_pool_ =
         ResourcePool::Create(resource_provider_.get(),
@@ -1955,6 +1962,7 @@ void LayerTreeHostImpl::CreateAndSetTileManager() {
         GpuRasterWorkerPool::Create(proxy_->ImplThreadTaskRunner(),
                                     context_provider,
                                     resource_provider_.get());
+    rasterizer_keeps_resource_contents = true;
   } else if (UseZeroCopyRasterizer()) {
     resource_pool_ = ResourcePool::Create(
         resource_provider_.get(),
@@ -1965,6 +1973,7 @@ void LayerTreeHostImpl::CreateAndSetTileManager() {
         ZeroCopyRasterWorkerPool::Create(proxy_->ImplThreadTaskRunner(),
                                          RasterWorkerPool::GetTaskGraphRunner(),
                                          resource_provider_.get());
+    rasterizer_keeps_resource_contents = true;
   } else if (UseOneCopyRasterizer()) {
     // We need to create a staging resource pool when using copy rasterizer.
     staging_resource_pool_ = ResourcePool::Create(
@@ -2002,7 +2011,12 @@ void LayerTreeHostImpl::CreateAndSetTileManager() {
                           proxy_->ImplThreadTaskRunner(),
                           resource_pool_.get(),
                           raster_worker_pool_->AsRasterizer(),
-                          rendering_stats_instrumentation_);
+                          rendering_stats_instrumentation_,
+                          settings_.use_partial_raster &&
+                              rasterizer_keeps_resource_contents,
+                          settings_.use_compressed_offscreen_tiles &&
+                              resource_provider_->default_resource_type() ==
+                                  ResourceProvider::Bitmap);
 
   UpdateTileManagerMemoryPolicy(ActualManagedMemoryPolicy());
   need_to_update_visible_tiles_before_draw_ = false;
@@ -374,6 +374,9 @@ class CC_EXPORT LayerTreeHostImpl
   ResourceProvider* resource_provider() {
     return resource_provider_.get();
   }
+  RenderingStatsInstrumentation* rendering_stats_instrumentation() {
+    return rendering_stats_instrumentation_;
+  }
   TopControlsManager* top_controls_manager() {
     return top_controls_manager_.get();
   }
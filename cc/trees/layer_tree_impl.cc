@@ -23,6 +23,7 @@
 #include "cc/layers/layer_iterator.h"
 #include "cc/layers/render_surface_impl.h"
 #include "cc/layers/scrollbar_layer_impl_base.h"
+#include "cc/resources/raster_worker_pool.h"
 #include "cc/resources/ui_resource_request.h"
 #include "cc/trees/layer_tree_host_common.h"
 #include "cc/trees/layer_tree_host_impl.h"
@@ -90,6 +91,7 @@ LayerTreeImpl::LayerTreeImpl(LayerTreeHostImpl* layer_tree_host_impl)
       requires_high_res_to_draw_(false),
       viewport_size_invalid_(false),
       needs_update_draw_properties_(true),
+      needs_full_update_draw_properties_(true),
       needs_full_tree_sync_(true),
       next_activation_forces_redraw_(false),
       has_ever_been_drawn_(false),
@@ -492,6 +494,16 @@ bool LayerTreeImpl::UpdateDrawProperties() {
         settings().layer_transforms_should_scale_layer_contents,
         &render_surface_layer_list_,
         render_surface_layer_list_id_);
+    if (settings().use_parallel_draw_properties)
+      inputs.task_graph_runner = RasterWorkerPool::GetTaskGraphRunner();
+    if (settings().use_incremental_draw_properties) {
+      if (!draw_properties_cache_)
+        draw_properties_cache_.reset(new DrawPropertiesCache);
+      else if (needs_full_update_draw_properties_)
+        draw_properties_cache_->Clear();
+      inputs.draw_properties_cache = draw_properties_cache_.get();
+    }
+    needs_full_update_draw_properties_ = false;
     LayerTreeHostCommon::CalculateDrawProperties(&inputs);
   }
 
@@ -589,6 +601,8 @@ void LayerTreeImpl::RegisterLayer(LayerImpl* layer) {
 void LayerTreeImpl::UnregisterLayer(LayerImpl* layer) {
   DCHECK(LayerById(layer->id()));
   layer_id_map_.erase(layer->id());
+  // The draw properties cache may still point at |layer|.
+  needs_full_update_draw_properties_ = true;
 }
 
 size_t LayerTreeImpl::NumLayers() {
@@ -39,6 +39,7 @@ namespace cc {
 
 class ContextProvider;
 class DebugRectHistory;
+class DrawPropertiesCache;
 class FrameRateCounter;
 class HeadsUpDisplayLayerImpl;
 class LayerScrollOffsetDelegateProxy;
@@ -188,6 +189,13 @@ class CC_EXPORT LayerTreeImpl {
 
   void set_needs_update_draw_properties() {
     needs_update_draw_properties_ = true;
+    needs_full_update_draw_properties_ = true;
+  }
+  // Like set_needs_update_draw_properties(), but when incremental draw
+  // property updates are enabled only the layers marked dirty (see
+  // LayerImpl::draw_properties_dirty()) have to be recomputed.
+  void set_needs_update_draw_properties_for_dirty_layers() {
+    needs_update_draw_properties_ = true;
   }
   bool needs_update_draw_properties() const {
     return needs_update_draw_properties_;
@@ -373,6 +381,8 @@ class CC_EXPORT LayerTreeImpl {
   bool requires_high_res_to_draw_;
   bool viewport_size_invalid_;
   bool needs_update_draw_properties_;
+  bool needs_full_update_draw_properties_;
+  scoped_ptr<DrawPropertiesCache> draw_properties_cache_;
 
   // In impl-side painting mode, this is true when the tree may contain
   // structural differences relative to the active tree.
@@ -66,7 +66,14 @@ LayerTreeSettings::LayerTreeSettings()
       use_rgba_4444_textures(false),
       texture_id_allocation_chunk_size(64),
       use_occlusion_for_tile_prioritization(false),
-      record_full_layer(false) {
+      record_full_layer(false),
+      use_parallel_draw_properties(false),
+      use_incremental_draw_properties(false),
+      use_partial_raster(false),
+      use_parallel_software_draw(false),
+      use_occlusion_coverage_map(false),
+      use_predictive_skewport(false),
+      use_compressed_offscreen_tiles(false) {
 }
 
 LayerTreeSettings::~LayerTreeSettings() {}
@@ -38,6 +38,7 @@ class CC_EXPORT LayerTreeSettings {
   enum RecordingMode {
     RecordNormally,
     RecordWithSkRecord,
+    RecordWithDisplayList,
   };
   RecordingMode recording_mode;
   bool create_low_res_tiling;
@@ -81,6 +82,13 @@ class CC_EXPORT LayerTreeSettings {
   size_t texture_id_allocation_chunk_size;
   bool use_occlusion_for_tile_prioritization;
   bool record_full_layer;
+  bool use_parallel_draw_properties;
+  bool use_incremental_draw_properties;
+  bool use_partial_raster;
+  bool use_parallel_software_draw;
+  bool use_occlusion_coverage_map;
+  bool use_predictive_skewport;
+  bool use_compressed_offscreen_tiles;
 
   LayerTreeDebugState initial_debug_state;
 };
@@ -0,0 +1,130 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "cc/trees/occlusion_coverage_map.h"
+
+#include <algorithm>
+
+#include "base/logging.h"
+
+namespace cc {
+
+const int OcclusionCoverageMap::kCellSize = 64;
+
+OcclusionCoverageMap::OcclusionCoverageMap(const gfx::Rect& bounds)
+    : bounds_(bounds),
+      num_columns_((bounds.width() + kCellSize - 1) / kCellSize),
+      num_rows_((bounds.height() + kCellSize - 1) / kCellSize),
+      full_cells_(num_columns_ * num_rows_, false),
+      partial_cells_(num_columns_ * num_rows_) {
+}
+
+OcclusionCoverageMap::~OcclusionCoverageMap() {
+}
+
+void OcclusionCoverageMap::Clear() {
+  if (covered_bounds_.IsEmpty())
+    return;
+  std::fill(full_cells_.begin(), full_cells_.end(), false);
+  for (size_t i = 0; i < partial_cells_.size(); ++i)
+    partial_cells_[i].Clear();
+  covered_bounds_ = gfx::Rect();
+}
+
+void OcclusionCoverageMap::Union(const gfx::Rect& rect) {
+  gfx::Rect covered_rect = gfx::IntersectRects(rect, bounds_);
+  if (covered_rect.IsEmpty())
+    return;
+  covered_bounds_.Union(covered_rect);
+
+  int left, top, right, bottom;
+  GetCellRange(covered_rect, &left, &top, &right, &bottom);
+  for (int row = top; row <= bottom; ++row) {
+    for (int column = left; column <= right; ++column) {
+      size_t index = row * num_columns_ + column;
+      if (full_cells_[index])
+        continue;
+
+      gfx::Rect cell_rect = CellRect(column, row);
+      Region& partial = partial_cells_[index];
+      partial.Union(gfx::IntersectRects(covered_rect, cell_rect));
+      if (partial.Contains(cell_rect)) {
+        full_cells_[index] = true;
+        partial.Clear();
+      }
+    }
+  }
+}
+
+void OcclusionCoverageMap::Subtract(const gfx::Rect& rect) {
+  gfx::Rect uncovered_rect = gfx::IntersectRects(rect, covered_bounds_);
+  if (uncovered_rect.IsEmpty())
+    return;
+  if (uncovered_rect == covered_bounds_) {
+    Clear();
+    return;
+  }
+
+  int left, top, right, bottom;
+  GetCellRange(uncovered_rect, &left, &top, &right, &bottom);
+  for (int row = top; row <= bottom; ++row) {
+    for (int column = left; column <= right; ++column) {
+      size_t index = row * num_columns_ + column;
+      Region& partial = partial_cells_[index];
+      if (full_cells_[index]) {
+        full_cells_[index] = false;
+        partial = CellRect(column, row);
+      }
+      partial.Subtract(uncovered_rect);
+    }
+  }
+}
+
+bool OcclusionCoverageMap::Contains(const gfx::Rect& rect) const {
+  if (rect.IsEmpty())
+    return true;
+  // |covered_bounds_| is always inside |bounds_|.
+  if (!covered_bounds_.Contains(rect))
+    return false;
+
+  int left, top, right, bottom;
+  GetCellRange(rect, &left, &top, &right, &bottom);
+  for (int row = top; row <= bottom; ++row) {
+    for (int column = left; column <= right; ++column) {
+      size_t index = row * num_columns_ + column;
+      if (full_cells_[index])
+        continue;
+      // Only the part of |rect| that falls in this cell needs to be covered
+      // here, which is where the edges of the covered area get their detail.
+      if (!partial_cells_[index].Contains(
+              gfx::IntersectRects(rect, CellRect(column, row))))
+        return false;
+    }
+  }
+  return true;
+}
+
+void OcclusionCoverageMap::GetCellRange(const gfx::Rect& rect,
+                                        int* left,
+                                        int* top,
+                                        int* right,
+                                        int* bottom) const {
+  DCHECK(!rect.IsEmpty());
+  DCHECK(bounds_.Contains(rect));
+  *left = (rect.x() - bounds_.x()) / kCellSize;
+  *top = (rect.y() - bounds_.y()) / kCellSize;
+  *right = (rect.right() - 1 - bounds_.x()) / kCellSize;
+  *bottom = (rect.bottom() - 1 - bounds_.y()) / kCellSize;
+}
+
+gfx::Rect OcclusionCoverageMap::CellRect(int column, int row) const {
+  gfx::Rect cell_rect(bounds_.x() + column * kCellSize,
+                      bounds_.y() + row * kCellSize,
+                      kCellSize,
+                      kCellSize);
+  cell_rect.Intersect(bounds_);
+  return cell_rect;
+}
+
+}  // namespace cc
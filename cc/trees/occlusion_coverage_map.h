@@ -0,0 +1,77 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CC_TREES_OCCLUSION_COVERAGE_MAP_H_
+#define CC_TREES_OCCLUSION_COVERAGE_MAP_H_
+
+#include <vector>
+
+#include "base/basictypes.h"
+#include "cc/base/cc_export.h"
+#include "cc/base/region.h"
+#include "ui/gfx/rect.h"
+
+namespace cc {
+
+// A coarse grid over |bounds| that remembers which parts of it are covered by
+// opaque content. Each cell is either flagged as fully covered, or keeps an
+// exact Region of the part of it that is covered, which is only ever non-empty
+// for cells on the edge of the covered area. Queries mostly look at the flags,
+// and only need the Regions where a rect crosses the edge of the covered area.
+//
+// Unlike a single SimpleEnclosedRegion, this can tell that a rect is covered
+// by several occluders which don't union into one rect, such as a grid of
+// opaque tiles that don't line up with the cells.
+class CC_EXPORT OcclusionCoverageMap {
+ public:
+  explicit OcclusionCoverageMap(const gfx::Rect& bounds);
+  ~OcclusionCoverageMap();
+
+  // The width and height of a cell, in pixels.
+  static const int kCellSize;
+
+  bool IsEmpty() const { return covered_bounds_.IsEmpty(); }
+  void Clear();
+
+  // Marks |rect| as covered. Anything outside of the bounds is ignored.
+  void Union(const gfx::Rect& rect);
+  // Marks |rect| as no longer covered.
+  void Subtract(const gfx::Rect& rect);
+
+  // Returns true if every point in |rect| is known to be covered. Points
+  // outside of the bounds are never covered.
+  bool Contains(const gfx::Rect& rect) const;
+
+  int num_columns() const { return num_columns_; }
+  int num_rows() const { return num_rows_; }
+
+ private:
+  // Finds the range of cells that |rect| touches. |rect| must be non-empty
+  // and inside the bounds. The right and bottom indices are inclusive.
+  void GetCellRange(const gfx::Rect& rect,
+                    int* left,
+                    int* top,
+                    int* right,
+                    int* bottom) const;
+  gfx::Rect CellRect(int column, int row) const;
+
+  gfx::Rect bounds_;
+  int num_columns_;
+  int num_rows_;
+
+  // One bit per cell, set when the whole cell is covered.
+  std::vector<bool> full_cells_;
+  // For cells that are not fully covered, the part that is.
+  std::vector<Region> partial_cells_;
+
+  // Encloses everything that may be covered. This is an upper bound, used to
+  // reject most queries without looking at any cells.
+  gfx::Rect covered_bounds_;
+
+  DISALLOW_COPY_AND_ASSIGN(OcclusionCoverageMap);
+};
+
+}  // namespace cc
+
+#endif  // CC_TREES_OCCLUSION_COVERAGE_MAP_H_
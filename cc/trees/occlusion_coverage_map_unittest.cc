@@ -0,0 +1,93 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "cc/trees/occlusion_coverage_map.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace cc {
+namespace {
+
+TEST(OcclusionCoverageMapTest, Empty) {
+  OcclusionCoverageMap map(gfx::Rect(0, 0, 100, 130));
+  EXPECT_EQ(2, map.num_columns());
+  EXPECT_EQ(3, map.num_rows());
+  EXPECT_TRUE(map.IsEmpty());
+  EXPECT_TRUE(map.Contains(gfx::Rect()));
+  EXPECT_FALSE(map.Contains(gfx::Rect(10, 10, 1, 1)));
+}
+
+TEST(OcclusionCoverageMapTest, SingleRect) {
+  OcclusionCoverageMap map(gfx::Rect(0, 0, 500, 500));
+  map.Union(gfx::Rect(10, 20, 200, 100));
+  EXPECT_FALSE(map.IsEmpty());
+
+  EXPECT_TRUE(map.Contains(gfx::Rect(10, 20, 200, 100)));
+  EXPECT_TRUE(map.Contains(gfx::Rect(100, 50, 30, 30)));
+  EXPECT_FALSE(map.Contains(gfx::Rect(9, 20, 200, 100)));
+  EXPECT_FALSE(map.Contains(gfx::Rect(10, 20, 200, 101)));
+  EXPECT_FALSE(map.Contains(gfx::Rect(300, 300, 10, 10)));
+}
+
+TEST(OcclusionCoverageMapTest, RectsThatDontUnionIntoOne) {
+  OcclusionCoverageMap map(gfx::Rect(0, 0, 500, 500));
+  // Two overlapping rects, whose union is an L-shape. A SimpleEnclosedRegion
+  // would only keep one of them.
+  map.Union(gfx::Rect(0, 0, 300, 100));
+  map.Union(gfx::Rect(0, 50, 100, 300));
+
+  EXPECT_TRUE(map.Contains(gfx::Rect(0, 0, 300, 100)));
+  EXPECT_TRUE(map.Contains(gfx::Rect(0, 50, 100, 300)));
+  // Crosses from one rect into the other.
+  EXPECT_TRUE(map.Contains(gfx::Rect(50, 0, 50, 350)));
+  EXPECT_FALSE(map.Contains(gfx::Rect(0, 0, 300, 101)));
+
+  // A grid of tiles, offset so that they don't line up with the cells.
+  OcclusionCoverageMap tiles(gfx::Rect(0, 0, 500, 500));
+  for (int x = 0; x < 4; ++x) {
+    for (int y = 0; y < 4; ++y)
+      tiles.Union(gfx::Rect(5 + x * 100, 5 + y * 100, 100, 100));
+  }
+  EXPECT_TRUE(tiles.Contains(gfx::Rect(5, 5, 400, 400)));
+  EXPECT_FALSE(tiles.Contains(gfx::Rect(4, 5, 400, 400)));
+}
+
+TEST(OcclusionCoverageMapTest, OutsideBounds) {
+  OcclusionCoverageMap map(gfx::Rect(100, 100, 200, 200));
+  map.Union(gfx::Rect(0, 0, 1000, 1000));
+  EXPECT_TRUE(map.Contains(gfx::Rect(100, 100, 200, 200)));
+  EXPECT_FALSE(map.Contains(gfx::Rect(99, 100, 200, 200)));
+  EXPECT_FALSE(map.Contains(gfx::Rect(0, 0, 50, 50)));
+}
+
+TEST(OcclusionCoverageMapTest, Subtract) {
+  OcclusionCoverageMap map(gfx::Rect(0, 0, 500, 500));
+  map.Union(gfx::Rect(0, 0, 500, 500));
+  map.Subtract(gfx::Rect(200, 200, 10, 10));
+
+  EXPECT_FALSE(map.Contains(gfx::Rect(205, 205, 1, 1)));
+  EXPECT_FALSE(map.Contains(gfx::Rect(0, 0, 500, 500)));
+  // Cells away from the subtracted rect are still covered.
+  EXPECT_TRUE(map.Contains(gfx::Rect(0, 0, 128, 500)));
+  EXPECT_TRUE(map.Contains(gfx::Rect(256, 0, 244, 500)));
+
+  map.Subtract(gfx::Rect(0, 0, 500, 500));
+  EXPECT_TRUE(map.IsEmpty());
+  EXPECT_FALSE(map.Contains(gfx::Rect(0, 0, 1, 1)));
+}
+
+TEST(OcclusionCoverageMapTest, Clear) {
+  OcclusionCoverageMap map(gfx::Rect(0, 0, 500, 500));
+  map.Union(gfx::Rect(0, 0, 200, 200));
+  map.Clear();
+  EXPECT_TRUE(map.IsEmpty());
+  EXPECT_FALSE(map.Contains(gfx::Rect(0, 0, 1, 1)));
+
+  map.Union(gfx::Rect(300, 300, 10, 10));
+  EXPECT_TRUE(map.Contains(gfx::Rect(300, 300, 10, 10)));
+  EXPECT_FALSE(map.Contains(gfx::Rect(0, 0, 1, 1)));
+}
+
+}  // namespace
+}  // namespace cc
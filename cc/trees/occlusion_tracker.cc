@@ -12,6 +12,7 @@
 #include "cc/layers/layer_impl.h"
 #include "cc/layers/render_surface.h"
 #include "cc/layers/render_surface_impl.h"
+#include "cc/trees/occlusion_coverage_map.h"
 #include "ui/gfx/quad_f.h"
 #include "ui/gfx/rect_conversions.h"
 
@@ -37,6 +38,41 @@ Occlusion OcclusionTracker<LayerType>::GetCurrentOcclusionForLayer(
                    back.occlusion_from_inside_target);
 }
 
+template <typename LayerType>
+bool OcclusionTracker<LayerType>::IsOccluded(
+    const gfx::Rect& content_rect,
+    const gfx::Transform& draw_transform) const {
+  if (GetCurrentOcclusionForLayer(draw_transform).IsOccluded(content_rect))
+    return true;
+
+  if (!screen_space_coverage_ || screen_space_coverage_->IsEmpty())
+    return false;
+  if (!ShouldTrackScreenSpaceCoverage(stack_.back().target))
+    return false;
+
+  return screen_space_coverage_->Contains(
+      MathUtil::MapEnclosingClippedRect(draw_transform, content_rect));
+}
+
+template <typename LayerType>
+void OcclusionTracker<LayerType>::set_use_screen_space_coverage(bool use) {
+  DCHECK(stack_.empty());
+  if (use)
+    screen_space_coverage_.reset(
+        new OcclusionCoverageMap(screen_space_clip_rect_));
+  else
+    screen_space_coverage_.reset();
+}
+
+template <typename LayerType>
+bool OcclusionTracker<LayerType>::ShouldTrackScreenSpaceCoverage(
+    const LayerType* target) const {
+  // The root target's space is screen space, so its occlusion can go into the
+  // coverage as is.
+  return screen_space_coverage_ && !target->parent() &&
+         target->render_surface()->screen_space_transform().IsIdentity();
+}
+
 template <typename LayerType>
 void OcclusionTracker<LayerType>::EnterLayer(
     const LayerIteratorPosition<LayerType>& layer_iterator) {
@@ -245,15 +281,15 @@ void OcclusionTracker<LayerType>::FinishedRenderTarget(
   }
 }
 
+// The area in the target that the background filters of |contributing_layer|
+// read from, when the unoccluded part of its surface is |surface_rect|.
 template <typename LayerType>
-static void ReduceOcclusionBelowSurface(
+static gfx::Rect AffectedAreaBelowSurface(
     LayerType* contributing_layer,
     const gfx::Rect& surface_rect,
-    const gfx::Transform& surface_transform,
-    LayerType* render_target,
-    SimpleEnclosedRegion* occlusion_from_inside_target) {
+    const gfx::Transform& surface_transform) {
   if (surface_rect.IsEmpty())
-    return;
+    return gfx::Rect();
 
   gfx::Rect affected_area_in_target =
       MathUtil::MapEnclosingClippedRect(surface_transform, surface_rect);
@@ -262,7 +298,7 @@ static void ReduceOcclusionBelowSurface(
         contributing_layer->render_surface()->clip_rect());
   }
   if (affected_area_in_target.IsEmpty())
-    return;
+    return gfx::Rect();
 
   int outset_top, outset_right, outset_bottom, outset_left;
   contributing_layer->background_filters().GetOutsets(
@@ -272,6 +308,25 @@ static void ReduceOcclusionBelowSurface(
   // to expand outside the clip.
   affected_area_in_target.Inset(
       -outset_left, -outset_top, -outset_right, -outset_bottom);
+  return affected_area_in_target;
+}
+
+template <typename LayerType>
+static void ReduceOcclusionBelowSurface(
+    LayerType* contributing_layer,
+    const gfx::Rect& surface_rect,
+    const gfx::Transform& surface_transform,
+    LayerType* render_target,
+    SimpleEnclosedRegion* occlusion_from_inside_target) {
+  gfx::Rect affected_area_in_target = AffectedAreaBelowSurface(
+      contributing_layer, surface_rect, surface_transform);
+  if (affected_area_in_target.IsEmpty())
+    return;
+
+  int outset_top, outset_right, outset_bottom, outset_left;
+  contributing_layer->background_filters().GetOutsets(
+      &outset_top, &outset_right, &outset_bottom, &outset_left);
+
   SimpleEnclosedRegion affected_occlusion = *occlusion_from_inside_target;
   affected_occlusion.Intersect(affected_area_in_target);
 
@@ -373,9 +428,29 @@ void OcclusionTracker<LayerType>::LeaveToRenderTarget(
     }
   }
 
+  bool track_screen_space_coverage = ShouldTrackScreenSpaceCoverage(new_target);
+  if (track_screen_space_coverage) {
+    screen_space_coverage_->Union(
+        old_occlusion_from_inside_target_in_new_target.bounds());
+  }
+
   if (!old_target->background_filters().HasFilterThatMovesPixels())
     return;
 
+  if (track_screen_space_coverage) {
+    // The filters read what is below the surface, so none of that is hidden.
+    screen_space_coverage_->Subtract(
+        AffectedAreaBelowSurface(old_target,
+                                 unoccluded_surface_rect,
+                                 old_surface->draw_transform()));
+    if (old_target->has_replica()) {
+      screen_space_coverage_->Subtract(
+          AffectedAreaBelowSurface(old_target,
+                                   unoccluded_replica_rect,
+                                   old_surface->replica_draw_transform()));
+    }
+  }
+
   ReduceOcclusionBelowSurface(old_target,
                               unoccluded_surface_rect,
                               old_surface->draw_transform(),
@@ -429,6 +504,9 @@ void OcclusionTracker<LayerType>::MarkOccludedBehindLayer(
   if (!layer->draw_transform().Preserves2dAxisAlignment())
     return;
 
+  bool track_screen_space_coverage =
+      ShouldTrackScreenSpaceCoverage(layer->render_target());
+
   gfx::Rect clip_rect_in_target = ScreenSpaceClipRectInTargetSurface(
       layer->render_target()->render_surface(), screen_space_clip_rect_);
   if (layer->is_clipped()) {
@@ -447,6 +525,8 @@ void OcclusionTracker<LayerType>::MarkOccludedBehindLayer(
         transformed_rect.height() < minimum_tracking_size_.height())
       continue;
     stack_.back().occlusion_from_inside_target.Union(transformed_rect);
+    if (track_screen_space_coverage)
+      screen_space_coverage_->Union(transformed_rect);
 
     if (!occluding_screen_space_rects_)
       continue;
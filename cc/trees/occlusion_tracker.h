@@ -8,6 +8,7 @@
 #include <vector>
 
 #include "base/basictypes.h"
+#include "base/memory/scoped_ptr.h"
 #include "cc/base/cc_export.h"
 #include "cc/base/simple_enclosed_region.h"
 #include "cc/layers/layer_iterator.h"
@@ -16,6 +17,7 @@
 
 namespace cc {
 class LayerImpl;
+class OcclusionCoverageMap;
 class Region;
 class RenderSurfaceImpl;
 class Layer;
@@ -41,6 +43,13 @@ class CC_EXPORT OcclusionTracker {
   Occlusion GetCurrentOcclusionForLayer(
       const gfx::Transform& draw_transform) const;
 
+  // Returns true if |content_rect| of the current layer, which draws into the
+  // current target with |draw_transform|, is hidden. This is the same as
+  // GetCurrentOcclusionForLayer().IsOccluded(), except that it also sees the
+  // screen space coverage when that is being tracked.
+  bool IsOccluded(const gfx::Rect& content_rect,
+                  const gfx::Transform& draw_transform) const;
+
   // Called at the beginning of each step in the LayerIterator's front-to-back
   // traversal.
   void EnterLayer(const LayerIteratorPosition<LayerType>& layer_iterator);
@@ -62,6 +71,12 @@ class CC_EXPORT OcclusionTracker {
     minimum_tracking_size_ = size;
   }
 
+  // When enabled, occlusion in the root target is also recorded in a coarse
+  // coverage map over the screen space clip rect. That lets IsOccluded() find
+  // layers that are hidden behind several occluders together, which the
+  // single rect kept per target can't represent. Must be set before the walk.
+  void set_use_screen_space_coverage(bool use);
+
   // The following is used for visualization purposes.
   void set_occluding_screen_space_rects_container(
       std::vector<gfx::Rect>* rects) {
@@ -117,9 +132,15 @@ class CC_EXPORT OcclusionTracker {
   // Add the layer's occlusion to the tracked state.
   void MarkOccludedBehindLayer(const LayerType* layer);
 
+  // Whether occlusion in |target|'s space can go in the screen space coverage.
+  bool ShouldTrackScreenSpaceCoverage(const LayerType* target) const;
+
   gfx::Rect screen_space_clip_rect_;
   gfx::Size minimum_tracking_size_;
 
+  // Occlusion in the root target. Only created when in use.
+  scoped_ptr<OcclusionCoverageMap> screen_space_coverage_;
+
   // This is used for visualizing the occlusion tracking process.
   std::vector<gfx::Rect>* occluding_screen_space_rects_;
   std::vector<gfx::Rect>* non_occluding_screen_space_rects_;
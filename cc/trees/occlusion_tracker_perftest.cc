@@ -18,6 +18,8 @@
 #include "cc/trees/single_thread_proxy.h"
 #include "testing/gtest/include/gtest/gtest.h"
 #include "testing/perf/perf_test.h"
+#include "third_party/skia/include/core/SkRegion.h"
+#include "ui/gfx/skia_util.h"
 
 namespace cc {
 namespace {
@@ -47,6 +49,8 @@ class OcclusionTrackerPerfTest : public testing::Test {
 
   LayerTreeImpl* active_tree() { return host_impl_->active_tree(); }
 
+  void IsOccludedBehindCheckerboard(bool use_screen_space_coverage);
+
   void SetTestName(const std::string& name) { test_name_ = name; }
 
   void PrintResults() {
@@ -206,5 +210,141 @@ TEST_F(OcclusionTrackerPerfTest, UnoccludedContentRect_10OpaqueLayers) {
   PrintResults();
 }
 
+// Covers the viewport with opaque squares in a checkerboard pattern, where all
+// the "black" squares are in front of all the "white" ones. No single rect
+// can enclose more than two of the squares, so only the screen space coverage
+// sees that anything larger than that is occluded.
+void OcclusionTrackerPerfTest::IsOccludedBehindCheckerboard(
+    bool use_screen_space_coverage) {
+  static const int kSquareSize = 128;
+
+  gfx::Rect viewport_rect(768, 1038);
+  OcclusionTracker<LayerImpl> tracker(viewport_rect);
+  tracker.set_use_screen_space_coverage(use_screen_space_coverage);
+
+  CreateHost();
+  host_impl_->SetViewportSize(viewport_rect.size());
+
+  int num_columns = viewport_rect.width() / kSquareSize;
+  int num_rows = (viewport_rect.height() + kSquareSize - 1) / kSquareSize;
+  int num_squares = 0;
+  // Layers added later are in front, so add the white squares first.
+  for (int parity = 1; parity >= 0; --parity) {
+    for (int y = 0; y < num_rows; ++y) {
+      for (int x = 0; x < num_columns; ++x) {
+        if ((x + y) % 2 != parity)
+          continue;
+        scoped_ptr<SolidColorLayerImpl> opaque_layer =
+            SolidColorLayerImpl::Create(active_tree(), 2 + num_squares);
+        opaque_layer->SetBackgroundColor(SK_ColorRED);
+        opaque_layer->SetContentsOpaque(true);
+        opaque_layer->SetDrawsContent(true);
+        opaque_layer->SetBounds(gfx::Size(kSquareSize, kSquareSize));
+        opaque_layer->SetContentBounds(gfx::Size(kSquareSize, kSquareSize));
+        opaque_layer->SetPosition(gfx::Point(x * kSquareSize, y * kSquareSize));
+        active_tree()->root_layer()->AddChild(opaque_layer.PassAs<LayerImpl>());
+        ++num_squares;
+      }
+    }
+  }
+
+  active_tree()->UpdateDrawProperties();
+  const LayerImplList& rsll = active_tree()->RenderSurfaceLayerList();
+  ASSERT_EQ(1u, rsll.size());
+  EXPECT_EQ(static_cast<size_t>(num_squares),
+            rsll[0]->render_surface()->layer_list().size());
+
+  LayerIterator<LayerImpl> begin = LayerIterator<LayerImpl>::Begin(&rsll);
+  LayerIterator<LayerImpl> end = LayerIterator<LayerImpl>::End(&rsll);
+
+  // The squares add occlusion.
+  for (int i = 0; i < num_squares; ++i) {
+    LayerIteratorPosition<LayerImpl> pos = begin;
+    tracker.EnterLayer(pos);
+    tracker.LeaveLayer(pos);
+    ++begin;
+  }
+
+  gfx::Transform transform_to_target;
+
+  do {
+    for (int x = 0; x + 256 <= viewport_rect.width(); x += 256) {
+      for (int y = 0; y + 256 <= viewport_rect.height(); y += 256) {
+        gfx::Rect query_content_rect(x, y, 256, 256);
+        bool occluded =
+            tracker.IsOccluded(query_content_rect, transform_to_target);
+        CHECK_EQ(use_screen_space_coverage, occluded)
+            << query_content_rect.ToString();
+      }
+    }
+
+    timer_.NextLap();
+  } while (!timer_.HasTimeLimitExpired());
+
+  LayerIteratorPosition<LayerImpl> next = begin;
+  EXPECT_EQ(active_tree()->root_layer(), next.current_layer);
+
+  ++begin;
+  EXPECT_EQ(end, begin);
+
+  PrintResults();
+}
+
+TEST_F(OcclusionTrackerPerfTest, IsOccluded_Checkerboard) {
+  SetTestName("is_occluded_checkerboard");
+  IsOccludedBehindCheckerboard(false);
+}
+
+TEST_F(OcclusionTrackerPerfTest, IsOccluded_Checkerboard_CoverageMap) {
+  SetTestName("is_occluded_checkerboard_coverage_map");
+  IsOccludedBehindCheckerboard(true);
+}
+
+// Occlusion, damage and invalidation tracking mostly union, subtract and
+// intersect a handful of rects. These compare cc::Region against the SkRegion
+// it used to wrap, on the same sequence of operations.
+static const int kNumRegionRects = 10;
+
+TEST_F(OcclusionTrackerPerfTest, RegionOps) {
+  SetTestName("region_ops");
+
+  gfx::Rect viewport_rect(768, 1038);
+  do {
+    Region region;
+    for (int i = 0; i < kNumRegionRects; ++i)
+      region.Union(gfx::Rect(i * 20, i * 30, 256, 256));
+    region.Subtract(gfx::Rect(100, 100, 50, 50));
+    region.Intersect(viewport_rect);
+    CHECK(region.Contains(gfx::Rect(0, 0, 10, 10)));
+    CHECK(!region.Intersects(gfx::Rect(110, 110, 10, 10)));
+
+    timer_.NextLap();
+  } while (!timer_.HasTimeLimitExpired());
+
+  PrintResults();
+}
+
+TEST_F(OcclusionTrackerPerfTest, RegionOps_SkRegion) {
+  SetTestName("region_ops_skregion");
+
+  gfx::Rect viewport_rect(768, 1038);
+  do {
+    SkRegion region;
+    for (int i = 0; i < kNumRegionRects; ++i) {
+      region.op(gfx::RectToSkIRect(gfx::Rect(i * 20, i * 30, 256, 256)),
+                SkRegion::kUnion_Op);
+    }
+    region.op(gfx::RectToSkIRect(gfx::Rect(100, 100, 50, 50)),
+              SkRegion::kDifference_Op);
+    region.op(gfx::RectToSkIRect(viewport_rect), SkRegion::kIntersect_Op);
+    CHECK(region.contains(gfx::RectToSkIRect(gfx::Rect(0, 0, 10, 10))));
+    CHECK(!region.intersects(gfx::RectToSkIRect(gfx::Rect(110, 110, 10, 10))));
+
+    timer_.NextLap();
+  } while (!timer_.HasTimeLimitExpired());
+
+  PrintResults();
+}
+
 }  // namespace
 }  // namespace cc
@@ -2972,6 +2972,244 @@ class OcclusionTrackerTestOccludedLayer : public OcclusionTrackerTest<Types> {
 
 ALL_OCCLUSIONTRACKER_TEST(OcclusionTrackerTestOccludedLayer)
 
+template <class Types>
+class OcclusionTrackerTestScreenSpaceCoverageOccludesLayer
+    : public OcclusionTrackerTest<Types> {
+ protected:
+  explicit OcclusionTrackerTestScreenSpaceCoverageOccludesLayer(
+      bool opaque_layers)
+      : OcclusionTrackerTest<Types>(opaque_layers) {}
+  void RunMyTest() {
+    // Five occluders cover (0, 0, 200, 200) together, but no two of them
+    // union into one larger rect that covers it. |center| is in a surface so
+    // that its occlusion reaches the root when the surface is merged.
+    typename Types::ContentLayerType* root = this->CreateRoot(
+        this->identity_matrix, gfx::PointF(), gfx::Size(300, 300));
+    typename Types::ContentLayerType* hidden =
+        this->CreateDrawingLayer(root,
+                                 this->identity_matrix,
+                                 gfx::PointF(),
+                                 gfx::Size(210, 200),
+                                 false);
+    typename Types::LayerType* surface =
+        this->CreateSurface(root,
+                            this->identity_matrix,
+                            gfx::PointF(80.f, 80.f),
+                            gfx::Size(40, 40));
+    typename Types::ContentLayerType* center =
+        this->CreateDrawingLayer(surface,
+                                 this->identity_matrix,
+                                 gfx::PointF(),
+                                 gfx::Size(40, 40),
+                                 true);
+    typename Types::ContentLayerType* bottom_left =
+        this->CreateDrawingLayer(root,
+                                 this->identity_matrix,
+                                 gfx::PointF(0.f, 80.f),
+                                 gfx::Size(80, 120),
+                                 true);
+    typename Types::ContentLayerType* bottom_right =
+        this->CreateDrawingLayer(root,
+                                 this->identity_matrix,
+                                 gfx::PointF(80.f, 120.f),
+                                 gfx::Size(120, 80),
+                                 true);
+    typename Types::ContentLayerType* top_right =
+        this->CreateDrawingLayer(root,
+                                 this->identity_matrix,
+                                 gfx::PointF(120.f, 0.f),
+                                 gfx::Size(80, 120),
+                                 true);
+    typename Types::ContentLayerType* top_left =
+        this->CreateDrawingLayer(root,
+                                 this->identity_matrix,
+                                 gfx::PointF(),
+                                 gfx::Size(120, 80),
+                                 true);
+    this->CalcDrawEtc(root);
+
+    TestOcclusionTrackerWithClip<typename Types::LayerType> occlusion(
+        gfx::Rect(0, 0, 300, 300));
+    occlusion.set_use_screen_space_coverage(true);
+
+    this->VisitLayer(top_left, &occlusion);
+    this->VisitLayer(top_right, &occlusion);
+    this->VisitLayer(bottom_right, &occlusion);
+    this->VisitLayer(bottom_left, &occlusion);
+    this->VisitLayer(center, &occlusion);
+    this->VisitContributingSurface(surface, &occlusion);
+    this->EnterLayer(hidden, &occlusion);
+
+    // The single rect of occlusion only holds the top row.
+    EXPECT_EQ(gfx::Rect(0, 0, 200, 80).ToString(),
+              occlusion.occlusion_from_inside_target().ToString());
+    EXPECT_FALSE(occlusion.OccludedLayer(hidden, gfx::Rect(0, 0, 200, 200)));
+    EXPECT_EQ(gfx::Rect(0, 80, 200, 120).ToString(),
+              occlusion.UnoccludedLayerContentRect(
+                            hidden, gfx::Rect(0, 0, 200, 200)).ToString());
+
+    // The coverage sees all of the occluders.
+    EXPECT_TRUE(occlusion.IsOccluded(gfx::Rect(0, 0, 200, 200),
+                                     hidden->draw_transform()));
+    EXPECT_TRUE(occlusion.IsOccluded(gfx::Rect(70, 70, 60, 60),
+                                     hidden->draw_transform()));
+    EXPECT_TRUE(occlusion.IsOccluded(gfx::Rect(150, 150, 50, 50),
+                                     hidden->draw_transform()));
+    EXPECT_FALSE(occlusion.IsOccluded(gfx::Rect(0, 0, 210, 200),
+                                      hidden->draw_transform()));
+    EXPECT_FALSE(occlusion.IsOccluded(gfx::Rect(150, 190, 60, 10),
+                                      hidden->draw_transform()));
+    this->LeaveLayer(hidden, &occlusion);
+  }
+};
+
+ALL_OCCLUSIONTRACKER_TEST(OcclusionTrackerTestScreenSpaceCoverageOccludesLayer)
+
+template <class Types>
+class OcclusionTrackerTestScreenSpaceCoverageNotUsedUnlessEnabled
+    : public OcclusionTrackerTest<Types> {
+ protected:
+  explicit OcclusionTrackerTestScreenSpaceCoverageNotUsedUnlessEnabled(
+      bool opaque_layers)
+      : OcclusionTrackerTest<Types>(opaque_layers) {}
+  void RunMyTest() {
+    typename Types::ContentLayerType* root = this->CreateRoot(
+        this->identity_matrix, gfx::PointF(), gfx::Size(200, 200));
+    typename Types::ContentLayerType* hidden =
+        this->CreateDrawingLayer(root,
+                                 this->identity_matrix,
+                                 gfx::PointF(),
+                                 gfx::Size(200, 200),
+                                 false);
+    typename Types::ContentLayerType* center =
+        this->CreateDrawingLayer(root,
+                                 this->identity_matrix,
+                                 gfx::PointF(80.f, 80.f),
+                                 gfx::Size(40, 40),
+                                 true);
+    typename Types::ContentLayerType* bottom_left =
+        this->CreateDrawingLayer(root,
+                                 this->identity_matrix,
+                                 gfx::PointF(0.f, 80.f),
+                                 gfx::Size(80, 120),
+                                 true);
+    typename Types::ContentLayerType* bottom_right =
+        this->CreateDrawingLayer(root,
+                                 this->identity_matrix,
+                                 gfx::PointF(80.f, 120.f),
+                                 gfx::Size(120, 80),
+                                 true);
+    typename Types::ContentLayerType* top_right =
+        this->CreateDrawingLayer(root,
+                                 this->identity_matrix,
+                                 gfx::PointF(120.f, 0.f),
+                                 gfx::Size(80, 120),
+                                 true);
+    typename Types::ContentLayerType* top_left =
+        this->CreateDrawingLayer(root,
+                                 this->identity_matrix,
+                                 gfx::PointF(),
+                                 gfx::Size(120, 80),
+                                 true);
+    this->CalcDrawEtc(root);
+
+    TestOcclusionTrackerWithClip<typename Types::LayerType> occlusion(
+        gfx::Rect(0, 0, 200, 200));
+
+    this->VisitLayer(top_left, &occlusion);
+    this->VisitLayer(top_right, &occlusion);
+    this->VisitLayer(bottom_right, &occlusion);
+    this->VisitLayer(bottom_left, &occlusion);
+    this->VisitLayer(center, &occlusion);
+    this->EnterLayer(hidden, &occlusion);
+
+    // Without the coverage, IsOccluded() only sees the single rect.
+    EXPECT_FALSE(occlusion.IsOccluded(gfx::Rect(0, 0, 200, 200),
+                                      hidden->draw_transform()));
+    EXPECT_TRUE(occlusion.IsOccluded(gfx::Rect(0, 0, 200, 80),
+                                     hidden->draw_transform()));
+    this->LeaveLayer(hidden, &occlusion);
+  }
+};
+
+ALL_OCCLUSIONTRACKER_TEST(
+    OcclusionTrackerTestScreenSpaceCoverageNotUsedUnlessEnabled)
+
+template <class Types>
+class OcclusionTrackerTestScreenSpaceCoverageBackgroundFilter
+    : public OcclusionTrackerTest<Types> {
+ protected:
+  explicit OcclusionTrackerTestScreenSpaceCoverageBackgroundFilter(
+      bool opaque_layers)
+      : OcclusionTrackerTest<Types>(opaque_layers) {}
+  void RunMyTest() {
+    FilterOperations filters;
+    filters.Append(FilterOperation::CreateBlurFilter(5.f));
+
+    int outset_top, outset_right, outset_bottom, outset_left;
+    filters.GetOutsets(
+        &outset_top, &outset_right, &outset_bottom, &outset_left);
+
+    // A 50x50 filtered surface right below an occluder that covers the top of
+    // the screen.
+    typename Types::ContentLayerType* parent = this->CreateRoot(
+        this->identity_matrix, gfx::PointF(), gfx::Size(200, 200));
+    typename Types::LayerType* filtered_surface =
+        this->CreateDrawingLayer(parent,
+                                 this->identity_matrix,
+                                 gfx::PointF(50.f, 50.f),
+                                 gfx::Size(50, 50),
+                                 false);
+    filtered_surface->SetBackgroundFilters(filters);
+    typename Types::LayerType* occluding_layer =
+        this->CreateDrawingLayer(parent,
+                                 this->identity_matrix,
+                                 gfx::PointF(),
+                                 gfx::Size(200, 50),
+                                 true);
+    this->CalcDrawEtc(parent);
+
+    TestOcclusionTrackerWithClip<typename Types::LayerType> occlusion(
+        gfx::Rect(0, 0, 200, 200));
+    occlusion.set_use_screen_space_coverage(true);
+
+    this->VisitLayer(occluding_layer, &occlusion);
+    EXPECT_TRUE(occlusion.IsOccluded(gfx::Rect(50, 40, 50, 10),
+                                     parent->draw_transform()));
+
+    this->VisitLayer(filtered_surface, &occlusion);
+    this->VisitContributingSurface(filtered_surface, &occlusion);
+    this->EnterLayer(parent, &occlusion);
+
+    // The blur reads the pixels above the surface, so they are subtracted
+    // from the coverage as well as from the occlusion rect.
+    EXPECT_FALSE(occlusion.IsOccluded(gfx::Rect(50, 40, 50, 10),
+                                      parent->draw_transform()));
+    EXPECT_FALSE(occlusion.IsOccluded(
+        gfx::Rect(50 - outset_left, 50 - outset_top, 1, 1),
+        parent->draw_transform()));
+    EXPECT_FALSE(occlusion.IsOccluded(
+        gfx::Rect(100 + outset_right - 1, 49, 1, 1),
+        parent->draw_transform()));
+
+    // The rest of the occluder is still covered, including the sides of the
+    // affected area that the occlusion rect can no longer hold.
+    EXPECT_EQ(gfx::Rect(0, 0, 200, 50 - outset_top).ToString(),
+              occlusion.occlusion_from_inside_target().ToString());
+    EXPECT_TRUE(occlusion.IsOccluded(gfx::Rect(0, 0, 200, 50 - outset_top),
+                                     parent->draw_transform()));
+    EXPECT_TRUE(occlusion.IsOccluded(gfx::Rect(0, 0, 50 - outset_left, 50),
+                                     parent->draw_transform()));
+    EXPECT_TRUE(occlusion.IsOccluded(
+        gfx::Rect(100 + outset_right, 0, 100 - outset_right, 50),
+        parent->draw_transform()));
+    this->LeaveLayer(parent, &occlusion);
+  }
+};
+
+ALL_OCCLUSIONTRACKER_TEST(
+    OcclusionTrackerTestScreenSpaceCoverageBackgroundFilter)
+
 template <class Types>
 class OcclusionTrackerTestUnoccludedLayerQuery
     : public OcclusionTrackerTest<Types> {
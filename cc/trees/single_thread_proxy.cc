@@ -513,6 +513,12 @@ DrawResult SingleThreadProxy::DoComposite(base::TimeTicks frame_begin_time,
     UpdateBackgroundAnimateTicking();
 
     layer_tree_host_impl_->PrepareToDraw(frame);
+    if (scheduler_on_impl_thread_) {
+      scheduler_on_impl_thread_->SetDrawStats(
+          layer_tree_host_impl_->resource_provider()->num_resources(),
+          layer_tree_host_impl_->rendering_stats_instrumentation()
+              ->impl_thread_rendering_stats().rasterize_time);
+    }
     layer_tree_host_impl_->DrawLayers(frame, frame_begin_time);
     layer_tree_host_impl_->DidDrawAllLayers(*frame);
 
@@ -1068,6 +1068,12 @@ DrawResult ThreadProxy::DrawSwapInternal(bool forced_draw) {
   }
 
   if (draw_frame) {
+    // DrawLayers() clears the impl thread stats, so grab the raster time for
+    // this frame first.
+    impl().scheduler->SetDrawStats(
+        impl().layer_tree_host_impl->resource_provider()->num_resources(),
+        impl().layer_tree_host_impl->rendering_stats_instrumentation()
+            ->impl_thread_rendering_stats().rasterize_time);
     impl().layer_tree_host_impl->DrawLayers(
         &frame, impl().scheduler->LastBeginImplFrameTime());
     result = DRAW_SUCCESS;
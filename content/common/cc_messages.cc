@@ -299,6 +299,8 @@ void ParamTraits<cc::RenderPass>::Write(
 
   size_t shared_quad_state_index = 0;
   size_t last_shared_quad_state_index = kuint32max;
+  cc::SharedQuadStateList::ConstIterator shared_quad_state_iter =
+      p.shared_quad_state_list.begin();
   for (cc::QuadList::ConstIterator iter = p.quad_list.begin();
        iter != p.quad_list.end();
        ++iter) {
@@ -349,8 +351,7 @@ void ParamTraits<cc::RenderPass>::Write(
         break;
     }
 
-    const cc::ScopedPtrVector<cc::SharedQuadState>& sqs_list =
-        p.shared_quad_state_list;
+    const cc::SharedQuadStateList& sqs_list = p.shared_quad_state_list;
 
     // This is an invalid index.
     size_t bad_index = sqs_list.size();
@@ -364,9 +365,11 @@ void ParamTraits<cc::RenderPass>::Write(
 
     // SharedQuadStates should appear in the order they are used by DrawQuads.
     // Find the SharedQuadState for this DrawQuad.
-    while (shared_quad_state_index < sqs_list.size() &&
-           quad->shared_quad_state != sqs_list[shared_quad_state_index])
+    while (shared_quad_state_iter != sqs_list.end() &&
+           quad->shared_quad_state != &*shared_quad_state_iter) {
+      ++shared_quad_state_iter;
       ++shared_quad_state_index;
+    }
 
     DCHECK_LT(shared_quad_state_index, sqs_list.size());
     if (shared_quad_state_index >= sqs_list.size()) {
@@ -376,7 +379,7 @@ void ParamTraits<cc::RenderPass>::Write(
 
     WriteParam(m, shared_quad_state_index);
     if (shared_quad_state_index != last_shared_quad_state_index) {
-      WriteParam(m, *sqs_list[shared_quad_state_index]);
+      WriteParam(m, *shared_quad_state_iter);
       last_shared_quad_state_index = shared_quad_state_index;
     }
   }
@@ -530,10 +533,13 @@ void ParamTraits<cc::RenderPass>::Log(
   l->append(", ");
 
   l->append("[");
-  for (size_t i = 0; i < p.shared_quad_state_list.size(); ++i) {
-    if (i)
+  for (cc::SharedQuadStateList::ConstIterator iter =
+           p.shared_quad_state_list.begin();
+       iter != p.shared_quad_state_list.end();
+       ++iter) {
+    if (iter != p.shared_quad_state_list.begin())
       l->append(", ");
-    LogParam(*p.shared_quad_state_list[i], l);
+    LogParam(*iter, l);
   }
   l->append("], [");
   for (cc::QuadList::ConstIterator iter = p.quad_list.begin();
@@ -711,6 +717,23 @@ void ParamTraits<cc::CompositorFrameAck>::Log(const param_type& p,
   l->append(")");
 }
 
+// Only the shared quad states that are used by a quad are serialized, once
+// per run of quads that share them.
+static size_t CountSerializedSharedQuadStates(const cc::RenderPass& p) {
+  size_t count = 0;
+  const cc::SharedQuadState* last_shared_quad_state = NULL;
+  for (cc::QuadList::ConstIterator iter = p.quad_list.begin();
+       iter != p.quad_list.end();
+       ++iter) {
+    if (iter->shared_quad_state &&
+        iter->shared_quad_state != last_shared_quad_state) {
+      ++count;
+      last_shared_quad_state = iter->shared_quad_state;
+    }
+  }
+  return count;
+}
+
 void ParamTraits<cc::DelegatedFrameData>::Write(Message* m,
                                                 const param_type& p) {
   DCHECK_NE(0u, p.render_pass_list.size());
@@ -726,8 +749,14 @@ void ParamTraits<cc::DelegatedFrameData>::Write(Message* m,
   WriteParam(m, p.device_scale_factor);
   WriteParam(m, p.resource_list);
   WriteParam(m, p.render_pass_list.size());
-  for (size_t i = 0; i < p.render_pass_list.size(); ++i)
-    WriteParam(m, *p.render_pass_list[i]);
+  for (size_t i = 0; i < p.render_pass_list.size(); ++i) {
+    // The list sizes go ahead of each pass so the reader can allocate the
+    // pass' quads and shared quad states in one block each.
+    const cc::RenderPass* pass = p.render_pass_list[i];
+    WriteParam(m, pass->quad_list.size());
+    WriteParam(m, CountSerializedSharedQuadStates(*pass));
+    WriteParam(m, *pass);
+  }
 }
 
 bool ParamTraits<cc::DelegatedFrameData>::Read(const Message* m,
@@ -737,6 +766,15 @@ bool ParamTraits<cc::DelegatedFrameData>::Read(const Message* m,
     return false;
 
   const static size_t kMaxRenderPasses = 10000;
+  const static size_t kMaxSharedQuadStateListSize = 100000;
+  const static size_t kMaxQuadListSize = 1000000;
+
+  // Every serialized quad and shared quad state is at least as large as a
+  // gfx::Rect, so the message can't hold more of them than this. Checking the
+  // sizes sent ahead of the passes against it keeps a small message from
+  // making us reserve large lists.
+  const size_t max_elements = m->payload_size() / sizeof(gfx::Rect);
+  size_t num_elements = 0;
 
   size_t num_render_passes;
   if (!ReadParam(m, iter, &p->resource_list) ||
@@ -744,9 +782,25 @@ bool ParamTraits<cc::DelegatedFrameData>::Read(const Message* m,
       num_render_passes > kMaxRenderPasses || num_render_passes == 0)
     return false;
   for (size_t i = 0; i < num_render_passes; ++i) {
-    scoped_ptr<cc::RenderPass> render_pass = cc::RenderPass::Create();
+    size_t quad_list_size;
+    size_t shared_quad_state_list_size;
+    if (!ReadParam(m, iter, &quad_list_size) ||
+        !ReadParam(m, iter, &shared_quad_state_list_size) ||
+        quad_list_size > kMaxQuadListSize ||
+        shared_quad_state_list_size > kMaxSharedQuadStateListSize)
+      return false;
+    num_elements += quad_list_size + shared_quad_state_list_size;
+    if (num_elements > max_elements)
+      return false;
+    scoped_ptr<cc::RenderPass> render_pass =
+        cc::RenderPass::Create(shared_quad_state_list_size, quad_list_size);
     if (!ReadParam(m, iter, render_pass.get()))
       return false;
+    // The pass must contain exactly what the sizes ahead of it promised.
+    if (render_pass->quad_list.size() != quad_list_size ||
+        render_pass->shared_quad_state_list.size() !=
+            shared_quad_state_list_size)
+      return false;
     p->render_pass_list.push_back(render_pass.Pass());
   }
   return true;
@@ -474,8 +474,8 @@ TEST_F(CCMessagesTest, AllQuads) {
   ASSERT_EQ(3u, pass_in->shared_quad_state_list.size());
   ASSERT_EQ(10u, pass_in->quad_list.size());
   for (size_t i = 0; i < 3; ++i) {
-    Compare(pass_cmp->shared_quad_state_list[i],
-            pass_in->shared_quad_state_list[i]);
+    Compare(pass_cmp->shared_quad_state_list.ElementAt(i),
+            pass_in->shared_quad_state_list.ElementAt(i));
   }
   for (cc::QuadList::Iterator in_iter = pass_in->quad_list.begin(),
                               cmp_iter = pass_cmp->quad_list.begin();
@@ -510,8 +510,8 @@ TEST_F(CCMessagesTest, AllQuads) {
   ASSERT_EQ(3u, pass_out->shared_quad_state_list.size());
   ASSERT_EQ(10u, pass_out->quad_list.size());
   for (size_t i = 0; i < 3; ++i) {
-    Compare(pass_cmp->shared_quad_state_list[i],
-            pass_out->shared_quad_state_list[i]);
+    Compare(pass_cmp->shared_quad_state_list.ElementAt(i),
+            pass_out->shared_quad_state_list.ElementAt(i));
   }
   for (cc::QuadList::Iterator out_iter = pass_out->quad_list.begin(),
                               cmp_iter = pass_cmp->quad_list.begin();
@@ -634,9 +634,91 @@ TEST_F(CCMessagesTest, UnusedSharedQuadStates) {
   ASSERT_EQ(2u, pass_out->quad_list.size());
 
   EXPECT_EQ(gfx::Size(1, 1).ToString(),
-            pass_out->shared_quad_state_list[0]->content_bounds.ToString());
+            pass_out->shared_quad_state_list.ElementAt(0)
+                ->content_bounds.ToString());
   EXPECT_EQ(gfx::Size(4, 4).ToString(),
-            pass_out->shared_quad_state_list[1]->content_bounds.ToString());
+            pass_out->shared_quad_state_list.ElementAt(1)
+                ->content_bounds.ToString());
+}
+
+// Writes a DelegatedFrameData holding |pass|, with the given list sizes sent
+// ahead of the pass in place of its real ones.
+void WriteFrameWithListSizes(IPC::Message* msg,
+                             const RenderPass& pass,
+                             size_t quad_list_size,
+                             size_t shared_quad_state_list_size) {
+  IPC::WriteParam(msg, 1.f);
+  IPC::WriteParam(msg, cc::TransferableResourceArray());
+  IPC::WriteParam(msg, static_cast<size_t>(1));
+  IPC::WriteParam(msg, quad_list_size);
+  IPC::WriteParam(msg, shared_quad_state_list_size);
+  IPC::WriteParam(msg, pass);
+}
+
+TEST_F(CCMessagesTest, ListSizesMustMatchPass) {
+  scoped_ptr<RenderPass> pass = RenderPass::Create();
+  pass->SetAll(RenderPassId(1, 1),
+               gfx::Rect(100, 100),
+               gfx::Rect(),
+               gfx::Transform(),
+               false);
+  SharedQuadState* shared_state = pass->CreateAndAppendSharedQuadState();
+  shared_state->SetAll(gfx::Transform(),
+                       gfx::Size(1, 1),
+                       gfx::Rect(),
+                       gfx::Rect(),
+                       false,
+                       1.f,
+                       SkXfermode::kSrcOver_Mode,
+                       0);
+  CheckerboardDrawQuad* quad =
+      pass->CreateAndAppendDrawQuad<CheckerboardDrawQuad>();
+  quad->SetAll(shared_state,
+               gfx::Rect(10, 10),
+               gfx::Rect(10, 10),
+               gfx::Rect(10, 10),
+               false,
+               SK_ColorRED);
+
+  {
+    IPC::Message msg(1, 2, IPC::Message::PRIORITY_NORMAL);
+    WriteFrameWithListSizes(&msg, *pass, 1, 1);
+    DelegatedFrameData frame_out;
+    PickleIterator iter(msg);
+    EXPECT_TRUE(
+        IPC::ParamTraits<DelegatedFrameData>::Read(&msg, &iter, &frame_out));
+  }
+
+  // More quads than the pass holds.
+  {
+    IPC::Message msg(1, 2, IPC::Message::PRIORITY_NORMAL);
+    WriteFrameWithListSizes(&msg, *pass, 2, 1);
+    DelegatedFrameData frame_out;
+    PickleIterator iter(msg);
+    EXPECT_FALSE(
+        IPC::ParamTraits<DelegatedFrameData>::Read(&msg, &iter, &frame_out));
+  }
+
+  // Fewer shared quad states than the pass holds.
+  {
+    IPC::Message msg(1, 2, IPC::Message::PRIORITY_NORMAL);
+    WriteFrameWithListSizes(&msg, *pass, 1, 0);
+    DelegatedFrameData frame_out;
+    PickleIterator iter(msg);
+    EXPECT_FALSE(
+        IPC::ParamTraits<DelegatedFrameData>::Read(&msg, &iter, &frame_out));
+  }
+
+  // Within the per-pass limits, but far more quads than the message could
+  // contain. This is rejected before the lists are reserved.
+  {
+    IPC::Message msg(1, 2, IPC::Message::PRIORITY_NORMAL);
+    WriteFrameWithListSizes(&msg, *pass, 100000, 1);
+    DelegatedFrameData frame_out;
+    PickleIterator iter(msg);
+    EXPECT_FALSE(
+        IPC::ParamTraits<DelegatedFrameData>::Read(&msg, &iter, &frame_out));
+  }
 }
 
 TEST_F(CCMessagesTest, Resources) {
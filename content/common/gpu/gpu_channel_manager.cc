@@ -6,17 +6,20 @@
 
 #include "base/bind.h"
 #include "base/command_line.h"
+#include "base/threading/thread.h"
 #include "content/common/gpu/gpu_channel.h"
 #include "content/common/gpu/gpu_memory_buffer_factory.h"
 #include "content/common/gpu/gpu_memory_manager.h"
 #include "content/common/gpu/gpu_messages.h"
 #include "content/common/gpu/sync_point_manager.h"
 #include "content/common/message_router.h"
+#include "gpu/command_buffer/service/disk_program_cache.h"
 #include "gpu/command_buffer/service/feature_info.h"
 #include "gpu/command_buffer/service/gpu_switches.h"
 #include "gpu/command_buffer/service/mailbox_manager.h"
 #include "gpu/command_buffer/service/memory_program_cache.h"
 #include "gpu/command_buffer/service/shader_translator_cache.h"
+#include "gpu/config/gpu_info.h"
 #include "ipc/message_filter.h"
 #include "ui/gl/gl_bindings.h"
 #include "ui/gl/gl_share_group.h"
@@ -79,7 +82,8 @@ GpuChannelManager::GpuChannelManager(MessageRouter* router,
                                      GpuWatchdog* watchdog,
                                      base::MessageLoopProxy* io_message_loop,
                                      base::WaitableEvent* shutdown_event,
-                                     IPC::SyncChannel* channel)
+                                     IPC::SyncChannel* channel,
+                                     const gpu::GPUInfo& gpu_info)
     : io_message_loop_(io_message_loop),
       shutdown_event_(shutdown_event),
       router_(router),
@@ -97,6 +101,13 @@ GpuChannelManager::GpuChannelManager(MessageRouter* router,
   DCHECK(io_message_loop);
   DCHECK(shutdown_event);
   channel_->AddFilter(filter_.get());
+  // The GL strings are collected at startup, so the program cache doesn't
+  // need a current context. Programs are only cached in memory when the
+  // strings weren't collected.
+  if (!gpu_info.gl_renderer.empty()) {
+    program_cache_driver_version_ =
+        gpu_info.gl_vendor + gpu_info.gl_renderer + gpu_info.gl_version;
+  }
 }
 
 GpuChannelManager::~GpuChannelManager() {
@@ -113,7 +124,20 @@ gpu::gles2::ProgramCache* GpuChannelManager::program_cache() {
        gfx::g_driver_gl.ext.b_GL_OES_get_program_binary) &&
       !CommandLine::ForCurrentProcess()->HasSwitch(
           switches::kDisableGpuProgramCache)) {
-    program_cache_.reset(new gpu::gles2::MemoryProgramCache());
+    const CommandLine* command_line = CommandLine::ForCurrentProcess();
+    if (command_line->HasSwitch(switches::kGpuProgramCacheDir) &&
+        !command_line->HasSwitch(switches::kDisableGpuShaderDiskCache) &&
+        !program_cache_driver_version_.empty()) {
+      program_cache_thread_.reset(new base::Thread("GpuProgramCacheThread"));
+      if (program_cache_thread_->Start()) {
+        program_cache_.reset(new gpu::gles2::DiskProgramCache(
+            command_line->GetSwitchValuePath(switches::kGpuProgramCacheDir),
+            program_cache_driver_version_,
+            program_cache_thread_->message_loop_proxy()));
+      }
+    }
+    if (!program_cache_.get())
+      program_cache_.reset(new gpu::gles2::MemoryProgramCache());
   }
   return program_cache_.get();
 }
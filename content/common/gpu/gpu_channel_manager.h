@@ -23,6 +23,7 @@
 #include "ui/gl/gl_surface.h"
 
 namespace base {
+class Thread;
 class WaitableEvent;
 }
 
@@ -32,6 +33,7 @@ struct GpuMemoryBufferHandle;
 }
 
 namespace gpu {
+struct GPUInfo;
 namespace gles2 {
 class MailboxManager;
 class ProgramCache;
@@ -64,7 +66,8 @@ class GpuChannelManager : public IPC::Listener,
                     GpuWatchdog* watchdog,
                     base::MessageLoopProxy* io_message_loop,
                     base::WaitableEvent* shutdown_event,
-                    IPC::SyncChannel* channel);
+                    IPC::SyncChannel* channel,
+                    const gpu::GPUInfo& gpu_info);
   virtual ~GpuChannelManager();
 
   // Remove the channel for a particular renderer.
@@ -144,6 +147,11 @@ class GpuChannelManager : public IPC::Listener,
   GpuEventsDispatcher gpu_devtools_events_dispatcher_;
   GpuWatchdog* watchdog_;
   scoped_refptr<SyncPointManager> sync_point_manager_;
+  // Identifies the GL driver of the programs in the disk program cache.
+  std::string program_cache_driver_version_;
+  // Does the file I/O of the disk program cache. Stopping it writes the
+  // pending entries, so it has to outlive |program_cache_|.
+  scoped_ptr<base::Thread> program_cache_thread_;
   scoped_ptr<gpu::gles2::ProgramCache> program_cache_;
   scoped_refptr<gpu::gles2::ShaderTranslatorCache> shader_translator_cache_;
   scoped_refptr<gfx::GLSurface> default_offscreen_surface_;
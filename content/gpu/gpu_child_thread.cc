@@ -164,7 +164,8 @@ void GpuChildThread::OnInitialize() {
                             watchdog_thread_.get(),
                             ChildProcess::current()->io_message_loop_proxy(),
                             ChildProcess::current()->GetShutDownEvent(),
-                            channel()));
+                            channel(),
+                            gpu_info_));
 
 #if defined(USE_OZONE)
   ui::OzonePlatform::GetInstance()
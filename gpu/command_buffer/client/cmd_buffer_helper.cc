@@ -13,6 +13,13 @@
 
 namespace gpu {
 
+namespace {
+
+// Weight of a new sample in the service throughput moving average.
+const double kServiceThroughputSampleWeight = 0.25;
+
+}  // namespace
+
 CommandBufferHelper::CommandBufferHelper(CommandBuffer* command_buffer)
     : command_buffer_(command_buffer),
       ring_buffer_id_(-1),
@@ -29,6 +36,7 @@ CommandBufferHelper::CommandBufferHelper(CommandBuffer* command_buffer)
       usable_(true),
       context_lost_(false),
       flush_automatically_(true),
+      service_entries_per_second_(0.0),
       flush_generation_(0) {
 }
 
@@ -64,9 +72,9 @@ void CommandBufferHelper::CalcImmediateEntries(int waiting_count) {
 
   // Limit entry count to force early flushing.
   if (flush_automatically_) {
-    int32 limit =
-        total_entry_count_ /
-        ((curr_get == last_put_sent_) ? kAutoFlushSmall : kAutoFlushBig);
+    int32 limit = (curr_get == last_put_sent_)
+                      ? total_entry_count_ / kAutoFlushSmall
+                      : BusyAutoFlushLimit();
 
     int32 pending =
         (put_ + total_entry_count_ - last_put_sent_) % total_entry_count_;
@@ -85,6 +93,39 @@ void CommandBufferHelper::CalcImmediateEntries(int waiting_count) {
   }
 }
 
+int32 CommandBufferHelper::BusyAutoFlushLimit() const {
+  int32 max_limit = total_entry_count_ / kAutoFlushBig;
+  if (service_entries_per_second_ <= 0.0)
+    return max_limit;
+
+  // Commands flushed while the service is busy only start executing once it
+  // gets to them, so they can be batched into fewer flushes. Keep each batch
+  // to what the service gets through in the target time though, so that it
+  // doesn't run dry while the next batch is being built.
+  double target_entries = service_entries_per_second_ *
+                          kAutoFlushBusyTargetInMicroseconds /
+                          base::Time::kMicrosecondsPerSecond;
+  int32 min_limit = total_entry_count_ / kAutoFlushSmall;
+  if (target_entries <= min_limit)
+    return min_limit;
+  if (target_entries >= max_limit)
+    return max_limit;
+  return static_cast<int32>(target_entries);
+}
+
+void CommandBufferHelper::RecordServiceThroughput(int32 entries,
+                                                  base::TimeDelta elapsed) {
+  if (entries <= 0 || elapsed <= base::TimeDelta())
+    return;
+  double sample = entries / elapsed.InSecondsF();
+  if (service_entries_per_second_ <= 0.0) {
+    service_entries_per_second_ = sample;
+    return;
+  }
+  service_entries_per_second_ +=
+      (sample - service_entries_per_second_) * kServiceThroughputSampleWeight;
+}
+
 bool CommandBufferHelper::AllocateRingBuffer() {
   if (!usable()) {
     return false;
@@ -141,8 +182,17 @@ bool CommandBufferHelper::WaitForGetOffsetInRange(int32 start, int32 end) {
   if (!usable()) {
     return false;
   }
+  // The service is busy until get reaches the range, so the time it takes is a
+  // measure of its throughput.
+  int32 start_get = get_offset();
+  base::TimeTicks start_time = base::TimeTicks::Now();
   command_buffer_->WaitForGetOffsetInRange(start, end);
-  return command_buffer_->GetLastError() == gpu::error::kNoError;
+  if (command_buffer_->GetLastError() != gpu::error::kNoError)
+    return false;
+  RecordServiceThroughput(
+      (get_offset() - start_get + total_entry_count_) % total_entry_count_,
+      base::TimeTicks::Now() - start_time);
+  return true;
 }
 
 void CommandBufferHelper::Flush() {
@@ -230,7 +280,12 @@ void CommandBufferHelper::WaitForToken(int32 token) {
   if (last_token_read() >= token)
     return;
   Flush();
+  int32 start_get = get_offset();
+  base::TimeTicks start_time = base::TimeTicks::Now();
   command_buffer_->WaitForTokenInRange(token, token_);
+  RecordServiceThroughput(
+      (get_offset() - start_get + total_entry_count_) % total_entry_count_,
+      base::TimeTicks::Now() - start_time);
 }
 
 // Waits for available entries, basically waiting until get >= put + count + 1.
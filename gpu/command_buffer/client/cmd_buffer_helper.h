@@ -28,6 +28,10 @@ const int kPeriodicFlushDelayInMicroseconds =
 const int kAutoFlushSmall = 16;  // 1/16 of the buffer
 const int kAutoFlushBig = 2;     // 1/2 of the buffer
 
+// While the service is busy, commands are batched until they amount to about
+// this much service time, between kAutoFlushSmall and kAutoFlushBig.
+const int kAutoFlushBusyTargetInMicroseconds = 4000;
+
 // Command buffer helper class. This class simplifies ring buffer management:
 // it will allocate the buffer, give it to the buffer interface, and let the
 // user add commands to it, while taking care of the synchronization (put and
@@ -296,6 +300,12 @@ class GPU_EXPORT CommandBufferHelper {
   }
 
   void CalcImmediateEntries(int waiting_count);
+  // Returns the number of entries to batch before flushing while the service
+  // is still busy with previously flushed commands.
+  int32 BusyAutoFlushLimit() const;
+  // Updates the service throughput estimate with |entries| processed by the
+  // service in |elapsed|, while the service was known to be busy.
+  void RecordServiceThroughput(int32 entries, base::TimeDelta elapsed);
   bool AllocateRingBuffer();
   void FreeResources();
 
@@ -329,6 +339,10 @@ class GPU_EXPORT CommandBufferHelper {
 
   base::TimeTicks last_flush_time_;
 
+  // Moving average of the entries the service processes per second, measured
+  // while waiting on it. Zero until the first wait.
+  double service_entries_per_second_;
+
   // Incremented every time the helper flushes the command buffer.
   // Can be used to track when prior commands have been flushed.
   uint32 flush_generation_;
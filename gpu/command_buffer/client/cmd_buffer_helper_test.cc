@@ -128,6 +128,10 @@ class CommandBufferHelperTest : public testing::Test {
 
   int32 ImmediateEntryCount() const { return helper_->immediate_entry_count_; }
 
+  void RecordServiceThroughput(int32 entries, base::TimeDelta elapsed) {
+    helper_->RecordServiceThroughput(entries, elapsed);
+  }
+
   // Adds a command to the buffer through the helper, while adding it as an
   // expected call on the API mock.
   void AddCommandWithExpect(error::Error _return,
@@ -400,6 +404,43 @@ TEST_F(CommandBufferHelperTest, TestCalcImmediateEntriesAutoFlushing) {
   EXPECT_EQ(error::kNoError, GetError());
 }
 
+// Checks that the flush limit while the service is busy follows the measured
+// service throughput.
+TEST_F(CommandBufferHelperTest, TestCalcImmediateEntriesAdaptiveFlushing) {
+  command_buffer_->LockFlush();
+  helper_->SetAutomaticFlushes(true);
+  AddUniqueCommandWithExpect(error::kNoError, 2);
+  helper_->Flush();
+  EXPECT_EQ(ImmediateEntryCount(), kTotalNumCommandEntries / kAutoFlushBig);
+
+  // A service that gets through 2000 entries per second runs 8 entries in the
+  // target time.
+  RecordServiceThroughput(2, base::TimeDelta::FromMilliseconds(1));
+  helper_->SetAutomaticFlushes(true);
+  EXPECT_EQ(ImmediateEntryCount(),
+            2000 * kAutoFlushBusyTargetInMicroseconds /
+                base::Time::kMicrosecondsPerSecond);
+
+  // A slower service is still flushed no more often than an idle one.
+  for (int i = 0; i < 20; ++i)
+    RecordServiceThroughput(1, base::TimeDelta::FromSeconds(1));
+  helper_->SetAutomaticFlushes(true);
+  EXPECT_EQ(ImmediateEntryCount(), kTotalNumCommandEntries / kAutoFlushSmall);
+
+  // A fast service gets the largest batches.
+  for (int i = 0; i < 20; ++i)
+    RecordServiceThroughput(1000, base::TimeDelta::FromMilliseconds(1));
+  helper_->SetAutomaticFlushes(true);
+  EXPECT_EQ(ImmediateEntryCount(), kTotalNumCommandEntries / kAutoFlushBig);
+
+  helper_->Finish();
+  // Check that the commands did happen.
+  Mock::VerifyAndClearExpectations(api_mock_.get());
+
+  // Check the error status.
+  EXPECT_EQ(error::kNoError, GetError());
+}
+
 // Checks immediate_entry_count_ calc when automatic flushing is enabled, and
 // we allocate commands over the immediate_entry_count_ size.
 TEST_F(CommandBufferHelperTest, TestCalcImmediateEntriesOverFlushLimit) {
@@ -8,6 +8,7 @@
 
 #include <algorithm>
 
+#include "base/bits.h"
 #include "gpu/command_buffer/client/cmd_buffer_helper.h"
 
 namespace gpu {
@@ -31,6 +32,7 @@ unsigned int RoundUp(unsigned int size) {
 
 #ifndef _MSC_VER
 const FencedAllocator::Offset FencedAllocator::kInvalidOffset;
+const FencedAllocator::BlockIndex FencedAllocator::kNoBlock;
 #endif
 
 FencedAllocator::FencedAllocator(unsigned int size,
@@ -38,28 +40,29 @@ FencedAllocator::FencedAllocator(unsigned int size,
                                  const base::Closure& poll_callback)
     : helper_(helper),
       poll_callback_(poll_callback),
+      first_block_(kNoBlock),
+      num_blocks_(0),
+      free_size_classes_(0),
       bytes_in_use_(0) {
-  Block block = { FREE, 0, RoundDown(size), kUnusedToken };
-  blocks_.push_back(block);
+  for (int i = 0; i < kNumSizeClasses; ++i)
+    free_lists_[i] = kNoBlock;
+  first_block_ = NewBlock(FREE, 0, RoundDown(size));
+  if (blocks_[first_block_].size)
+    AddToFreeList(first_block_);
 }
 
 FencedAllocator::~FencedAllocator() {
   // Free blocks pending tokens.
-  for (unsigned int i = 0; i < blocks_.size(); ++i) {
-    if (blocks_[i].state == FREE_PENDING_TOKEN) {
-      i = WaitForTokenAndFreeBlock(i);
-    }
-  }
+  while (!pending_blocks_.empty())
+    WaitForTokenAndFreeOldestBlock();
 
-  DCHECK_EQ(blocks_.size(), 1u);
-  DCHECK_EQ(blocks_[0].state, FREE);
+  DCHECK_EQ(num_blocks_, 1u);
+  DCHECK_EQ(blocks_[first_block_].state, FREE);
 }
 
-// Looks for a non-allocated block that is big enough. Search in the FREE
-// blocks first (for direct usage), first-fit, then in the FREE_PENDING_TOKEN
-// blocks, waiting for them. The current implementation isn't smart about
-// optimizing what to wait for, just looks inside the block in order (first-fit
-// as well).
+// Looks for a FREE block that is big enough first, for direct usage. Then
+// reclaims the blocks whose tokens have passed, and as a last resort waits for
+// the blocks pending tokens, oldest first, until one big enough is freed.
 FencedAllocator::Offset FencedAllocator::Alloc(unsigned int size) {
   // size of 0 is not allowed because it would be inconsistent to only sometimes
   // have it succeed. Example: Alloc(SizeOfBuffer), Alloc(0).
@@ -70,59 +73,68 @@ FencedAllocator::Offset FencedAllocator::Alloc(unsigned int size) {
   // Round up the allocation size to ensure alignment.
   size = RoundUp(size);
 
-  // Try first to allocate in a free block.
-  for (unsigned int i = 0; i < blocks_.size(); ++i) {
-    Block &block = blocks_[i];
-    if (block.state == FREE && block.size >= size) {
-      return AllocInBlock(i, size);
-    }
-  }
+  BlockIndex index = FindFreeBlock(size);
+  if (index == kNoBlock && FreePassedTokens())
+    index = FindFreeBlock(size);
 
-  // No free block is available. Look for blocks pending tokens, and wait for
-  // them to be re-usable.
-  for (unsigned int i = 0; i < blocks_.size(); ++i) {
-    if (blocks_[i].state != FREE_PENDING_TOKEN)
-      continue;
-    i = WaitForTokenAndFreeBlock(i);
-    if (blocks_[i].size >= size)
-      return AllocInBlock(i, size);
+  while (index == kNoBlock && !pending_blocks_.empty()) {
+    BlockIndex freed = WaitForTokenAndFreeOldestBlock();
+    if (blocks_[freed].size >= size)
+      index = freed;
   }
-  return kInvalidOffset;
+  if (index == kNoBlock)
+    return kInvalidOffset;
+  return AllocInBlock(index, size);
 }
 
 // Looks for the corresponding block, mark it FREE, and collapse it if
 // necessary.
 void FencedAllocator::Free(FencedAllocator::Offset offset) {
   BlockIndex index = GetBlockByOffset(offset);
-  DCHECK_NE(blocks_[index].state, FREE);
-  Block &block = blocks_[index];
+  Block& block = blocks_[index];
+  DCHECK_NE(block.state, FREE);
 
-  if (block.state == IN_USE)
+  if (block.state == IN_USE) {
     bytes_in_use_ -= block.size;
+  } else {
+    pending_blocks_.erase(
+        std::find(pending_blocks_.begin(), pending_blocks_.end(), index));
+  }
 
-  block.state = FREE;
-  CollapseFreeBlock(index);
+  allocated_blocks_.erase(offset);
+  MarkBlockFree(index);
 }
 
 // Looks for the corresponding block, mark it FREE_PENDING_TOKEN.
 void FencedAllocator::FreePendingToken(
     FencedAllocator::Offset offset, int32 token) {
   BlockIndex index = GetBlockByOffset(offset);
-  Block &block = blocks_[index];
-  if (block.state == IN_USE)
+  Block& block = blocks_[index];
+  if (block.state == IN_USE) {
     bytes_in_use_ -= block.size;
+  } else {
+    DCHECK_EQ(block.state, FREE_PENDING_TOKEN);
+    pending_blocks_.erase(
+        std::find(pending_blocks_.begin(), pending_blocks_.end(), index));
+  }
   block.state = FREE_PENDING_TOKEN;
   block.token = token;
+  pending_blocks_.push_back(index);
 }
 
-// Gets the max of the size of the blocks marked as free.
+// Gets the max of the size of the blocks marked as free. Only the largest
+// non-empty size class can hold it.
 unsigned int FencedAllocator::GetLargestFreeSize() {
   FreeUnused();
+  if (!free_size_classes_)
+    return 0;
+  int size_class = kNumSizeClasses - 1;
+  while (!(free_size_classes_ & (1u << size_class)))
+    --size_class;
   unsigned int max_size = 0;
-  for (unsigned int i = 0; i < blocks_.size(); ++i) {
-    Block &block = blocks_[i];
-    if (block.state == FREE)
-      max_size = std::max(max_size, block.size);
+  for (BlockIndex index = free_lists_[size_class]; index != kNoBlock;
+       index = blocks_[index].next_free) {
+    max_size = std::max(max_size, blocks_[index].size);
   }
   return max_size;
 }
@@ -132,8 +144,9 @@ unsigned int FencedAllocator::GetLargestFreeSize() {
 unsigned int FencedAllocator::GetLargestFreeOrPendingSize() {
   unsigned int max_size = 0;
   unsigned int current_size = 0;
-  for (unsigned int i = 0; i < blocks_.size(); ++i) {
-    Block &block = blocks_[i];
+  for (BlockIndex index = first_block_; index != kNoBlock;
+       index = blocks_[index].next) {
+    Block &block = blocks_[index];
     if (block.state == IN_USE) {
       max_size = std::max(max_size, current_size);
       current_size = 0;
@@ -149,58 +162,210 @@ unsigned int FencedAllocator::GetLargestFreeOrPendingSize() {
 // - there is at least one block.
 // - there are no contiguous FREE blocks (they should have been collapsed).
 // - the successive offsets match the block sizes, and they are in order.
+// - the allocated blocks can be found by offset.
+// - every FREE block is in the free list of its size class, and only there.
 bool FencedAllocator::CheckConsistency() {
-  if (blocks_.size() < 1) return false;
-  for (unsigned int i = 0; i < blocks_.size() - 1; ++i) {
-    Block &current = blocks_[i];
-    Block &next = blocks_[i + 1];
-    // This test is NOT included in the next one, because offset is unsigned.
-    if (next.offset <= current.offset)
+  if (first_block_ == kNoBlock) return false;
+  size_t count = 0;
+  size_t free_count = 0;
+  Offset offset = 0;
+  BlockIndex prev = kNoBlock;
+  for (BlockIndex index = first_block_; index != kNoBlock;
+       index = blocks_[index].next) {
+    Block &block = blocks_[index];
+    if (block.prev != prev || block.offset != offset)
       return false;
-    if (next.offset != current.offset + current.size)
-      return false;
-    if (current.state == FREE && next.state == FREE)
+    if (block.state == FREE) {
+      if (prev != kNoBlock && blocks_[prev].state == FREE)
+        return false;
+      if (block.size)
+        ++free_count;
+    } else {
+      OffsetToBlockMap::iterator it = allocated_blocks_.find(block.offset);
+      if (it == allocated_blocks_.end() || it->second != index)
+        return false;
+    }
+    offset += block.size;
+    prev = index;
+    ++count;
+  }
+  if (count != num_blocks_)
+    return false;
+
+  size_t listed_count = 0;
+  for (int size_class = 0; size_class < kNumSizeClasses; ++size_class) {
+    if (!(free_size_classes_ & (1u << size_class)) !=
+        (free_lists_[size_class] == kNoBlock))
       return false;
+    BlockIndex prev_free = kNoBlock;
+    for (BlockIndex index = free_lists_[size_class]; index != kNoBlock;
+         index = blocks_[index].next_free) {
+      Block &block = blocks_[index];
+      if (block.state != FREE || block.prev_free != prev_free ||
+          GetSizeClass(block.size) != size_class)
+        return false;
+      prev_free = index;
+      ++listed_count;
+    }
   }
-  return true;
+  return listed_count == free_count;
 }
 
 // Returns false if all blocks are actually FREE, in which
 // case they would be coalesced into one block, true otherwise.
 bool FencedAllocator::InUse() {
-  return blocks_.size() != 1 || blocks_[0].state != FREE;
+  return num_blocks_ != 1 || blocks_[first_block_].state != FREE;
+}
+
+// static
+int FencedAllocator::GetSizeClass(unsigned int size) {
+  DCHECK_GE(size, kAllocAlignment);
+  return std::min(base::bits::Log2Floor(size / kAllocAlignment),
+                  kNumSizeClasses - 1);
+}
+
+FencedAllocator::BlockIndex FencedAllocator::NewBlock(State state,
+                                                      Offset offset,
+                                                      unsigned int size) {
+  Block block = { state, offset, size, kUnusedToken,
+                  kNoBlock, kNoBlock, kNoBlock, kNoBlock };
+  ++num_blocks_;
+  if (!deleted_blocks_.empty()) {
+    BlockIndex index = deleted_blocks_.back();
+    deleted_blocks_.pop_back();
+    blocks_[index] = block;
+    return index;
+  }
+  blocks_.push_back(block);
+  return blocks_.size() - 1;
+}
+
+void FencedAllocator::DeleteBlock(BlockIndex index) {
+  --num_blocks_;
+  deleted_blocks_.push_back(index);
+}
+
+void FencedAllocator::AddToFreeList(BlockIndex index) {
+  Block& block = blocks_[index];
+  DCHECK_EQ(block.state, FREE);
+  int size_class = GetSizeClass(block.size);
+  block.prev_free = kNoBlock;
+  block.next_free = free_lists_[size_class];
+  if (block.next_free != kNoBlock)
+    blocks_[block.next_free].prev_free = index;
+  free_lists_[size_class] = index;
+  free_size_classes_ |= 1u << size_class;
+}
+
+void FencedAllocator::RemoveFromFreeList(BlockIndex index) {
+  Block& block = blocks_[index];
+  DCHECK_EQ(block.state, FREE);
+  int size_class = GetSizeClass(block.size);
+  if (block.prev_free != kNoBlock)
+    blocks_[block.prev_free].next_free = block.next_free;
+  else
+    free_lists_[size_class] = block.next_free;
+  if (block.next_free != kNoBlock)
+    blocks_[block.next_free].prev_free = block.prev_free;
+  if (free_lists_[size_class] == kNoBlock)
+    free_size_classes_ &= ~(1u << size_class);
+}
+
+// Any block in a larger size class fits, so only the smallest such class needs
+// to be looked at. Blocks in the same size class as |size| may be too small,
+// and are only searched when there is nothing larger.
+FencedAllocator::BlockIndex FencedAllocator::FindFreeBlock(unsigned int size) {
+  int size_class = GetSizeClass(size);
+  BlockIndex index = free_lists_[size_class];
+  if (index != kNoBlock && blocks_[index].size >= size)
+    return index;
+
+  if (size_class + 1 < kNumSizeClasses) {
+    uint32_t larger_classes = free_size_classes_ >> (size_class + 1);
+    if (larger_classes) {
+      int larger_class = size_class + 1;
+      while (!(larger_classes & 1u)) {
+        larger_classes >>= 1;
+        ++larger_class;
+      }
+      return free_lists_[larger_class];
+    }
+  }
+
+  for (; index != kNoBlock; index = blocks_[index].next_free) {
+    if (blocks_[index].size >= size)
+      return index;
+  }
+  return kNoBlock;
 }
 
 // Collapse the block to the next one, then to the previous one. Provided the
 // structure is consistent, those are the only blocks eligible for collapse.
-FencedAllocator::BlockIndex FencedAllocator::CollapseFreeBlock(
-    BlockIndex index) {
-  if (index + 1 < blocks_.size()) {
-    Block &next = blocks_[index + 1];
-    if (next.state == FREE) {
-      blocks_[index].size += next.size;
-      blocks_.erase(blocks_.begin() + index + 1);
-    }
+FencedAllocator::BlockIndex FencedAllocator::MarkBlockFree(BlockIndex index) {
+  Block& block = blocks_[index];
+  block.state = FREE;
+  block.token = kUnusedToken;
+
+  BlockIndex next_index = block.next;
+  if (next_index != kNoBlock && blocks_[next_index].state == FREE) {
+    Block& next = blocks_[next_index];
+    RemoveFromFreeList(next_index);
+    block.size += next.size;
+    block.next = next.next;
+    if (block.next != kNoBlock)
+      blocks_[block.next].prev = index;
+    DeleteBlock(next_index);
   }
-  if (index > 0) {
-    Block &prev = blocks_[index - 1];
-    if (prev.state == FREE) {
-      prev.size += blocks_[index].size;
-      blocks_.erase(blocks_.begin() + index);
-      --index;
-    }
+
+  BlockIndex prev_index = block.prev;
+  if (prev_index != kNoBlock && blocks_[prev_index].state == FREE) {
+    Block& prev = blocks_[prev_index];
+    RemoveFromFreeList(prev_index);
+    prev.size += block.size;
+    prev.next = block.next;
+    if (prev.next != kNoBlock)
+      blocks_[prev.next].prev = prev_index;
+    DeleteBlock(index);
+    index = prev_index;
   }
+
+  AddToFreeList(index);
   return index;
 }
 
+// Tokens are usually freed in increasing order, but a caller may free a block
+// pending a token that is older than the ones already pending, so every
+// pending block is checked rather than stopping at the first one that is still
+// in use. Freeing a block only ever deletes FREE neighbours, so the indices of
+// the other pending blocks stay valid.
+bool FencedAllocator::FreePassedTokens() {
+  bool freed = false;
+  std::deque<BlockIndex>::iterator kept = pending_blocks_.begin();
+  for (std::deque<BlockIndex>::iterator it = pending_blocks_.begin();
+       it != pending_blocks_.end(); ++it) {
+    BlockIndex index = *it;
+    if (!helper_->HasTokenPassed(blocks_[index].token)) {
+      *kept++ = index;
+      continue;
+    }
+    allocated_blocks_.erase(blocks_[index].offset);
+    MarkBlockFree(index);
+    freed = true;
+  }
+  pending_blocks_.erase(kept, pending_blocks_.end());
+  return freed;
+}
+
 // Waits for the block's token, then mark the block as free, then collapse it.
-FencedAllocator::BlockIndex FencedAllocator::WaitForTokenAndFreeBlock(
-    BlockIndex index) {
+FencedAllocator::BlockIndex FencedAllocator::WaitForTokenAndFreeOldestBlock() {
+  DCHECK(!pending_blocks_.empty());
+  BlockIndex index = pending_blocks_.front();
+  pending_blocks_.pop_front();
   Block &block = blocks_[index];
   DCHECK_EQ(block.state, FREE_PENDING_TOKEN);
   helper_->WaitForToken(block.token);
-  block.state = FREE;
-  return CollapseFreeBlock(index);
+  allocated_blocks_.erase(block.offset);
+  return MarkBlockFree(index);
 }
 
 // Frees any blocks pending a token for which the token has been read.
@@ -208,46 +373,40 @@ void FencedAllocator::FreeUnused() {
   // Free any potential blocks that has its lifetime handled outside.
   poll_callback_.Run();
 
-  for (unsigned int i = 0; i < blocks_.size();) {
-    Block& block = blocks_[i];
-    if (block.state == FREE_PENDING_TOKEN &&
-        helper_->HasTokenPassed(block.token)) {
-      block.state = FREE;
-      i = CollapseFreeBlock(i);
-    } else {
-      ++i;
-    }
-  }
+  FreePassedTokens();
 }
 
 // If the block is exactly the requested size, simply mark it IN_USE, otherwise
 // split it and mark the first one (of the requested size) IN_USE.
 FencedAllocator::Offset FencedAllocator::AllocInBlock(BlockIndex index,
                                                       unsigned int size) {
-  Block &block = blocks_[index];
-  DCHECK_GE(block.size, size);
-  DCHECK_EQ(block.state, FREE);
-  Offset offset = block.offset;
+  DCHECK_GE(blocks_[index].size, size);
+  RemoveFromFreeList(index);
+  Offset offset = blocks_[index].offset;
+  unsigned int remaining_size = blocks_[index].size - size;
   bytes_in_use_ += size;
-  if (block.size == size) {
-    block.state = IN_USE;
+  blocks_[index].state = IN_USE;
+  blocks_[index].size = size;
+  allocated_blocks_[offset] = index;
+  if (!remaining_size)
     return offset;
-  }
-  Block newblock = { FREE, offset + size, block.size - size, kUnusedToken};
-  block.state = IN_USE;
-  block.size = size;
-  // this is the last thing being done because it may invalidate block;
-  blocks_.insert(blocks_.begin() + index + 1, newblock);
+
+  // NewBlock may reallocate |blocks_|, so no references are held across it.
+  BlockIndex new_index = NewBlock(FREE, offset + size, remaining_size);
+  BlockIndex next_index = blocks_[index].next;
+  blocks_[new_index].prev = index;
+  blocks_[new_index].next = next_index;
+  if (next_index != kNoBlock)
+    blocks_[next_index].prev = new_index;
+  blocks_[index].next = new_index;
+  AddToFreeList(new_index);
   return offset;
 }
 
-// The blocks are in offset order, so we can do a binary search.
 FencedAllocator::BlockIndex FencedAllocator::GetBlockByOffset(Offset offset) {
-  Block templ = { IN_USE, offset, 0, kUnusedToken };
-  Container::iterator it = std::lower_bound(blocks_.begin(), blocks_.end(),
-                                            templ, OffsetCmp());
-  DCHECK(it != blocks_.end() && it->offset == offset);
-  return it-blocks_.begin();
+  OffsetToBlockMap::iterator it = allocated_blocks_.find(offset);
+  DCHECK(it != allocated_blocks_.end());
+  return it->second;
 }
 
 }  // namespace gpu
@@ -9,9 +9,11 @@
 
 #include <stdint.h>
 
+#include <deque>
 #include <vector>
 
 #include "base/bind.h"
+#include "base/containers/hash_tables.h"
 #include "base/logging.h"
 #include "base/macros.h"
 #include "gpu/gpu_export.h"
@@ -98,43 +100,63 @@ class GPU_EXPORT FencedAllocator {
     FREE_PENDING_TOKEN
   };
 
-  // Book-keeping sturcture that describes a block of memory.
+  typedef unsigned int BlockIndex;
+
+  static const BlockIndex kNoBlock = 0xffffffffU;
+
+  // Book-keeping sturcture that describes a block of memory. Blocks are kept
+  // in a doubly linked list in offset order, and FREE blocks are also linked
+  // in the free list of their size class.
   struct Block {
     State state;
     Offset offset;
     unsigned int size;
     int32_t token;  // token to wait for in the FREE_PENDING_TOKEN case.
-  };
-
-  // Comparison functor for memory block sorting.
-  class OffsetCmp {
-   public:
-    bool operator() (const Block &left, const Block &right) {
-      return left.offset < right.offset;
-    }
+    BlockIndex prev;
+    BlockIndex next;
+    BlockIndex prev_free;
+    BlockIndex next_free;
   };
 
   typedef std::vector<Block> Container;
-  typedef unsigned int BlockIndex;
+  typedef base::hash_map<Offset, BlockIndex> OffsetToBlockMap;
 
   static const int32_t kUnusedToken = 0;
 
-  // Gets the index of a memory block, given its offset.
+  // FREE blocks are segregated by the power of two of their size (in
+  // allocation alignment units), so that finding a block that fits only
+  // needs to look at the first block of a larger class.
+  static const int kNumSizeClasses = 32;
+
+  static int GetSizeClass(unsigned int size);
+
+  // Gets a book-keeping entry for a new block, reusing a deleted one if any.
+  BlockIndex NewBlock(State state, Offset offset, unsigned int size);
+  void DeleteBlock(BlockIndex index);
+
+  void AddToFreeList(BlockIndex index);
+  void RemoveFromFreeList(BlockIndex index);
+
+  // Returns a FREE block of at least |size| bytes, or kNoBlock.
+  BlockIndex FindFreeBlock(unsigned int size);
+
+  // Gets the index of an allocated memory block, given its offset.
   BlockIndex GetBlockByOffset(Offset offset);
 
-  // Collapse a free block with its neighbours if they are free. Returns the
-  // index of the collapsed block.
-  // NOTE: this will invalidate block indices.
-  BlockIndex CollapseFreeBlock(BlockIndex index);
+  // Marks a block FREE and collapses it with its neighbours if they are free.
+  // Returns the index of the collapsed block.
+  BlockIndex MarkBlockFree(BlockIndex index);
+
+  // Frees all the blocks pending tokens that have passed, whatever order the
+  // tokens were inserted in. Returns true if any block was freed.
+  bool FreePassedTokens();
 
-  // Waits for a FREE_PENDING_TOKEN block to be usable, and free it. Returns
-  // the new index of that block (since it may have been collapsed).
-  // NOTE: this will invalidate block indices.
-  BlockIndex WaitForTokenAndFreeBlock(BlockIndex index);
+  // Waits for the oldest FREE_PENDING_TOKEN block to be usable, and frees it.
+  // Returns the index of that block (since it may have been collapsed).
+  BlockIndex WaitForTokenAndFreeOldestBlock();
 
   // Allocates a block of memory inside a given block, splitting it in two
   // (unless that block is of the exact requested size).
-  // NOTE: this will invalidate block indices.
   // Returns the offset of the allocated block (NOTE: this is different from
   // the other functions that return a block index).
   Offset AllocInBlock(BlockIndex index, unsigned int size);
@@ -142,6 +164,19 @@ class GPU_EXPORT FencedAllocator {
   CommandBufferHelper *helper_;
   base::Closure poll_callback_;
   Container blocks_;
+  // Entries of |blocks_| that are not used by any block.
+  std::vector<BlockIndex> deleted_blocks_;
+  // The block at offset 0.
+  BlockIndex first_block_;
+  size_t num_blocks_;
+  // IN_USE and FREE_PENDING_TOKEN blocks, by offset.
+  OffsetToBlockMap allocated_blocks_;
+  // First block of the free list of each size class.
+  BlockIndex free_lists_[kNumSizeClasses];
+  // Bit i is set if free_lists_[i] isn't empty.
+  uint32_t free_size_classes_;
+  // FREE_PENDING_TOKEN blocks, in the order they were freed.
+  std::deque<BlockIndex> pending_blocks_;
   size_t bytes_in_use_;
 
   DISALLOW_IMPLICIT_CONSTRUCTORS(FencedAllocator);
@@ -0,0 +1,160 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Measures the client CPU spent managing transfer memory for texture uploads.
+
+#include <deque>
+
+#include "base/bind.h"
+#include "base/bind_helpers.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/time/time.h"
+#include "gpu/command_buffer/client/client_test_helper.h"
+#include "gpu/command_buffer/client/cmd_buffer_helper.h"
+#include "gpu/command_buffer/client/fenced_allocator.h"
+#include "gpu/command_buffer/client/mapped_memory.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+
+namespace gpu {
+namespace {
+
+const int kTimeLimitMillis = 2000;
+const int kAllocationsPerLap = 1000;
+const int32 kCommandBufferSizeBytes = 64 * 1024;
+// Uploads of a few rows up to a whole tile.
+const unsigned int kMinAllocationSize = 64;
+const unsigned int kMaxAllocationSize = 256 * 1024;
+const size_t kLiveAllocations = 32;
+
+void EmptyPoll() {
+}
+
+class FencedAllocatorPerfTest : public testing::Test {
+ public:
+  virtual void SetUp() OVERRIDE {
+    command_buffer_.reset(new testing::NiceMock<MockClientCommandBuffer>());
+    ASSERT_TRUE(command_buffer_->Initialize());
+    helper_.reset(new CommandBufferHelper(command_buffer_.get()));
+    ASSERT_TRUE(helper_->Initialize(kCommandBufferSizeBytes));
+    seed_ = 1;
+  }
+
+  virtual void TearDown() OVERRIDE {
+    helper_.reset();
+    command_buffer_.reset();
+  }
+
+  // A cheap deterministic sequence of upload sizes.
+  unsigned int NextAllocationSize() {
+    seed_ = seed_ * 1103515245u + 12345u;
+    return kMinAllocationSize +
+           (seed_ >> 8) % (kMaxAllocationSize - kMinAllocationSize);
+  }
+
+  // Runs |lap| until the time limit is reached, and returns the number of
+  // allocations per second.
+  double RunLaps(const base::Closure& lap) {
+    base::TimeTicks start = base::TimeTicks::Now();
+    base::TimeDelta elapsed;
+    int laps = 0;
+    do {
+      lap.Run();
+      ++laps;
+      elapsed = base::TimeTicks::Now() - start;
+    } while (elapsed < base::TimeDelta::FromMilliseconds(kTimeLimitMillis));
+    return laps * kAllocationsPerLap / elapsed.InSecondsF();
+  }
+
+  // Keeps |kLiveAllocations| uploads in flight, each freed pending a token
+  // once it is the oldest.
+  void AllocatorLap(FencedAllocator* allocator,
+                    std::deque<FencedAllocator::Offset>* live) {
+    for (int i = 0; i < kAllocationsPerLap; ++i) {
+      if (live->size() == kLiveAllocations) {
+        allocator->FreePendingToken(live->front(), helper_->InsertToken());
+        live->pop_front();
+      }
+      FencedAllocator::Offset offset =
+          allocator->Alloc(NextAllocationSize());
+      ASSERT_NE(FencedAllocator::kInvalidOffset, offset);
+      live->push_back(offset);
+    }
+  }
+
+  void MappedMemoryLap(MappedMemoryManager* manager, std::deque<void*>* live) {
+    for (int i = 0; i < kAllocationsPerLap; ++i) {
+      if (live->size() == kLiveAllocations) {
+        manager->FreePendingToken(live->front(), helper_->InsertToken());
+        live->pop_front();
+      }
+      int32 shm_id = -1;
+      unsigned int shm_offset = 0;
+      void* memory =
+          manager->Alloc(NextAllocationSize(), &shm_id, &shm_offset);
+      ASSERT_TRUE(memory);
+      live->push_back(memory);
+    }
+  }
+
+ protected:
+  scoped_ptr<MockClientCommandBuffer> command_buffer_;
+  scoped_ptr<CommandBufferHelper> helper_;
+  uint32 seed_;
+};
+
+TEST_F(FencedAllocatorPerfTest, FencedAllocator) {
+  // Enough room for all the live allocations, with some fragmentation.
+  FencedAllocator allocator(
+      2 * kLiveAllocations * kMaxAllocationSize,
+      helper_.get(),
+      base::Bind(&EmptyPoll));
+  std::deque<FencedAllocator::Offset> live;
+
+  double allocations_per_second =
+      RunLaps(base::Bind(&FencedAllocatorPerfTest::AllocatorLap,
+                         base::Unretained(this),
+                         &allocator,
+                         &live));
+  perf_test::PrintResult("fenced_allocator",
+                         "",
+                         "alloc_free_pending_token",
+                         allocations_per_second,
+                         "allocations/s",
+                         true);
+
+  while (!live.empty()) {
+    allocator.Free(live.front());
+    live.pop_front();
+  }
+}
+
+TEST_F(FencedAllocatorPerfTest, MappedMemoryManager) {
+  MappedMemoryManager manager(
+      helper_.get(), base::Bind(&EmptyPoll), MappedMemoryManager::kNoLimit);
+  // Few enough chunks to fit the transfer buffers the mock command buffer
+  // provides.
+  manager.set_chunk_size_multiple(4 * 1024 * 1024);
+  std::deque<void*> live;
+
+  double allocations_per_second =
+      RunLaps(base::Bind(&FencedAllocatorPerfTest::MappedMemoryLap,
+                         base::Unretained(this),
+                         &manager,
+                         &live));
+  perf_test::PrintResult("mapped_memory_manager",
+                         "",
+                         "alloc_free_pending_token",
+                         allocations_per_second,
+                         "allocations/s",
+                         true);
+
+  while (!live.empty()) {
+    manager.Free(live.front());
+    live.pop_front();
+  }
+}
+
+}  // namespace
+}  // namespace gpu
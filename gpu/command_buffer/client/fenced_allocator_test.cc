@@ -297,6 +297,97 @@ TEST_F(FencedAllocatorTest, FreeUnused) {
   EXPECT_FALSE(allocator_->InUse());
 }
 
+// Checks that FreeUnused frees a block whose token has passed even if a block
+// freed before it is still pending a newer token.
+TEST_F(FencedAllocatorTest, FreeUnusedWithOutOfOrderTokens) {
+  const unsigned int kSize = 16;
+  const unsigned int kAllocCount = kBufferSize / kSize;
+
+  FencedAllocator::Offset offsets[kAllocCount];
+  for (unsigned int i = 0; i < kAllocCount; ++i) {
+    offsets[i] = allocator_->Alloc(kSize);
+    EXPECT_NE(FencedAllocator::kInvalidOffset, offsets[i]);
+  }
+
+  int32 old_token = helper_.get()->InsertToken();
+  helper_->Finish();
+  // This token is not flushed, so it can't pass.
+  int32 new_token = helper_.get()->InsertToken();
+  EXPECT_TRUE(helper_->HasTokenPassed(old_token));
+  EXPECT_FALSE(helper_->HasTokenPassed(new_token));
+
+  allocator_->FreePendingToken(offsets[1], new_token);
+  allocator_->FreePendingToken(offsets[3], old_token);
+  EXPECT_TRUE(allocator_->CheckConsistency());
+
+  allocator_->FreeUnused();
+  EXPECT_EQ(kSize, allocator_->GetLargestFreeSize());
+  EXPECT_EQ(kSize, allocator_->GetLargestFreeOrPendingSize());
+  EXPECT_TRUE(allocator_->CheckConsistency());
+
+  helper_->Finish();
+  allocator_->FreeUnused();
+  EXPECT_EQ(kSize, allocator_->GetLargestFreeSize());
+  EXPECT_TRUE(allocator_->CheckConsistency());
+
+  for (unsigned int i = 0; i < kAllocCount; ++i) {
+    if (i != 1 && i != 3)
+      allocator_->Free(offsets[i]);
+  }
+  EXPECT_FALSE(allocator_->InUse());
+}
+
+// Checks that blocks pending tokens are reused oldest first.
+TEST_F(FencedAllocatorTest, TestReusesOldestPendingBlock) {
+  const unsigned int kSize = 16;
+  const unsigned int kAllocCount = kBufferSize / kSize;
+
+  FencedAllocator::Offset offsets[kAllocCount];
+  for (unsigned int i = 0; i < kAllocCount; ++i) {
+    offsets[i] = allocator_->Alloc(kSize);
+    EXPECT_NE(FencedAllocator::kInvalidOffset, offsets[i]);
+  }
+
+  // Free two blocks that can't be collapsed, the later one first.
+  allocator_->FreePendingToken(offsets[3], helper_.get()->InsertToken());
+  allocator_->FreePendingToken(offsets[1], helper_.get()->InsertToken());
+  EXPECT_TRUE(allocator_->CheckConsistency());
+
+  FencedAllocator::Offset offset = allocator_->Alloc(kSize);
+  EXPECT_EQ(offsets[3], offset);
+  offsets[3] = offset;
+  offset = allocator_->Alloc(kSize);
+  EXPECT_EQ(offsets[1], offset);
+  offsets[1] = offset;
+  EXPECT_TRUE(allocator_->CheckConsistency());
+
+  for (unsigned int i = 0; i < kAllocCount; ++i)
+    allocator_->Free(offsets[i]);
+  EXPECT_FALSE(allocator_->InUse());
+}
+
+// Checks that a free block of the requested size is preferred over splitting
+// a larger one.
+TEST_F(FencedAllocatorTest, TestReusesBlockOfSameSize) {
+  const unsigned int kSize = 64;
+
+  FencedAllocator::Offset offset1 = allocator_->Alloc(kSize);
+  FencedAllocator::Offset offset2 = allocator_->Alloc(kSize);
+  ASSERT_NE(FencedAllocator::kInvalidOffset, offset1);
+  ASSERT_NE(FencedAllocator::kInvalidOffset, offset2);
+  allocator_->Free(offset1);
+  EXPECT_TRUE(allocator_->CheckConsistency());
+
+  // Both the hole and the rest of the buffer fit, but the hole is used.
+  EXPECT_EQ(offset1, allocator_->Alloc(kSize));
+  EXPECT_EQ(kBufferSize - 2 * kSize, allocator_->GetLargestFreeSize());
+  EXPECT_TRUE(allocator_->CheckConsistency());
+
+  allocator_->Free(offset1);
+  allocator_->Free(offset2);
+  EXPECT_FALSE(allocator_->InUse());
+}
+
 // Tests GetLargestFreeSize
 TEST_F(FencedAllocatorTest, TestGetLargestFreeSize) {
   EXPECT_TRUE(allocator_->CheckConsistency());
@@ -48,12 +48,14 @@ void* MappedMemoryManager::Alloc(
   DCHECK(shm_offset);
   if (size <= allocated_memory_) {
     size_t total_bytes_in_use = 0;
-    // See if any of the chunks can satisfy this request.
+    // See if any of the chunks can satisfy this request. Getting the largest
+    // free size also reclaims the blocks whose tokens have passed.
     for (size_t ii = 0; ii < chunks_.size(); ++ii) {
       MemoryChunk* chunk = chunks_[ii];
-      chunk->FreeUnused();
+      unsigned int largest_free_size =
+          chunk->GetLargestFreeSizeWithoutWaiting();
       total_bytes_in_use += chunk->bytes_in_use();
-      if (chunk->GetLargestFreeSizeWithoutWaiting() >= size) {
+      if (largest_free_size >= size) {
         void* mem = chunk->Alloc(size);
         DCHECK(mem);
         *shm_id = chunk->shm_id();
@@ -95,6 +97,7 @@ void* MappedMemoryManager::Alloc(
   MemoryChunk* mc = new MemoryChunk(id, shm, helper_, poll_callback_);
   allocated_memory_ += mc->GetSize();
   chunks_.push_back(mc);
+  chunks_by_memory_[mc->memory()] = mc;
   void* mem = mc->Alloc(size);
   DCHECK(mem);
   *shm_id = mc->shm_id();
@@ -102,26 +105,31 @@ void* MappedMemoryManager::Alloc(
   return mem;
 }
 
+MemoryChunk* MappedMemoryManager::GetChunk(void* pointer) const {
+  // The chunk that holds |pointer| is the last one starting at or before it.
+  MemoryChunkMap::const_iterator it = chunks_by_memory_.upper_bound(pointer);
+  if (it == chunks_by_memory_.begin())
+    return NULL;
+  --it;
+  return it->second->IsInChunk(pointer) ? it->second : NULL;
+}
+
 void MappedMemoryManager::Free(void* pointer) {
-  for (size_t ii = 0; ii < chunks_.size(); ++ii) {
-    MemoryChunk* chunk = chunks_[ii];
-    if (chunk->IsInChunk(pointer)) {
-      chunk->Free(pointer);
-      return;
-    }
+  MemoryChunk* chunk = GetChunk(pointer);
+  if (!chunk) {
+    NOTREACHED();
+    return;
   }
-  NOTREACHED();
+  chunk->Free(pointer);
 }
 
 void MappedMemoryManager::FreePendingToken(void* pointer, int32 token) {
-  for (size_t ii = 0; ii < chunks_.size(); ++ii) {
-    MemoryChunk* chunk = chunks_[ii];
-    if (chunk->IsInChunk(pointer)) {
-      chunk->FreePendingToken(pointer, token);
-      return;
-    }
+  MemoryChunk* chunk = GetChunk(pointer);
+  if (!chunk) {
+    NOTREACHED();
+    return;
   }
-  NOTREACHED();
+  chunk->FreePendingToken(pointer, token);
 }
 
 void MappedMemoryManager::FreeUnused() {
@@ -133,6 +141,7 @@ void MappedMemoryManager::FreeUnused() {
     if (!chunk->InUse()) {
       cmd_buf->DestroyTransferBuffer(chunk->shm_id());
       allocated_memory_ -= chunk->GetSize();
+      chunks_by_memory_.erase(chunk->memory());
       iter = chunks_.erase(iter);
     } else {
       ++iter;
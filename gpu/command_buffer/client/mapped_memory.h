@@ -7,6 +7,8 @@
 
 #include <stdint.h>
 
+#include <map>
+
 #include "base/bind.h"
 #include "base/macros.h"
 #include "base/memory/scoped_vector.h"
@@ -48,6 +50,11 @@ class GPU_EXPORT MemoryChunk {
     return shm_id_;
   }
 
+  // The start of the memory of this chunk.
+  const void* memory() const {
+    return shm_->memory();
+  }
+
   // Allocates a block of memory. If the buffer is out of directly available
   // memory, this function may wait until memory that was freed "pending a
   // token" can be re-used.
@@ -186,12 +193,18 @@ class GPU_EXPORT MappedMemoryManager {
 
  private:
   typedef ScopedVector<MemoryChunk> MemoryChunkVector;
+  // Chunks by the address of their memory, to find the chunk of a pointer.
+  typedef std::map<const void*, MemoryChunk*> MemoryChunkMap;
+
+  // Returns the chunk |pointer| was allocated from.
+  MemoryChunk* GetChunk(void* pointer) const;
 
   // size a chunk is rounded up to.
   unsigned int chunk_size_multiple_;
   CommandBufferHelper* helper_;
   base::Closure poll_callback_;
   MemoryChunkVector chunks_;
+  MemoryChunkMap chunks_by_memory_;
   size_t allocated_memory_;
   size_t max_free_bytes_;
 
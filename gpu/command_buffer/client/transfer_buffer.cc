@@ -13,6 +13,12 @@
 
 namespace gpu {
 
+TransferBuffer::RetiredBuffer::RetiredBuffer() : id(-1), token(0) {
+}
+
+TransferBuffer::RetiredBuffer::~RetiredBuffer() {
+}
+
 TransferBuffer::TransferBuffer(
     CommandBufferHelper* helper)
     : helper_(helper),
@@ -51,9 +57,17 @@ bool TransferBuffer::Initialize(
 }
 
 void TransferBuffer::Free() {
+  if (!HaveBuffer() && retired_buffers_.empty())
+    return;
+  TRACE_EVENT0("gpu", "TransferBuffer::Free");
+  helper_->Finish();
+  for (ScopedVector<RetiredBuffer>::iterator it = retired_buffers_.begin();
+       it != retired_buffers_.end();
+       ++it) {
+    helper_->command_buffer()->DestroyTransferBuffer((*it)->id);
+  }
+  retired_buffers_.clear();
   if (HaveBuffer()) {
-    TRACE_EVENT0("gpu", "TransferBuffer::Free");
-    helper_->Finish();
     helper_->command_buffer()->DestroyTransferBuffer(buffer_id_);
     buffer_id_ = -1;
     buffer_ = NULL;
@@ -106,6 +120,32 @@ void TransferBuffer::AllocateRingBuffer(unsigned int size) {
   usable_ = false;
 }
 
+void TransferBuffer::RetireBuffer() {
+  DCHECK(HaveBuffer());
+  RetiredBuffer* retired = new RetiredBuffer;
+  retired->ring_buffer = ring_buffer_.Pass();
+  retired->buffer = buffer_;
+  retired->id = buffer_id_;
+  retired->token = helper_->InsertToken();
+  retired_buffers_.push_back(retired);
+
+  buffer_id_ = -1;
+  buffer_ = NULL;
+  result_buffer_ = NULL;
+  result_shm_offset_ = 0;
+}
+
+void TransferBuffer::FreeRetiredBuffers() {
+  // Tokens pass in order, so buffers retired later can't be done with before
+  // the first one.
+  while (!retired_buffers_.empty() &&
+         helper_->HasTokenPassed(retired_buffers_.front()->token)) {
+    helper_->command_buffer()->DestroyTransferBuffer(
+        retired_buffers_.front()->id);
+    retired_buffers_.erase(retired_buffers_.begin());
+  }
+}
+
 static unsigned int ComputePOTSize(unsigned int dimension) {
   return (dimension == 0) ? 0 : 1 << base::bits::Log2Ceiling(dimension);
 }
@@ -117,9 +157,14 @@ void TransferBuffer::ReallocateRingBuffer(unsigned int size) {
   needed_buffer_size = std::max(needed_buffer_size, default_buffer_size_);
   needed_buffer_size = std::min(needed_buffer_size, max_buffer_size_);
 
+  FreeRetiredBuffers();
+
   if (usable_ && (!HaveBuffer() || needed_buffer_size > buffer_->size())) {
+    // Waiting for the service to be done with the old buffer would stall
+    // large uploads, so keep it around until its commands have been processed
+    // and map the new one right away.
     if (HaveBuffer()) {
-      Free();
+      RetireBuffer();
     }
     AllocateRingBuffer(needed_buffer_size);
   }
@@ -7,6 +7,7 @@
 
 #include "base/compiler_specific.h"
 #include "base/memory/scoped_ptr.h"
+#include "base/memory/scoped_vector.h"
 #include "gpu/command_buffer/client/ring_buffer.h"
 #include "gpu/command_buffer/common/buffer.h"
 #include "gpu/command_buffer/common/gles2_cmd_utils.h"
@@ -78,13 +79,33 @@ class GPU_EXPORT TransferBuffer : public TransferBufferInterface {
   // These are for testing.
   unsigned int GetCurrentMaxAllocationWithoutRealloc() const;
   unsigned int GetMaxAllocation() const;
+  size_t GetRetiredBufferCount() const { return retired_buffers_.size(); }
 
  private:
+  // A buffer that was outgrown, kept mapped until the commands issued before
+  // it was replaced have been processed.
+  struct RetiredBuffer {
+    RetiredBuffer();
+    ~RetiredBuffer();
+
+    scoped_ptr<RingBuffer> ring_buffer;
+    scoped_refptr<gpu::Buffer> buffer;
+    int32 id;
+    int32 token;
+  };
+
   // Tries to reallocate the ring buffer if it's not large enough for size.
   void ReallocateRingBuffer(unsigned int size);
 
   void AllocateRingBuffer(unsigned int size);
 
+  // Replaces the current buffer with nothing, without waiting for the service
+  // to be done with it.
+  void RetireBuffer();
+
+  // Destroys the retired buffers the service is done with.
+  void FreeRetiredBuffers();
+
   CommandBufferHelper* helper_;
   scoped_ptr<RingBuffer> ring_buffer_;
 
@@ -123,6 +144,9 @@ class GPU_EXPORT TransferBuffer : public TransferBufferInterface {
 
   // false if we failed to allocate min_buffer_size
   bool usable_;
+
+  // Outgrown buffers, oldest first.
+  ScopedVector<RetiredBuffer> retired_buffers_;
 };
 
 // A class that will manage the lifetime of a transferbuffer allocation.
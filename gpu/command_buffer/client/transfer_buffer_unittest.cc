@@ -323,10 +323,10 @@ TEST_F(TransferBufferExpandContractTest, Expand) {
   EXPECT_EQ(
       kStartTransferBufferSize - kStartingOffset,
       transfer_buffer_->GetCurrentMaxAllocationWithoutRealloc());
+  int32 start_id = transfer_buffer_->GetShmId();
 
-  EXPECT_CALL(*command_buffer(), DestroyTransferBuffer(_))
-      .Times(1)
-      .RetiresOnSaturation();
+  // Growing doesn't wait for the service to be done with the old buffer, so
+  // nothing is destroyed yet.
   EXPECT_CALL(*command_buffer(),
               CreateTransferBuffer(kStartTransferBufferSize * 2, _))
       .WillOnce(Invoke(
@@ -341,9 +341,14 @@ TEST_F(TransferBufferExpandContractTest, Expand) {
   ASSERT_TRUE(ptr != NULL);
   EXPECT_EQ(kSize1, size_allocated);
   EXPECT_EQ(kSize1, transfer_buffer_->GetCurrentMaxAllocationWithoutRealloc());
+  EXPECT_EQ(1u, transfer_buffer_->GetRetiredBufferCount());
   transfer_buffer_->FreePendingToken(ptr, 1);
+  int32 second_id = transfer_buffer_->GetShmId();
+  EXPECT_NE(start_id, second_id);
 
-  EXPECT_CALL(*command_buffer(), DestroyTransferBuffer(_))
+  // The old buffer is destroyed on the next allocation, as its token has
+  // passed.
+  EXPECT_CALL(*command_buffer(), DestroyTransferBuffer(start_id))
       .Times(1)
       .RetiresOnSaturation();
   EXPECT_CALL(*command_buffer(),
@@ -359,15 +364,51 @@ TEST_F(TransferBufferExpandContractTest, Expand) {
   ASSERT_TRUE(ptr != NULL);
   EXPECT_EQ(kSize2, size_allocated);
   EXPECT_EQ(kSize2, transfer_buffer_->GetCurrentMaxAllocationWithoutRealloc());
+  EXPECT_EQ(1u, transfer_buffer_->GetRetiredBufferCount());
   transfer_buffer_->FreePendingToken(ptr, 1);
 
+  EXPECT_CALL(*command_buffer(), DestroyTransferBuffer(second_id))
+      .Times(1)
+      .RetiresOnSaturation();
+
   // Try next one more. Should not go past max.
   size_allocated = 0;
   const size_t kSize3 = kSize2 + 1;
   ptr = transfer_buffer_->AllocUpTo(kSize3, &size_allocated);
   EXPECT_EQ(kSize2, size_allocated);
   EXPECT_EQ(kSize2, transfer_buffer_->GetCurrentMaxAllocationWithoutRealloc());
+  EXPECT_EQ(0u, transfer_buffer_->GetRetiredBufferCount());
   transfer_buffer_->FreePendingToken(ptr, 1);
+
+  // The tokens inserted for the retired buffers get flushed on teardown.
+  EXPECT_CALL(*command_buffer(), Flush(_)).Times(AtMost(1));
+  EXPECT_CALL(*command_buffer(), OnFlush()).Times(AtMost(1));
+}
+
+TEST_F(TransferBufferExpandContractTest, FreeDestroysRetiredBuffers) {
+  EXPECT_CALL(*command_buffer(),
+              CreateTransferBuffer(kStartTransferBufferSize * 2, _))
+      .WillOnce(Invoke(
+          command_buffer(),
+          &MockClientCommandBufferCanFail::RealCreateTransferBuffer))
+      .RetiresOnSaturation();
+
+  const size_t kSize1 = 512 - kStartingOffset;
+  unsigned int size_allocated = 0;
+  void* ptr = transfer_buffer_->AllocUpTo(kSize1, &size_allocated);
+  ASSERT_TRUE(ptr != NULL);
+  transfer_buffer_->FreePendingToken(ptr, 1);
+  EXPECT_EQ(1u, transfer_buffer_->GetRetiredBufferCount());
+
+  // Both the current and the retired buffer are destroyed.
+  EXPECT_CALL(*command_buffer(), Flush(_)).Times(AtMost(1));
+  EXPECT_CALL(*command_buffer(), OnFlush()).Times(AtMost(1));
+  EXPECT_CALL(*command_buffer(), DestroyTransferBuffer(_))
+      .Times(2)
+      .RetiresOnSaturation();
+  transfer_buffer_->Free();
+  EXPECT_FALSE(transfer_buffer_->HaveBuffer());
+  EXPECT_EQ(0u, transfer_buffer_->GetRetiredBufferCount());
 }
 
 TEST_F(TransferBufferExpandContractTest, Contract) {
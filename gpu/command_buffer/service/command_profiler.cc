@@ -0,0 +1,111 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gpu/command_buffer/service/command_profiler.h"
+
+#include <algorithm>
+#include <string>
+
+#include "base/debug/trace_event.h"
+#include "base/strings/string_number_conversions.h"
+#include "gpu/command_buffer/service/cmd_parser.h"
+
+namespace gpu {
+
+namespace {
+
+struct ProfileEntry {
+  const char* name;
+  CommandProfiler::Counters counters;
+};
+
+bool TookLonger(const ProfileEntry& a, const ProfileEntry& b) {
+  return a.counters.time > b.counters.time;
+}
+
+class ProfileSnapshot : public base::debug::ConvertableToTraceFormat {
+ public:
+  explicit ProfileSnapshot(std::vector<ProfileEntry>* entries) {
+    entries_.swap(*entries);
+  }
+
+  // base::debug::ConvertableToTraceFormat implementation.
+  virtual void AppendAsTraceFormat(std::string* out) const OVERRIDE {
+    *out += "{\"commands\":[";
+    for (size_t i = 0; i < entries_.size(); ++i) {
+      const ProfileEntry& entry = entries_[i];
+      if (i)
+        *out += ",";
+      *out += "{\"name\":\"";
+      *out += entry.name;
+      *out += "\",\"count\":";
+      *out += base::Uint64ToString(entry.counters.count);
+      *out += ",\"bytes\":";
+      *out += base::Uint64ToString(entry.counters.bytes);
+      *out += ",\"time_us\":";
+      *out += base::Int64ToString(entry.counters.time.InMicroseconds());
+      *out += "}";
+    }
+    *out += "]}";
+  }
+
+ private:
+  virtual ~ProfileSnapshot() {}
+
+  std::vector<ProfileEntry> entries_;
+
+  DISALLOW_COPY_AND_ASSIGN(ProfileSnapshot);
+};
+
+}  // namespace
+
+#ifndef _MSC_VER
+const int64 CommandProfiler::kDumpIntervalMs;
+#endif
+
+CommandProfiler::CommandProfiler(const AsyncAPIInterface* decoder,
+                                 unsigned int num_commands)
+    : decoder_(decoder), counters_(num_commands) {
+  DCHECK(decoder_);
+}
+
+CommandProfiler::~CommandProfiler() {
+}
+
+void CommandProfiler::MaybeDump(base::TimeTicks now) {
+  if (now - last_dump_ <
+      base::TimeDelta::FromMilliseconds(kDumpIntervalMs)) {
+    return;
+  }
+  last_dump_ = now;
+  TRACE_EVENT_OBJECT_SNAPSHOT_WITH_ID(
+      TRACE_DISABLED_BY_DEFAULT("gpu.command_profile"),
+      "gpu::CommandProfile",
+      this,
+      GetSnapshot());
+}
+
+scoped_refptr<base::debug::ConvertableToTraceFormat>
+CommandProfiler::GetSnapshot() const {
+  std::vector<ProfileEntry> entries;
+  for (size_t command = 0; command < counters_.size(); ++command) {
+    if (!counters_[command].count)
+      continue;
+    ProfileEntry entry;
+    entry.name = decoder_->GetCommandName(command);
+    entry.counters = counters_[command];
+    entries.push_back(entry);
+  }
+  std::stable_sort(entries.begin(), entries.end(), TookLonger);
+  return scoped_refptr<base::debug::ConvertableToTraceFormat>(
+      new ProfileSnapshot(&entries));
+}
+
+const CommandProfiler::Counters& CommandProfiler::GetCounters(
+    unsigned int command) const {
+  CR_DEFINE_STATIC_LOCAL(Counters, empty_counters, ());
+  return command < counters_.size() ? counters_[command] : empty_counters;
+}
+
+}  // namespace gpu
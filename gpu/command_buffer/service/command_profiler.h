@@ -0,0 +1,89 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef GPU_COMMAND_BUFFER_SERVICE_COMMAND_PROFILER_H_
+#define GPU_COMMAND_BUFFER_SERVICE_COMMAND_PROFILER_H_
+
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/memory/ref_counted.h"
+#include "base/time/time.h"
+#include "gpu/gpu_export.h"
+
+namespace base {
+namespace debug {
+class ConvertableToTraceFormat;
+}
+}
+
+namespace gpu {
+
+class AsyncAPIInterface;
+
+// Counts the commands a decoder runs, with their size and the time spent in
+// each, per command id. Recording takes a clock read and a few additions per
+// command, so it can stay on for whole traces. The totals since the profiler
+// was created are added to the trace as snapshots of "gpu::CommandProfile".
+class GPU_EXPORT CommandProfiler {
+ public:
+  struct Counters {
+    Counters() : count(0), bytes(0) {}
+
+    uint64 count;
+    // Including the command header and immediate data.
+    uint64 bytes;
+    // Wall time on the decoder thread.
+    base::TimeDelta time;
+  };
+
+  // Command names are looked up with |decoder|, which must outlive this.
+  // Only the ids below |num_commands| are counted.
+  CommandProfiler(const AsyncAPIInterface* decoder, unsigned int num_commands);
+  ~CommandProfiler();
+
+  // Starts timing a batch of commands at |now|.
+  void BeginBatch(base::TimeTicks now) {
+    last_command_end_ = now;
+  }
+
+  // Records a command of |bytes| that completed at |now|. It is charged with
+  // the time since the previous command of the batch completed. The id comes
+  // from the client, so ids the decoder doesn't know are not counted.
+  void RecordCommand(unsigned int command, size_t bytes, base::TimeTicks now) {
+    if (command >= counters_.size()) {
+      last_command_end_ = now;
+      return;
+    }
+    Counters& counters = counters_[command];
+    ++counters.count;
+    counters.bytes += bytes;
+    counters.time += now - last_command_end_;
+    last_command_end_ = now;
+  }
+
+  // Adds a snapshot to the trace if the last one is older than
+  // |kDumpIntervalMs|.
+  void MaybeDump(base::TimeTicks now);
+
+  // Returns the totals as a list of commands, the most expensive first.
+  scoped_refptr<base::debug::ConvertableToTraceFormat> GetSnapshot() const;
+
+  const Counters& GetCounters(unsigned int command) const;
+
+ private:
+  static const int64 kDumpIntervalMs = 1000;
+
+  const AsyncAPIInterface* decoder_;
+  // Indexed by command id. The size is fixed at construction.
+  std::vector<Counters> counters_;
+  base::TimeTicks last_command_end_;
+  base::TimeTicks last_dump_;
+
+  DISALLOW_COPY_AND_ASSIGN(CommandProfiler);
+};
+
+}  // namespace gpu
+
+#endif  // GPU_COMMAND_BUFFER_SERVICE_COMMAND_PROFILER_H_
@@ -0,0 +1,122 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gpu/command_buffer/service/command_profiler.h"
+
+#include <string>
+
+#include "base/debug/trace_event.h"
+#include "gpu/command_buffer/service/cmd_parser.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace gpu {
+
+namespace {
+
+const unsigned int kDrawCommand = 10;
+const unsigned int kFlushCommand = 300;
+const unsigned int kNumCommands = 400;
+
+class FakeDecoder : public AsyncAPIInterface {
+ public:
+  FakeDecoder() {}
+  virtual ~FakeDecoder() {}
+
+  virtual error::Error DoCommand(unsigned int command,
+                                 unsigned int arg_count,
+                                 const void* cmd_data) OVERRIDE {
+    return error::kNoError;
+  }
+
+  virtual const char* GetCommandName(unsigned int command) const OVERRIDE {
+    if (command == kDrawCommand)
+      return "Draw";
+    if (command == kFlushCommand)
+      return "Flush";
+    return "Unknown";
+  }
+};
+
+}  // namespace
+
+class CommandProfilerTest : public testing::Test {
+ public:
+  CommandProfilerTest() : profiler_(&decoder_, kNumCommands) {}
+
+ protected:
+  base::TimeTicks At(int64 ms) {
+    return start_ + base::TimeDelta::FromMilliseconds(ms);
+  }
+
+  FakeDecoder decoder_;
+  CommandProfiler profiler_;
+  base::TimeTicks start_;
+};
+
+TEST_F(CommandProfilerTest, RecordsCommands) {
+  EXPECT_EQ(0u, profiler_.GetCounters(kDrawCommand).count);
+
+  profiler_.BeginBatch(At(0));
+  profiler_.RecordCommand(kDrawCommand, 16, At(2));
+  profiler_.RecordCommand(kFlushCommand, 4, At(3));
+  profiler_.RecordCommand(kDrawCommand, 20, At(7));
+  // Time between batches isn't charged to the next command.
+  profiler_.BeginBatch(At(100));
+  profiler_.RecordCommand(kFlushCommand, 4, At(101));
+
+  const CommandProfiler::Counters& draw = profiler_.GetCounters(kDrawCommand);
+  EXPECT_EQ(2u, draw.count);
+  EXPECT_EQ(36u, draw.bytes);
+  EXPECT_EQ(6, draw.time.InMilliseconds());
+
+  const CommandProfiler::Counters& flush =
+      profiler_.GetCounters(kFlushCommand);
+  EXPECT_EQ(2u, flush.count);
+  EXPECT_EQ(8u, flush.bytes);
+  EXPECT_EQ(2, flush.time.InMilliseconds());
+
+  EXPECT_EQ(0u, profiler_.GetCounters(kDrawCommand + 1).count);
+  EXPECT_EQ(0u, profiler_.GetCounters(kFlushCommand + 1).count);
+}
+
+TEST_F(CommandProfilerTest, IgnoresUnknownCommands) {
+  const unsigned int kUnknownCommand = (1 << 21) - 1;
+
+  profiler_.BeginBatch(At(0));
+  profiler_.RecordCommand(kUnknownCommand, 4, At(5));
+  profiler_.RecordCommand(kNumCommands, 4, At(6));
+  // The time spent in the unknown commands isn't charged to the next one.
+  profiler_.RecordCommand(kDrawCommand, 16, At(8));
+
+  EXPECT_EQ(0u, profiler_.GetCounters(kUnknownCommand).count);
+  EXPECT_EQ(0u, profiler_.GetCounters(kNumCommands).count);
+  const CommandProfiler::Counters& draw = profiler_.GetCounters(kDrawCommand);
+  EXPECT_EQ(1u, draw.count);
+  EXPECT_EQ(2, draw.time.InMilliseconds());
+
+  std::string json;
+  profiler_.GetSnapshot()->AppendAsTraceFormat(&json);
+  EXPECT_EQ(
+      "{\"commands\":["
+      "{\"name\":\"Draw\",\"count\":1,\"bytes\":16,\"time_us\":2000}"
+      "]}",
+      json);
+}
+
+TEST_F(CommandProfilerTest, SnapshotListsMostExpensiveFirst) {
+  profiler_.BeginBatch(At(0));
+  profiler_.RecordCommand(kFlushCommand, 4, At(1));
+  profiler_.RecordCommand(kDrawCommand, 16, At(4));
+
+  std::string json;
+  profiler_.GetSnapshot()->AppendAsTraceFormat(&json);
+  EXPECT_EQ(
+      "{\"commands\":["
+      "{\"name\":\"Draw\",\"count\":1,\"bytes\":16,\"time_us\":3000},"
+      "{\"name\":\"Flush\",\"count\":1,\"bytes\":4,\"time_us\":1000}"
+      "]}",
+      json);
+}
+
+}  // namespace gpu
@@ -0,0 +1,303 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gpu/command_buffer/service/disk_program_cache.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "base/base64.h"
+#include "base/bind.h"
+#include "base/files/file_enumerator.h"
+#include "base/files/file_util.h"
+#include "base/location.h"
+#include "base/logging.h"
+#include "base/metrics/histogram.h"
+#include "base/sequenced_task_runner.h"
+#include "base/sha1.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_util.h"
+#include "base/time/time.h"
+
+namespace gpu {
+namespace gles2 {
+
+namespace {
+
+struct DiskEntry {
+  base::FilePath path;
+  base::Time last_used;
+  size_t size;
+};
+
+bool IsMoreRecentlyUsed(const DiskEntry& a, const DiskEntry& b) {
+  return a.last_used > b.last_used;
+}
+
+// Entries and driver directories are both named after a SHA-1 hash, so that
+// nothing else in the directory is ever deleted.
+bool IsHashName(const base::FilePath& path) {
+  std::string name = path.BaseName().MaybeAsASCII();
+  if (name.size() != 2 * base::kSHA1Length)
+    return false;
+  for (size_t i = 0; i < name.size(); ++i) {
+    if (!IsHexDigit(name[i]))
+      return false;
+  }
+  return true;
+}
+
+std::string HashName(const std::string& hash) {
+  return base::HexEncode(hash.data(), hash.size());
+}
+
+// Writes to a temporary file first, so that a crash never leaves a partial
+// entry behind.
+void WriteEntry(const base::FilePath& path, const std::string& program) {
+  base::FilePath temp_path;
+  if (!base::CreateTemporaryFileInDir(path.DirName(), &temp_path))
+    return;
+  int size = static_cast<int>(program.size());
+  if (base::WriteFile(temp_path, program.data(), size) != size ||
+      !base::ReplaceFile(temp_path, path, NULL)) {
+    LOG(ERROR) << "Failed to write a program cache entry.";
+    base::DeleteFile(temp_path, false);
+    base::DeleteFile(path, false);
+  }
+}
+
+void TouchEntry(const base::FilePath& path) {
+  base::Time now = base::Time::Now();
+  base::TouchFile(path, now, now);
+}
+
+void DeleteEntry(const base::FilePath& path) {
+  base::DeleteFile(path, false);
+}
+
+}  // namespace
+
+DiskProgramCache::DiskProgramCache(
+    const base::FilePath& directory,
+    const std::string& driver_version,
+    const scoped_refptr<base::SequencedTaskRunner>& file_task_runner)
+    : max_disk_size_bytes_(max_size_bytes()),
+      file_task_runner_(file_task_runner),
+      disk_size_bytes_(0),
+      entries_(EntryMRUCache::NO_AUTO_EVICT),
+      weak_factory_(this) {
+  LoadEntries(directory, driver_version);
+}
+
+DiskProgramCache::DiskProgramCache(
+    const base::FilePath& directory,
+    const std::string& driver_version,
+    size_t max_cache_size_bytes,
+    const scoped_refptr<base::SequencedTaskRunner>& file_task_runner)
+    : MemoryProgramCache(max_cache_size_bytes),
+      max_disk_size_bytes_(max_cache_size_bytes),
+      file_task_runner_(file_task_runner),
+      disk_size_bytes_(0),
+      entries_(EntryMRUCache::NO_AUTO_EVICT),
+      weak_factory_(this) {
+  LoadEntries(directory, driver_version);
+}
+
+DiskProgramCache::~DiskProgramCache() {}
+
+ProgramCache::ProgramLoadResult DiskProgramCache::LoadLinkedProgram(
+    GLuint program,
+    Shader* shader_a,
+    const ShaderTranslatorInterface* translator_a,
+    Shader* shader_b,
+    const ShaderTranslatorInterface* translator_b,
+    const LocationMap* bind_attrib_location_map,
+    const ShaderCacheCallback& shader_callback) {
+  return MemoryProgramCache::LoadLinkedProgram(
+      program,
+      shader_a,
+      translator_a,
+      shader_b,
+      translator_b,
+      bind_attrib_location_map,
+      WrapCallback(shader_callback, false));
+}
+
+void DiskProgramCache::SaveLinkedProgram(
+    GLuint program,
+    const Shader* shader_a,
+    const ShaderTranslatorInterface* translator_a,
+    const Shader* shader_b,
+    const ShaderTranslatorInterface* translator_b,
+    const LocationMap* bind_attrib_location_map,
+    const ShaderCacheCallback& shader_callback) {
+  MemoryProgramCache::SaveLinkedProgram(program,
+                                        shader_a,
+                                        translator_a,
+                                        shader_b,
+                                        translator_b,
+                                        bind_attrib_location_map,
+                                        WrapCallback(shader_callback, true));
+}
+
+void DiskProgramCache::LoadEntries(const base::FilePath& directory,
+                                   const std::string& driver_version) {
+  driver_directory_ =
+      directory.AppendASCII(HashName(base::SHA1HashString(driver_version)));
+  LoadedEntryVector* entries = new LoadedEntryVector;
+  file_task_runner_->PostTaskAndReply(
+      FROM_HERE,
+      base::Bind(&DiskProgramCache::ReadEntries,
+                 directory,
+                 driver_directory_,
+                 max_disk_size_bytes_,
+                 entries),
+      base::Bind(&DiskProgramCache::OnEntriesRead,
+                 weak_factory_.GetWeakPtr(),
+                 base::Owned(entries)));
+}
+
+// static
+void DiskProgramCache::ReadEntries(const base::FilePath& directory,
+                                   const base::FilePath& driver_directory,
+                                   size_t max_size_bytes,
+                                   LoadedEntryVector* entries) {
+  // Binaries of other drivers will never load again.
+  base::FileEnumerator drivers(
+      directory, false, base::FileEnumerator::DIRECTORIES);
+  for (base::FilePath path = drivers.Next(); !path.empty();
+       path = drivers.Next()) {
+    if (path != driver_directory && IsHashName(path))
+      base::DeleteFile(path, true);
+  }
+
+  if (!base::CreateDirectory(driver_directory)) {
+    LOG(ERROR) << "Failed to create the program cache directory.";
+    return;
+  }
+
+  std::vector<DiskEntry> disk_entries;
+  base::FileEnumerator files(
+      driver_directory, false, base::FileEnumerator::FILES);
+  for (base::FilePath path = files.Next(); !path.empty();
+       path = files.Next()) {
+    // Leftovers of interrupted writes.
+    if (!IsHashName(path)) {
+      base::DeleteFile(path, false);
+      continue;
+    }
+    DiskEntry entry;
+    entry.path = path;
+    entry.last_used = files.GetInfo().GetLastModifiedTime();
+    entry.size = files.GetInfo().GetSize();
+    disk_entries.push_back(entry);
+  }
+  std::sort(disk_entries.begin(), disk_entries.end(), IsMoreRecentlyUsed);
+
+  // Keep the most recently used entries that fit.
+  size_t kept_size = 0;
+  size_t num_kept = 0;
+  for (; num_kept < disk_entries.size(); ++num_kept) {
+    if (kept_size + disk_entries[num_kept].size > max_size_bytes)
+      break;
+    kept_size += disk_entries[num_kept].size;
+  }
+  for (size_t i = num_kept; i < disk_entries.size(); ++i)
+    base::DeleteFile(disk_entries[i].path, false);
+
+  for (size_t i = num_kept; i > 0; --i) {
+    const DiskEntry& disk_entry = disk_entries[i - 1];
+    LoadedEntry entry;
+    if (!base::ReadFileToString(disk_entry.path, &entry.program)) {
+      base::DeleteFile(disk_entry.path, false);
+      continue;
+    }
+    entry.name = disk_entry.path.BaseName().MaybeAsASCII();
+    entries->push_back(entry);
+  }
+}
+
+void DiskProgramCache::OnEntriesRead(const LoadedEntryVector* entries) {
+  // Programs stored while the entries were read are the most recently used.
+  std::vector<std::string> stored_names;
+  for (EntryMRUCache::reverse_iterator it = entries_.rbegin();
+       it != entries_.rend();
+       ++it) {
+    stored_names.push_back(it->first);
+  }
+
+  // Load the least recently used first, so that the in-memory cache ends up
+  // in the same order.
+  for (LoadedEntryVector::const_iterator it = entries->begin();
+       it != entries->end();
+       ++it) {
+    if (entries_.Peek(it->name) != entries_.end())
+      continue;
+    LoadProgram(it->program);
+    entries_.Put(it->name, it->program.size());
+    disk_size_bytes_ += it->program.size();
+  }
+  UMA_HISTOGRAM_COUNTS("GPU.ProgramCache.DiskSizeOnLoadKb",
+                       disk_size_bytes_ / 1024);
+
+  for (size_t i = 0; i < stored_names.size(); ++i)
+    entries_.Get(stored_names[i]);
+  EvictEntries();
+}
+
+ShaderCacheCallback DiskProgramCache::WrapCallback(
+    const ShaderCacheCallback& shader_callback,
+    bool overwrite) {
+  return base::Bind(&DiskProgramCache::StoreEntry,
+                    base::Unretained(this),
+                    shader_callback,
+                    overwrite);
+}
+
+void DiskProgramCache::StoreEntry(const ShaderCacheCallback& shader_callback,
+                                  bool overwrite,
+                                  const std::string& key,
+                                  const std::string& program) {
+  if (!shader_callback.is_null())
+    shader_callback.Run(key, program);
+
+  std::string hash;
+  if (!base::Base64Decode(key, &hash))
+    return;
+  const std::string name = HashName(hash);
+  const base::FilePath path = driver_directory_.AppendASCII(name);
+
+  EntryMRUCache::iterator existing = entries_.Get(name);
+  if (existing != entries_.end()) {
+    if (!overwrite) {
+      // Only record the use, which is what eviction goes by on the next
+      // launch.
+      file_task_runner_->PostTask(FROM_HERE, base::Bind(&TouchEntry, path));
+      return;
+    }
+    disk_size_bytes_ -= existing->second;
+    entries_.Erase(existing);
+  }
+
+  file_task_runner_->PostTask(FROM_HERE,
+                              base::Bind(&WriteEntry, path, program));
+  entries_.Put(name, program.size());
+  disk_size_bytes_ += program.size();
+  EvictEntries();
+}
+
+void DiskProgramCache::EvictEntries() {
+  while (disk_size_bytes_ > max_disk_size_bytes_) {
+    DCHECK(!entries_.empty());
+    EntryMRUCache::reverse_iterator oldest = entries_.rbegin();
+    file_task_runner_->PostTask(
+        FROM_HERE,
+        base::Bind(&DeleteEntry, driver_directory_.AppendASCII(oldest->first)));
+    disk_size_bytes_ -= oldest->second;
+    entries_.Erase(oldest);
+  }
+}
+
+}  // namespace gles2
+}  // namespace gpu
@@ -0,0 +1,118 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef GPU_COMMAND_BUFFER_SERVICE_DISK_PROGRAM_CACHE_H_
+#define GPU_COMMAND_BUFFER_SERVICE_DISK_PROGRAM_CACHE_H_
+
+#include <string>
+
+#include <vector>
+
+#include "base/containers/mru_cache.h"
+#include "base/files/file_path.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/weak_ptr.h"
+#include "gpu/command_buffer/service/memory_program_cache.h"
+
+namespace base {
+class SequencedTaskRunner;
+}
+
+namespace gpu {
+namespace gles2 {
+
+// Program cache that keeps the in-memory cache of MemoryProgramCache, and
+// also persists every program it caches to files in a directory, so that the
+// binaries survive restarts without the embedder having to store them.
+// Programs are kept in a subdirectory per driver, since binaries from another
+// driver version can't be loaded. The files are bounded by the same size as
+// the in-memory cache, and the least recently used ones are deleted first.
+// All file access happens on a task runner that allows blocking I/O.
+class GPU_EXPORT DiskProgramCache : public MemoryProgramCache {
+ public:
+  // |driver_version| should identify the GL implementation, e.g. the vendor,
+  // renderer and version strings. Programs cached under |directory| for the
+  // same driver are read on |file_task_runner| and added to the cache once
+  // they have all been read.
+  DiskProgramCache(
+      const base::FilePath& directory,
+      const std::string& driver_version,
+      const scoped_refptr<base::SequencedTaskRunner>& file_task_runner);
+  DiskProgramCache(
+      const base::FilePath& directory,
+      const std::string& driver_version,
+      size_t max_cache_size_bytes,
+      const scoped_refptr<base::SequencedTaskRunner>& file_task_runner);
+  virtual ~DiskProgramCache();
+
+  virtual ProgramLoadResult LoadLinkedProgram(
+      GLuint program,
+      Shader* shader_a,
+      const ShaderTranslatorInterface* translator_a,
+      Shader* shader_b,
+      const ShaderTranslatorInterface* translator_b,
+      const LocationMap* bind_attrib_location_map,
+      const ShaderCacheCallback& shader_callback) OVERRIDE;
+  virtual void SaveLinkedProgram(
+      GLuint program,
+      const Shader* shader_a,
+      const ShaderTranslatorInterface* translator_a,
+      const Shader* shader_b,
+      const ShaderTranslatorInterface* translator_b,
+      const LocationMap* bind_attrib_location_map,
+      const ShaderCacheCallback& shader_callback) OVERRIDE;
+
+  // Only for testing.
+  const base::FilePath& driver_directory() const { return driver_directory_; }
+  size_t disk_size_bytes() const { return disk_size_bytes_; }
+
+ private:
+  // Maps the file name of each entry to its size.
+  typedef base::MRUCache<std::string, size_t> EntryMRUCache;
+
+  struct LoadedEntry {
+    std::string name;
+    std::string program;
+  };
+  typedef std::vector<LoadedEntry> LoadedEntryVector;
+
+  // Reads the entries of the driver from the file task runner.
+  void LoadEntries(const base::FilePath& directory,
+                   const std::string& driver_version);
+  // Runs on the file task runner. Deletes the entries of other drivers, and
+  // reads this driver's entries, from the most recently used one until the
+  // size limit is reached, into |entries| in least recently used order.
+  static void ReadEntries(const base::FilePath& directory,
+                          const base::FilePath& driver_directory,
+                          size_t max_size_bytes,
+                          LoadedEntryVector* entries);
+  void OnEntriesRead(const LoadedEntryVector* entries);
+
+  // Wraps the embedder's |shader_callback|, so that every program the memory
+  // cache hands out is also stored on disk. Saved programs replace the
+  // stored entry, and loaded ones only mark it as used.
+  ShaderCacheCallback WrapCallback(const ShaderCacheCallback& shader_callback,
+                                   bool overwrite);
+  void StoreEntry(const ShaderCacheCallback& shader_callback,
+                  bool overwrite,
+                  const std::string& key,
+                  const std::string& program);
+
+  // Evicts the least recently used entries until the size limit is met.
+  void EvictEntries();
+
+  const size_t max_disk_size_bytes_;
+  scoped_refptr<base::SequencedTaskRunner> file_task_runner_;
+  base::FilePath driver_directory_;
+  size_t disk_size_bytes_;
+  EntryMRUCache entries_;
+  base::WeakPtrFactory<DiskProgramCache> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(DiskProgramCache);
+};
+
+}  // namespace gles2
+}  // namespace gpu
+
+#endif  // GPU_COMMAND_BUFFER_SERVICE_DISK_PROGRAM_CACHE_H_
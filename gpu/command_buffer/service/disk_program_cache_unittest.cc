@@ -0,0 +1,234 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gpu/command_buffer/service/disk_program_cache.h"
+
+#include "base/bind.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/message_loop/message_loop.h"
+#include "gpu/command_buffer/service/gl_utils.h"
+#include "gpu/command_buffer/service/gpu_service_test.h"
+#include "gpu/command_buffer/service/shader_manager.h"
+#include "gpu/command_buffer/service/test_helper.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "ui/gl/gl_mock.h"
+
+using ::testing::_;
+using ::testing::DoAll;
+using ::testing::SetArgPointee;
+using ::testing::SetArrayArgument;
+
+namespace gpu {
+namespace gles2 {
+
+namespace {
+
+const char kDriverVersion[] = "vendor renderer 1.0";
+const size_t kCacheSizeBytes = 4096;
+const GLenum kFormat = 1;
+const GLint kProgramId = 10;
+const GLsizei kBinaryLength = 20;
+
+}  // namespace
+
+class DiskProgramCacheTest : public GpuServiceTest {
+ public:
+  static const GLuint kVertexShaderClientId = 90;
+  static const GLuint kVertexShaderServiceId = 100;
+  static const GLuint kFragmentShaderClientId = 91;
+  static const GLuint kFragmentShaderServiceId = 100;
+
+  DiskProgramCacheTest()
+      : vertex_shader_(NULL),
+        fragment_shader_(NULL),
+        shader_cache_count_(0) {
+    for (int i = 0; i < kBinaryLength; ++i)
+      binary_[i] = i;
+  }
+  virtual ~DiskProgramCacheTest() {
+    shader_manager_.Destroy(false);
+  }
+
+  void ShaderCacheCb(const std::string& key, const std::string& shader) {
+    shader_cache_count_++;
+  }
+
+ protected:
+  virtual void SetUp() {
+    GpuServiceTest::SetUp();
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+
+    vertex_shader_ = shader_manager_.CreateShader(kVertexShaderClientId,
+                                                  kVertexShaderServiceId,
+                                                  GL_VERTEX_SHADER);
+    fragment_shader_ = shader_manager_.CreateShader(
+        kFragmentShaderClientId,
+        kFragmentShaderServiceId,
+        GL_FRAGMENT_SHADER);
+    ASSERT_TRUE(vertex_shader_ != NULL);
+    ASSERT_TRUE(fragment_shader_ != NULL);
+    SetShaderSources("bbbalsldkdkdkd", "bbbal   sldkdkdkas 134 ad");
+  }
+
+  void SetShaderSources(const char* vertex_source,
+                        const char* fragment_source) {
+    vertex_shader_->set_source(vertex_source);
+    fragment_shader_->set_source(fragment_source);
+    TestHelper::SetShaderStates(gl_.get(), vertex_shader_, true);
+    TestHelper::SetShaderStates(gl_.get(), fragment_shader_, true);
+  }
+
+  void SaveProgram(DiskProgramCache* cache) {
+    EXPECT_CALL(*gl_.get(),
+                GetProgramiv(kProgramId, GL_PROGRAM_BINARY_LENGTH_OES, _))
+        .WillOnce(SetArgPointee<2>(kBinaryLength));
+    EXPECT_CALL(*gl_.get(),
+                GetProgramBinary(kProgramId, kBinaryLength, _, _, _))
+        .WillOnce(DoAll(SetArgPointee<3>(kFormat),
+                        SetArrayArgument<4>(binary_,
+                                            binary_ + kBinaryLength)));
+    cache->SaveLinkedProgram(kProgramId, vertex_shader_, NULL,
+                             fragment_shader_, NULL, NULL,
+                             base::Bind(&DiskProgramCacheTest::ShaderCacheCb,
+                                        base::Unretained(this)));
+  }
+
+  // Creates a cache on |directory| and waits for its entries to be read.
+  scoped_ptr<DiskProgramCache> CreateCache(const base::FilePath& directory,
+                                           const char* driver_version,
+                                           size_t max_size_bytes) {
+    scoped_ptr<DiskProgramCache> cache(
+        new DiskProgramCache(directory,
+                             driver_version,
+                             max_size_bytes,
+                             message_loop_.message_loop_proxy()));
+    message_loop_.RunUntilIdle();
+    return cache.Pass();
+  }
+
+  ProgramCache::LinkedProgramStatus GetStatus(DiskProgramCache* cache) {
+    return cache->GetLinkedProgramStatus(vertex_shader_->signature_source(),
+                                         NULL,
+                                         fragment_shader_->signature_source(),
+                                         NULL,
+                                         NULL);
+  }
+
+  base::MessageLoop message_loop_;
+  base::ScopedTempDir temp_dir_;
+  ShaderManager shader_manager_;
+  Shader* vertex_shader_;
+  Shader* fragment_shader_;
+  char binary_[kBinaryLength];
+  int32 shader_cache_count_;
+};
+
+TEST_F(DiskProgramCacheTest, SaveWritesEntry) {
+  scoped_ptr<DiskProgramCache> cache =
+      CreateCache(temp_dir_.path(), kDriverVersion, kCacheSizeBytes);
+  EXPECT_EQ(0u, cache->disk_size_bytes());
+
+  SaveProgram(cache.get());
+  EXPECT_EQ(ProgramCache::LINK_SUCCEEDED, GetStatus(cache.get()));
+  EXPECT_GT(cache->disk_size_bytes(), static_cast<size_t>(kBinaryLength));
+  // The file is written on the file task runner.
+  message_loop_.RunUntilIdle();
+  EXPECT_FALSE(base::IsDirectoryEmpty(cache->driver_directory()));
+  // The embedder still gets to see the program.
+  EXPECT_EQ(1, shader_cache_count_);
+}
+
+TEST_F(DiskProgramCacheTest, LoadsEntriesOnRestart) {
+  {
+    scoped_ptr<DiskProgramCache> cache =
+        CreateCache(temp_dir_.path(), kDriverVersion, kCacheSizeBytes);
+    SaveProgram(cache.get());
+  }
+  message_loop_.RunUntilIdle();
+
+  scoped_ptr<DiskProgramCache> cache =
+      CreateCache(temp_dir_.path(), kDriverVersion, kCacheSizeBytes);
+  EXPECT_EQ(ProgramCache::LINK_SUCCEEDED, GetStatus(cache.get()));
+  EXPECT_GT(cache->disk_size_bytes(), 0u);
+
+  EXPECT_CALL(*gl_.get(), ProgramBinary(kProgramId, kFormat, _, kBinaryLength))
+      .Times(1);
+  EXPECT_CALL(*gl_.get(), GetProgramiv(kProgramId, GL_LINK_STATUS, _))
+      .WillOnce(SetArgPointee<2>(GL_TRUE));
+  EXPECT_EQ(ProgramCache::PROGRAM_LOAD_SUCCESS,
+            cache->LoadLinkedProgram(
+                kProgramId, vertex_shader_, NULL, fragment_shader_, NULL,
+                NULL, base::Bind(&DiskProgramCacheTest::ShaderCacheCb,
+                                 base::Unretained(this))));
+}
+
+TEST_F(DiskProgramCacheTest, EntriesAreNotReadSynchronously) {
+  {
+    scoped_ptr<DiskProgramCache> cache =
+        CreateCache(temp_dir_.path(), kDriverVersion, kCacheSizeBytes);
+    SaveProgram(cache.get());
+  }
+  message_loop_.RunUntilIdle();
+
+  DiskProgramCache cache(temp_dir_.path(),
+                         kDriverVersion,
+                         kCacheSizeBytes,
+                         message_loop_.message_loop_proxy());
+  EXPECT_EQ(ProgramCache::LINK_UNKNOWN, GetStatus(&cache));
+  message_loop_.RunUntilIdle();
+  EXPECT_EQ(ProgramCache::LINK_SUCCEEDED, GetStatus(&cache));
+}
+
+TEST_F(DiskProgramCacheTest, OtherDriverDeletesEntries) {
+  base::FilePath old_driver_directory;
+  {
+    scoped_ptr<DiskProgramCache> cache =
+        CreateCache(temp_dir_.path(), kDriverVersion, kCacheSizeBytes);
+    SaveProgram(cache.get());
+    old_driver_directory = cache->driver_directory();
+  }
+  message_loop_.RunUntilIdle();
+
+  scoped_ptr<DiskProgramCache> cache =
+      CreateCache(temp_dir_.path(), "vendor renderer 2.0", kCacheSizeBytes);
+  EXPECT_EQ(ProgramCache::LINK_UNKNOWN, GetStatus(cache.get()));
+  EXPECT_EQ(0u, cache->disk_size_bytes());
+  EXPECT_FALSE(base::PathExists(old_driver_directory));
+}
+
+TEST_F(DiskProgramCacheTest, EvictsLeastRecentlyUsed) {
+  size_t entry_size = 0;
+  {
+    base::ScopedTempDir measure_dir;
+    ASSERT_TRUE(measure_dir.CreateUniqueTempDir());
+    scoped_ptr<DiskProgramCache> cache =
+        CreateCache(measure_dir.path(), kDriverVersion, kCacheSizeBytes);
+    SaveProgram(cache.get());
+    entry_size = cache->disk_size_bytes();
+    message_loop_.RunUntilIdle();
+  }
+
+  // Room for one entry only.
+  scoped_ptr<DiskProgramCache> cache =
+      CreateCache(temp_dir_.path(), kDriverVersion, entry_size * 3 / 2);
+  SaveProgram(cache.get());
+  EXPECT_EQ(entry_size, cache->disk_size_bytes());
+
+  SetShaderSources("aaaalsldkdkdkd", "aaaal   sldkdkdkas 134 ad");
+  SaveProgram(cache.get());
+  EXPECT_EQ(entry_size, cache->disk_size_bytes());
+  cache.reset();
+  message_loop_.RunUntilIdle();
+
+  // Only the second program survives a restart.
+  scoped_ptr<DiskProgramCache> restarted =
+      CreateCache(temp_dir_.path(), kDriverVersion, entry_size * 3 / 2);
+  EXPECT_EQ(ProgramCache::LINK_SUCCEEDED, GetStatus(restarted.get()));
+  SetShaderSources("bbbalsldkdkdkd", "bbbal   sldkdkdkas 134 ad");
+  EXPECT_EQ(ProgramCache::LINK_UNKNOWN, GetStatus(restarted.get()));
+}
+
+}  // namespace gles2
+}  // namespace gpu
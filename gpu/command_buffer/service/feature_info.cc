@@ -142,7 +142,8 @@ FeatureInfo::FeatureFlags::FeatureFlags()
       is_swiftshader(false),
       angle_texture_usage(false),
       ext_texture_storage(false),
-      chromium_path_rendering(false) {
+      chromium_path_rendering(false),
+      async_shader_translation(false) {
 }
 
 FeatureInfo::Workarounds::Workarounds() :
@@ -176,6 +177,9 @@ void FeatureInfo::InitializeBasicState(const CommandLine& command_line) {
   feature_flags_.is_swiftshader =
       (command_line.GetSwitchValueASCII(switches::kUseGL) == "swiftshader");
 
+  feature_flags_.async_shader_translation =
+      command_line.HasSwitch(switches::kEnableAsyncShaderTranslation);
+
   static const GLenum kAlphaTypes[] = {
       GL_UNSIGNED_BYTE,
   };
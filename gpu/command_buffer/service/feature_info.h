@@ -70,6 +70,9 @@ class GPU_EXPORT FeatureInfo : public base::RefCounted<FeatureInfo> {
     bool angle_texture_usage;
     bool ext_texture_storage;
     bool chromium_path_rendering;
+    // Shaders are translated on the worker pool, and compiles only finish
+    // when the shader is used.
+    bool async_shader_translation;
   };
 
   struct Workarounds {
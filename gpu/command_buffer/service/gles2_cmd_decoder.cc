@@ -35,6 +35,7 @@
 #include "gpu/command_buffer/service/async_pixel_transfer_manager.h"
 #include "gpu/command_buffer/service/buffer_manager.h"
 #include "gpu/command_buffer/service/cmd_buffer_engine.h"
+#include "gpu/command_buffer/service/command_profiler.h"
 #include "gpu/command_buffer/service/context_group.h"
 #include "gpu/command_buffer/service/context_state.h"
 #include "gpu/command_buffer/service/error_state.h"
@@ -1761,6 +1762,9 @@ class GLES2DecoderImpl : public GLES2Decoder,
   bool use_shader_translator_;
   scoped_refptr<ShaderTranslator> vertex_translator_;
   scoped_refptr<ShaderTranslator> fragment_translator_;
+  // Extra translators handed out for translations on the worker pool. They
+  // are kept so that later compiles reuse their compilers.
+  std::vector<scoped_refptr<ShaderTranslator> > async_translators_;
 
   DisallowedFeatures disallowed_features_;
 
@@ -1818,9 +1822,12 @@ class GLES2DecoderImpl : public GLES2Decoder,
   scoped_ptr<GPUTracer> gpu_tracer_;
   scoped_ptr<GPUStateTracer> gpu_state_tracer_;
   const unsigned char* cb_command_trace_category_;
+  const unsigned char* command_profile_trace_category_;
+  scoped_ptr<CommandProfiler> command_profiler_;
   int gpu_trace_level_;
   bool gpu_trace_commands_;
   bool gpu_debug_commands_;
+  bool command_profiling_;
 
   std::queue<linked_ptr<FenceCallback> > pending_readpixel_fences_;
 
@@ -2333,9 +2340,13 @@ GLES2DecoderImpl::GLES2DecoderImpl(ContextGroup* group)
                          .texsubimage2d_faster_than_teximage2d),
       cb_command_trace_category_(TRACE_EVENT_API_GET_CATEGORY_GROUP_ENABLED(
           TRACE_DISABLED_BY_DEFAULT("cb_command"))),
+      command_profile_trace_category_(
+          TRACE_EVENT_API_GET_CATEGORY_GROUP_ENABLED(
+              TRACE_DISABLED_BY_DEFAULT("gpu.command_profile"))),
       gpu_trace_level_(2),
       gpu_trace_commands_(false),
       gpu_debug_commands_(false),
+      command_profiling_(false),
       validation_texture_(0),
       validation_fbo_multisample_(0),
       validation_fbo_(0) {
@@ -2774,6 +2785,8 @@ bool GLES2DecoderImpl::InitializeShaderTranslator() {
   if (!use_shader_translator_) {
     return true;
   }
+  // They were created for the old resources.
+  async_translators_.clear();
   ShBuiltInResources resources;
   ShInitBuiltInResources(&resources);
   resources.MaxVertexAttribs = group_->max_vertex_attribs();
@@ -3348,12 +3361,18 @@ Logger* GLES2DecoderImpl::GetLogger() {
 void GLES2DecoderImpl::BeginDecoding() {
   gpu_tracer_->BeginDecoding();
   gpu_trace_commands_ = gpu_tracer_->IsTracing();
+  command_profiling_ = *command_profile_trace_category_ != 0;
+  if (command_profiling_ && !command_profiler_)
+    command_profiler_.reset(new CommandProfiler(this, kNumCommands));
   gpu_debug_commands_ = log_commands() || debug() || gpu_trace_commands_ ||
-                        (*cb_command_trace_category_ != 0);
+                        (*cb_command_trace_category_ != 0) ||
+                        command_profiling_;
 }
 
 void GLES2DecoderImpl::EndDecoding() {
   gpu_tracer_->EndDecoding();
+  if (command_profiling_)
+    command_profiler_->MaybeDump(base::TimeTicks::Now());
 }
 
 ErrorState* GLES2DecoderImpl::GetErrorState() {
@@ -3534,6 +3553,7 @@ void GLES2DecoderImpl::Destroy(bool have_context) {
 
   // Need to release these before releasing |group_| which may own the
   // ShaderTranslatorCache.
+  async_translators_.clear();
   fragment_translator_ = NULL;
   vertex_translator_ = NULL;
 
@@ -3784,6 +3804,9 @@ error::Error GLES2DecoderImpl::DoCommandsImpl(unsigned int num_commands,
   int process_pos = 0;
   unsigned int command = 0;
 
+  if (DebugImpl && command_profiling_)
+    command_profiler_->BeginBatch(base::TimeTicks::Now());
+
   while (process_pos < num_entries && result == error::kNoError &&
          commands_to_process_--) {
     const unsigned int size = cmd_data->value_header.size;
@@ -3860,6 +3883,11 @@ error::Error GLES2DecoderImpl::DoCommandsImpl(unsigned int num_commands,
     }
 
     if (result != error::kDeferCommandUntilLater) {
+      if (DebugImpl && command_profiling_) {
+        command_profiler_->RecordCommand(
+            command, size * sizeof(CommandBufferEntry),  // NOLINT
+            base::TimeTicks::Now());
+      }
       process_pos += size;
       cmd_data += size;
     }
@@ -4970,6 +4998,8 @@ error::Error GLES2DecoderImpl::HandleDeleteShader(uint32 immediate_data_size,
     Shader* shader = GetShader(client_id);
     if (shader) {
       if (!shader->IsDeleted()) {
+        // The shader can still be linked while it is attached.
+        shader->FinishCompile();
         glDeleteShader(shader->service_id());
         shader_manager()->MarkAsDeleted(shader);
       }
@@ -6910,10 +6940,27 @@ void GLES2DecoderImpl::DoCompileShader(GLuint client_id) {
         vertex_translator_.get() : fragment_translator_.get();
   }
 
-  shader->DoCompile(
-     translator,
-     feature_info_->feature_flags().angle_translated_shader_source ?
-         Shader::kANGLE : Shader::kGL);
+  Shader::TranslatedShaderSourceType type =
+      feature_info_->feature_flags().angle_translated_shader_source ?
+          Shader::kANGLE : Shader::kGL;
+  if (features().async_shader_translation) {
+    // The compile is finished when the shader is linked, queried or deleted.
+    // Translations in flight at the same time get translators of their own.
+    scoped_refptr<ShaderTranslator> async_translator;
+    if (translator) {
+      async_translator =
+          shader_translator_cache()->GetTranslatorForAsyncCompile(translator);
+      if (async_translator.get() != translator &&
+          std::find(async_translators_.begin(),
+                    async_translators_.end(),
+                    async_translator) == async_translators_.end()) {
+        async_translators_.push_back(async_translator);
+      }
+    }
+    shader->RequestCompile(async_translator.get(), type);
+    return;
+  }
+  shader->DoCompile(translator, type);
 
   // CompileShader can be very slow.  Exit command processing to allow for
   // context preemption and GPU watchdog checks.
@@ -6926,6 +6973,7 @@ void GLES2DecoderImpl::DoGetShaderiv(
   if (!shader) {
     return;
   }
+  shader->FinishCompile();
   switch (pname) {
     case GL_SHADER_SOURCE_LENGTH:
       *params = shader->source().size();
@@ -6983,6 +7031,7 @@ error::Error GLES2DecoderImpl::HandleGetTranslatedShaderSourceANGLE(
     return error::kNoError;
   }
 
+  shader->FinishCompile();
   bucket->SetFromString(shader->translated_source().c_str());
   return error::kNoError;
 }
@@ -7018,6 +7067,7 @@ error::Error GLES2DecoderImpl::HandleGetShaderInfoLog(
     bucket->SetFromString("");
     return error::kNoError;
   }
+  shader->FinishCompile();
   bucket->SetFromString(shader->log_info().c_str());
   return error::kNoError;
 }
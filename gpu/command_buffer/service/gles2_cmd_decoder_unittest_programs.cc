@@ -691,6 +691,125 @@ TEST_P(GLES2DecoderTest, CompileShaderInvalidArgs) {
 #endif  // GLES2_TEST_SHADER_VS_PROGRAM_IDS
 }
 
+class GLES2DecoderAsyncShaderTranslationTest : public GLES2DecoderTest {
+ public:
+  GLES2DecoderAsyncShaderTranslationTest() {}
+
+  virtual void SetUp() {
+    CommandLine command_line(0, NULL);
+    command_line.AppendSwitch(switches::kEnableAsyncShaderTranslation);
+    InitState init;
+    init.gl_version = "3.0";
+    init.bind_generates_resource = true;
+    InitDecoderWithCommandLine(init, &command_line);
+  }
+
+ protected:
+  void RequestCompile(GLuint client_id) {
+    cmds::CompileShader cmd;
+    cmd.Init(client_id);
+    EXPECT_EQ(error::kNoError, ExecuteCmd(cmd));
+  }
+
+  void ExpectDriverCompile(GLuint service_id) {
+    EXPECT_CALL(*gl_, ShaderSource(service_id, 1, _, _))
+        .Times(1)
+        .RetiresOnSaturation();
+    EXPECT_CALL(*gl_, CompileShader(service_id))
+        .Times(1)
+        .RetiresOnSaturation();
+    EXPECT_CALL(*gl_, GetShaderiv(service_id, GL_COMPILE_STATUS, _))
+        .WillOnce(SetArgumentPointee<2>(GL_TRUE))
+        .RetiresOnSaturation();
+  }
+};
+
+INSTANTIATE_TEST_CASE_P(Service,
+                        GLES2DecoderAsyncShaderTranslationTest,
+                        ::testing::Bool());
+
+TEST_P(GLES2DecoderAsyncShaderTranslationTest, GetShaderivFinishesCompile) {
+  // The gl mock is strict, so nothing may reach the driver here.
+  RequestCompile(client_shader_id_);
+  Mock::VerifyAndClearExpectations(gl_.get());
+
+  ExpectDriverCompile(kServiceShaderId);
+  EXPECT_CALL(*gl_, GetError())
+      .WillOnce(Return(GL_NO_ERROR))
+      .WillOnce(Return(GL_NO_ERROR))
+      .RetiresOnSaturation();
+  typedef cmds::GetShaderiv::Result Result;
+  Result* result = static_cast<Result*>(shared_memory_address_);
+  result->size = 0;
+  cmds::GetShaderiv cmd;
+  cmd.Init(client_shader_id_,
+           GL_COMPILE_STATUS,
+           shared_memory_id_,
+           shared_memory_offset_);
+  EXPECT_EQ(error::kNoError, ExecuteCmd(cmd));
+  EXPECT_EQ(1, result->GetNumResults());
+  EXPECT_EQ(GL_NO_ERROR, GetGLError());
+
+  // The compile only happens once.
+  EXPECT_CALL(*gl_, GetError())
+      .WillOnce(Return(GL_NO_ERROR))
+      .WillOnce(Return(GL_NO_ERROR))
+      .RetiresOnSaturation();
+  result->size = 0;
+  EXPECT_EQ(error::kNoError, ExecuteCmd(cmd));
+  EXPECT_EQ(GL_NO_ERROR, GetGLError());
+}
+
+TEST_P(GLES2DecoderAsyncShaderTranslationTest, LinkProgramFinishesCompiles) {
+  DoCreateShader(GL_FRAGMENT_SHADER,
+                 client_fragment_shader_id_,
+                 kServiceFragmentShaderId);
+  RequestCompile(client_shader_id_);
+  RequestCompile(client_fragment_shader_id_);
+
+  EXPECT_CALL(*gl_, AttachShader(kServiceProgramId, kServiceShaderId))
+      .Times(1)
+      .RetiresOnSaturation();
+  EXPECT_CALL(*gl_, AttachShader(kServiceProgramId, kServiceFragmentShaderId))
+      .Times(1)
+      .RetiresOnSaturation();
+  cmds::AttachShader attach_cmd;
+  attach_cmd.Init(client_program_id_, client_shader_id_);
+  EXPECT_EQ(error::kNoError, ExecuteCmd(attach_cmd));
+  attach_cmd.Init(client_program_id_, client_fragment_shader_id_);
+  EXPECT_EQ(error::kNoError, ExecuteCmd(attach_cmd));
+  Mock::VerifyAndClearExpectations(gl_.get());
+
+  // Both compiles finish before the shaders are checked. Without a shader
+  // translator in these tests they aren't valid, so the driver link doesn't
+  // happen.
+  ExpectDriverCompile(kServiceShaderId);
+  ExpectDriverCompile(kServiceFragmentShaderId);
+  cmds::LinkProgram link_cmd;
+  link_cmd.Init(client_program_id_);
+  EXPECT_EQ(error::kNoError, ExecuteCmd(link_cmd));
+  EXPECT_EQ(GL_NO_ERROR, GetGLError());
+}
+
+TEST_P(GLES2DecoderAsyncShaderTranslationTest, DeleteShaderFinishesCompile) {
+  RequestCompile(client_shader_id_);
+  Mock::VerifyAndClearExpectations(gl_.get());
+
+  // The compile finishes before the driver shader is deleted, as the shader
+  // could still be linked into a program it is attached to.
+  {
+    InSequence sequence;
+    ExpectDriverCompile(kServiceShaderId);
+    EXPECT_CALL(*gl_, DeleteShader(kServiceShaderId))
+        .Times(1)
+        .RetiresOnSaturation();
+  }
+  cmds::DeleteShader cmd;
+  cmd.Init(client_shader_id_);
+  EXPECT_EQ(error::kNoError, ExecuteCmd(cmd));
+  EXPECT_EQ(GL_NO_ERROR, GetGLError());
+}
+
 TEST_P(GLES2DecoderTest, ShaderSourceBucketAndGetShaderSourceValidArgs) {
   const uint32 kInBucketId = 123;
   const uint32 kOutBucketId = 125;
@@ -52,6 +52,13 @@ const char kGpuProgramCacheSizeKb[]         = "gpu-program-cache-size-kb";
 // Disables the GPU shader on disk cache.
 const char kDisableGpuShaderDiskCache[]     = "disable-gpu-shader-disk-cache";
 
+// Persists the gpu program cache to files in the given directory.
+const char kGpuProgramCacheDir[]            = "gpu-program-cache-dir";
+
+// Translates shaders on worker threads, and only waits for the result when
+// the shader is linked or queried.
+const char kEnableAsyncShaderTranslation[] = "enable-async-shader-translation";
+
 // Allows async texture uploads (off main thread) via GL context sharing.
 const char kEnableShareGroupAsyncTextureUpload[] =
     "enable-share-group-async-texture-upload";
@@ -71,6 +78,8 @@ const char* kGpuSwitches[] = {
   kGpuDriverBugWorkarounds,
   kGpuProgramCacheSizeKb,
   kDisableGpuShaderDiskCache,
+  kGpuProgramCacheDir,
+  kEnableAsyncShaderTranslation,
   kEnableShareGroupAsyncTextureUpload,
 };
 
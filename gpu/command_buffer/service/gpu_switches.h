@@ -25,6 +25,8 @@ GPU_EXPORT extern const char kForceGpuMemAvailableMb[];
 GPU_EXPORT extern const char kGpuDriverBugWorkarounds[];
 GPU_EXPORT extern const char kGpuProgramCacheSizeKb[];
 GPU_EXPORT extern const char kDisableGpuShaderDiskCache[];
+GPU_EXPORT extern const char kGpuProgramCacheDir[];
+GPU_EXPORT extern const char kEnableAsyncShaderTranslation[];
 GPU_EXPORT extern const char kEnableShareGroupAsyncTextureUpload[];
 
 GPU_EXPORT extern const char* kGpuSwitches[];
@@ -45,6 +45,9 @@ class GPU_EXPORT MemoryProgramCache : public ProgramCache {
 
   virtual void LoadProgram(const std::string& program) OVERRIDE;
 
+ protected:
+  size_t max_size_bytes() const { return max_size_bytes_; }
+
  private:
   virtual void ClearBackend() OVERRIDE;
 
@@ -527,6 +527,10 @@ bool Program::Link(ShaderManager* manager,
                    Program::VaryingsPackingOption varyings_packing_option,
                    const ShaderCacheCallback& shader_callback) {
   ClearLinkStatus();
+  for (int ii = 0; ii < kMaxAttachedShaders; ++ii) {
+    if (attached_shaders_[ii].get())
+      attached_shaders_[ii]->FinishCompile();
+  }
   if (!CanLink()) {
     set_log_info("missing shaders");
     return false;
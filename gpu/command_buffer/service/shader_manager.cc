@@ -6,24 +6,97 @@
 
 #include <utility>
 
+#include "base/bind.h"
+#include "base/debug/trace_event.h"
 #include "base/logging.h"
 #include "base/strings/string_util.h"
+#include "base/synchronization/waitable_event.h"
+#include "base/threading/worker_pool.h"
 
 namespace gpu {
 namespace gles2 {
 
+// Translates a copy of the source on the worker pool. Only the results are
+// shared with the Shader, and only once |done_| is signaled.
+class Shader::PendingTranslation
+    : public base::RefCountedThreadSafe<PendingTranslation> {
+ public:
+  // Without a |translator| there is nothing to run, and only the driver
+  // compile of |source| is pending.
+  PendingTranslation(const std::string& source,
+                     const ShaderTranslatorInterface* translator)
+      : source_(source),
+        translator_(translator),
+        valid_(false),
+        done_(true, translator == NULL) {
+  }
+
+  void Run() {
+    TRACE_EVENT0("gpu", "Shader::PendingTranslation::Run");
+    valid_ = translator_->Translate(source_,
+                                    &log_info_,
+                                    &translated_source_,
+                                    &attrib_map_,
+                                    &uniform_map_,
+                                    &varying_map_,
+                                    &name_map_);
+    done_.Signal();
+  }
+
+  void Wait() {
+    TRACE_EVENT0("gpu", "Shader::PendingTranslation::Wait");
+    done_.Wait();
+  }
+
+  const std::string& source() const { return source_; }
+  bool valid() const { return valid_; }
+  std::string* log_info() { return &log_info_; }
+  std::string* translated_source() { return &translated_source_; }
+  VariableMap* attrib_map() { return &attrib_map_; }
+  VariableMap* uniform_map() { return &uniform_map_; }
+  VariableMap* varying_map() { return &varying_map_; }
+  NameMap* name_map() { return &name_map_; }
+
+ private:
+  friend class base::RefCountedThreadSafe<PendingTranslation>;
+
+  ~PendingTranslation() {}
+
+  const std::string source_;
+  const ShaderTranslatorInterface* const translator_;
+  bool valid_;
+  std::string log_info_;
+  std::string translated_source_;
+  VariableMap attrib_map_;
+  VariableMap uniform_map_;
+  VariableMap varying_map_;
+  NameMap name_map_;
+  base::WaitableEvent done_;
+
+  DISALLOW_COPY_AND_ASSIGN(PendingTranslation);
+};
+
 Shader::Shader(GLuint service_id, GLenum shader_type)
       : use_count_(0),
         service_id_(service_id),
         shader_type_(shader_type),
-        valid_(false) {
+        valid_(false),
+        pending_type_(kGL) {
 }
 
 Shader::~Shader() {
+  // The worker may still be using the translator.
+  if (pending_translation_.get())
+    pending_translation_->Wait();
+  if (pending_translator_.get())
+    pending_translator_->RemovePendingTranslation();
 }
 
 void Shader::DoCompile(ShaderTranslatorInterface* translator,
                        TranslatedShaderSourceType type) {
+  // The results of an earlier request would overwrite this compile's.
+  FinishCompile();
+
   // Translate GL ES 2.0 shader to Desktop GL shader and pass that to
   // glShaderSource and then glCompileShader.
   const char* source_for_driver = source_.c_str();
@@ -42,6 +115,65 @@ void Shader::DoCompile(ShaderTranslatorInterface* translator,
     source_for_driver = translated_source_.c_str();
   }
 
+  CompileWithDriver(source_, source_for_driver, translator != NULL, type);
+}
+
+void Shader::RequestCompile(ShaderTranslator* translator,
+                            TranslatedShaderSourceType type) {
+  FinishCompile();
+  pending_translation_ = new PendingTranslation(source_, translator);
+  pending_type_ = type;
+  if (!translator)
+    return;
+
+  pending_translator_ = translator;
+  translator->AddPendingTranslation();
+  base::WorkerPool::PostTask(
+      FROM_HERE,
+      base::Bind(&PendingTranslation::Run, pending_translation_),
+      true);
+}
+
+void Shader::FinishCompile() {
+  if (!pending_translation_.get())
+    return;
+
+  scoped_refptr<PendingTranslation> translation;
+  translation.swap(pending_translation_);
+  translation->Wait();
+
+  const char* source_for_driver = translation->source().c_str();
+  bool translated = pending_translator_.get() != NULL;
+  if (translated) {
+    pending_translator_->RemovePendingTranslation();
+    pending_translator_ = NULL;
+
+    valid_ = translation->valid();
+    log_info_.swap(*translation->log_info());
+    translated_source_.swap(*translation->translated_source());
+    attrib_map_.swap(*translation->attrib_map());
+    uniform_map_.swap(*translation->uniform_map());
+    varying_map_.swap(*translation->varying_map());
+    name_map_.swap(*translation->name_map());
+    if (!valid_)
+      return;
+    signature_source_ = translation->source();
+    source_for_driver = translated_source_.c_str();
+  }
+
+  // A deleted shader has no driver object to compile into.
+  if (IsDeleted())
+    return;
+  CompileWithDriver(translation->source(),
+                    source_for_driver,
+                    translated,
+                    pending_type_);
+}
+
+void Shader::CompileWithDriver(const std::string& source,
+                               const char* source_for_driver,
+                               bool translated,
+                               TranslatedShaderSourceType type) {
   glShaderSource(service_id_, 1, &source_for_driver, NULL);
   glCompileShader(service_id_);
   if (type == kANGLE) {
@@ -73,10 +205,10 @@ void Shader::DoCompile(ShaderTranslatorInterface* translator,
     DCHECK(len == 0 || buffer[len] == '\0');
     valid_ = false;
     log_info_ = std::string(buffer.get(), len);
-    LOG_IF(ERROR, translator)
+    LOG_IF(ERROR, translated)
         << "Shader translator allowed/produced an invalid shader "
         << "unless the driver is buggy:"
-        << "\n--original-shader--\n" << source_
+        << "\n--original-shader--\n" << source
         << "\n--translated-shader--\n" << source_for_driver
         << "\n--info-log--\n" << log_info_;
   }
@@ -34,6 +34,21 @@ class GPU_EXPORT Shader : public base::RefCounted<Shader> {
   void DoCompile(ShaderTranslatorInterface* translator,
                  TranslatedShaderSourceType type);
 
+  // Starts translating the current source on the worker pool, and returns
+  // right away. The driver compile, and any access to the results, waits
+  // until FinishCompile() is called. Without a |translator|, only the driver
+  // compile is deferred.
+  void RequestCompile(ShaderTranslator* translator,
+                      TranslatedShaderSourceType type);
+
+  // Waits for a compile started by RequestCompile() and completes it, if there
+  // is one. Must be called before using the compile results.
+  void FinishCompile();
+
+  bool compile_pending() const {
+    return pending_translation_.get() != NULL;
+  }
+
   GLuint service_id() const {
     return service_id_;
   }
@@ -124,12 +139,22 @@ class GPU_EXPORT Shader : public base::RefCounted<Shader> {
   typedef ShaderTranslator::VariableMap VariableMap;
   typedef ShaderTranslator::NameMap NameMap;
 
+  class PendingTranslation;
+
   friend class base::RefCounted<Shader>;
   friend class ShaderManager;
 
   Shader(GLuint service_id, GLenum shader_type);
   ~Shader();
 
+  // Passes |source_for_driver| to the driver and checks the result.
+  // |translated| is true if it was produced by the shader translator from
+  // |source|.
+  void CompileWithDriver(const std::string& source,
+                         const char* source_for_driver,
+                         bool translated,
+                         TranslatedShaderSourceType type);
+
   void IncUseCount();
   void DecUseCount();
   void MarkAsDeleted();
@@ -163,6 +188,13 @@ class GPU_EXPORT Shader : public base::RefCounted<Shader> {
 
   // The name hashing info when the shader was last compiled.
   NameMap name_map_;
+
+  // The translation started by RequestCompile(), if it hasn't been finished.
+  // The translator is kept alive here rather than in the translation, so that
+  // its reference count is only touched on this thread.
+  scoped_refptr<PendingTranslation> pending_translation_;
+  scoped_refptr<ShaderTranslator> pending_translator_;
+  TranslatedShaderSourceType pending_type_;
 };
 
 // Tracks the Shaders.
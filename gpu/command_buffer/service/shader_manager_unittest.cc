@@ -5,14 +5,18 @@
 #include "gpu/command_buffer/service/shader_manager.h"
 
 #include "base/memory/scoped_ptr.h"
+#include "gpu/command_buffer/service/shader_translator.h"
 #include "gpu/command_buffer/service/gpu_service_test.h"
 #include "gpu/command_buffer/service/mocks.h"
 #include "gpu/command_buffer/service/test_helper.h"
 #include "testing/gtest/include/gtest/gtest.h"
 #include "ui/gl/gl_mock.h"
 
+using ::testing::_;
+using ::testing::NotNull;
 using ::testing::Return;
 using ::testing::ReturnRef;
+using ::testing::SetArgumentPointee;
 
 namespace gpu {
 namespace gles2 {
@@ -268,5 +272,71 @@ TEST_F(ShaderManagerTest, ShaderInfoUseCount) {
   EXPECT_TRUE(shader2 == NULL);
 }
 
+TEST_F(ShaderManagerTest, RequestCompile) {
+  const GLuint kClient1Id = 1;
+  const GLuint kService1Id = 11;
+  const GLuint kClient2Id = 2;
+  const GLuint kService2Id = 12;
+  const char* kValidSource =
+      "attribute vec4 a;\n"
+      "void main() {\n"
+      "  gl_Position = a;\n"
+      "}";
+  const char* kInvalidSource = "void main() { gl_Position = b; }";
+
+  ShBuiltInResources resources;
+  ShInitBuiltInResources(&resources);
+  scoped_refptr<ShaderTranslator> translator(new ShaderTranslator());
+  ASSERT_TRUE(translator->Init(GL_VERTEX_SHADER,
+                               SH_GLES2_SPEC,
+                               &resources,
+                               ShaderTranslatorInterface::kGlsl,
+                               static_cast<ShCompileOptions>(0)));
+
+  // Nothing reaches the driver until the compile is finished.
+  Shader* shader1 =
+      manager_.CreateShader(kClient1Id, kService1Id, GL_VERTEX_SHADER);
+  shader1->set_source(kValidSource);
+  shader1->RequestCompile(translator.get(), Shader::kGL);
+  EXPECT_TRUE(shader1->compile_pending());
+  EXPECT_FALSE(shader1->valid());
+  // Later source changes don't affect the pending compile.
+  shader1->set_source(kInvalidSource);
+
+  EXPECT_CALL(*gl_, ShaderSource(kService1Id, 1, _, NULL))
+      .Times(1)
+      .RetiresOnSaturation();
+  EXPECT_CALL(*gl_, CompileShader(kService1Id))
+      .Times(1)
+      .RetiresOnSaturation();
+  EXPECT_CALL(*gl_, GetShaderiv(kService1Id, GL_COMPILE_STATUS, NotNull()))
+      .WillOnce(SetArgumentPointee<2>(GL_TRUE))
+      .RetiresOnSaturation();
+  shader1->FinishCompile();
+  EXPECT_FALSE(shader1->compile_pending());
+  EXPECT_TRUE(shader1->valid());
+  EXPECT_STREQ(kValidSource, shader1->signature_source().c_str());
+  EXPECT_FALSE(shader1->translated_source().empty());
+  EXPECT_TRUE(shader1->GetAttribInfo("a") != NULL);
+
+  // Translation failures don't reach the driver at all.
+  Shader* shader2 =
+      manager_.CreateShader(kClient2Id, kService2Id, GL_VERTEX_SHADER);
+  shader2->set_source(kInvalidSource);
+  shader2->RequestCompile(translator.get(), Shader::kGL);
+  shader2->FinishCompile();
+  EXPECT_FALSE(shader2->valid());
+  EXPECT_FALSE(shader2->log_info().empty());
+
+  // Neither do shaders deleted while they were being translated.
+  shader2->set_source(kValidSource);
+  shader2->RequestCompile(translator.get(), Shader::kGL);
+  manager_.UseShader(shader2);
+  manager_.MarkAsDeleted(shader2);
+  shader2->FinishCompile();
+  EXPECT_TRUE(shader2->valid());
+  manager_.UnuseShader(shader2);
+}
+
 }  // namespace gles2
 }  // namespace gpu
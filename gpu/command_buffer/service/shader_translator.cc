@@ -122,7 +122,8 @@ ShaderTranslator::DestructionObserver::~DestructionObserver() {
 ShaderTranslator::ShaderTranslator()
     : compiler_(NULL),
       implementation_is_glsl_es_(false),
-      driver_bug_workarounds_(static_cast<ShCompileOptions>(0)) {
+      driver_bug_workarounds_(static_cast<ShCompileOptions>(0)),
+      pending_translations_(0) {
 }
 
 bool ShaderTranslator::Init(
@@ -174,6 +175,7 @@ bool ShaderTranslator::Translate(const std::string& shader_source,
   // Make sure this instance is initialized.
   DCHECK(compiler_ != NULL);
 
+  base::AutoLock lock(lock_);
   bool success = false;
   {
     TRACE_EVENT0("gpu", "ShCompile");
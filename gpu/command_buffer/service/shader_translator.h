@@ -9,9 +9,11 @@
 
 #include "base/basictypes.h"
 #include "base/containers/hash_tables.h"
+#include "base/logging.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/observer_list.h"
+#include "base/synchronization/lock.h"
 #include "gpu/gpu_export.h"
 #include "third_party/angle/include/GLSLANG/ShaderLang.h"
 
@@ -134,17 +136,32 @@ class GPU_EXPORT ShaderTranslator
   void AddDestructionObserver(DestructionObserver* observer);
   void RemoveDestructionObserver(DestructionObserver* observer);
 
+  // The number of translations started on the worker pool with this translator
+  // that haven't been finished. Only used on the thread that owns the
+  // translator.
+  int pending_translations() const { return pending_translations_; }
+  void AddPendingTranslation() { ++pending_translations_; }
+  void RemovePendingTranslation() {
+    DCHECK_GT(pending_translations_, 0);
+    --pending_translations_;
+  }
+
  private:
   friend class base::RefCounted<ShaderTranslator>;
 
   virtual ~ShaderTranslator();
   int GetCompileOptions() const;
 
+  // ShCompile isn't reentrant on a compiler. Translations on the worker pool
+  // only share a translator once ShaderTranslatorCache has created as many as
+  // it allows for the same parameters.
+  mutable base::Lock lock_;
   ShHandle compiler_;
   ShBuiltInResources compiler_options_;
   bool implementation_is_glsl_es_;
   ShCompileOptions driver_bug_workarounds_;
   ObserverList<DestructionObserver> destruction_observers_;
+  int pending_translations_;
 
   DISALLOW_COPY_AND_ASSIGN(ShaderTranslator);
 };
@@ -9,6 +9,10 @@
 namespace gpu {
 namespace gles2 {
 
+#if !defined(_MSC_VER)
+const size_t ShaderTranslatorCache::kMaxTranslatorsPerParams;
+#endif
+
 ShaderTranslatorCache::ShaderTranslatorCache() {
 }
 
@@ -40,20 +44,59 @@ scoped_refptr<ShaderTranslator> ShaderTranslatorCache::GetTranslator(
                                     glsl_implementation_type,
                                     driver_bug_workarounds);
 
-  Cache::iterator it = cache_.find(params);
-  if (it != cache_.end())
+  Cache::iterator it = cache_.lower_bound(params);
+  if (it != cache_.end() && it->first == params)
     return it->second;
 
-  ShaderTranslator* translator = new ShaderTranslator();
-  if (translator->Init(shader_type, shader_spec, resources,
-                       glsl_implementation_type,
-                       driver_bug_workarounds)) {
-    cache_[params] = translator;
-    translator->AddDestructionObserver(this);
+  return CreateTranslator(params);
+}
+
+scoped_refptr<ShaderTranslator>
+ShaderTranslatorCache::GetTranslatorForAsyncCompile(
+    ShaderTranslator* translator) {
+  DCHECK(translator);
+  if (!translator->pending_translations())
+    return translator;
+
+  Cache::iterator it = cache_.begin();
+  while (it != cache_.end() && it->second != translator)
+    ++it;
+  if (it == cache_.end())
     return translator;
-  } else {
+
+  std::pair<Cache::iterator, Cache::iterator> range =
+      cache_.equal_range(it->first);
+  ShaderTranslator* least_busy = translator;
+  size_t count = 0;
+  for (it = range.first; it != range.second; ++it, ++count) {
+    if (it->second->pending_translations() <
+        least_busy->pending_translations()) {
+      least_busy = it->second;
+    }
+  }
+  if (!least_busy->pending_translations() || count >= kMaxTranslatorsPerParams)
+    return least_busy;
+
+  scoped_refptr<ShaderTranslator> new_translator =
+      CreateTranslator(range.first->first);
+  if (!new_translator.get())
+    return least_busy;
+  return new_translator;
+}
+
+scoped_refptr<ShaderTranslator> ShaderTranslatorCache::CreateTranslator(
+    const ShaderTranslatorInitParams& params) {
+  scoped_refptr<ShaderTranslator> translator(new ShaderTranslator());
+  if (!translator->Init(params.shader_type,
+                        params.shader_spec,
+                        &params.resources,
+                        params.glsl_implementation_type,
+                        params.driver_bug_workarounds)) {
     return NULL;
   }
+  cache_.insert(std::make_pair(params, translator.get()));
+  translator->AddDestructionObserver(this);
+  return translator;
 }
 
 }  // namespace gles2
@@ -39,6 +39,14 @@ class GPU_EXPORT ShaderTranslatorCache
           glsl_implementation_type,
       ShCompileOptions driver_bug_workarounds);
 
+  // Returns a translator created with the same parameters as |translator| for
+  // a translation on the worker pool. One that has no translation pending is
+  // preferred, and a new one is created if there is none, so that concurrent
+  // translations each get their own compiler. Past
+  // |kMaxTranslatorsPerParams| of them, the least busy one is shared.
+  scoped_refptr<ShaderTranslator> GetTranslatorForAsyncCompile(
+      ShaderTranslator* translator);
+
  private:
   friend class base::RefCounted<ShaderTranslatorCache>;
   virtual ~ShaderTranslatorCache();
@@ -79,7 +87,16 @@ class GPU_EXPORT ShaderTranslatorCache
     }
   };
 
-  typedef std::map<ShaderTranslatorInitParams, ShaderTranslator* > Cache;
+  // Each ANGLE compiler keeps its own symbol tables, so only a few are
+  // created for each set of parameters.
+  static const size_t kMaxTranslatorsPerParams = 4;
+
+  scoped_refptr<ShaderTranslator> CreateTranslator(
+      const ShaderTranslatorInitParams& params);
+
+  // GetTranslator() returns the first translator for its parameters; the rest
+  // are only used by GetTranslatorForAsyncCompile().
+  typedef std::multimap<ShaderTranslatorInitParams, ShaderTranslator*> Cache;
   Cache cache_;
 
   DISALLOW_COPY_AND_ASSIGN(ShaderTranslatorCache);
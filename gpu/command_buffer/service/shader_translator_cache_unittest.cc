@@ -0,0 +1,74 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <GLES2/gl2.h>
+
+#include <vector>
+
+#include "gpu/command_buffer/service/shader_translator_cache.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace gpu {
+namespace gles2 {
+
+TEST(ShaderTranslatorCacheTest, AsyncCompilesGetIdleTranslators) {
+  scoped_refptr<ShaderTranslatorCache> cache = new ShaderTranslatorCache;
+  ShBuiltInResources resources;
+  ShInitBuiltInResources(&resources);
+
+  scoped_refptr<ShaderTranslator> translator =
+      cache->GetTranslator(GL_VERTEX_SHADER,
+                           SH_GLES2_SPEC,
+                           &resources,
+                           ShaderTranslatorInterface::kGlsl,
+                           static_cast<ShCompileOptions>(0));
+  ASSERT_TRUE(translator.get());
+
+  // An idle translator is handed out as is.
+  EXPECT_EQ(translator.get(),
+            cache->GetTranslatorForAsyncCompile(translator.get()).get());
+
+  // While it is busy, other translators with the same parameters are.
+  std::vector<scoped_refptr<ShaderTranslator> > translators;
+  translators.push_back(translator);
+  translator->AddPendingTranslation();
+  for (int ii = 0; ii < 3; ++ii) {
+    scoped_refptr<ShaderTranslator> other =
+        cache->GetTranslatorForAsyncCompile(translator.get());
+    ASSERT_TRUE(other.get());
+    for (size_t jj = 0; jj < translators.size(); ++jj)
+      EXPECT_NE(translators[jj].get(), other.get());
+    other->AddPendingTranslation();
+    translators.push_back(other);
+  }
+
+  // Past the limit, the least busy one is shared.
+  translator->AddPendingTranslation();
+  translators[1]->AddPendingTranslation();
+  translators[3]->AddPendingTranslation();
+  EXPECT_EQ(translators[2].get(),
+            cache->GetTranslatorForAsyncCompile(translator.get()).get());
+
+  // Once one is idle again, it is reused.
+  translators[3]->RemovePendingTranslation();
+  translators[3]->RemovePendingTranslation();
+  EXPECT_EQ(translators[3].get(),
+            cache->GetTranslatorForAsyncCompile(translator.get()).get());
+
+  // Synchronous compiles keep using the first translator.
+  EXPECT_EQ(translator.get(),
+            cache->GetTranslator(GL_VERTEX_SHADER,
+                                 SH_GLES2_SPEC,
+                                 &resources,
+                                 ShaderTranslatorInterface::kGlsl,
+                                 static_cast<ShCompileOptions>(0)).get());
+
+  for (size_t ii = 0; ii < translators.size(); ++ii) {
+    while (translators[ii]->pending_translations())
+      translators[ii]->RemovePendingTranslation();
+  }
+}
+
+}  // namespace gles2
+}  // namespace gpu
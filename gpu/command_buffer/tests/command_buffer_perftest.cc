@@ -0,0 +1,187 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Measures the client side of the command buffer, running the service in
+// process on top of OSMesa.
+
+#include <GLES2/gl2.h>
+#include <GLES2/gl2ext.h>
+
+#include <vector>
+
+#include "base/strings/stringprintf.h"
+#include "base/time/time.h"
+#include "gpu/command_buffer/tests/gl_manager.h"
+#include "gpu/command_buffer/tests/gl_test_utils.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+
+namespace gpu {
+namespace {
+
+const int kTimeLimitMillis = 2000;
+const int kSmallCommandsPerLap = 1000;
+const int kBufferSize = 4;
+
+class CommandBufferPerfTest : public testing::Test {
+ protected:
+  virtual void SetUp() OVERRIDE {
+    GLManager::Options options;
+    options.size = gfx::Size(kBufferSize, kBufferSize);
+    gl_.Initialize(options);
+  }
+
+  virtual void TearDown() OVERRIDE {
+    gl_.Destroy();
+  }
+
+  // Runs |lap| until the time limit is reached, and returns the number of
+  // laps run per second.
+  template <typename Lap>
+  double RunLaps(const Lap& lap) {
+    // Warm up, so that the transfer buffer has grown to its final size.
+    lap();
+    glFinish();
+
+    base::TimeTicks start = base::TimeTicks::Now();
+    base::TimeDelta elapsed;
+    int laps = 0;
+    do {
+      lap();
+      glFinish();
+      ++laps;
+      elapsed = base::TimeTicks::Now() - start;
+    } while (elapsed < base::TimeDelta::FromMilliseconds(kTimeLimitMillis));
+    return laps / elapsed.InSecondsF();
+  }
+
+  GLManager gl_;
+};
+
+struct SmallCommandsLap {
+  explicit SmallCommandsLap(GLuint texture) : texture(texture) {}
+
+  void operator()() const {
+    for (int i = 0; i < kSmallCommandsPerLap; ++i) {
+      glBindTexture(GL_TEXTURE_2D, texture);
+      glTexParameteri(GL_TEXTURE_2D,
+                      GL_TEXTURE_MIN_FILTER,
+                      i % 2 ? GL_NEAREST : GL_LINEAR);
+    }
+  }
+
+  GLuint texture;
+};
+
+struct TexSubImageLap {
+  TexSubImageLap(int size, const std::vector<uint8>* pixels)
+      : size(size), pixels(pixels) {}
+
+  void operator()() const {
+    glTexSubImage2D(GL_TEXTURE_2D,
+                    0,
+                    0,
+                    0,
+                    size,
+                    size,
+                    GL_RGBA,
+                    GL_UNSIGNED_BYTE,
+                    &(*pixels)[0]);
+  }
+
+  int size;
+  const std::vector<uint8>* pixels;
+};
+
+TEST_F(CommandBufferPerfTest, SmallCommands) {
+  GLuint texture = 0;
+  glGenTextures(1, &texture);
+
+  double laps_per_second = RunLaps(SmallCommandsLap(texture));
+  perf_test::PrintResult("command_buffer_small_commands",
+                         "",
+                         "bind_texture_and_parameter",
+                         laps_per_second * kSmallCommandsPerLap * 2,
+                         "commands/s",
+                         true);
+
+  glDeleteTextures(1, &texture);
+  GLTestHelper::CheckGLError("no errors", __LINE__);
+}
+
+TEST_F(CommandBufferPerfTest, TexSubImageUpload) {
+  // The largest size doesn't fit the initial transfer buffer, so the warm up
+  // lap grows it.
+  const int kSizes[] = {64, 256, 1024, 2048};
+
+  GLuint texture = 0;
+  glGenTextures(1, &texture);
+  glBindTexture(GL_TEXTURE_2D, texture);
+  for (size_t i = 0; i < arraysize(kSizes); ++i) {
+    int size = kSizes[i];
+    std::vector<uint8> pixels(size * size * 4, static_cast<uint8>(i));
+    glTexImage2D(GL_TEXTURE_2D,
+                 0,
+                 GL_RGBA,
+                 size,
+                 size,
+                 0,
+                 GL_RGBA,
+                 GL_UNSIGNED_BYTE,
+                 NULL);
+
+    double laps_per_second = RunLaps(TexSubImageLap(size, &pixels));
+    perf_test::PrintResult("command_buffer_tex_sub_image",
+                           "",
+                           base::StringPrintf("%dx%d", size, size),
+                           laps_per_second * pixels.size() / (1024 * 1024),
+                           "MB/s",
+                           true);
+  }
+
+  glDeleteTextures(1, &texture);
+  GLTestHelper::CheckGLError("no errors", __LINE__);
+}
+
+TEST_F(CommandBufferPerfTest, FirstLargeUpload) {
+  // Uploads that outgrow the transfer buffer pay for mapping a new one while
+  // the service is still busy with the old one.
+  const int kSize = 2048;
+  std::vector<uint8> pixels(kSize * kSize * 4, 0x80);
+
+  GLuint texture = 0;
+  glGenTextures(1, &texture);
+  glBindTexture(GL_TEXTURE_2D, texture);
+  glTexImage2D(GL_TEXTURE_2D,
+               0,
+               GL_RGBA,
+               kSize,
+               kSize,
+               0,
+               GL_RGBA,
+               GL_UNSIGNED_BYTE,
+               NULL);
+  // Queue some work so that the service is busy when the buffer grows.
+  SmallCommandsLap small_commands(texture);
+  small_commands();
+  glFlush();
+
+  TexSubImageLap upload(kSize, &pixels);
+  base::TimeTicks start = base::TimeTicks::Now();
+  upload();
+  base::TimeDelta elapsed = base::TimeTicks::Now() - start;
+  glFinish();
+  perf_test::PrintResult("command_buffer_first_large_upload",
+                         "",
+                         base::StringPrintf("%dx%d", kSize, kSize),
+                         elapsed.InMillisecondsF(),
+                         "ms",
+                         true);
+
+  glDeleteTextures(1, &texture);
+  GLTestHelper::CheckGLError("no errors", __LINE__);
+}
+
+}  // namespace
+}  // namespace gpu
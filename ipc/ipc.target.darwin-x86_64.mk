@@ -33,8 +33,10 @@ LOCAL_SRC_FILES := \
 	ipc/ipc_forwarding_message_filter.cc \
 	ipc/ipc_logging.cc \
 	ipc/ipc_message.cc \
+	ipc/ipc_message_profiler.cc \
 	ipc/ipc_message_utils.cc \
 	ipc/ipc_platform_file.cc \
+	ipc/ipc_struct_member_reader.cc \
 	ipc/ipc_switches.cc \
 	ipc/ipc_sync_channel.cc \
 	ipc/ipc_sync_message.cc \
@@ -15,6 +15,7 @@
 #include "ipc/ipc_listener.h"
 #include "ipc/ipc_logging.h"
 #include "ipc/ipc_message_macros.h"
+#include "ipc/ipc_message_profiler.h"
 #include "ipc/message_filter.h"
 #include "ipc/message_filter_router.h"
 
@@ -64,7 +65,17 @@ bool ChannelProxy::Context::TryFilters(const Message& message) {
     logger->OnPreDispatchMessage(message);
 #endif
 
+  MessageProfiler* profiler = MessageProfiler::GetInstance();
+  bool profiling = profiler->enabled();
+  base::TimeTicks filter_start;
+  if (profiling)
+    filter_start = MessageProfiler::HandlerClockNow();
+
   if (message_filter_router_->TryFilters(message)) {
+    if (profiling) {
+      profiler->RecordFilteredMessage(
+          message, MessageProfiler::HandlerClockNow() - filter_start);
+    }
     if (message.dispatch_error()) {
       listener_task_runner_->PostTask(
           FROM_HERE, base::Bind(&Context::OnDispatchBadMessage, this, message));
@@ -88,6 +99,12 @@ bool ChannelProxy::Context::OnMessageReceived(const Message& message) {
 
 // Called on the IPC::Channel thread
 bool ChannelProxy::Context::OnMessageReceivedNoFilter(const Message& message) {
+  if (MessageProfiler::GetInstance()->enabled()) {
+    listener_task_runner_->PostTask(
+        FROM_HERE, base::Bind(&Context::OnDispatchQueuedMessage, this, message,
+                              base::TimeTicks::Now()));
+    return true;
+  }
   listener_task_runner_->PostTask(
       FROM_HERE, base::Bind(&Context::OnDispatchMessage, this, message));
   return true;
@@ -244,6 +261,19 @@ void ChannelProxy::Context::AddFilter(MessageFilter* filter) {
 
 // Called on the listener's thread
 void ChannelProxy::Context::OnDispatchMessage(const Message& message) {
+  DispatchToListener(message, base::TimeDelta());
+}
+
+// Called on the listener's thread
+void ChannelProxy::Context::OnDispatchQueuedMessage(
+    const Message& message,
+    base::TimeTicks queued_time) {
+  DispatchToListener(message, base::TimeTicks::Now() - queued_time);
+}
+
+// Called on the listener's thread
+void ChannelProxy::Context::DispatchToListener(const Message& message,
+                                               base::TimeDelta queue_time) {
 #ifdef IPC_MESSAGE_LOG_ENABLED
   Logging* logger = Logging::GetInstance();
   std::string name;
@@ -271,7 +301,20 @@ void ChannelProxy::Context::OnDispatchMessage(const Message& message) {
     logger->OnPreDispatchMessage(message);
 #endif
 
+  MessageProfiler* profiler = MessageProfiler::GetInstance();
+  bool profiling = profiler->enabled();
+  base::TimeTicks handler_start;
+  if (profiling)
+    handler_start = MessageProfiler::HandlerClockNow();
+
   listener_->OnMessageReceived(message);
+
+  if (profiling) {
+    profiler->RecordDispatchedMessage(
+        message, queue_time,
+        MessageProfiler::HandlerClockNow() - handler_start);
+  }
+
   if (message.dispatch_error())
     listener_->OnBadMessageReceived(message);
 
@@ -11,6 +11,7 @@
 #include "base/memory/scoped_ptr.h"
 #include "base/synchronization/lock.h"
 #include "base/threading/non_thread_safe.h"
+#include "base/time/time.h"
 #include "ipc/ipc_channel.h"
 #include "ipc/ipc_channel_handle.h"
 #include "ipc/ipc_listener.h"
@@ -193,6 +194,13 @@ class IPC_EXPORT ChannelProxy : public Sender, public base::NonThreadSafe {
     void OnDispatchError();
     void OnDispatchBadMessage(const Message& message);
 
+    // Like OnDispatchMessage, but also accounts for the time |message| spent
+    // queued since |queued_time| when the MessageProfiler is enabled.
+    void OnDispatchQueuedMessage(const Message& message,
+                                 base::TimeTicks queued_time);
+    void DispatchToListener(const Message& message,
+                            base::TimeDelta queue_time);
+
     scoped_refptr<base::SingleThreadTaskRunner> listener_task_runner_;
     Listener* listener_;
 
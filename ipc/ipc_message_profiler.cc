@@ -0,0 +1,152 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ipc/ipc_message_profiler.h"
+
+#include <algorithm>
+
+#include "base/debug/trace_event.h"
+#include "base/format_macros.h"
+#include "base/memory/singleton.h"
+#include "base/strings/stringprintf.h"
+#include "ipc/ipc_message.h"
+#include "ipc/ipc_message_macros.h"
+
+namespace IPC {
+
+namespace {
+
+const char kTraceCategory[] = TRACE_DISABLED_BY_DEFAULT("ipc.profiler");
+
+bool CompareByHandlerTime(const MessageProfile& a, const MessageProfile& b) {
+  if (a.total_handler_time != b.total_handler_time)
+    return a.total_handler_time > b.total_handler_time;
+  return a.type < b.type;
+}
+
+}  // namespace
+
+MessageProfile::MessageProfile()
+    : type(0),
+      count(0),
+      bytes(0),
+      filtered_count(0) {
+}
+
+// static
+MessageProfiler* MessageProfiler::GetInstance() {
+  return Singleton<MessageProfiler>::get();
+}
+
+MessageProfiler::MessageProfiler() : enabled_(0) {
+}
+
+MessageProfiler::~MessageProfiler() {
+}
+
+void MessageProfiler::Enable() {
+  base::subtle::NoBarrier_Store(&enabled_, 1);
+}
+
+void MessageProfiler::Disable() {
+  base::subtle::NoBarrier_Store(&enabled_, 0);
+}
+
+void MessageProfiler::Reset() {
+  base::AutoLock auto_lock(lock_);
+  profiles_.clear();
+}
+
+void MessageProfiler::RecordFilteredMessage(const Message& message,
+                                            base::TimeDelta handler_time) {
+  base::AutoLock auto_lock(lock_);
+  MessageProfile* profile = ProfileForMessage(message);
+  profile->filtered_count++;
+  profile->total_handler_time += handler_time;
+  profile->max_handler_time =
+      std::max(profile->max_handler_time, handler_time);
+  EmitTraceCounters(*profile);
+}
+
+void MessageProfiler::RecordDispatchedMessage(const Message& message,
+                                              base::TimeDelta queue_time,
+                                              base::TimeDelta handler_time) {
+  base::AutoLock auto_lock(lock_);
+  MessageProfile* profile = ProfileForMessage(message);
+  profile->total_queue_time += queue_time;
+  profile->max_queue_time = std::max(profile->max_queue_time, queue_time);
+  profile->total_handler_time += handler_time;
+  profile->max_handler_time =
+      std::max(profile->max_handler_time, handler_time);
+  EmitTraceCounters(*profile);
+}
+
+void MessageProfiler::GetProfiles(std::vector<MessageProfile>* profiles) const {
+  profiles->clear();
+  {
+    base::AutoLock auto_lock(lock_);
+    profiles->reserve(profiles_.size());
+    for (ProfileMap::const_iterator it = profiles_.begin();
+         it != profiles_.end(); ++it) {
+      profiles->push_back(it->second);
+    }
+  }
+  std::sort(profiles->begin(), profiles->end(), CompareByHandlerTime);
+}
+
+std::string MessageProfiler::DumpProfiles() const {
+  std::vector<MessageProfile> profiles;
+  GetProfiles(&profiles);
+
+  std::string result =
+      "class line    count filtered      bytes  queue_avg_us  queue_max_us"
+      "  handler_total_us  handler_max_us\n";
+  for (size_t i = 0; i < profiles.size(); ++i) {
+    const MessageProfile& profile = profiles[i];
+    int64 dispatched = profile.count - profile.filtered_count;
+    int64 queue_avg_us = dispatched ?
+        profile.total_queue_time.InMicroseconds() / dispatched : 0;
+    base::StringAppendF(
+        &result,
+        "%5u %4u %8" PRId64 " %8" PRId64 " %10" PRId64 " %13" PRId64
+        " %13" PRId64 " %17" PRId64 " %15" PRId64 "\n",
+        IPC_MESSAGE_ID_CLASS(profile.type),
+        IPC_MESSAGE_ID_LINE(profile.type),
+        profile.count,
+        profile.filtered_count,
+        profile.bytes,
+        queue_avg_us,
+        profile.max_queue_time.InMicroseconds(),
+        profile.total_handler_time.InMicroseconds(),
+        profile.max_handler_time.InMicroseconds());
+  }
+  return result;
+}
+
+// static
+base::TimeTicks MessageProfiler::HandlerClockNow() {
+  if (base::TimeTicks::IsThreadNowSupported())
+    return base::TimeTicks::ThreadNow();
+  return base::TimeTicks::Now();
+}
+
+MessageProfile* MessageProfiler::ProfileForMessage(const Message& message) {
+  lock_.AssertAcquired();
+  MessageProfile* profile = &profiles_[message.type()];
+  profile->type = message.type();
+  profile->count++;
+  profile->bytes += message.size();
+  return profile;
+}
+
+void MessageProfiler::EmitTraceCounters(const MessageProfile& profile) {
+  // The counter id is the message type, so each type gets its own track.
+  TRACE_COUNTER_ID2(kTraceCategory, "IPC::MessageProfile", profile.type,
+                    "count", profile.count,
+                    "bytes", profile.bytes);
+  TRACE_COUNTER_ID1(kTraceCategory, "IPC::MessageProfile::HandlerTimeUs",
+                    profile.type, profile.total_handler_time.InMicroseconds());
+}
+
+}  // namespace IPC
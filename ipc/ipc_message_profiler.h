@@ -0,0 +1,119 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef IPC_IPC_MESSAGE_PROFILER_H_
+#define IPC_IPC_MESSAGE_PROFILER_H_
+
+#include <string>
+#include <vector>
+
+#include "base/atomicops.h"
+#include "base/basictypes.h"
+#include "base/containers/hash_tables.h"
+#include "base/synchronization/lock.h"
+#include "base/time/time.h"
+#include "ipc/ipc_export.h"
+
+template <typename T> struct DefaultSingletonTraits;
+
+namespace IPC {
+
+class Message;
+
+// Accumulated cost of one message type.
+struct IPC_EXPORT MessageProfile {
+  MessageProfile();
+
+  uint32 type;
+
+  // Number of messages received and their total size in bytes, including
+  // headers.
+  int64 count;
+  int64 bytes;
+
+  // Number of the above that were handled by a MessageFilter on the IPC
+  // thread instead of being posted to the listener thread.
+  int64 filtered_count;
+
+  // Time between a message being posted by the IPC thread and its dispatch
+  // starting on the listener thread.
+  base::TimeDelta total_queue_time;
+  base::TimeDelta max_queue_time;
+
+  // Time spent in MessageFilter::OnMessageReceived() and
+  // Listener::OnMessageReceived(). This is thread CPU time where the platform
+  // supports it and wall time otherwise.
+  base::TimeDelta total_handler_time;
+  base::TimeDelta max_handler_time;
+};
+
+// Per-process accounting of received IPC messages, broken down by message
+// type. ChannelProxy feeds it from both the IPC thread (filter routing) and
+// the listener thread (dispatch). It is off by default; the hooks cost a
+// single atomic load while disabled.
+//
+// While the "disabled-by-default-ipc.profiler" trace category is being
+// recorded, the accumulated counts, bytes and handler time of each type are
+// also emitted as TraceLog counters.
+class IPC_EXPORT MessageProfiler {
+ public:
+  static MessageProfiler* GetInstance();
+
+  void Enable();
+  void Disable();
+  bool enabled() const {
+    return base::subtle::NoBarrier_Load(&enabled_) != 0;
+  }
+
+  // Discards all accumulated profiles.
+  void Reset();
+
+  // Called on the IPC thread when a MessageFilter consumed |message|.
+  void RecordFilteredMessage(const Message& message,
+                             base::TimeDelta handler_time);
+
+  // Called on the listener thread after |message| has been dispatched.
+  // |queue_time| is zero if the message was not queued, e.g. for sync
+  // messages dispatched while blocked in Send().
+  void RecordDispatchedMessage(const Message& message,
+                               base::TimeDelta queue_time,
+                               base::TimeDelta handler_time);
+
+  // Returns a snapshot of all profiles, most expensive (by total handler time)
+  // first.
+  void GetProfiles(std::vector<MessageProfile>* profiles) const;
+
+  // Returns a human readable table of the profiles, for about: pages and
+  // logs.
+  std::string DumpProfiles() const;
+
+  // Returns the clock used to time handlers: thread CPU time if supported,
+  // otherwise wall time.
+  static base::TimeTicks HandlerClockNow();
+
+ private:
+  friend struct DefaultSingletonTraits<MessageProfiler>;
+
+  typedef base::hash_map<uint32, MessageProfile> ProfileMap;
+
+  MessageProfiler();
+  ~MessageProfiler();
+
+  // Must be called with |lock_| held. Returns the profile for |message|
+  // after accounting for its count and size.
+  MessageProfile* ProfileForMessage(const Message& message);
+
+  void EmitTraceCounters(const MessageProfile& profile);
+
+  base::subtle::Atomic32 enabled_;
+
+  mutable base::Lock lock_;
+  ProfileMap profiles_;
+
+  DISALLOW_COPY_AND_ASSIGN(MessageProfiler);
+};
+
+}  // namespace IPC
+
+#endif  // IPC_IPC_MESSAGE_PROFILER_H_
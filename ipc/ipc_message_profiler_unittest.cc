@@ -0,0 +1,79 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ipc/ipc_message_profiler.h"
+
+#include <vector>
+
+#include "ipc/ipc_message.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace IPC {
+namespace {
+
+class MessageProfilerTest : public testing::Test {
+ public:
+  virtual void SetUp() OVERRIDE {
+    MessageProfiler::GetInstance()->Reset();
+  }
+
+  virtual void TearDown() OVERRIDE {
+    MessageProfiler::GetInstance()->Disable();
+    MessageProfiler::GetInstance()->Reset();
+  }
+};
+
+TEST_F(MessageProfilerTest, DisabledByDefault) {
+  EXPECT_FALSE(MessageProfiler::GetInstance()->enabled());
+  MessageProfiler::GetInstance()->Enable();
+  EXPECT_TRUE(MessageProfiler::GetInstance()->enabled());
+  MessageProfiler::GetInstance()->Disable();
+  EXPECT_FALSE(MessageProfiler::GetInstance()->enabled());
+}
+
+TEST_F(MessageProfilerTest, AccumulatesPerType) {
+  MessageProfiler* profiler = MessageProfiler::GetInstance();
+
+  Message small(0, 1, Message::PRIORITY_NORMAL);
+  Message large(0, 2, Message::PRIORITY_NORMAL);
+  large.WriteString(std::string(100, 'x'));
+
+  profiler->RecordDispatchedMessage(small,
+                                    base::TimeDelta::FromMicroseconds(10),
+                                    base::TimeDelta::FromMicroseconds(5));
+  profiler->RecordDispatchedMessage(small,
+                                    base::TimeDelta::FromMicroseconds(30),
+                                    base::TimeDelta::FromMicroseconds(7));
+  profiler->RecordFilteredMessage(large,
+                                  base::TimeDelta::FromMicroseconds(50));
+
+  std::vector<MessageProfile> profiles;
+  profiler->GetProfiles(&profiles);
+  ASSERT_EQ(2U, profiles.size());
+
+  // Sorted by total handler time, most expensive first.
+  EXPECT_EQ(2U, profiles[0].type);
+  EXPECT_EQ(1, profiles[0].count);
+  EXPECT_EQ(1, profiles[0].filtered_count);
+  EXPECT_EQ(static_cast<int64>(large.size()), profiles[0].bytes);
+  EXPECT_EQ(50, profiles[0].total_handler_time.InMicroseconds());
+
+  EXPECT_EQ(1U, profiles[1].type);
+  EXPECT_EQ(2, profiles[1].count);
+  EXPECT_EQ(0, profiles[1].filtered_count);
+  EXPECT_EQ(static_cast<int64>(2 * small.size()), profiles[1].bytes);
+  EXPECT_EQ(40, profiles[1].total_queue_time.InMicroseconds());
+  EXPECT_EQ(30, profiles[1].max_queue_time.InMicroseconds());
+  EXPECT_EQ(12, profiles[1].total_handler_time.InMicroseconds());
+  EXPECT_EQ(7, profiles[1].max_handler_time.InMicroseconds());
+
+  EXPECT_FALSE(profiler->DumpProfiles().empty());
+
+  profiler->Reset();
+  profiler->GetProfiles(&profiles);
+  EXPECT_TRUE(profiles.empty());
+}
+
+}  // namespace
+}  // namespace IPC
@@ -0,0 +1,79 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ipc/ipc_struct_member_reader.h"
+
+#include <string.h>
+
+#include "base/pickle.h"
+
+namespace IPC {
+
+namespace {
+
+// Pickle pads every value it writes to a multiple of this.
+const int kWireAlignment = sizeof(uint32);
+
+int AlignToWire(int size) {
+  return (size + kWireAlignment - 1) & ~(kWireAlignment - 1);
+}
+
+}  // namespace
+
+StructMemberReader::StructMemberReader(const Message* m, PickleIterator* iter)
+    : m_(m),
+      iter_(iter),
+      num_runs_(0),
+      pending_wire_size_(0) {
+}
+
+StructMemberReader::~StructMemberReader() {
+}
+
+bool StructMemberReader::AddFlatMember(char* dest, int size) {
+  int wire_size = AlignToWire(size);
+
+  // A member extends the previous run if it directly follows it in memory
+  // and neither has wire padding, since then the message bytes for the run
+  // are an exact image of the memory.
+  if (num_runs_ > 0) {
+    Run& last = runs_[num_runs_ - 1];
+    if (last.dest + last.size == dest && last.size == last.wire_size &&
+        size == wire_size) {
+      last.size += size;
+      last.wire_size += wire_size;
+      pending_wire_size_ += wire_size;
+      return true;
+    }
+  }
+
+  if (num_runs_ == kMaxRuns && !Flush())
+    return false;
+
+  Run& run = runs_[num_runs_++];
+  run.dest = dest;
+  run.size = size;
+  run.wire_size = wire_size;
+  pending_wire_size_ += wire_size;
+  return true;
+}
+
+bool StructMemberReader::Flush() {
+  if (!num_runs_)
+    return true;
+
+  const char* data;
+  bool result = iter_->ReadBytes(&data, pending_wire_size_);
+  if (result) {
+    for (int i = 0; i < num_runs_; ++i) {
+      memcpy(runs_[i].dest, data, runs_[i].size);
+      data += runs_[i].wire_size;
+    }
+  }
+  num_runs_ = 0;
+  pending_wire_size_ = 0;
+  return result;
+}
+
+}  // namespace IPC
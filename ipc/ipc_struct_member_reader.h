@@ -0,0 +1,106 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef IPC_IPC_STRUCT_MEMBER_READER_H_
+#define IPC_IPC_STRUCT_MEMBER_READER_H_
+
+#include "base/basictypes.h"
+#include "ipc/ipc_export.h"
+#include "ipc/ipc_message_utils.h"
+
+class PickleIterator;
+
+namespace IPC {
+
+class Message;
+
+namespace internal {
+
+// Member types whose ParamTraits write the raw bytes of the value, padded to
+// a multiple of four, and for which every bit pattern is a valid value. Such
+// members can be copied out of a message without any per-field validation.
+// bool and enums are deliberately absent since their values are checked on
+// read, as are long and unsigned long whose size differs between 32-bit and
+// 64-bit processes.
+template <typename T> struct IsFlatWireType { enum { value = false }; };
+template <> struct IsFlatWireType<unsigned char> { enum { value = true }; };
+template <> struct IsFlatWireType<unsigned short> { enum { value = true }; };
+template <> struct IsFlatWireType<int> { enum { value = true }; };
+template <> struct IsFlatWireType<unsigned int> { enum { value = true }; };
+template <> struct IsFlatWireType<long long> { enum { value = true }; };
+template <> struct IsFlatWireType<unsigned long long> {
+  enum { value = true };
+};
+template <> struct IsFlatWireType<float> { enum { value = true }; };
+template <> struct IsFlatWireType<double> { enum { value = true }; };
+
+}  // namespace internal
+
+// Reads the members of an IPC_STRUCT_TRAITS struct. The generated
+// ParamTraits<>::Read() uses this instead of calling ReadParam() for every
+// member.
+//
+// Runs of members with a flat wire representation (see IsFlatWireType) are
+// not read one by one. Instead the reader records where each one goes, and
+// when the run ends fetches the bytes for the whole run from the message with
+// a single bounds check. Members that are also adjacent in memory with no
+// padding in between are then copied with a single memcpy, which makes
+// reading structs of plain numeric fields (geometry, input events, frame
+// metadata) considerably cheaper.
+//
+// The wire format is the same as reading every member with ReadParam(), and
+// does not depend on the in-memory layout of the struct, so processes with
+// different struct layouts (e.g. 32-bit and 64-bit) still interoperate.
+class IPC_EXPORT StructMemberReader {
+ public:
+  StructMemberReader(const Message* m, PickleIterator* iter);
+  ~StructMemberReader();
+
+  template <typename T>
+  bool Read(T* member) {
+    return ReadMember(member, Bool<internal::IsFlatWireType<T>::value>());
+  }
+
+  // Reads all pending flat members. Must be called before anything else is
+  // read from the iterator, and after the last member.
+  bool Flush();
+
+ private:
+  template <bool B> struct Bool {};
+
+  // A span of destination memory that is filled from consecutive bytes of
+  // the message.
+  struct Run {
+    char* dest;
+    int size;       // Number of bytes to copy.
+    int wire_size;  // Number of bytes the run occupies in the message.
+  };
+
+  // Runs are merged when adjacent, so structs rarely need more than a few.
+  static const int kMaxRuns = 16;
+
+  template <typename T>
+  bool ReadMember(T* member, Bool<true>) {
+    return AddFlatMember(reinterpret_cast<char*>(member), sizeof(T));
+  }
+
+  template <typename T>
+  bool ReadMember(T* member, Bool<false>) {
+    return Flush() && ReadParam(m_, iter_, member);
+  }
+
+  bool AddFlatMember(char* dest, int size);
+
+  const Message* m_;
+  PickleIterator* iter_;
+  Run runs_[kMaxRuns];
+  int num_runs_;
+  int pending_wire_size_;
+
+  DISALLOW_COPY_AND_ASSIGN(StructMemberReader);
+};
+
+}  // namespace IPC
+
+#endif  // IPC_IPC_STRUCT_MEMBER_READER_H_
@@ -0,0 +1,139 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ipc/ipc_struct_member_reader.h"
+
+#include <string>
+
+#include "ipc/ipc_message.h"
+#include "ipc/ipc_message_utils.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace IPC {
+namespace {
+
+struct MixedStruct {
+  int a;
+  unsigned int b;
+  float c;
+  unsigned short d;
+  unsigned char e;
+  double f;
+  std::string g;
+  long long h;
+  bool i;
+  unsigned long long j;
+};
+
+void WriteMixedStruct(Message* m, const MixedStruct& s) {
+  WriteParam(m, s.a);
+  WriteParam(m, s.b);
+  WriteParam(m, s.c);
+  WriteParam(m, s.d);
+  WriteParam(m, s.e);
+  WriteParam(m, s.f);
+  WriteParam(m, s.g);
+  WriteParam(m, s.h);
+  WriteParam(m, s.i);
+  WriteParam(m, s.j);
+}
+
+bool ReadMixedStruct(const Message* m, PickleIterator* iter, MixedStruct* s) {
+  StructMemberReader reader(m, iter);
+  return reader.Read(&s->a) &&
+         reader.Read(&s->b) &&
+         reader.Read(&s->c) &&
+         reader.Read(&s->d) &&
+         reader.Read(&s->e) &&
+         reader.Read(&s->f) &&
+         reader.Read(&s->g) &&
+         reader.Read(&s->h) &&
+         reader.Read(&s->i) &&
+         reader.Read(&s->j) &&
+         reader.Flush();
+}
+
+MixedStruct MakeMixedStruct() {
+  MixedStruct s;
+  s.a = -17;
+  s.b = 0xdeadbeef;
+  s.c = 2.5f;
+  s.d = 0xbeef;
+  s.e = 0x7f;
+  s.f = -1.25;
+  s.g = "hello";
+  s.h = -1234567890123LL;
+  s.i = true;
+  s.j = 0x0123456789abcdefULL;
+  return s;
+}
+
+// The reader must understand exactly what member-by-member WriteParam()
+// produced, whatever the memory layout of the struct.
+TEST(StructMemberReaderTest, MatchesWriteParam) {
+  MixedStruct input = MakeMixedStruct();
+  Message m(0, 1, Message::PRIORITY_NORMAL);
+  WriteMixedStruct(&m, input);
+  m.WriteInt(42);
+
+  MixedStruct output;
+  PickleIterator iter(m);
+  ASSERT_TRUE(ReadMixedStruct(&m, &iter, &output));
+  EXPECT_EQ(input.a, output.a);
+  EXPECT_EQ(input.b, output.b);
+  EXPECT_EQ(input.c, output.c);
+  EXPECT_EQ(input.d, output.d);
+  EXPECT_EQ(input.e, output.e);
+  EXPECT_EQ(input.f, output.f);
+  EXPECT_EQ(input.g, output.g);
+  EXPECT_EQ(input.h, output.h);
+  EXPECT_EQ(input.i, output.i);
+  EXPECT_EQ(input.j, output.j);
+
+  // The iterator is left just past the struct.
+  int trailer;
+  EXPECT_TRUE(m.ReadInt(&iter, &trailer));
+  EXPECT_EQ(42, trailer);
+}
+
+TEST(StructMemberReaderTest, ManyAdjacentMembers) {
+  int input[40];
+  Message m(0, 1, Message::PRIORITY_NORMAL);
+  for (size_t i = 0; i < arraysize(input); ++i) {
+    input[i] = static_cast<int>(i * 3);
+    WriteParam(&m, input[i]);
+  }
+
+  // Read every other element so that no two members are adjacent and more
+  // runs are needed than the reader holds at once.
+  int output[80] = { 0 };
+  PickleIterator iter(m);
+  StructMemberReader reader(&m, &iter);
+  for (size_t i = 0; i < arraysize(input); ++i)
+    ASSERT_TRUE(reader.Read(&output[i * 2]));
+  ASSERT_TRUE(reader.Flush());
+  for (size_t i = 0; i < arraysize(input); ++i)
+    EXPECT_EQ(input[i], output[i * 2]);
+}
+
+TEST(StructMemberReaderTest, TruncatedMessage) {
+  MixedStruct input = MakeMixedStruct();
+  Message full(0, 1, Message::PRIORITY_NORMAL);
+  WriteMixedStruct(&full, input);
+
+  // Every strict prefix of the payload must be rejected.
+  for (size_t length = 0; length < full.payload_size(); length += 4) {
+    Message truncated(0, 1, Message::PRIORITY_NORMAL);
+    truncated.WriteBytes(full.payload(), static_cast<int>(length));
+    // WriteBytes() may pad; make sure the payload really is shorter.
+    ASSERT_LT(truncated.payload_size(), full.payload_size());
+
+    MixedStruct output;
+    PickleIterator iter(truncated);
+    EXPECT_FALSE(ReadMixedStruct(&truncated, &iter, &output)) << length;
+  }
+}
+
+}  // namespace
+}  // namespace IPC
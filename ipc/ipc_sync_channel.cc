@@ -4,14 +4,19 @@
 
 #include "ipc/ipc_sync_channel.h"
 
+#include <algorithm>
+
 #include "base/bind.h"
 #include "base/debug/trace_event.h"
 #include "base/lazy_instance.h"
 #include "base/location.h"
 #include "base/logging.h"
+#include "base/metrics/sparse_histogram.h"
 #include "base/synchronization/waitable_event.h"
 #include "base/synchronization/waitable_event_watcher.h"
+#include "base/sys_info.h"
 #include "base/thread_task_runner_handle.h"
+#include "base/threading/platform_thread.h"
 #include "base/threading/thread_local.h"
 #include "ipc/ipc_channel_factory.h"
 #include "ipc/ipc_logging.h"
@@ -23,6 +28,53 @@ using base::TimeTicks;
 using base::WaitableEvent;
 
 namespace IPC {
+
+namespace {
+
+// Sync sends slower than this have their message type recorded so that the
+// worst offenders can be found. The duration of every send, with its type, is
+// in the SyncChannel::Send trace event.
+const int64 kSlowSyncSendMilliseconds = 50;
+
+void RecordSyncSendTime(uint32 type, base::TimeDelta elapsed) {
+  if (elapsed.InMilliseconds() >= kSlowSyncSendMilliseconds)
+    UMA_HISTOGRAM_SPARSE_SLOWLY("IPC.SlowSyncSendMessageType", type);
+}
+
+}  // namespace
+
+#if !defined(COMPILER_MSVC)
+const int64 SyncReplySpinBudget::kMinSpinMicroseconds;
+const int64 SyncReplySpinBudget::kMaxSpinMicroseconds;
+const int SyncReplySpinBudget::kSpinProbeInterval;
+#endif
+
+SyncReplySpinBudget::SyncReplySpinBudget(bool can_spin)
+    : can_spin_(can_spin),
+      budget_us_(can_spin ? kMinSpinMicroseconds : 0),
+      blocking_waits_(0) {
+}
+
+void SyncReplySpinBudget::Update(bool spin_succeeded) {
+  if (!can_spin_)
+    return;
+  if (spin_succeeded) {
+    budget_us_ = std::min(kMaxSpinMicroseconds,
+                          std::max(kMinSpinMicroseconds, budget_us_ * 2));
+    return;
+  }
+  if (budget_us_ == 0) {
+    if (++blocking_waits_ == kSpinProbeInterval) {
+      blocking_waits_ = 0;
+      budget_us_ = kMinSpinMicroseconds;
+    }
+    return;
+  }
+  budget_us_ /= 2;
+  if (budget_us_ < kMinSpinMicroseconds)
+    budget_us_ = 0;
+}
+
 // When we're blocked in a Send(), we need to process incoming synchronous
 // messages right away because it could be blocking our reply (either
 // directly from the same object we're calling, or indirectly through one or
@@ -179,6 +231,10 @@ class SyncChannel::ReceivedSyncMsgQueue :
     top_send_done_watcher_ = watcher;
   }
 
+  // How long the listener thread polls for a sync reply before blocking.
+  // Only used on the listener thread.
+  SyncReplySpinBudget* spin_budget() { return &spin_budget_; }
+
  private:
   friend class base::RefCountedThreadSafe<ReceivedSyncMsgQueue>;
 
@@ -190,7 +246,8 @@ class SyncChannel::ReceivedSyncMsgQueue :
       listener_task_runner_(base::ThreadTaskRunnerHandle::Get()),
       task_pending_(false),
       listener_count_(0),
-      top_send_done_watcher_(NULL) {
+      top_send_done_watcher_(NULL),
+      spin_budget_(base::SysInfo::NumberOfProcessors() > 1) {
   }
 
   ~ReceivedSyncMsgQueue() {}
@@ -221,6 +278,8 @@ class SyncChannel::ReceivedSyncMsgQueue :
   // a local global stack of send done watchers to ensure that nested sync
   // message loops complete correctly.
   base::WaitableEventWatcher* top_send_done_watcher_;
+
+  SyncReplySpinBudget spin_budget_;
 };
 
 base::LazyInstance<base::ThreadLocalPointer<SyncChannel::ReceivedSyncMsgQueue> >
@@ -487,19 +546,56 @@ bool SyncChannel::Send(Message* message) {
   context->Push(sync_msg);
   WaitableEvent* pump_messages_event = sync_msg->pump_messages_event();
 
+  uint32 type = message->type();
+  base::TimeTicks start = base::TimeTicks::Now();
   ChannelProxy::Send(message);
 
   // Wait for reply, or for any other incoming synchronous messages.
   // *this* might get deleted, so only call static functions at this point.
   WaitForReply(context.get(), pump_messages_event);
 
+  RecordSyncSendTime(type, base::TimeTicks::Now() - start);
   return context->Pop();
 }
 
+bool SyncChannel::SpinForReply(SyncContext* context) {
+  SyncReplySpinBudget* spin_budget =
+      context->received_sync_msgs()->spin_budget();
+  base::TimeDelta budget = spin_budget->budget();
+  if (budget == base::TimeDelta()) {
+    // Still counts towards the next probe.
+    spin_budget->Update(false);
+    return false;
+  }
+
+  // Only the dispatch and send done events are polled: both are manual reset,
+  // so IsSignaled() leaves them set for the WaitMany() that follows. The pump
+  // messages event may be auto reset and is left to WaitMany().
+  WaitableEvent* dispatch_event = context->GetDispatchEvent();
+  WaitableEvent* send_done_event = context->GetSendDoneEvent();
+  base::TimeTicks deadline = base::TimeTicks::Now() + budget;
+  bool signaled = false;
+  while (true) {
+    if (send_done_event->IsSignaled() || dispatch_event->IsSignaled()) {
+      signaled = true;
+      break;
+    }
+    if (base::TimeTicks::Now() >= deadline)
+      break;
+    base::PlatformThread::YieldCurrentThread();
+  }
+  spin_budget->Update(signaled);
+  return signaled;
+}
+
 void SyncChannel::WaitForReply(
     SyncContext* context, WaitableEvent* pump_messages_event) {
   context->DispatchMessages();
   while (true) {
+    // Give a fast peer the chance to reply before paying for a sleep. If the
+    // spin succeeds WaitMany() below returns without blocking.
+    SpinForReply(context);
+
     WaitableEvent* objects[] = {
       context->GetDispatchEvent(),
       context->GetSendDoneEvent(),
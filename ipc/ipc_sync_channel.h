@@ -12,6 +12,7 @@
 #include "base/memory/ref_counted.h"
 #include "base/synchronization/lock.h"
 #include "base/synchronization/waitable_event_watcher.h"
+#include "base/time/time.h"
 #include "ipc/ipc_channel_handle.h"
 #include "ipc/ipc_channel_proxy.h"
 #include "ipc/ipc_sync_message.h"
@@ -25,6 +26,40 @@ namespace IPC {
 class SyncMessage;
 class ChannelFactory;
 
+// How long a thread polls for a sync reply before it blocks on the events.
+// Replies from a busy peer commonly arrive within a few microseconds, which
+// is far less than the cost of a futex sleep and wake-up, but spinning any
+// longer than kMaxSpinMicroseconds wastes a core. Exposed for testing.
+class IPC_EXPORT SyncReplySpinBudget {
+ public:
+  static const int64 kMinSpinMicroseconds = 5;
+  static const int64 kMaxSpinMicroseconds = 100;
+  // Once spinning keeps failing the budget decays to zero. After this many
+  // waits without spinning it probes again with kMinSpinMicroseconds, in case
+  // the peer has become faster.
+  static const int kSpinProbeInterval = 64;
+
+  // The budget stays zero if |can_spin| is false, e.g. on single core
+  // machines.
+  explicit SyncReplySpinBudget(bool can_spin);
+
+  base::TimeDelta budget() const {
+    return base::TimeDelta::FromMicroseconds(budget_us_);
+  }
+
+  // Called after every wait for a reply, with whether the reply arrived while
+  // spinning. Successful spins grow the budget up to kMaxSpinMicroseconds;
+  // misses halve it, so a thread whose peer is slow quickly goes back to
+  // blocking.
+  void Update(bool spin_succeeded);
+
+ private:
+  bool can_spin_;
+  int64 budget_us_;
+  // Waits since the budget reached zero.
+  int blocking_waits_;
+};
+
 // This is similar to ChannelProxy, with the added feature of supporting sending
 // synchronous messages.
 //
@@ -216,6 +251,11 @@ class IPC_EXPORT SyncChannel : public ChannelProxy {
   static void WaitForReply(
       SyncContext* context, base::WaitableEvent* pump_messages_event);
 
+  // Polls for the reply, or an incoming sync message, for the adaptive spin
+  // budget of the current thread. Returns true if one arrived, in which case
+  // waiting on the events will not block.
+  static bool SpinForReply(SyncContext* context);
+
   // Runs a nested message loop until a reply arrives, times out, or the process
   // shuts down.
   static void WaitForReplyWithNestedMessageLoop(SyncContext* context);
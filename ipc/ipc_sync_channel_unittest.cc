@@ -1791,5 +1791,65 @@ TEST_F(IPCSyncChannelTest, Verified) {
   Verified();
 }
 
+//------------------------------------------------------------------------------
+
+base::TimeDelta DecaySpinBudgetToZero(SyncReplySpinBudget* spin_budget) {
+  for (int i = 0; i < 10 && spin_budget->budget() != base::TimeDelta(); ++i)
+    spin_budget->Update(false);
+  return spin_budget->budget();
+}
+
+TEST(SyncReplySpinBudgetTest, GrowsOnSuccessAndDecaysOnMisses) {
+  SyncReplySpinBudget spin_budget(true);
+  EXPECT_EQ(SyncReplySpinBudget::kMinSpinMicroseconds,
+            spin_budget.budget().InMicroseconds());
+
+  for (int i = 0; i < 10; ++i)
+    spin_budget.Update(true);
+  EXPECT_EQ(SyncReplySpinBudget::kMaxSpinMicroseconds,
+            spin_budget.budget().InMicroseconds());
+
+  spin_budget.Update(false);
+  EXPECT_EQ(SyncReplySpinBudget::kMaxSpinMicroseconds / 2,
+            spin_budget.budget().InMicroseconds());
+  EXPECT_EQ(base::TimeDelta(), DecaySpinBudgetToZero(&spin_budget));
+}
+
+TEST(SyncReplySpinBudgetTest, ProbesAfterBlockingWaits) {
+  SyncReplySpinBudget spin_budget(true);
+  ASSERT_EQ(base::TimeDelta(), DecaySpinBudgetToZero(&spin_budget));
+
+  for (int i = 0; i < SyncReplySpinBudget::kSpinProbeInterval; ++i) {
+    EXPECT_EQ(base::TimeDelta(), spin_budget.budget());
+    spin_budget.Update(false);
+  }
+  EXPECT_EQ(SyncReplySpinBudget::kMinSpinMicroseconds,
+            spin_budget.budget().InMicroseconds());
+
+  // A failed probe goes back to blocking, for another interval.
+  spin_budget.Update(false);
+  EXPECT_EQ(base::TimeDelta(), spin_budget.budget());
+  for (int i = 0; i < SyncReplySpinBudget::kSpinProbeInterval - 1; ++i)
+    spin_budget.Update(false);
+  EXPECT_EQ(base::TimeDelta(), spin_budget.budget());
+  spin_budget.Update(false);
+  EXPECT_EQ(SyncReplySpinBudget::kMinSpinMicroseconds,
+            spin_budget.budget().InMicroseconds());
+
+  // A successful probe starts spinning again.
+  spin_budget.Update(true);
+  EXPECT_EQ(2 * SyncReplySpinBudget::kMinSpinMicroseconds,
+            spin_budget.budget().InMicroseconds());
+}
+
+TEST(SyncReplySpinBudgetTest, NeverSpinsWhenDisabled) {
+  SyncReplySpinBudget spin_budget(false);
+  for (int i = 0; i < 2 * SyncReplySpinBudget::kSpinProbeInterval; ++i) {
+    EXPECT_EQ(base::TimeDelta(), spin_budget.budget());
+    spin_budget.Update(i % 2 == 0);
+  }
+  EXPECT_EQ(base::TimeDelta(), spin_budget.budget());
+}
+
 }  // namespace
 }  // namespace IPC
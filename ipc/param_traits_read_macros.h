@@ -7,6 +7,7 @@
 
 // Null out all the macros that need nulling.
 #include "ipc/ipc_message_null_macros.h"
+#include "ipc/ipc_struct_member_reader.h"
 
 // STRUCT declarations cause corresponding STRUCT_TRAITS declarations to occur.
 #undef IPC_STRUCT_BEGIN_WITH_PARENT
@@ -25,10 +26,12 @@
 #define IPC_STRUCT_TRAITS_BEGIN(struct_name) \
   bool ParamTraits<struct_name>:: \
       Read(const Message* m, PickleIterator* iter, param_type* p) { \
+    IPC::StructMemberReader reader(m, iter); \
     return
-#define IPC_STRUCT_TRAITS_MEMBER(name) ReadParam(m, iter, &p->name) &&
-#define IPC_STRUCT_TRAITS_PARENT(type) ParamTraits<type>::Read(m, iter, p) &&
-#define IPC_STRUCT_TRAITS_END() 1; }
+#define IPC_STRUCT_TRAITS_MEMBER(name) reader.Read(&p->name) &&
+#define IPC_STRUCT_TRAITS_PARENT(type) \
+    reader.Flush() && ParamTraits<type>::Read(m, iter, p) &&
+#define IPC_STRUCT_TRAITS_END() reader.Flush(); }
 
 #undef IPC_ENUM_TRAITS_VALIDATE
 #define IPC_ENUM_TRAITS_VALIDATE(enum_name, validation_expression)    \
@@ -0,0 +1,78 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef MOJO_PUBLIC_CPP_BINDINGS_ARRAY_VIEW_H_
+#define MOJO_PUBLIC_CPP_BINDINGS_ARRAY_VIEW_H_
+
+#include <stddef.h>
+
+#include "mojo/public/cpp/bindings/lib/array_internal.h"
+#include "mojo/public/cpp/bindings/lib/bindings_internal.h"
+#include "mojo/public/cpp/bindings/string_view.h"
+
+namespace mojo {
+
+// ArrayView is a read-only view of an array that lives inside a received
+// message. It is meant for handlers that only inspect their arguments:
+// deserializing into an ArrayView does not rebuild an Array<T>, so no memory
+// is allocated and no elements are copied. The view is only valid for as long
+// as the message it was deserialized from.
+//
+// Elements are exposed in their wire representation, e.g. an
+// ArrayView<String> yields StringViews and an ArrayView<SomeStructPtr> yields
+// pointers to the serialized struct data. Arrays of handles cannot be viewed,
+// since the receiver must take ownership of the handles.
+template <typename T>
+class ArrayView {
+ public:
+  typedef typename internal::WrapperTraits<T>::DataType DataType;
+  typedef internal::Array_Data<DataType> Data;
+  typedef typename Data::ConstRef ConstRefType;
+  typedef typename Data::StorageType StorageType;
+
+  MOJO_COMPILE_ASSERT(!internal::IsHandle<DataType>::value,
+                      handle_arrays_cannot_be_viewed);
+
+  ArrayView() : data_(NULL) {}
+  explicit ArrayView(const Data* data) : data_(data) {}
+
+  bool is_null() const { return !data_; }
+
+  size_t size() const { return data_ ? data_->size() : 0; }
+
+  ConstRefType at(size_t offset) const { return data_->at(offset); }
+  ConstRefType operator[](size_t offset) const { return at(offset); }
+
+  // Raw access to the elements. For POD element types this is a contiguous
+  // array of |size()| elements that may be read directly.
+  const StorageType* storage() const {
+    return data_ ? data_->storage() : NULL;
+  }
+
+ private:
+  const Data* data_;
+};
+
+template <>
+class ArrayView<String> {
+ public:
+  typedef internal::Array_Data<internal::String_Data*> Data;
+
+  ArrayView() : data_(NULL) {}
+  explicit ArrayView(const Data* data) : data_(data) {}
+
+  bool is_null() const { return !data_; }
+
+  size_t size() const { return data_ ? data_->size() : 0; }
+
+  StringView at(size_t offset) const { return StringView(data_->at(offset)); }
+  StringView operator[](size_t offset) const { return at(offset); }
+
+ private:
+  const Data* data_;
+};
+
+}  // namespace mojo
+
+#endif  // MOJO_PUBLIC_CPP_BINDINGS_ARRAY_VIEW_H_
@@ -10,6 +10,7 @@
 #include <vector>
 
 #include "mojo/public/c/system/macros.h"
+#include "mojo/public/cpp/bindings/array_view.h"
 #include "mojo/public/cpp/bindings/lib/array_internal.h"
 #include "mojo/public/cpp/bindings/lib/string_serialization.h"
 #include "mojo/public/cpp/bindings/lib/template_util.h"
@@ -31,6 +32,9 @@ inline void SerializeArray_(Array<E> input, internal::Buffer* buf,
 template <typename E, typename F>
 inline void Deserialize_(internal::Array_Data<F>* data, Array<E>* output);
 
+template <typename E, typename F>
+inline void Deserialize_(internal::Array_Data<F>* data, ArrayView<E>* output);
+
 namespace internal {
 
 template <typename E, typename F, bool move_only = IsMoveOnlyType<E>::value>
@@ -50,12 +54,14 @@ template <typename E, typename F> struct ArraySerializer<E, F, false> {
         (IsSame<ElementValidateParams, NoValidateParams>::value),
         Primitive_type_should_not_have_array_validate_params);
 
-    memcpy(output->storage(), &input.storage()[0], input.size() * sizeof(E));
+    if (input.size())
+      memcpy(output->storage(), &input.storage()[0], input.size() * sizeof(E));
   }
   static void DeserializeElements(
       Array_Data<F>* input, Array<E>* output) {
     std::vector<E> result(input->size());
-    memcpy(&result[0], input->storage(), input->size() * sizeof(E));
+    if (input->size())
+      memcpy(&result[0], input->storage(), input->size() * sizeof(E));
     output->Swap(&result);
   }
 };
@@ -73,16 +79,28 @@ template <> struct ArraySerializer<bool, bool, false> {
         (IsSame<ElementValidateParams, NoValidateParams>::value),
         Primitive_type_should_not_have_array_validate_params);
 
-    // TODO(darin): Can this be a memcpy somehow instead of a bit-by-bit copy?
-    for (size_t i = 0; i < input.size(); ++i)
-      output->at(i) = input[i];
+    // Pack a byte at a time rather than going through BitRef, which does a
+    // read-modify-write of the destination byte for every element. The
+    // storage is zero-filled by the buffer, so trailing bits stay clear.
+    uint8_t* storage = output->storage();
+    const size_t size = input.size();
+    for (size_t i = 0; i < size; i += 8) {
+      const size_t end = size - i < 8 ? size : i + 8;
+      uint8_t byte = 0;
+      for (size_t j = i; j < end; ++j) {
+        if (input[j])
+          byte |= static_cast<uint8_t>(1 << (j - i));
+      }
+      storage[i / 8] = byte;
+    }
   }
   static void DeserializeElements(
       Array_Data<bool>* input, Array<bool>* output) {
-    Array<bool> result(input->size());
-    // TODO(darin): Can this be a memcpy somehow instead of a bit-by-bit copy?
-    for (size_t i = 0; i < input->size(); ++i)
-      result.at(i) = input->at(i);
+    const size_t size = input->size();
+    std::vector<bool> result(size);
+    const uint8_t* storage = input->storage();
+    for (size_t i = 0; i < size; ++i)
+      result[i] = (storage[i / 8] & (1 << (i % 8))) != 0;
     output->Swap(&result);
   }
 };
@@ -257,6 +275,12 @@ inline void Deserialize_(internal::Array_Data<F>* input, Array<E>* output) {
   }
 }
 
+template <typename E, typename F>
+inline void Deserialize_(internal::Array_Data<F>* input,
+                         ArrayView<E>* output) {
+  *output = ArrayView<E>(input);
+}
+
 }  // namespace mojo
 
 #endif  // MOJO_PUBLIC_CPP_BINDINGS_LIB_ARRAY_SERIALIZATION_H_
@@ -7,6 +7,7 @@
 
 #include "mojo/public/cpp/bindings/lib/array_internal.h"
 #include "mojo/public/cpp/bindings/string.h"
+#include "mojo/public/cpp/bindings/string_view.h"
 
 namespace mojo {
 
@@ -15,6 +16,11 @@ void Serialize_(const String& input, internal::Buffer* buffer,
                 internal::String_Data** output);
 void Deserialize_(internal::String_Data* input, String* output);
 
+// Does not copy; |output| refers to the characters inside |input|.
+inline void Deserialize_(internal::String_Data* input, StringView* output) {
+  *output = StringView(input);
+}
+
 }  // namespace mojo
 
 #endif  // MOJO_PUBLIC_CPP_BINDINGS_LIB_STRING_SERIALIZATION_H_
@@ -0,0 +1,70 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef MOJO_PUBLIC_CPP_BINDINGS_STRING_VIEW_H_
+#define MOJO_PUBLIC_CPP_BINDINGS_STRING_VIEW_H_
+
+#include <string.h>
+
+#include <string>
+
+#include "mojo/public/cpp/bindings/lib/array_internal.h"
+#include "mojo/public/cpp/bindings/string.h"
+
+namespace mojo {
+
+// StringView is a read-only view of a string that lives inside a received
+// message. Unlike String, deserializing into a StringView does not copy the
+// characters; the view is only valid for as long as the message it was
+// deserialized from.
+class StringView {
+ public:
+  StringView() : data_(NULL) {}
+  explicit StringView(const internal::String_Data* data) : data_(data) {}
+
+  bool is_null() const { return !data_; }
+
+  size_t size() const { return data_ ? data_->size() : 0; }
+
+  // Note: the returned characters are not NUL-terminated.
+  const char* data() const { return data_ ? data_->storage() : NULL; }
+
+  const char& operator[](size_t offset) const {
+    MOJO_DCHECK(offset < size());
+    return data_->storage()[offset];
+  }
+
+  // Copies the characters out of the message.
+  String ToString() const {
+    return data_ ? String(data(), size()) : String();
+  }
+
+ private:
+  const internal::String_Data* data_;
+};
+
+inline bool operator==(const StringView& a, const StringView& b) {
+  return a.is_null() == b.is_null() && a.size() == b.size() &&
+         memcmp(a.data(), b.data(), a.size()) == 0;
+}
+inline bool operator==(const StringView& a, const std::string& b) {
+  return !a.is_null() && a.size() == b.size() &&
+         memcmp(a.data(), b.data(), a.size()) == 0;
+}
+inline bool operator==(const std::string& a, const StringView& b) {
+  return b == a;
+}
+inline bool operator!=(const StringView& a, const StringView& b) {
+  return !(a == b);
+}
+inline bool operator!=(const StringView& a, const std::string& b) {
+  return !(a == b);
+}
+inline bool operator!=(const std::string& a, const StringView& b) {
+  return !(a == b);
+}
+
+}  // namespace mojo
+
+#endif  // MOJO_PUBLIC_CPP_BINDINGS_STRING_VIEW_H_
@@ -3,6 +3,7 @@
 // found in the LICENSE file.
 
 #include "mojo/public/cpp/bindings/array.h"
+#include "mojo/public/cpp/bindings/array_view.h"
 #include "mojo/public/cpp/bindings/lib/array_internal.h"
 #include "mojo/public/cpp/bindings/lib/array_serialization.h"
 #include "mojo/public/cpp/bindings/lib/fixed_buffer.h"
@@ -237,6 +238,102 @@ TEST_F(ArrayTest, Serialization_ArrayOfString) {
   }
 }
 
+TEST_F(ArrayTest, Serialization_EmptyArrayOfPOD) {
+  Array<int32_t> array(0);
+
+  size_t size = GetSerializedSize_(array);
+  EXPECT_EQ(8U, size);
+
+  internal::FixedBuffer buf(size);
+  internal::Array_Data<int32_t>* data;
+  SerializeArray_<internal::ArrayValidateParams<0, false,
+                  internal::NoValidateParams> >(
+      array.Pass(), &buf, &data);
+
+  Array<int32_t> array2;
+  Deserialize_(data, &array2);
+
+  EXPECT_FALSE(array2.is_null());
+  EXPECT_EQ(0U, array2.size());
+}
+
+TEST_F(ArrayTest, Serialization_ArrayViewOfPOD) {
+  Array<int32_t> array(4);
+  for (size_t i = 0; i < array.size(); ++i)
+    array[i] = static_cast<int32_t>(i);
+
+  internal::FixedBuffer buf(GetSerializedSize_(array));
+  internal::Array_Data<int32_t>* data;
+  SerializeArray_<internal::ArrayValidateParams<0, false,
+                  internal::NoValidateParams> >(
+      array.Pass(), &buf, &data);
+
+  ArrayView<int32_t> view;
+  Deserialize_(data, &view);
+
+  // The view refers to the serialized storage rather than a copy of it.
+  EXPECT_FALSE(view.is_null());
+  EXPECT_EQ(4U, view.size());
+  EXPECT_EQ(data->storage(), view.storage());
+  for (size_t i = 0; i < view.size(); ++i)
+    EXPECT_EQ(static_cast<int32_t>(i), view[i]);
+
+  ArrayView<int32_t> null_view;
+  Deserialize_(static_cast<internal::Array_Data<int32_t>*>(NULL), &null_view);
+  EXPECT_TRUE(null_view.is_null());
+  EXPECT_EQ(0U, null_view.size());
+}
+
+TEST_F(ArrayTest, Serialization_ArrayViewOfBool) {
+  Array<bool> array(10);
+  for (size_t i = 0; i < array.size(); ++i)
+    array[i] = i % 3 ? true : false;
+
+  internal::FixedBuffer buf(GetSerializedSize_(array));
+  internal::Array_Data<bool>* data;
+  SerializeArray_<internal::ArrayValidateParams<0, false,
+                  internal::NoValidateParams> >(
+      array.Pass(), &buf, &data);
+
+  ArrayView<bool> view;
+  Deserialize_(data, &view);
+
+  EXPECT_EQ(10U, view.size());
+  for (size_t i = 0; i < view.size(); ++i)
+    EXPECT_EQ(i % 3 ? true : false, view[i]);
+}
+
+TEST_F(ArrayTest, Serialization_ArrayViewOfString) {
+  Array<String> array(10);
+  for (size_t i = 0; i < array.size(); ++i) {
+    char c = 'A' + static_cast<char>(i);
+    array[i] = String(&c, 1);
+  }
+  array[3] = String();
+
+  internal::FixedBuffer buf(GetSerializedSize_(array));
+  internal::Array_Data<internal::String_Data*>* data;
+  SerializeArray_<internal::ArrayValidateParams<0, true,
+                  internal::ArrayValidateParams<0, false,
+                  internal::NoValidateParams> > >(
+      array.Pass(), &buf, &data);
+
+  ArrayView<String> view;
+  Deserialize_(data, &view);
+
+  EXPECT_EQ(10U, view.size());
+  for (size_t i = 0; i < view.size(); ++i) {
+    if (i == 3) {
+      EXPECT_TRUE(view[i].is_null());
+      continue;
+    }
+    char c = 'A' + static_cast<char>(i);
+    EXPECT_EQ(std::string(&c, 1), view[i]);
+    EXPECT_EQ(data->at(i)->storage(), view[i].data());
+    EXPECT_EQ(String(&c, 1), view[i].ToString());
+  }
+}
+
 TEST_F(ArrayTest, Resize_Copyable) {
   ASSERT_EQ(0u, CopyableType::num_instances());
   mojo::Array<CopyableType> array(3);
@@ -359,6 +359,8 @@ PassPtr TypeConverter<PassPtr, cc::RenderPass>::Convert(
       input.shared_quad_state_list.size());
   int sqs_i = -1;
   const cc::SharedQuadState* last_sqs = NULL;
+  cc::SharedQuadStateList::ConstIterator sqs_iter =
+      input.shared_quad_state_list.begin();
   size_t i = 0;
   for (cc::QuadList::ConstIterator iter = input.quad_list.begin();
        iter != input.quad_list.end();
@@ -366,9 +368,10 @@ PassPtr TypeConverter<PassPtr, cc::RenderPass>::Convert(
     const cc::DrawQuad& quad = *iter;
     quads[i] = Quad::From(quad);
     if (quad.shared_quad_state != last_sqs) {
+      if (sqs_i >= 0)
+        ++sqs_iter;
       sqs_i++;
-      shared_quad_state[sqs_i] =
-          SharedQuadState::From(*input.shared_quad_state_list[sqs_i]);
+      shared_quad_state[sqs_i] = SharedQuadState::From(*sqs_iter);
       last_sqs = quad.shared_quad_state;
     }
     quads[i]->shared_quad_state_index = sqs_i;
@@ -385,23 +388,22 @@ PassPtr TypeConverter<PassPtr, cc::RenderPass>::Convert(
 scoped_ptr<cc::RenderPass>
 TypeConverter<scoped_ptr<cc::RenderPass>, PassPtr>::Convert(
     const PassPtr& input) {
-  // TODO(weiliangc): RenderPass will have a constructor that takes in preset
-  // size of quad list and shared quad state list size in upcoming CL.
-  scoped_ptr<cc::RenderPass> pass = cc::RenderPass::Create();
+  scoped_ptr<cc::RenderPass> pass = cc::RenderPass::Create(
+      input->shared_quad_states.size(), input->quads.size());
   pass->SetAll(cc::RenderPassId(1, input->id),
                input->output_rect.To<gfx::Rect>(),
                input->damage_rect.To<gfx::Rect>(),
                input->transform_to_root_target.To<gfx::Transform>(),
                input->has_transparent_background);
   cc::SharedQuadStateList& sqs_list = pass->shared_quad_state_list;
-  sqs_list.reserve(input->shared_quad_states.size());
   for (size_t i = 0; i < input->shared_quad_states.size(); ++i) {
     ConvertSharedQuadState(input->shared_quad_states[i], pass.get());
   }
   for (size_t i = 0; i < input->quads.size(); ++i) {
     QuadPtr quad = input->quads[i].Pass();
-    if (!ConvertDrawQuad(
-            quad, sqs_list[quad->shared_quad_state_index], pass.get()))
+    if (!ConvertDrawQuad(quad,
+                         sqs_list.ElementAt(quad->shared_quad_state_index),
+                         pass.get()))
       return scoped_ptr<cc::RenderPass>();
   }
   return pass.Pass();
@@ -77,7 +77,8 @@ namespace system {
 
 // TODO(vtl): This should take a |scoped_ptr<PlatformSupport>| as a parameter.
 Core::Core(scoped_ptr<embedder::PlatformSupport> platform_support)
-    : platform_support_(platform_support.Pass()) {
+    : platform_support_(platform_support.Pass()),
+      shared_buffer_pool_(new SharedBufferPool(platform_support_.get())) {
 }
 
 Core::~Core() {
@@ -467,7 +468,7 @@ MojoResult Core::CreateSharedBuffer(
 
   scoped_refptr<SharedBufferDispatcher> dispatcher;
   result = SharedBufferDispatcher::Create(
-      platform_support(), validated_options, num_bytes, &dispatcher);
+      shared_buffer_pool(), validated_options, num_bytes, &dispatcher);
   if (result != MOJO_RESULT_OK) {
     DCHECK(!dispatcher.get());
     return result;
@@ -18,6 +18,7 @@
 #include "mojo/system/handle_table.h"
 #include "mojo/system/mapping_table.h"
 #include "mojo/system/memory.h"
+#include "mojo/system/shared_buffer_pool.h"
 #include "mojo/system/system_impl_export.h"
 
 namespace mojo {
@@ -53,6 +54,11 @@ class MOJO_SYSTEM_IMPL_EXPORT Core {
     return platform_support_.get();
   }
 
+  // The pool that shared buffers created by |CreateSharedBuffer()| come from.
+  SharedBufferPool* shared_buffer_pool() const {
+    return shared_buffer_pool_.get();
+  }
+
   // ---------------------------------------------------------------------------
 
   // System calls implementation:
@@ -138,6 +144,9 @@ class MOJO_SYSTEM_IMPL_EXPORT Core {
                               HandleSignalsState* signals_states);
 
   const scoped_ptr<embedder::PlatformSupport> platform_support_;
+  // Wraps |platform_support_|. (Buffers it has handed out may keep it alive
+  // beyond us, but they don't use |platform_support_|.)
+  const scoped_refptr<SharedBufferPool> shared_buffer_pool_;
 
   // TODO(vtl): |handle_table_lock_| should be a reader-writer lock (if only we
   // had them).
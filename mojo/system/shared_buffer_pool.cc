@@ -0,0 +1,371 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "mojo/system/shared_buffer_pool.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <set>
+
+#include "base/logging.h"
+#include "mojo/embedder/platform_shared_buffer.h"
+
+namespace mojo {
+namespace system {
+
+// SharedBufferPool::PooledSharedBuffer ----------------------------------------
+
+// The |PlatformSharedBuffer| handed out by the pool. It presents exactly the
+// requested number of bytes, and gives its storage back to the pool when
+// destroyed.
+class SharedBufferPool::PooledSharedBuffer
+    : public embedder::PlatformSharedBuffer {
+ public:
+  PooledSharedBuffer(SharedBufferPool* pool,
+                     scoped_ptr<Storage> storage,
+                     size_t num_bytes)
+      : pool_(pool),
+        storage_(storage.Pass()),
+        num_bytes_(num_bytes),
+        escaped_(false),
+        dirty_num_bytes_(0) {
+    DCHECK(storage_);
+    DCHECK_LE(num_bytes_, storage_->mapping->GetLength());
+  }
+
+  // |embedder::PlatformSharedBuffer| implementation:
+  virtual size_t GetNumBytes() const OVERRIDE { return num_bytes_; }
+
+  virtual scoped_ptr<embedder::PlatformSharedBufferMapping> Map(
+      size_t offset,
+      size_t length) OVERRIDE {
+    if (!IsValidMap(offset, length))
+      return scoped_ptr<embedder::PlatformSharedBufferMapping>();
+
+    return MapNoCheck(offset, length);
+  }
+
+  virtual bool IsValidMap(size_t offset, size_t length) OVERRIDE {
+    if (offset > num_bytes_ || length == 0)
+      return false;
+
+    // Note: This is an overflow-safe check of |offset + length > num_bytes_|
+    // (that |num_bytes >= offset| is verified above).
+    if (length > num_bytes_ - offset)
+      return false;
+
+    return true;
+  }
+
+  virtual scoped_ptr<embedder::PlatformSharedBufferMapping> MapNoCheck(
+      size_t offset,
+      size_t length) OVERRIDE;
+
+  virtual embedder::ScopedPlatformHandle DuplicatePlatformHandle() OVERRIDE {
+    MarkEscaped();
+    return storage_->buffer->DuplicatePlatformHandle();
+  }
+
+  virtual embedder::ScopedPlatformHandle PassPlatformHandle() OVERRIDE {
+    // The storage's buffer may still be referenced by the pool's mapping, so
+    // hand out a duplicate; the original is closed when the storage is
+    // destroyed.
+    MarkEscaped();
+    return storage_->buffer->DuplicatePlatformHandle();
+  }
+
+ private:
+  virtual ~PooledSharedBuffer() {
+    bool recyclable;
+    size_t dirty_num_bytes;
+    {
+      base::AutoLock locker(lock_);
+      recyclable = !escaped_;
+      dirty_num_bytes = dirty_num_bytes_;
+    }
+    pool_->ReleaseStorage(storage_.Pass(), dirty_num_bytes, recyclable);
+  }
+
+  friend class PooledSharedBufferMapping;
+
+  void MarkEscaped() {
+    base::AutoLock locker(lock_);
+    escaped_ = true;
+  }
+
+  // Called by |PooledSharedBufferMapping| when a mapping obtained from the
+  // storage's persistent mapping goes away.
+  void RemoveMappedOffset(size_t offset) {
+    base::AutoLock locker(lock_);
+    DCHECK(mapped_offsets_.find(offset) != mapped_offsets_.end());
+    mapped_offsets_.erase(offset);
+  }
+
+  const scoped_refptr<SharedBufferPool> pool_;
+  scoped_ptr<Storage> storage_;
+  const size_t num_bytes_;
+
+  base::Lock lock_;  // Protects the following members.
+  // Set once the platform handle has been handed out, after which the storage
+  // may be referenced outside this process and must not be reused.
+  bool escaped_;
+  // Offsets of outstanding mappings that point into the persistent mapping.
+  // Mappings are identified by their base address, so a second mapping at the
+  // same offset gets a fresh mapping of its own instead.
+  std::set<size_t> mapped_offsets_;
+  // The end of the furthest range that has been mapped. Nothing past it can
+  // have been written to.
+  size_t dirty_num_bytes_;
+
+  DISALLOW_COPY_AND_ASSIGN(PooledSharedBuffer);
+};
+
+// SharedBufferPool::PooledSharedBufferMapping ---------------------------------
+
+// A mapping of part of a |PooledSharedBuffer|. Usually this just points into
+// the storage's persistent mapping, but it may own a separate mapping (see
+// |PooledSharedBuffer::mapped_offsets_|). Either way it keeps the buffer, and
+// thus its storage, alive.
+class SharedBufferPool::PooledSharedBufferMapping
+    : public embedder::PlatformSharedBufferMapping {
+ public:
+  // Points into the persistent mapping.
+  PooledSharedBufferMapping(PooledSharedBuffer* buffer,
+                            size_t offset,
+                            void* base,
+                            size_t length)
+      : buffer_(buffer), offset_(offset), base_(base), length_(length) {}
+
+  // Wraps a separate mapping.
+  PooledSharedBufferMapping(
+      PooledSharedBuffer* buffer,
+      scoped_ptr<embedder::PlatformSharedBufferMapping> mapping)
+      : buffer_(buffer),
+        offset_(0),
+        base_(mapping->GetBase()),
+        length_(mapping->GetLength()),
+        mapping_(mapping.Pass()) {}
+
+  virtual ~PooledSharedBufferMapping() {
+    if (!mapping_)
+      buffer_->RemoveMappedOffset(offset_);
+  }
+
+  virtual void* GetBase() const OVERRIDE { return base_; }
+  virtual size_t GetLength() const OVERRIDE { return length_; }
+
+ private:
+  const scoped_refptr<PooledSharedBuffer> buffer_;
+  const size_t offset_;
+  void* const base_;
+  const size_t length_;
+  scoped_ptr<embedder::PlatformSharedBufferMapping> mapping_;
+
+  DISALLOW_COPY_AND_ASSIGN(PooledSharedBufferMapping);
+};
+
+scoped_ptr<embedder::PlatformSharedBufferMapping>
+SharedBufferPool::PooledSharedBuffer::MapNoCheck(size_t offset, size_t length) {
+  DCHECK(IsValidMap(offset, length));
+
+  bool inserted;
+  {
+    base::AutoLock locker(lock_);
+    inserted = mapped_offsets_.insert(offset).second;
+    dirty_num_bytes_ = std::max(dirty_num_bytes_, offset + length);
+  }
+  if (inserted) {
+    return scoped_ptr<embedder::PlatformSharedBufferMapping>(
+        new PooledSharedBufferMapping(
+            this,
+            offset,
+            static_cast<char*>(storage_->mapping->GetBase()) + offset,
+            length));
+  }
+
+  scoped_ptr<embedder::PlatformSharedBufferMapping> mapping(
+      storage_->buffer->MapNoCheck(offset, length));
+  if (!mapping)
+    return scoped_ptr<embedder::PlatformSharedBufferMapping>();
+  return scoped_ptr<embedder::PlatformSharedBufferMapping>(
+      new PooledSharedBufferMapping(this, mapping.Pass()));
+}
+
+// SharedBufferPool ------------------------------------------------------------
+
+// static
+const size_t SharedBufferPool::kMinPooledNumBytes;
+// static
+const size_t SharedBufferPool::kMaxPooledNumBytes;
+// static
+const size_t SharedBufferPool::kMaxFreeBuffersPerSizeClass;
+// static
+const size_t SharedBufferPool::kMaxFreeBytes;
+// static
+const size_t SharedBufferPool::kNumSizeClasses;
+
+SharedBufferPool::Stats::Stats()
+    : hits(0), misses(0), bypassed(0), recycled(0), discarded(0),
+      free_bytes(0) {
+}
+
+double SharedBufferPool::Stats::hit_rate() const {
+  if (!hits && !misses)
+    return 0.0;
+  return static_cast<double>(hits) / static_cast<double>(hits + misses);
+}
+
+SharedBufferPool::Storage::Storage() : size_class(0) {
+}
+
+SharedBufferPool::Storage::~Storage() {
+  // Unmap before releasing the buffer.
+  mapping.reset();
+}
+
+SharedBufferPool::SharedBufferPool(embedder::PlatformSupport* platform_support)
+    : platform_support_(platform_support) {
+  DCHECK(platform_support_);
+  COMPILE_ASSERT(kMinPooledNumBytes << (kNumSizeClasses - 1) ==
+                     kMaxPooledNumBytes,
+                 kNumSizeClasses_does_not_match_pooled_size_range);
+}
+
+embedder::PlatformSharedBuffer* SharedBufferPool::CreateSharedBuffer(
+    size_t num_bytes) {
+  if (num_bytes < kMinPooledNumBytes || num_bytes > kMaxPooledNumBytes) {
+    {
+      base::AutoLock locker(lock_);
+      stats_.bypassed++;
+    }
+    return platform_support_->CreateSharedBuffer(num_bytes);
+  }
+
+  scoped_ptr<Storage> storage = AcquireStorage(GetSizeClass(num_bytes));
+  if (!storage)
+    return nullptr;
+  return new PooledSharedBuffer(this, storage.Pass(), num_bytes);
+}
+
+embedder::PlatformSharedBuffer* SharedBufferPool::CreateSharedBufferFromHandle(
+    size_t num_bytes,
+    embedder::ScopedPlatformHandle platform_handle) {
+  // Buffers received from elsewhere are shared with someone else, so they're
+  // never pooled.
+  return platform_support_->CreateSharedBufferFromHandle(
+      num_bytes, platform_handle.Pass());
+}
+
+SharedBufferPool::Stats SharedBufferPool::GetStats() const {
+  base::AutoLock locker(lock_);
+  return stats_;
+}
+
+void SharedBufferPool::Trim() {
+  ScopedVector<Storage> to_destroy;
+  {
+    base::AutoLock locker(lock_);
+    for (size_t i = 0; i < kNumSizeClasses; i++) {
+      to_destroy.insert(to_destroy.end(),
+                        free_storage_[i].begin(),
+                        free_storage_[i].end());
+      free_storage_[i].weak_clear();
+    }
+    stats_.free_bytes = 0;
+  }
+  // |to_destroy| is destroyed (unmapping and closing everything) outside the
+  // lock.
+}
+
+SharedBufferPool::~SharedBufferPool() {
+}
+
+// static
+size_t SharedBufferPool::GetSizeClass(size_t num_bytes) {
+  DCHECK_GE(num_bytes, kMinPooledNumBytes);
+  DCHECK_LE(num_bytes, kMaxPooledNumBytes);
+  size_t size_class = 0;
+  while (GetSizeClassNumBytes(size_class) < num_bytes)
+    size_class++;
+  return size_class;
+}
+
+// static
+size_t SharedBufferPool::GetSizeClassNumBytes(size_t size_class) {
+  DCHECK_LT(size_class, kNumSizeClasses);
+  return kMinPooledNumBytes << size_class;
+}
+
+scoped_ptr<SharedBufferPool::Storage> SharedBufferPool::AcquireStorage(
+    size_t size_class) {
+  {
+    base::AutoLock locker(lock_);
+    ScopedVector<Storage>& free_storage = free_storage_[size_class];
+    if (!free_storage.empty()) {
+      scoped_ptr<Storage> storage(free_storage.back());
+      free_storage.weak_erase(free_storage.end() - 1);
+      stats_.hits++;
+      stats_.free_bytes -= GetSizeClassNumBytes(size_class);
+      return storage.Pass();
+    }
+    stats_.misses++;
+  }
+
+  // Create and map the new buffer outside the lock.
+  const size_t size_class_num_bytes = GetSizeClassNumBytes(size_class);
+  scoped_ptr<Storage> storage(new Storage());
+  storage->size_class = size_class;
+  storage->buffer = platform_support_->CreateSharedBuffer(size_class_num_bytes);
+  if (!storage->buffer.get())
+    return scoped_ptr<Storage>();
+  storage->mapping = storage->buffer->Map(0, size_class_num_bytes);
+  if (!storage->mapping)
+    return scoped_ptr<Storage>();
+  return storage.Pass();
+}
+
+void SharedBufferPool::ReleaseStorage(scoped_ptr<Storage> storage,
+                                      size_t dirty_num_bytes,
+                                      bool recyclable) {
+  const size_t size_class_num_bytes = GetSizeClassNumBytes(storage->size_class);
+
+  // Check for room before paying for zeroing. (This is rechecked below, since
+  // another buffer may have been recycled in the meantime.)
+  if (recyclable) {
+    base::AutoLock locker(lock_);
+    recyclable =
+        free_storage_[storage->size_class].size() <
+            kMaxFreeBuffersPerSizeClass &&
+        stats_.free_bytes + size_class_num_bytes <= kMaxFreeBytes;
+  }
+
+  if (recyclable) {
+    // Shared buffers are zero-filled on creation, and only the first
+    // |dirty_num_bytes| bytes can have been mapped by the previous user. A
+    // buffer that was never mapped is recycled as is.
+    DCHECK_LE(dirty_num_bytes, storage->mapping->GetLength());
+    if (dirty_num_bytes)
+      memset(storage->mapping->GetBase(), 0, dirty_num_bytes);
+
+    base::AutoLock locker(lock_);
+    ScopedVector<Storage>& free_storage = free_storage_[storage->size_class];
+    if (free_storage.size() < kMaxFreeBuffersPerSizeClass &&
+        stats_.free_bytes + size_class_num_bytes <= kMaxFreeBytes) {
+      free_storage.push_back(storage.release());
+      stats_.free_bytes += size_class_num_bytes;
+      stats_.recycled++;
+      return;
+    }
+  }
+
+  {
+    base::AutoLock locker(lock_);
+    stats_.discarded++;
+  }
+  // |storage| is destroyed outside the lock.
+}
+
+}  // namespace system
+}  // namespace mojo
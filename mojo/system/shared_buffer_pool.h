@@ -0,0 +1,142 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef MOJO_SYSTEM_SHARED_BUFFER_POOL_H_
+#define MOJO_SYSTEM_SHARED_BUFFER_POOL_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "base/macros.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/memory/scoped_vector.h"
+#include "base/synchronization/lock.h"
+#include "mojo/embedder/platform_support.h"
+#include "mojo/system/system_impl_export.h"
+
+namespace mojo {
+
+namespace embedder {
+class PlatformSharedBuffer;
+class PlatformSharedBufferMapping;
+}
+
+namespace system {
+
+// A |PlatformSupport| that recycles large shared buffers. Creating (and first
+// mapping) a large shared buffer is expensive: it costs a file/section
+// creation, an mmap and a page fault per page touched. Buffers created through
+// the pool are rounded up to a power-of-two size class and kept mapped for
+// their whole lifetime; once the last reference to a buffer (i.e., the last
+// handle and the last mapping) is released, its storage is zeroed and returned
+// to the pool, to be handed out by a later |CreateSharedBuffer()| of the same
+// size class.
+//
+// Buffers whose platform handle is duplicated or passed (e.g., to send them to
+// another process) can no longer be recycled safely, since we don't know when
+// the other side is done with them; such buffers are simply destroyed on
+// release.
+//
+// Requests smaller than |kMinPooledNumBytes| or larger than
+// |kMaxPooledNumBytes| are passed straight through to the underlying
+// |PlatformSupport|.
+//
+// This class is thread-safe. It is ref-counted, since buffers handed out by it
+// keep it alive (so that they can return their storage to it).
+class MOJO_SYSTEM_IMPL_EXPORT SharedBufferPool
+    : public embedder::PlatformSupport,
+      public base::RefCountedThreadSafe<SharedBufferPool> {
+ public:
+  static const size_t kMinPooledNumBytes = 64 * 1024;
+  static const size_t kMaxPooledNumBytes = 16 * 1024 * 1024;
+  // Limits on the number of free buffers (per size class) and the total
+  // number of bytes the pool keeps around.
+  static const size_t kMaxFreeBuffersPerSizeClass = 4;
+  static const size_t kMaxFreeBytes = 64 * 1024 * 1024;
+
+  struct Stats {
+    Stats();
+
+    // Returns |hits / (hits + misses)|, or 0 if there were no pooled requests.
+    double hit_rate() const;
+
+    // Pooled requests satisfied from (respectively, not satisfied from) a
+    // free buffer.
+    uint64_t hits;
+    uint64_t misses;
+    // Requests outside the pooled size range.
+    uint64_t bypassed;
+    // Released buffers returned to (respectively, not returned to) the pool.
+    uint64_t recycled;
+    uint64_t discarded;
+    // Current number of bytes (rounded up to size classes) in free buffers.
+    size_t free_bytes;
+  };
+
+  // |platform_support| is used to create the actual buffers; it must outlive
+  // all calls to |CreateSharedBuffer()| and |CreateSharedBufferFromHandle()|
+  // (but not necessarily the buffers created by them).
+  explicit SharedBufferPool(embedder::PlatformSupport* platform_support);
+
+  // |embedder::PlatformSupport| implementation:
+  virtual embedder::PlatformSharedBuffer* CreateSharedBuffer(
+      size_t num_bytes) OVERRIDE;
+  virtual embedder::PlatformSharedBuffer* CreateSharedBufferFromHandle(
+      size_t num_bytes,
+      embedder::ScopedPlatformHandle platform_handle) OVERRIDE;
+
+  Stats GetStats() const;
+
+  // Destroys all free buffers.
+  void Trim();
+
+ private:
+  friend class base::RefCountedThreadSafe<SharedBufferPool>;
+  class PooledSharedBuffer;
+  class PooledSharedBufferMapping;
+
+  // The actual buffer backing a |PooledSharedBuffer|, together with a mapping
+  // of all of it.
+  struct Storage {
+    Storage();
+    ~Storage();
+
+    size_t size_class;
+    scoped_refptr<embedder::PlatformSharedBuffer> buffer;
+    scoped_ptr<embedder::PlatformSharedBufferMapping> mapping;
+  };
+
+  // Size classes are powers of two from |kMinPooledNumBytes| to
+  // |kMaxPooledNumBytes|, inclusive.
+  static const size_t kNumSizeClasses = 9;
+
+  virtual ~SharedBufferPool();
+
+  static size_t GetSizeClass(size_t num_bytes);
+  static size_t GetSizeClassNumBytes(size_t size_class);
+
+  // Returns free storage for |size_class|, or creates new storage. Returns
+  // null on failure.
+  scoped_ptr<Storage> AcquireStorage(size_t size_class);
+
+  // Called (on any thread) when a |PooledSharedBuffer| is destroyed. The first
+  // |dirty_num_bytes| bytes of |storage| may be dirty; the rest is still zero.
+  void ReleaseStorage(scoped_ptr<Storage> storage,
+                      size_t dirty_num_bytes,
+                      bool recyclable);
+
+  embedder::PlatformSupport* const platform_support_;
+
+  mutable base::Lock lock_;  // Protects the following members.
+  ScopedVector<Storage> free_storage_[kNumSizeClasses];
+  Stats stats_;
+
+  DISALLOW_COPY_AND_ASSIGN(SharedBufferPool);
+};
+
+}  // namespace system
+}  // namespace mojo
+
+#endif  // MOJO_SYSTEM_SHARED_BUFFER_POOL_H_
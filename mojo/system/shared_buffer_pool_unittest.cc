@@ -0,0 +1,200 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "mojo/system/shared_buffer_pool.h"
+
+#include <string.h>
+
+#include "base/macros.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/scoped_ptr.h"
+#include "mojo/embedder/platform_shared_buffer.h"
+#include "mojo/embedder/simple_platform_support.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace mojo {
+namespace system {
+namespace {
+
+class SharedBufferPoolTest : public testing::Test {
+ public:
+  SharedBufferPoolTest()
+      : pool_(new SharedBufferPool(&platform_support_)) {}
+  virtual ~SharedBufferPoolTest() {}
+
+  SharedBufferPool* pool() { return pool_.get(); }
+
+  scoped_refptr<embedder::PlatformSharedBuffer> CreateBuffer(
+      size_t num_bytes) {
+    return make_scoped_refptr(pool_->CreateSharedBuffer(num_bytes));
+  }
+
+ private:
+  embedder::SimplePlatformSupport platform_support_;
+  scoped_refptr<SharedBufferPool> pool_;
+
+  DISALLOW_COPY_AND_ASSIGN(SharedBufferPoolTest);
+};
+
+TEST_F(SharedBufferPoolTest, RecyclesReleasedBuffers) {
+  const size_t kNumBytes = SharedBufferPool::kMinPooledNumBytes + 100;
+
+  scoped_refptr<embedder::PlatformSharedBuffer> buffer(CreateBuffer(kNumBytes));
+  ASSERT_TRUE(buffer.get());
+  EXPECT_EQ(kNumBytes, buffer->GetNumBytes());
+  EXPECT_FALSE(buffer->IsValidMap(0, kNumBytes + 1));
+
+  // Dirty the buffer.
+  {
+    scoped_ptr<embedder::PlatformSharedBufferMapping> mapping(
+        buffer->Map(0, kNumBytes));
+    ASSERT_TRUE(mapping);
+    memset(mapping->GetBase(), 'x', kNumBytes);
+  }
+  buffer = nullptr;
+
+  SharedBufferPool::Stats stats = pool()->GetStats();
+  EXPECT_EQ(0u, stats.hits);
+  EXPECT_EQ(1u, stats.misses);
+  EXPECT_EQ(1u, stats.recycled);
+  EXPECT_EQ(2 * SharedBufferPool::kMinPooledNumBytes, stats.free_bytes);
+
+  // Anything in the same size class should reuse the storage, zero-filled.
+  buffer = CreateBuffer(kNumBytes + 200);
+  ASSERT_TRUE(buffer.get());
+  {
+    scoped_ptr<embedder::PlatformSharedBufferMapping> mapping(
+        buffer->Map(0, kNumBytes + 200));
+    ASSERT_TRUE(mapping);
+    const char* data = static_cast<const char*>(mapping->GetBase());
+    for (size_t i = 0; i < kNumBytes + 200; i++)
+      ASSERT_EQ(0, data[i]) << i;
+  }
+
+  stats = pool()->GetStats();
+  EXPECT_EQ(1u, stats.hits);
+  EXPECT_EQ(1u, stats.misses);
+  EXPECT_EQ(0u, stats.free_bytes);
+  EXPECT_DOUBLE_EQ(0.5, stats.hit_rate());
+}
+
+TEST_F(SharedBufferPoolTest, ZeroesOnlyMappedRanges) {
+  const size_t kNumBytes = SharedBufferPool::kMinPooledNumBytes;
+  const size_t kOffset = kNumBytes / 2;
+  const size_t kLength = 100;
+
+  // A buffer that was never mapped is recycled too.
+  scoped_refptr<embedder::PlatformSharedBuffer> buffer(CreateBuffer(kNumBytes));
+  ASSERT_TRUE(buffer.get());
+  buffer = nullptr;
+  EXPECT_EQ(1u, pool()->GetStats().recycled);
+
+  // Dirty a range in the middle of the buffer, through both the persistent
+  // mapping and a separate one.
+  buffer = CreateBuffer(kNumBytes);
+  ASSERT_TRUE(buffer.get());
+  {
+    scoped_ptr<embedder::PlatformSharedBufferMapping> mapping(
+        buffer->Map(kOffset, kLength));
+    ASSERT_TRUE(mapping);
+    scoped_ptr<embedder::PlatformSharedBufferMapping> other_mapping(
+        buffer->Map(kOffset, 2 * kLength));
+    ASSERT_TRUE(other_mapping);
+    memset(mapping->GetBase(), 'x', kLength);
+    memset(other_mapping->GetBase(), 'y', 2 * kLength);
+  }
+  buffer = nullptr;
+
+  buffer = CreateBuffer(kNumBytes);
+  ASSERT_TRUE(buffer.get());
+  {
+    scoped_ptr<embedder::PlatformSharedBufferMapping> mapping(
+        buffer->Map(0, kNumBytes));
+    ASSERT_TRUE(mapping);
+    const char* data = static_cast<const char*>(mapping->GetBase());
+    for (size_t i = 0; i < kNumBytes; i++)
+      ASSERT_EQ(0, data[i]) << i;
+  }
+
+  SharedBufferPool::Stats stats = pool()->GetStats();
+  EXPECT_EQ(2u, stats.hits);
+  EXPECT_EQ(1u, stats.misses);
+}
+
+TEST_F(SharedBufferPoolTest, MappingsKeepBufferAlive) {
+  const size_t kNumBytes = SharedBufferPool::kMinPooledNumBytes;
+
+  scoped_refptr<embedder::PlatformSharedBuffer> buffer(CreateBuffer(kNumBytes));
+  ASSERT_TRUE(buffer.get());
+  scoped_ptr<embedder::PlatformSharedBufferMapping> mapping1(
+      buffer->Map(0, kNumBytes));
+  ASSERT_TRUE(mapping1);
+  // A second mapping of the same range must have a distinct address.
+  scoped_ptr<embedder::PlatformSharedBufferMapping> mapping2(
+      buffer->Map(0, 100));
+  ASSERT_TRUE(mapping2);
+  EXPECT_NE(mapping1->GetBase(), mapping2->GetBase());
+
+  static_cast<char*>(mapping1->GetBase())[50] = 'x';
+  EXPECT_EQ('x', static_cast<char*>(mapping2->GetBase())[50]);
+
+  buffer = nullptr;
+  EXPECT_EQ(0u, pool()->GetStats().recycled);
+  mapping1.reset();
+  EXPECT_EQ(0u, pool()->GetStats().recycled);
+  mapping2.reset();
+  EXPECT_EQ(1u, pool()->GetStats().recycled);
+}
+
+TEST_F(SharedBufferPoolTest, EscapedBuffersAreNotRecycled) {
+  const size_t kNumBytes = SharedBufferPool::kMinPooledNumBytes;
+
+  scoped_refptr<embedder::PlatformSharedBuffer> buffer(CreateBuffer(kNumBytes));
+  ASSERT_TRUE(buffer.get());
+  embedder::ScopedPlatformHandle handle(buffer->DuplicatePlatformHandle());
+  EXPECT_TRUE(handle.is_valid());
+  buffer = nullptr;
+
+  SharedBufferPool::Stats stats = pool()->GetStats();
+  EXPECT_EQ(0u, stats.recycled);
+  EXPECT_EQ(1u, stats.discarded);
+  EXPECT_EQ(0u, stats.free_bytes);
+}
+
+TEST_F(SharedBufferPoolTest, SmallAndHugeBuffersBypassPool) {
+  scoped_refptr<embedder::PlatformSharedBuffer> buffer(CreateBuffer(100));
+  ASSERT_TRUE(buffer.get());
+  EXPECT_EQ(100u, buffer->GetNumBytes());
+  buffer = nullptr;
+
+  SharedBufferPool::Stats stats = pool()->GetStats();
+  EXPECT_EQ(1u, stats.bypassed);
+  EXPECT_EQ(0u, stats.misses);
+  EXPECT_EQ(0u, stats.recycled);
+  EXPECT_DOUBLE_EQ(0.0, stats.hit_rate());
+}
+
+TEST_F(SharedBufferPoolTest, FreeBuffersAreCapped) {
+  const size_t kNumBytes = SharedBufferPool::kMinPooledNumBytes;
+  const size_t kNumBuffers = SharedBufferPool::kMaxFreeBuffersPerSizeClass + 2;
+
+  scoped_refptr<embedder::PlatformSharedBuffer> buffers[kNumBuffers];
+  for (size_t i = 0; i < kNumBuffers; i++) {
+    buffers[i] = CreateBuffer(kNumBytes);
+    ASSERT_TRUE(buffers[i].get());
+  }
+  for (size_t i = 0; i < kNumBuffers; i++)
+    buffers[i] = nullptr;
+
+  SharedBufferPool::Stats stats = pool()->GetStats();
+  EXPECT_EQ(SharedBufferPool::kMaxFreeBuffersPerSizeClass, stats.recycled);
+  EXPECT_EQ(2u, stats.discarded);
+
+  pool()->Trim();
+  EXPECT_EQ(0u, pool()->GetStats().free_bytes);
+}
+
+}  // namespace
+}  // namespace system
+}  // namespace mojo